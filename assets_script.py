@@ -0,0 +1,170 @@
+Import("env")
+
+# Statik web dosyalarını (data/) build öncesi hazırlar:
+#   - her dosya gzip'lenir (mtime=0, çıktı deterministik)
+#   - css/js gibi dosyalar içerik hash'iyle parmak izlenir (app.<hash>.js),
+#     HTML içindeki referanslar bu adlara çevrilir
+#   - tablo include/ yerine .pio/assets/include/StaticAssetsData.h'ye yazılır
+#   - SPIFFS imajı .pio/assets/data/ dizininden (.gz dosyaları) oluşturulur
+#
+# custom_embed_assets = yes ise gzip içerikleri firmware'e const dizi olarak
+# gömülür ve sayfa yükleme SPIFFS'e hiç dokunmaz.
+
+import gzip
+import hashlib
+import os
+import re
+
+PROJECT_DIR = env.subst("$PROJECT_DIR")
+SOURCE_DIR = os.path.join(PROJECT_DIR, "data")
+OUT_DIR = os.path.join(PROJECT_DIR, ".pio", "assets")
+OUT_DATA_DIR = os.path.join(OUT_DIR, "data")
+OUT_INCLUDE_DIR = os.path.join(OUT_DIR, "include")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".ico": "image/x-icon",
+    ".png": "image/png",
+    ".svg": "image/svg+xml",
+    ".txt": "text/plain",
+}
+
+# HTML girdi noktasıdır, adı sabit kalmalı
+NOT_FINGERPRINTED = (".html",)
+
+
+def embed_enabled():
+    value = env.GetProjectOption("custom_embed_assets", "no")
+    return value.strip().lower() in ("yes", "true", "1")
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()
+
+
+def fingerprint_path(path, digest):
+    root, ext = os.path.splitext(path)
+    if ext in NOT_FINGERPRINTED:
+        return path
+    return "%s.%s%s" % (root, digest[:8], ext)
+
+
+def write_if_changed(path, data):
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == data:
+                return
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "wb") as f:
+        f.write(data)
+
+
+def collect_assets():
+    assets = []
+    for root, _, files in os.walk(SOURCE_DIR):
+        for name in sorted(files):
+            if name.startswith("."):
+                continue
+            full = os.path.join(root, name)
+            url = "/" + os.path.relpath(full, SOURCE_DIR).replace(os.sep, "/")
+            with open(full, "rb") as f:
+                assets.append({"url": url, "data": f.read()})
+    # HTML en son: referans verdiği dosyaların hash'i önce belli olmalı
+    assets.sort(key=lambda a: (a["url"].endswith(".html"), a["url"]))
+    return assets
+
+
+def rewrite_references(data, renames):
+    text = data.decode("utf-8")
+    for url, fingerprinted in renames.items():
+        # href='css/style.css', src="/js/app.js" gibi göreli ve mutlak biçimler
+        pattern = r"""(["'])(/?)%s\1""" % re.escape(url.lstrip("/"))
+        text = re.sub(pattern, lambda m: m.group(1) + m.group(2) + fingerprinted.lstrip("/") + m.group(1), text)
+    return text.encode("utf-8")
+
+
+def c_string(value):
+    return '"' + value.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def c_bytes(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def build_assets():
+    embed = embed_enabled()
+    renames = {}
+    entries = []
+
+    for asset in collect_assets():
+        url = asset["url"]
+        data = asset["data"]
+        if url.endswith(".html"):
+            data = rewrite_references(data, renames)
+
+        digest = content_hash(data)
+        fingerprinted = fingerprint_path(url, digest)
+        renames[url] = fingerprinted
+
+        compressed = gzip.compress(data, 9, mtime=0)
+        write_if_changed(os.path.join(OUT_DATA_DIR, url.lstrip("/") + ".gz"), compressed)
+
+        ext = os.path.splitext(url)[1].lower()
+        entries.append({
+            "url": url,
+            "fingerprinted": fingerprinted,
+            "type": CONTENT_TYPES.get(ext, "application/octet-stream"),
+            "etag": '"%s"' % digest[:16],
+            "storage": url + ".gz",
+            "gz": compressed,
+            "size": len(data),
+        })
+
+    lines = [
+        "// assets_script.py tarafından üretildi, elle düzenlemeyin",
+        "#ifndef STATIC_ASSETS_DATA_H",
+        "#define STATIC_ASSETS_DATA_H",
+        "",
+        "#define STATIC_ASSETS_EMBEDDED %d" % (1 if embed else 0),
+        "",
+    ]
+    if embed:
+        for i, entry in enumerate(entries):
+            lines.append("static const uint8_t STATIC_ASSET_%d[] = {" % i)
+            lines.append(c_bytes(entry["gz"]))
+            lines.append("};")
+            lines.append("")
+
+    lines.append("static const StaticAsset STATIC_ASSETS[] = {")
+    for i, entry in enumerate(entries):
+        data_ref = "STATIC_ASSET_%d" % i if embed else "nullptr"
+        lines.append("    { %s, %s, %s, %s, %s, %s, %d },  // %d -> %d bytes" % (
+            c_string(entry["url"]), c_string(entry["fingerprinted"]), c_string(entry["type"]),
+            c_string(entry["etag"]), c_string(entry["storage"]), data_ref,
+            len(entry["gz"]), entry["size"], len(entry["gz"])))
+    lines.append("};")
+    lines.append("")
+    lines.append("#define STATIC_ASSET_COUNT %d" % len(entries))
+    lines.append("")
+    lines.append("#endif // STATIC_ASSETS_DATA_H")
+    lines.append("")
+
+    write_if_changed(os.path.join(OUT_INCLUDE_DIR, "StaticAssetsData.h"), "\n".join(lines).encode("utf-8"))
+
+    total = sum(e["size"] for e in entries)
+    total_gz = sum(len(e["gz"]) for e in entries)
+    print("Static assets: %d files, %d -> %d bytes gzip (%s)" % (
+        len(entries), total, total_gz, "embedded" if embed else "SPIFFS"))
+
+
+build_assets()
+
+env.Append(CPPPATH=[OUT_INCLUDE_DIR])
+# buildfs/uploadfs gzip'li dosyaları yükler
+env.Replace(PROJECT_DATA_DIR=OUT_DATA_DIR)
@@ -0,0 +1,112 @@
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+// env:native benchmark runner'ı.
+//
+//   pio run -e native && .pio/build/native/program [filtre]
+//
+// Her benchmark BENCH(isim) ile kaydedilir; filtre verilirse sadece adında
+// filtre geçenler çalışır. Ölçümler sabit tohumlu girdilerle yapılır ve
+// birkaç tekrarın medyanı raporlanır.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <SD.h>
+
+typedef void (*BenchFn)();
+
+struct BenchCase {
+    const char* name;
+    BenchFn fn;
+};
+
+std::vector<BenchCase>& benchRegistry();
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFn fn) {
+        benchRegistry().push_back({ name, fn });
+    }
+};
+
+#define BENCH(name) \
+    static void bench_##name(); \
+    static BenchRegistrar benchRegistrar_##name(#name, bench_##name); \
+    static void bench_##name()
+
+#define BENCH_REPEATS 5
+
+// fn'i `iterations` kez çalıştıran bir turun süresini ölçer; BENCH_REPEATS
+// turun medyanını işlem başına nanosaniye olarak döndürür
+inline double benchMeasureNs(size_t iterations, const std::function<void(size_t)>& fn) {
+    std::vector<double> samples;
+    fn(0);  // ısınma
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            fn(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+inline void benchReport(const char* label, double value, const char* unit) {
+    printf("  %-40s %12.2f %s\n", label, value, unit);
+}
+
+// Benchmark'ın geçici SD kökü. mkdtemp şablonuyla ("/tmp/ad_XXXXXX")
+// dizin açar ve SD'yi oraya bağlar; kapsamdan çıkınca (erken return dahil)
+// SD ayrılır, önceki kök geri yüklenir ve dizin silinir.
+class BenchSdRoot {
+private:
+    char dir[64];
+    std::string previous;
+    bool created;
+
+public:
+    explicit BenchSdRoot(const char* pattern) :
+        previous(SD.nativeRoot()),
+        created(false) {
+        snprintf(dir, sizeof(dir), "%s", pattern);
+        if (!mkdtemp(dir)) {
+            printf("  mkdtemp failed\n");
+            return;
+        }
+        created = true;
+        SD.nativeSetRoot(dir);
+        SD.begin();
+    }
+
+    ~BenchSdRoot() {
+        if (!created) return;
+        SD.end();
+        SD.nativeSetRoot(previous.c_str());
+        char cmd[96];
+        snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+        if (system(cmd) != 0) printf("  cleanup failed: %s\n", dir);
+    }
+
+    BenchSdRoot(const BenchSdRoot&) = delete;
+    BenchSdRoot& operator=(const BenchSdRoot&) = delete;
+
+    bool ok() const { return created; }
+    const char* path() const { return dir; }
+};
+
+// Derleyicinin ölçülen işi atmasını engeller
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif // BENCH_RUNNER_H
@@ -0,0 +1,56 @@
+#ifndef MOCK_I2C_BUS_H
+#define MOCK_I2C_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "DacOutputStage.h"
+
+// Host build için MCP4725 bus modeli. Gerçek I2C yok; her transaction'ın
+// hattı ne kadar meşgul edeceğini SCL frekansından hesaplar.
+//   start + adres (9 bit) + örnek başına 2 x 9 bit + stop
+class MockI2CBus : public DacBus {
+private:
+    uint32_t clockHz;
+    size_t maxSamplesPerTransaction;
+
+public:
+    uint64_t busyNs;
+    uint32_t transactions;
+    uint64_t bytes;
+    uint16_t lastCode;
+
+    MockI2CBus(uint32_t _clockHz, size_t _maxSamples = 64) :
+        clockHz(_clockHz),
+        maxSamplesPerTransaction(_maxSamples),
+        busyNs(0),
+        transactions(0),
+        bytes(0),
+        lastCode(DAC_MIDSCALE) {
+    }
+
+    static uint32_t transactionBits(size_t samples) {
+        return 1 + 9 + (uint32_t)samples * 18 + 1;
+    }
+
+    uint64_t transactionNs(size_t samples) const {
+        return (uint64_t)transactionBits(samples) * 1000000000ULL / clockHz;
+    }
+
+    virtual size_t writeFast(const uint16_t* codes, size_t count) override {
+        if (count > maxSamplesPerTransaction) count = maxSamplesPerTransaction;
+        if (count == 0) return 0;
+        busyNs += transactionNs(count);
+        transactions++;
+        bytes += 1 + count * 2;
+        lastCode = codes[count - 1];
+        return count;
+    }
+
+    void reset() {
+        busyNs = 0;
+        transactions = 0;
+        bytes = 0;
+    }
+};
+
+#endif // MOCK_I2C_BUS_H
@@ -0,0 +1,147 @@
+// Ses kontrol komutları (env:native).
+//
+// AudioManager host'ta derlenmediğinden AudioTask yerine onun kuyruğu
+// ölçülür. Üç üretici (async_tcp, MQTT, BLE) komut gönderir; tüketici
+// decode adımını 2 ms'lik iş olarak simüle eder.
+//
+// audio_commands_mutex: eski yol; üreticiler AudioManager'ı doğrudan
+// çağırır, decode adımı süresince aynı kilidi bekler.
+// audio_commands_mpsc: MpscQueue; üretici sadece hücre ayırır, tüketici
+// kuyruğu decode adımları arasında boşaltır. Kayıp olmadığı ve her
+// üreticinin sırasının korunduğu doğrulanır.
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BenchRunner.h"
+#include "MpscQueue.h"
+
+#define COMMAND_BENCH_PRODUCERS     3
+#define COMMAND_BENCH_PER_PRODUCER  200
+#define COMMAND_BENCH_DECODE_US     2000
+#define COMMAND_BENCH_GAP_US        3000    // üretici komutları arası (seri tıklama)
+
+struct BenchCommand {
+    uint8_t producer;
+    uint32_t seq;
+};
+
+static uint64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void spinUs(uint64_t us) {
+    uint64_t end = nowUs() + us;
+    while (nowUs() < end) {
+    }
+}
+
+struct ProducerLatency {
+    uint64_t maxUs = 0;
+    uint64_t totalUs = 0;
+};
+
+static void report(const char* label, const ProducerLatency* latency, uint64_t applied) {
+    uint64_t maxUs = 0, totalUs = 0;
+    for (int p = 0; p < COMMAND_BENCH_PRODUCERS; p++) {
+        maxUs = max(maxUs, latency[p].maxUs);
+        totalUs += latency[p].totalUs;
+    }
+    benchReport(label, (double)totalUs / (COMMAND_BENCH_PRODUCERS * COMMAND_BENCH_PER_PRODUCER), "us per command (caller)");
+    benchReport("  max caller block", maxUs / 1000.0, "ms");
+    benchReport("  commands applied", applied, "");
+}
+
+BENCH(audio_commands_mutex) {
+    std::mutex audioLock;
+    std::atomic<bool> running(true);
+    uint64_t applied = 0;
+    ProducerLatency latency[COMMAND_BENCH_PRODUCERS];
+
+    std::thread consumer([&]() {
+        while (running.load()) {
+            std::lock_guard<std::mutex> guard(audioLock);
+            spinUs(COMMAND_BENCH_DECODE_US);
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < COMMAND_BENCH_PRODUCERS; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < COMMAND_BENCH_PER_PRODUCER; i++) {
+                uint64_t start = nowUs();
+                {
+                    std::lock_guard<std::mutex> guard(audioLock);
+                    applied++;
+                }
+                uint64_t took = nowUs() - start;
+                latency[p].totalUs += took;
+                latency[p].maxUs = max(latency[p].maxUs, took);
+                spinUs(COMMAND_BENCH_GAP_US);
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    running.store(false);
+    consumer.join();
+
+    report("3 producers, shared lock", latency, applied);
+}
+
+BENCH(audio_commands_mpsc) {
+    MpscQueue<BenchCommand, 16> queue;
+    std::atomic<int> finished(0);
+    std::atomic<uint32_t> dropped(0);
+    uint64_t applied = 0;
+    uint32_t maxBatch = 0;
+    bool ordered = true;
+    uint32_t lastSeq[COMMAND_BENCH_PRODUCERS];
+    for (int p = 0; p < COMMAND_BENCH_PRODUCERS; p++) lastSeq[p] = 0;
+    ProducerLatency latency[COMMAND_BENCH_PRODUCERS];
+
+    std::thread consumer([&]() {
+        while (true) {
+            bool done = finished.load() == COMMAND_BENCH_PRODUCERS;
+            BenchCommand command;
+            uint32_t batch = 0;
+            while (queue.pop(command)) {
+                if (command.seq != lastSeq[command.producer] + 1) ordered = false;
+                lastSeq[command.producer] = command.seq;
+                applied++;
+                batch++;
+            }
+            maxBatch = max(maxBatch, batch);
+            if (done) break;
+            spinUs(COMMAND_BENCH_DECODE_US);
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < COMMAND_BENCH_PRODUCERS; p++) {
+        producers.emplace_back([&, p]() {
+            for (uint32_t i = 1; i <= COMMAND_BENCH_PER_PRODUCER; i++) {
+                uint64_t start = nowUs();
+                // Dolu kuyruk çağırana 503 döner; bench'te tekrar denenir
+                while (!queue.push({ (uint8_t)p, i })) {
+                    dropped.fetch_add(1);
+                    spinUs(COMMAND_BENCH_GAP_US);
+                }
+                uint64_t took = nowUs() - start;
+                latency[p].totalUs += took;
+                latency[p].maxUs = max(latency[p].maxUs, took);
+                spinUs(COMMAND_BENCH_GAP_US);
+            }
+            finished.fetch_add(1);
+        });
+    }
+    for (auto& t : producers) t.join();
+    consumer.join();
+
+    report("3 producers, lock-free queue", latency, applied);
+    benchReport("  queue full (retried)", dropped.load(), "");
+    benchReport("  max batch per decode step", maxBatch, "");
+    benchReport("  per-producer order kept", ordered ? 1 : 0, "");
+}
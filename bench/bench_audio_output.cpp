@@ -0,0 +1,67 @@
+// AudioOutputMCP4725 sıcak yolu (env:native): decoder'ın gördüğü
+// ConsumeSample / ConsumeSamples maliyeti ve değişiklik öncesi
+// "örnek başına setVoltage" yolunun I2C maliyeti.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "AudioOutputMCP4725.h"
+
+static std::vector<int16_t> makeInput(size_t frames) {
+    std::vector<int16_t> input(frames * 2);
+    uint32_t x = 1;
+    for (auto& s : input) {
+        x = x * 1664525u + 1013904223u;
+        s = (int16_t)(x >> 16);
+    }
+    return input;
+}
+
+BENCH(consume_sample) {
+    Adafruit_MCP4725 dac;
+    AudioOutputMCP4725 out(dac);
+    out.begin();
+    out.setVolume(80);
+
+    const size_t frames = 4096;
+    std::vector<int16_t> input = makeInput(frames);
+
+    double ns = benchMeasureNs(1000000, [&](size_t i) {
+        size_t f = i & (frames - 1);
+        if (!out.ConsumeSample(&input[2 * f])) {
+            while (out.pumpOnce()) {}
+            out.ConsumeSample(&input[2 * f]);
+        }
+    });
+    benchReport("ConsumeSample (per frame)", ns, "ns/frame");
+
+    double batch = benchMeasureNs(2000, [&](size_t) {
+        size_t done = 0;
+        while (done < frames) {
+            done += out.ConsumeSamples((const int16_t*)&input[2 * done], frames - done);
+            while (out.pumpOnce()) {}
+        }
+    });
+    benchReport("ConsumeSamples (batch, incl. drain)", batch / frames, "ns/frame");
+
+    const DacOutputStats& stats = out.getStats();
+    benchReport("I2C transactions per 1k frames",
+        stats.samplesWritten ? 1000.0 * stats.transactions / stats.samplesWritten : 0, "txn");
+}
+
+// Eski yol: her örnek ayrı bir setVoltage() transaction'ı
+BENCH(consume_sample_legacy_i2c) {
+    Adafruit_MCP4725 dac;
+    Wire.setClock(400000);
+    Wire.nativeResetStats();
+
+    const size_t frames = 22050;
+    for (size_t i = 0; i < frames; i++) {
+        dac.setVoltage((uint16_t)(i & 0x0FFF), false);
+    }
+    double lineSeconds = Wire.nativeBusyNs / 1e9;
+    benchReport("transactions per second of audio", (double)Wire.nativeTransactions, "txn");
+    benchReport("bus time per second of 22.05 kHz audio", lineSeconds * 1000.0, "ms");
+    benchReport("max sustainable rate at 400 kHz", frames / lineSeconds, "Hz");
+}
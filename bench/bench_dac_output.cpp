@@ -0,0 +1,124 @@
+// DAC çıkış katmanı için host benchmark'ı (env:native).
+//
+// Sanal saat üzerinde decoder (üretici) ve timer ile tetiklenen writer
+// (tüketici) simüle edilir; mock bus her transaction'ın hat süresini SCL
+// frekansından hesaplar. Eski "örnek başına bir setVoltage" yolu ile
+// karşılaştırma için teorik üst sınır da yazdırılır.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "DacOutputStage.h"
+#include "MockI2CBus.h"
+
+struct SimResult {
+    double achievedRate;
+    uint32_t transactions;
+    uint32_t underruns;
+    uint32_t missedDeadlines;
+    uint32_t minFill;
+};
+
+// Decoder modeli: 1152 örneklik MP3 frame'leri gerçek zamanın %35'i kadar
+// CPU ile üretilir, her 2 saniyede bir 80 ms'lik SD gecikmesi yaşanır.
+static SimResult simulate(uint32_t clockHz, uint32_t sampleRate, double seconds) {
+    MockI2CBus bus(clockHz);
+    DacOutputStage stage(&bus);
+
+    const uint64_t periodNs = (uint64_t)DAC_BURST_SAMPLES * 1000000000ULL / sampleRate;
+    const uint64_t endNs = (uint64_t)(seconds * 1e9);
+    const size_t frameSamples = 1152;
+    const uint64_t decodeNs = (uint64_t)(frameSamples * 1e9 / sampleRate * 0.35);
+    const uint64_t stallEveryNs = 2000000000ULL;
+    const uint64_t stallNs = 80000000ULL;
+
+    std::vector<uint16_t> frame(frameSamples);
+    for (size_t i = 0; i < frameSamples; i++) {
+        frame[i] = (uint16_t)(DAC_MIDSCALE + ((i * 37) & 0x3FF) - 512);
+    }
+
+    uint64_t producerNs = 0;
+    size_t frameOffset = 0;
+    uint64_t nextStallNs = stallEveryNs;
+    uint64_t busFreeNs = 0;
+    uint32_t missed = 0;
+
+    // Decoder'ın başlangıçta tamponu doldurması
+    stage.pushBlock(frame.data(), frameSamples);
+
+    for (uint64_t t = 0; t < endNs; t += periodNs) {
+        // Üretici bu ana kadar ne üretebildiyse tampona koy
+        while (producerNs <= t) {
+            if (producerNs >= nextStallNs) {
+                producerNs = nextStallNs + stallNs;
+                nextStallNs += stallEveryNs;
+                continue;
+            }
+            size_t pushed = stage.pushBlock(frame.data() + frameOffset, frameSamples - frameOffset);
+            frameOffset += pushed;
+            if (frameOffset < frameSamples) {
+                // Tampon dolu: decoder bir sonraki periyoda kadar bekler
+                producerNs = t + periodNs;
+                break;
+            }
+            frameOffset = 0;
+            producerNs += decodeNs;
+        }
+
+        // Writer: bus hâlâ önceki burst'ü gönderiyorsa bekleyen bildirim
+        // bus boşalınca işlenir; bir periyottan uzun sürerse bildirim kaçar
+        if (busFreeNs >= t + periodNs) {
+            missed++;
+            continue;
+        }
+        uint64_t startNs = busFreeNs > t ? busFreeNs : t;
+        uint64_t before = bus.busyNs;
+        stage.pump();
+        busFreeNs = startNs + (bus.busyNs - before);
+    }
+
+    SimResult r;
+    r.achievedRate = stage.getStats().samplesWritten / seconds;
+    r.transactions = stage.getStats().transactions;
+    r.underruns = stage.getStats().underruns;
+    r.missedDeadlines = missed;
+    r.minFill = stage.getStats().minFill;
+    return r;
+}
+
+BENCH(dac_output_pacing) {
+    const uint32_t clocks[] = { 100000, 400000, 1000000 };
+    const uint32_t rates[] = { 8000, 16000, 22050, 44100 };
+
+    printf("  burst=%d ring=%d\n", DAC_BURST_SAMPLES, DAC_RING_SAMPLES);
+    printf("  %-8s %-7s %12s %12s %8s %10s %8s %14s\n",
+        "scl", "rate", "achieved", "txn/s", "underrun", "missed", "minFill", "legacyMaxRate");
+
+    for (uint32_t clock : clocks) {
+        for (uint32_t rate : rates) {
+            const double seconds = 10.0;
+            SimResult r = simulate(clock, rate, seconds);
+            double legacyMax = clock / (double)MockI2CBus::transactionBits(1);
+            printf("  %-8u %-7u %12.0f %12.0f %8u %10u %8u %14.0f\n",
+                clock, rate, r.achievedRate, r.transactions / seconds,
+                r.underruns, r.missedDeadlines, r.minFill, legacyMax);
+        }
+    }
+}
+
+// Gerçek CPU maliyeti: push + pump, mock bus ile (hat süresi hariç)
+BENCH(dac_output_host_cost) {
+    MockI2CBus bus(400000);
+    DacOutputStage stage(&bus);
+    uint16_t code = DAC_MIDSCALE;
+
+    double ns = benchMeasureNs(4000000, [&](size_t) {
+        stage.push(code);
+        code = (uint16_t)((code + 7) & 0x0FFF);
+        if (stage.getFillLevel() >= DAC_BURST_SAMPLES) {
+            stage.pump();
+        }
+    });
+    benchReport("push + pump", ns, "ns/sample");
+}
@@ -0,0 +1,234 @@
+// Parça geçişleri (env:native).
+//
+// Üç 3 saniyelik parça arka arkaya çalınır. Decoder simüle saatte
+// maliyetlenir: dosya açma 30 ms, başlık 4 ms, 1152 frame'lik MP3
+// çerçevesi 6 ms. DAC 44.1 kHz'de ~93 ms'lik tampondan tüketir; tampon
+// boşken geçen süre sessizliktir. Çalınan her örnek parça ve sırasıyla
+// kodlanır, böylece eksik/fazla örnek ve geçiş sınırı doğrulanır.
+//
+// gapless_legacy: parça bitince decoder kapatılır, çıkış durdurulur
+// (tampon boşaltılır, DAC 0'a çekilir), sıradaki parça açılıp çözülür.
+// gapless_chain: GaplessChain; sıradaki parça önceden açılıp bir
+// çerçeve önden çözülür, aynı pump() içinde örnek sınırında geçilir.
+
+#include <Arduino.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "DacOutputStage.h"
+#include "GaplessChain.h"
+
+#define GAPLESS_BENCH_TRACKS        3
+#define GAPLESS_BENCH_RATE          44100
+#define GAPLESS_BENCH_FRAMES        (3 * GAPLESS_BENCH_RATE)
+#define GAPLESS_BENCH_OPEN_US       30000
+#define GAPLESS_BENCH_HEADER_US     4000
+#define GAPLESS_BENCH_DECODE_US     6000
+#define GAPLESS_BENCH_MP3_FRAME     1152
+#define GAPLESS_BENCH_DAC_FRAMES    4096
+#define GAPLESS_BENCH_TICK_US       1000    // ses task'ının vTaskDelay(1)'i
+
+// Zaman tabanlı DAC modeli: örnekleri hızında tüketir, sırasını doğrular
+class BenchDacSink : public AudioOutput {
+private:
+    std::vector<int16_t> ring;
+    size_t head = 0;
+    size_t count = 0;
+    double clock = 0;
+    bool started = false;
+    int expectTrack = 0;
+    uint32_t expectIndex = 0;
+    int16_t lastLevel = 0;
+
+    void play(int16_t l, int16_t r) {
+        if (r != expectTrack || (uint16_t)l != (expectIndex & 0x7FFF)) {
+            if (r == expectTrack + 1 && l == 0 && expectIndex == GAPLESS_BENCH_FRAMES) {
+                expectTrack++;
+                expectIndex = 0;
+            } else {
+                ordered = false;
+            }
+        }
+        expectIndex++;
+        lastLevel = l;
+        played++;
+    }
+
+public:
+    uint64_t starvedUs = 0;
+    uint32_t played = 0;
+    uint32_t lost = 0;
+    uint32_t stops = 0;
+    int maxStopJump = 0;
+    bool ordered = true;
+    uint16_t stopCode;
+
+    BenchDacSink(uint16_t _stopCode) :
+        ring(GAPLESS_BENCH_DAC_FRAMES * 2),
+        stopCode(_stopCode) {
+        hertz = GAPLESS_BENCH_RATE;
+    }
+
+    bool done() const { return played >= (uint32_t)GAPLESS_BENCH_TRACKS * GAPLESS_BENCH_FRAMES; }
+
+    // now'a kadar geçen sürede DAC'ın çaldığı örnekler
+    void advance(uint64_t now) {
+        double period = 1e6 / hertz;
+        if (!started) {
+            if (count == 0) {
+                clock = now;
+                return;
+            }
+            started = true;
+            clock = now;
+        }
+        while (clock + period <= now) {
+            if (count > 0) {
+                play(ring[2 * head], ring[2 * head + 1]);
+                head = (head + 1) % GAPLESS_BENCH_DAC_FRAMES;
+                count--;
+            } else if (!done()) {
+                starvedUs += (uint64_t)period;
+            }
+            clock += period;
+        }
+    }
+
+    virtual bool begin() override { return true; }
+
+    virtual bool ConsumeSample(int16_t sample[2]) override {
+        advance(micros());
+        if (count >= GAPLESS_BENCH_DAC_FRAMES) return false;
+        size_t index = (head + count) % GAPLESS_BENCH_DAC_FRAMES;
+        ring[2 * index] = sample[0];
+        ring[2 * index + 1] = sample[1];
+        count++;
+        return true;
+    }
+
+    // AudioOutputMCP4725::stop(): tampon atılır, DAC stopCode'a çekilir.
+    // Sinyal 12-bit koda çevrilmiş gibi sıçrama ölçülür.
+    virtual bool stop() override {
+        lost += count;
+        expectIndex += count;
+        count = 0;
+        head = 0;
+        stops++;
+        int level = (lastLevel + 32768) >> 4;
+        maxStopJump = max(maxStopJump, abs(level - (int)stopCode));
+        return true;
+    }
+};
+
+// Sentetik decoder: örnek = (sıra & 0x7FFF, parça no)
+class BenchDecoder : public GaplessDecoder {
+private:
+    AudioOutput* out = nullptr;
+    int track = 0;
+    uint32_t pos = 0;
+    uint32_t frameBase = 0;
+    uint32_t frameLen = 0;
+    uint32_t framePos = 0;
+
+public:
+    virtual bool begin(const String& path, AudioOutput* output) override {
+        nativeAdvanceMicros(GAPLESS_BENCH_OPEN_US + GAPLESS_BENCH_HEADER_US);
+        out = output;
+        track = path[2] - '0';
+        pos = 0;
+        frameLen = 0;
+        framePos = 0;
+        out->SetRate(GAPLESS_BENCH_RATE);
+        return true;
+    }
+
+    // ESP8266Audio gibi: çıkış doluncaya kadar çözer
+    virtual bool loop() override {
+        while (true) {
+            while (framePos < frameLen) {
+                uint32_t index = frameBase + framePos;
+                // Seviye parça içinde yavaşça değişir (klik ölçümü için)
+                int16_t sample[2] = { (int16_t)(index & 0x7FFF), (int16_t)track };
+                if (!out->ConsumeSample(sample)) return true;
+                framePos++;
+            }
+            if (pos >= GAPLESS_BENCH_FRAMES) return false;
+            nativeAdvanceMicros(GAPLESS_BENCH_DECODE_US);
+            frameBase = pos;
+            frameLen = min((uint32_t)GAPLESS_BENCH_MP3_FRAME, GAPLESS_BENCH_FRAMES - pos);
+            framePos = 0;
+            pos += frameLen;
+        }
+    }
+
+    virtual void stop() override {}
+};
+
+static String trackPath(int track) {
+    return String("/t") + String(track) + String(".mp3");
+}
+
+static void report(const char* label, const BenchDacSink& sink, uint32_t transitions) {
+    benchReport(label, transitions ? sink.starvedUs / 1000.0 / transitions : 0, "ms silence per transition");
+    benchReport("  samples played", sink.played, "");
+    benchReport("  samples lost (tail flushed)", sink.lost, "");
+    benchReport("  DAC jump at stop", sink.maxStopJump, "LSB");
+    benchReport("  sample-accurate order", sink.ordered && sink.lost == 0 ? 1 : 0, "");
+}
+
+BENCH(gapless_legacy) {
+    BenchDacSink sink(0);
+    BenchDecoder decoder;
+    nativeSetMicros(0);
+
+    int track = 0;
+    decoder.begin(trackPath(track), &sink);
+    while (!sink.done() && micros() < 60000000) {
+        if (!decoder.loop()) {
+            decoder.stop();
+            sink.stop();
+            if (++track >= GAPLESS_BENCH_TRACKS) break;
+            decoder.begin(trackPath(track), &sink);
+        }
+        nativeAdvanceMicros(GAPLESS_BENCH_TICK_US);
+        sink.advance(micros());
+    }
+    // Kalan tamponu çal
+    nativeAdvanceMicros(200000);
+    sink.advance(micros());
+    nativeUseRealClock();
+
+    report("decoder teardown + reopen", sink, GAPLESS_BENCH_TRACKS - 1);
+}
+
+BENCH(gapless_chain) {
+    BenchDacSink sink(DAC_MIDSCALE);
+    BenchDecoder first;
+    BenchDecoder second;
+    GaplessChain chain;
+    chain.begin(&sink, &first, &second);
+    nativeSetMicros(0);
+
+    int queued = 0;
+    uint32_t seenTransitions = 0;
+    chain.play(trackPath(0));
+    while (!sink.done() && micros() < 60000000) {
+        // AudioManager'ın yapacağı: geçişten sonra sıradakini kuyruğa al
+        if (queued == (int)seenTransitions && queued + 1 < GAPLESS_BENCH_TRACKS) {
+            chain.queueNext(trackPath(++queued));
+        }
+        seenTransitions = chain.getTransitions();
+        chain.loop();
+        nativeAdvanceMicros(GAPLESS_BENCH_TICK_US);
+        sink.advance(micros());
+    }
+    // Kuyruk bitti; çıkış bir kez, midscale'e durdurulur
+    chain.stop();
+    nativeUseRealClock();
+
+    const GaplessStats& stats = chain.getStats();
+    report("pre-opened next track", sink, stats.transitions);
+    benchReport("  transitions", stats.transitions, "");
+    benchReport("  preroll at switch", stats.prerollAtSwitch, "frames");
+    benchReport("  max switch latency (pipeline)", stats.maxSwitchUs, "us");
+    benchReport("  output stops (end of queue only)", sink.stops, "");
+}
@@ -0,0 +1,569 @@
+// Heap parçalanması uzun çalışma testi (env:native).
+//
+// heap_soak: günlerce süren simüle trafik (saniyede bir /api/status ve
+// WebSocket delta'sı, 5 sn'de bir playlist, dakikada bir timer listesi,
+// çalma/silme komutları, saatlik upload) iki kez oynatılır: handler'ların
+// bu değişiklikten önceki hali (String birleştirme, istek başına
+// DynamicJsonDocument, parça başına String) ve şimdiki hali (LibraryPath,
+// RequestArena). İki turda da AsyncWebServer'ın kendi nesneleri, WebSocket
+// tamponları ve saatlerce yaşayan oturum blokları aynı sırayla ayrılır.
+//
+// ESP32 heap'i ilk uyan (first-fit), adres sıralı, birleştirmeli bir
+// modelle taklit edilir. Tur boyunca global operator new modele yönlenir;
+// host String'i (std::string) ve LibraryIndex'in vektörleri gerçek kodla
+// modelden ayrılır. Cihazdaki ayırıcıdan farklı olduğu için mutlak
+// değerler değil iki tur arasındaki fark anlamlıdır. Rapor: 12 saatte bir
+// en büyük boş blok ve toplam boş, saat başına heap ayırma sayısı.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <new>
+#include <stdlib.h>
+#include <string>
+#include "BenchRunner.h"
+#include "LibraryIndex.h"
+#include "PlaylistStream.h"
+#include "RequestArena.h"
+#include "StatusSnapshot.h"
+
+#define SOAK_HEAP_SIZE          (96 * 1024)     // WiFi + BT sonrası kalan heap mertebesi
+#define SOAK_DAYS               7
+#define SOAK_SAMPLE_HOURS       12
+#define SOAK_LIBRARY_TRACKS     300
+#define SOAK_WS_CLIENTS         2
+#define SOAK_SESSION_SLOTS      24              // saatlerce yaşayan bloklar (lwIP, MQTT, WiFi)
+#define SOAK_PENDING_REQUESTS   2               // yanıtı henüz gönderilmemiş istekler
+
+// --- Heap modeli ---
+
+class SoakHeap {
+private:
+    struct Header {
+        uint32_t size;          // başlık dahil
+        uint32_t prevSize;      // fiziksel önceki blok; 0: ilk blok
+        uint32_t used;
+        uint32_t pad;
+    };
+    struct Links {
+        Header* prev;
+        Header* next;
+    };
+
+    static const size_t HEADER = sizeof(Header);
+    static const size_t MIN_BLOCK = HEADER + sizeof(Links);
+
+    uint8_t* base;
+    size_t capacity;
+    Header* freeHead;
+
+    static Links* links(Header* h) { return (Links*)(h + 1); }
+    Header* nextPhysical(Header* h) const {
+        uint8_t* next = (uint8_t*)h + h->size;
+        return next < base + capacity ? (Header*)next : nullptr;
+    }
+    Header* prevPhysical(Header* h) const {
+        return h->prevSize ? (Header*)((uint8_t*)h - h->prevSize) : nullptr;
+    }
+
+    void unlink(Header* h) {
+        Links* l = links(h);
+        if (l->prev) links(l->prev)->next = l->next; else freeHead = l->next;
+        if (l->next) links(l->next)->prev = l->prev;
+    }
+
+    // Adres sırası korunur (first-fit düşük adresleri tercih eder)
+    void insert(Header* h) {
+        Header* prev = nullptr;
+        Header* cur = freeHead;
+        while (cur && cur < h) {
+            prev = cur;
+            cur = links(cur)->next;
+        }
+        links(h)->prev = prev;
+        links(h)->next = cur;
+        if (prev) links(prev)->next = h; else freeHead = h;
+        if (cur) links(cur)->prev = h;
+    }
+
+public:
+    uint32_t allocations;
+    uint32_t failures;
+    size_t freeBytes;
+
+    SoakHeap() : base(nullptr), capacity(0), freeHead(nullptr), allocations(0), failures(0), freeBytes(0) {}
+
+    void reset(size_t size) {
+        if (!base) base = (uint8_t*)aligned_alloc(16, size);
+        capacity = size;
+        Header* h = (Header*)base;
+        h->size = (uint32_t)size;
+        h->prevSize = 0;
+        h->used = 0;
+        freeHead = nullptr;
+        insert(h);
+        freeBytes = size;
+        allocations = 0;
+        failures = 0;
+    }
+
+    bool owns(void* p) const { return base && p >= base && p < base + capacity; }
+
+    void* allocate(size_t n) {
+        size_t need = ((n + 15) & ~(size_t)15) + HEADER;
+        if (need < MIN_BLOCK) need = MIN_BLOCK;
+        for (Header* h = freeHead; h; h = links(h)->next) {
+            if (h->size < need) continue;
+            unlink(h);
+            if (h->size - need >= MIN_BLOCK) {
+                Header* rest = (Header*)((uint8_t*)h + need);
+                rest->size = h->size - (uint32_t)need;
+                rest->prevSize = (uint32_t)need;
+                rest->used = 0;
+                Header* after = nextPhysical(rest);
+                if (after) after->prevSize = rest->size;
+                h->size = (uint32_t)need;
+                insert(rest);
+            }
+            h->used = 1;
+            freeBytes -= h->size;
+            allocations++;
+            return h + 1;
+        }
+        failures++;
+        return nullptr;
+    }
+
+    void release(void* p) {
+        Header* h = (Header*)p - 1;
+        h->used = 0;
+        freeBytes += h->size;
+        Header* next = nextPhysical(h);
+        if (next && !next->used) {
+            unlink(next);
+            h->size += next->size;
+        }
+        Header* prev = prevPhysical(h);
+        if (prev && !prev->used) {
+            prev->size += h->size;
+            h = prev;
+        } else {
+            insert(h);
+        }
+        next = nextPhysical(h);
+        if (next) next->prevSize = h->size;
+    }
+
+    size_t largestFree() const {
+        size_t largest = 0;
+        for (Header* h = freeHead; h; h = links(h)->next) {
+            if (h->size > largest) largest = h->size;
+        }
+        return largest > HEADER ? largest - HEADER : 0;
+    }
+};
+
+static SoakHeap soakHeap;
+static thread_local bool soakActive = false;
+
+// Tur dışında ve model dolduğunda sistem ayırıcısı; serbest bırakma adrese göre
+void* operator new(size_t size) {
+    if (soakActive) {
+        void* p = soakHeap.allocate(size);
+        if (p) return p;
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    if (soakHeap.owns(p)) {
+        soakHeap.release(p);
+    } else {
+        free(p);
+    }
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+static void* heapAlloc(size_t size) {
+    return ::operator new(size);
+}
+
+static void heapFree(void* p) {
+    ::operator delete(p);
+}
+
+// --- Değişmeyen altyapı: AsyncWebServer istek/yanıt nesneleri ---
+
+struct PendingRequest {
+    void* blocks[6];
+    size_t count;
+};
+
+static PendingRequest pending[SOAK_PENDING_REQUESTS];
+static size_t pendingNext = 0;
+
+static void releaseRequest(PendingRequest& request) {
+    for (size_t i = 0; i < request.count; i++) heapFree(request.blocks[i]);
+    request.count = 0;
+}
+
+// İstek nesnesi, url ve parametreler, yanıt nesnesi ve tamponu; yanıt
+// gönderilene kadar (sonraki istekler işlenirken) yaşar
+static void beginRequest(size_t urlLength, size_t params, size_t responseBuffer) {
+    PendingRequest& request = pending[pendingNext];
+    pendingNext = (pendingNext + 1) % SOAK_PENDING_REQUESTS;
+    releaseRequest(request);
+    request.blocks[request.count++] = heapAlloc(320);
+    request.blocks[request.count++] = heapAlloc(urlLength + 1);
+    for (size_t i = 0; i < params && request.count < 5; i++) {
+        request.blocks[request.count++] = heapAlloc(48 + 24 * i);
+    }
+    request.blocks[request.count++] = heapAlloc(96 + responseBuffer);
+}
+
+static void* wsBuffers[SOAK_WS_CLIENTS];
+
+// Her istemciye delta çerçevesinin kopyası; bir sonraki çerçeveye kadar kuyrukta
+static void queueWebSocket(size_t frameLength) {
+    for (size_t c = 0; c < SOAK_WS_CLIENTS; c++) {
+        if (wsBuffers[c]) heapFree(wsBuffers[c]);
+        wsBuffers[c] = heapAlloc(frameLength + 48);
+    }
+}
+
+// Diğer task'lar (lwIP, MQTT, WiFi) handler çalışırken araya girer; onların
+// saatlerce yaşayan blokları o anda canlı olan geçici blokların arasına düşer.
+// Handler'ların aynı noktasından iki turda da aynı sırayla çağrılır.
+static void* sessions[SOAK_SESSION_SLOTS];
+static uint32_t sessionEnds[SOAK_SESSION_SLOTS];
+static uint32_t soakSecond = 0;
+static uint32_t soakSeed = 12345;
+static bool sessionDue = false;
+
+static uint32_t soakRandom(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static void soakPreempt() {
+    if (!sessionDue) return;
+    sessionDue = false;
+    size_t slot = soakRandom(soakSeed) % SOAK_SESSION_SLOTS;
+    if (sessions[slot]) return;
+    sessions[slot] = heapAlloc(64 + soakRandom(soakSeed) % 1984);
+    sessionEnds[slot] = soakSecond + 3600 * (1 + soakRandom(soakSeed) % 6);
+}
+
+// --- Handler'lar: önceki hali ---
+
+struct LegacyStatusState {
+    bool playing;
+    int volume;
+    String track;
+    String title;
+    String artist;
+    String album;
+    uint32_t position;
+    uint32_t duration;
+};
+
+// ArduinoJson String'e 32 byte'lık parçalarla yazar
+static void legacySerialize(const char* json, size_t length, String& output) {
+    for (size_t i = 0; i < length; i += 31) {
+        char chunk[32];
+        size_t n = min((size_t)31, length - i);
+        memcpy(chunk, json + i, n);
+        chunk[n] = '\0';
+        output.concat(chunk);
+    }
+}
+
+static void legacyStatus(const LegacyStatusState& snapshot, const StatusFrame& frame) {
+    LegacyStatusState audio = snapshot;
+    void* doc = heapAlloc(768);
+    String output;
+    legacySerialize(frame.data, frame.length, output);
+    soakPreempt();
+    heapFree(doc);
+}
+
+static void legacyPlaylist(const LibraryIndex& index) {
+    String etag = PlaylistStream::makeEtag(index.getCardId(), index.getGeneration(), 0, PLAYLIST_DEFAULT_LIMIT, true);
+    for (size_t i = 0; i < index.size(); i++) {
+        String path = index.getPath(i);
+        char escaped[LIBRARY_MAX_PATH * 6 + 1];
+        PlaylistStream::escapeJson(path.c_str(), escaped, sizeof(escaped) - 1);
+        if (i == index.size() / 2) soakPreempt();
+    }
+}
+
+static void legacyPlay(const String& param, char* command) {
+    void* doc = heapAlloc(1024);
+    String file = param;
+    if (file.startsWith("/")) {
+        file = file.substring(1);
+    }
+    strlcpy(command, ("/" + file).c_str(), LIBRARY_MAX_PATH + 1);
+    soakPreempt();
+    heapFree(doc);
+}
+
+static void legacyWebSocket(const char* data) {
+    String message = data;
+    String command = "volume";
+    soakPreempt();
+    (void)message;
+    (void)command;
+}
+
+static void legacyTimers(size_t timers) {
+    void* doc = heapAlloc(256 + 16 * 160);
+    for (size_t i = 0; i < timers; i++) {
+        String stamp = DateTime(1700000000 + i * 3600).timestamp();
+        String next = DateTime(1700003600 + i * 3600).timestamp();
+        if (i == 0) soakPreempt();
+    }
+    heapFree(doc);
+}
+
+static bool legacyUploadChunk(const String& filename) {
+    String name = filename;
+    name.replace(" ", "_");
+    String ext = name.substring(name.lastIndexOf("."));
+    ext.toLowerCase();
+    String path = "/" + name;
+    soakPreempt();
+    return ext == ".mp3" && path.length() > 1;
+}
+
+// --- Handler'lar: şimdiki hali ---
+
+static void arenaStatus(const StatusFrame& frame) {
+    RequestArena::Scope scope(requestArena);
+    StatusState audio = statusSnapshot.getState();
+    requestArena.allocate(768);
+    soakPreempt();
+    (void)audio;
+    (void)frame;
+}
+
+static void arenaPlaylist(const LibraryIndex& index) {
+    String etag = PlaylistStream::makeEtag(index.getCardId(), index.getGeneration(), 0, PLAYLIST_DEFAULT_LIMIT, true);
+    PlaylistStream stream(index, 0, 0);
+    uint8_t buffer[1436];
+    while (stream.fill(buffer, sizeof(buffer)) > 0) {
+        soakPreempt();
+    }
+}
+
+static void arenaPlay(const String& param, char* command) {
+    RequestArena::Scope scope(requestArena);
+    requestArena.allocate(1024);
+    LibraryPath path;
+    if (LibraryIndex::makePath(param.c_str(), path)) {
+        strlcpy(command, path.c_str(), LIBRARY_MAX_PATH + 1);
+    }
+    soakPreempt();
+}
+
+static void arenaTimers(size_t timers) {
+    RequestArena::Scope scope(requestArena);
+    requestArena.allocate(256 + 16 * 160);
+    for (size_t i = 0; i < timers; i++) {
+        char stamp[20];
+        snprintf(stamp, sizeof(stamp), "%u", (unsigned)i);
+        if (i == 0) soakPreempt();
+    }
+}
+
+static bool arenaUploadChunk(const String& filename) {
+    LibraryPath path;
+    path.append('/').append(filename);
+    path.replace(' ', '_');
+    soakPreempt();
+    return path.endsWithIgnoreCase(".mp3");
+}
+
+// --- Senaryo ---
+
+struct SoakSample {
+    size_t largest;
+    size_t free;
+};
+
+struct SoakResult {
+    SoakSample samples[SOAK_DAYS * 24 / SOAK_SAMPLE_HOURS + 1];
+    size_t minLargest;
+    uint32_t allocations;
+    uint32_t failures;
+};
+
+static void runSoak(bool legacy, SoakResult& result) {
+    LibraryIndex index;
+    index.begin();
+    index.rescan();
+
+    StatusFrame frame = statusSnapshot.serialize();
+    LegacyStatusState legacyState = { true, 60, "/album_03/Sezen_Aksu_-_Gulumse.mp3", "Gülümse", "Sezen Aksu", "Gülümse", 42, 241 };
+    String playParam = "/album_01/track_017.mp3";
+    String uploadName = "Yeni Parca 01.mp3";
+    char command[LIBRARY_MAX_PATH + 1];
+
+    memset(sessions, 0, sizeof(sessions));
+    soakSeed = 12345;
+    sessionDue = false;
+    pendingNext = 0;
+    size_t uploads = 0;
+    size_t sample = 0;
+    size_t windowLargest = SIZE_MAX;
+
+    soakHeap.reset(SOAK_HEAP_SIZE);
+    result.minLargest = SIZE_MAX;
+    soakActive = true;
+
+    for (uint32_t second = 0; second < SOAK_DAYS * 86400u; second++) {
+        // Saatlerce yaşayan oturum blokları: 5 dk'da bir, sıradaki handler'ın
+        // ortasında ayrılır, 1-6 saat yaşar
+        for (size_t i = 0; i < SOAK_SESSION_SLOTS; i++) {
+            if (sessions[i] && second >= sessionEnds[i]) {
+                heapFree(sessions[i]);
+                sessions[i] = nullptr;
+            }
+        }
+        soakSecond = second;
+        if (second % 300 == 0) sessionDue = true;
+
+        // /api/status ve WebSocket delta'sı
+        beginRequest(11, 0, 1460);
+        if (legacy) legacyStatus(legacyState, frame); else arenaStatus(frame);
+        queueWebSocket(80 + soakRandom(soakSeed) % 120);
+        if (second % 7 == 0) {
+            const char* message = "{\"command\":\"volume\",\"value\":55}";
+            if (legacy) legacyWebSocket(message); else soakPreempt();
+        }
+
+        // Playlist: çoğunlukla 304, kütüphane değişince tam gövde
+        if (second % 5 == 0) {
+            beginRequest(40, 3, 0);
+            bool changed = second % 3600 == 5;
+            if (changed) {
+                if (legacy) legacyPlaylist(index); else arenaPlaylist(index);
+            } else {
+                String etag = PlaylistStream::makeEtag(index.getCardId(), index.getGeneration(), 0, PLAYLIST_DEFAULT_LIMIT, true);
+            }
+        }
+
+        if (second % 60 == 0) {
+            beginRequest(11, 0, 1460);
+            if (legacy) legacyTimers(6); else arenaTimers(6);
+        }
+
+        if (second % 900 == 0) {
+            beginRequest(9, 1, 0);
+            if (legacy) legacyPlay(playParam, command); else arenaPlay(playParam, command);
+        }
+
+        // Saatlik 4 MB upload: 1436 byte'lık her TCP parçasında handler çağrılır
+        if (second % 3600 == 1800) {
+            beginRequest(11, 0, 0);
+            for (size_t chunk = 0; chunk < 4 * 1024 * 1024 / 1436; chunk++) {
+                if (legacy) legacyUploadChunk(uploadName); else arenaUploadChunk(uploadName);
+            }
+            char name[48];
+            snprintf(name, sizeof(name), "/upload_%03u.mp3", (unsigned)(uploads++ % 40));
+            index.addFile(name);
+        }
+
+        // Dakikada bir, istekler arasında ölçülür; pencerenin en kötüsü raporlanır
+        if (second % 60 == 59) {
+            size_t largest = soakHeap.largestFree();
+            if (largest < windowLargest) windowLargest = largest;
+            if (largest < result.minLargest) result.minLargest = largest;
+        }
+        if ((second + 1) % (SOAK_SAMPLE_HOURS * 3600) == 0) {
+            result.samples[sample].largest = windowLargest;
+            result.samples[sample].free = soakHeap.freeBytes;
+            windowLargest = SIZE_MAX;
+            sample++;
+        }
+    }
+
+    result.allocations = soakHeap.allocations;
+    result.failures = soakHeap.failures;
+
+    for (size_t i = 0; i < SOAK_PENDING_REQUESTS; i++) releaseRequest(pending[i]);
+    for (size_t c = 0; c < SOAK_WS_CLIENTS; c++) {
+        if (wsBuffers[c]) heapFree(wsBuffers[c]);
+        wsBuffers[c] = nullptr;
+    }
+    for (size_t i = 0; i < SOAK_SESSION_SLOTS; i++) {
+        if (sessions[i]) heapFree(sessions[i]);
+    }
+    soakActive = false;
+}
+
+BENCH(heap_soak) {
+    BenchSdRoot sd("/tmp/musicbox_soak_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    for (size_t i = 0; i < SOAK_LIBRARY_TRACKS; i++) {
+        char name[64];
+        if (i % 30 == 0) {
+            snprintf(name, sizeof(name), "/album_%02u", (unsigned)(i / 30));
+            SD.mkdir(name);
+        }
+        snprintf(name, sizeof(name), "/album_%02u/track_%03u.mp3", (unsigned)(i / 30), (unsigned)i);
+        File f = SD.open(name, FILE_WRITE);
+        f.close();
+    }
+    for (size_t i = 0; i < 40; i++) {
+        char name[48];
+        snprintf(name, sizeof(name), "/upload_%03u.mp3", (unsigned)i);
+        File f = SD.open(name, FILE_WRITE);
+        f.close();
+    }
+    Preferences::nativeReset();
+    statusSnapshot.setTrack("/album_03/Sezen_Aksu_-_Gulumse.mp3");
+    statusSnapshot.setTrackTags("Gülümse", "Sezen Aksu", "Gülümse");
+
+    static SoakResult legacy;
+    static SoakResult arena;
+    runSoak(true, legacy);
+    runSoak(false, arena);
+
+    printf("  %-8s %14s %14s %14s %14s\n", "hour", "legacy max", "arena max", "legacy free", "arena free");
+    size_t samples = SOAK_DAYS * 24 / SOAK_SAMPLE_HOURS;
+    for (size_t i = 0; i < samples; i++) {
+        printf("  %-8u %14u %14u %14u %14u\n", (unsigned)((i + 1) * SOAK_SAMPLE_HOURS),
+               (unsigned)legacy.samples[i].largest, (unsigned)arena.samples[i].largest,
+               (unsigned)legacy.samples[i].free, (unsigned)arena.samples[i].free);
+    }
+    double hours = SOAK_DAYS * 24.0;
+    benchReport("legacy: min largest free block", legacy.minLargest, "bytes");
+    benchReport("arena: min largest free block", arena.minLargest, "bytes");
+    benchReport("legacy: heap allocations", legacy.allocations / hours, "/hour");
+    benchReport("arena: heap allocations", arena.allocations / hours, "/hour");
+    benchReport("legacy: failed allocations", legacy.failures, "");
+    benchReport("arena: failed allocations", arena.failures, "");
+    benchReport("request arena peak", requestArena.getPeak(), "bytes");
+    benchReport("request arena in use after soak", requestArena.getUsed(), "bytes");
+    benchReport("request arena failures", requestArena.getFailures(), "");
+}
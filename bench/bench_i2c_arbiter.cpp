@@ -0,0 +1,208 @@
+// DAC ve DS3231'in paylaştığı I2C bus'ı (env:native).
+//
+// Simüle saatte bir saatlik çalma: DAC her burst periyodunda 32 örneği
+// tek transaction'da yazar (400 kHz, MockI2CBus ile aynı hat süresi).
+// Bus tek hat olduğundan başka bir transaction sürerken gelen burst onun
+// bitmesini bekler; RTC trafiğinin burst'leri ne kadar geciktirdiği
+// ölçülür (DAC'ın kendi taşması hariç).
+//
+// i2c_bus_legacy: durum örneklemesi saniyede bir getDateTime(), dakikada
+// bir getTemperature(), arayüz 2 sn'de bir /api/status (saat + sıcaklık);
+// her çağrı geldiği anda bus'a çıkar.
+// i2c_bus_arbiter: I2cArbiter + RtcClock; web loop'u ~1 ms'de bir döner,
+// saat ve sıcaklık dakikada bir aynı slotta okunur. RTC millis()'e göre
+// +40 ppm sapar; verilen saniye her saniye referans RTC ile karşılaştırılır.
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <vector>
+#include <algorithm>
+#include "BenchRunner.h"
+#include "MockI2CBus.h"
+#include "I2cArbiter.h"
+#include "RtcClock.h"
+
+#define I2C_BENCH_CLOCK_HZ      400000
+#define I2C_BENCH_SECONDS       3600
+#define I2C_BENCH_RING_FILL     2048    // decoder'ın tuttuğu doluluk
+#define I2C_BENCH_DRIFT_PPM     40
+
+// start + (adres + veri) x 9 bit + stop, sürücü payı olmadan
+static uint64_t rawUs(size_t bytes) {
+    return (uint64_t)(2 + bytes * 9) * 1000000ULL / I2C_BENCH_CLOCK_HZ;
+}
+
+// Tek hatlı bus zaman çizelgesi ve DAC burst'leri
+struct BusTimeline {
+    uint64_t periodUs;
+    uint64_t burstUs;
+    uint64_t busFree = 0;
+    uint64_t prevBurstEnd = 0;
+    uint64_t k = 0;
+
+    uint32_t bursts = 0;
+    uint32_t delayed = 0;
+    uint64_t totalDelayUs = 0;
+    uint64_t maxDelayUs = 0;
+    uint32_t rtcTransactions = 0;
+
+    BusTimeline(uint32_t rate) :
+        periodUs((uint64_t)DAC_BURST_SAMPLES * 1000000ULL / rate),
+        burstUs(MockI2CBus(I2C_BENCH_CLOCK_HZ).transactionNs(DAC_BURST_SAMPLES) / 1000) {
+    }
+
+    uint64_t nextDue() const { return k * periodUs; }
+
+    // Burst'ün başlama anı
+    uint64_t burst() {
+        uint64_t due = nextDue();
+        uint64_t ready = std::max(due, prevBurstEnd);
+        uint64_t start = std::max(ready, busFree);
+        uint64_t delay = start - ready;
+        if (delay > 0) {
+            delayed++;
+            totalDelayUs += delay;
+            maxDelayUs = std::max(maxDelayUs, delay);
+        }
+        busFree = start + burstUs;
+        prevBurstEnd = busFree;
+        bursts++;
+        k++;
+        return start;
+    }
+
+    // t anında gelen RTC transaction'ı; bus meşgulse sırasını bekler
+    void rtc(uint64_t t, uint64_t costUs) {
+        busFree = std::max(t, busFree) + costUs;
+        rtcTransactions++;
+    }
+};
+
+static void reportTimeline(const char* label, const BusTimeline& bus) {
+    benchReport(label, bus.totalDelayUs / 1000.0, "ms DAC delay per hour");
+    benchReport("  bursts delayed by RTC traffic", bus.delayed, "");
+    benchReport("  max burst delay", bus.maxDelayUs, "us");
+    benchReport("  RTC transactions per hour", bus.rtcTransactions, "");
+}
+
+struct LegacyRead {
+    uint64_t at;
+    bool temperature;
+};
+
+static void runLegacy(uint32_t rate) {
+    BusTimeline bus(rate);
+    std::vector<LegacyRead> reads;
+    srand(11);
+    for (uint64_t s = 0; s < I2C_BENCH_SECONDS; s++) {
+        uint64_t base = s * 1000000ULL;
+        reads.push_back({ base + rand() % 1000, false });
+        if (s % 60 == 0) reads.push_back({ base + 300 + rand() % 1000, true });
+        if (s % 2 == 0) {
+            uint64_t poll = base + 500000 + rand() % 100000;
+            reads.push_back({ poll, false });
+            reads.push_back({ poll + 40, true });
+        }
+    }
+    std::sort(reads.begin(), reads.end(), [](const LegacyRead& a, const LegacyRead& b) { return a.at < b.at; });
+
+    const uint64_t end = (uint64_t)I2C_BENCH_SECONDS * 1000000ULL;
+    size_t next = 0;
+    while (bus.nextDue() < end) {
+        uint64_t due = bus.nextDue();
+        while (next < reads.size() && reads[next].at < due) {
+            // Adres yaz + oku: saat 7 byte, sıcaklık 2 byte
+            const LegacyRead& read = reads[next++];
+            bus.rtc(read.at, rawUs(2));
+            bus.rtc(bus.busFree, rawUs(read.temperature ? 3 : 8));
+        }
+        bus.burst();
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "%u Hz, read on request", (unsigned)rate);
+    reportTimeline(label, bus);
+}
+
+BENCH(i2c_bus_legacy) {
+    runLegacy(8000);
+    runLegacy(16000);
+    runLegacy(20000);
+}
+
+static void runArbiter(uint32_t rate) {
+    BusTimeline bus(rate);
+    I2cArbiter arbiter;
+    RtcClock clock;
+    RTC_DS3231 rtc;
+    RTC_DS3231 reference;
+
+    nativeSetMicros(0);
+    arbiter.begin(I2C_BENCH_CLOCK_HZ);
+    rtc.begin();
+    reference.begin();
+    rtc.nativeSetDriftPpm(I2C_BENCH_DRIFT_PPM);
+    reference.nativeSetDriftPpm(I2C_BENCH_DRIFT_PPM);
+    clock.begin(&rtc, &arbiter);
+
+    // Toplu okuma: saat (2 + 8 byte) ve sıcaklık (2 + 3 byte)
+    const uint64_t batchUs = rawUs(2) + rawUs(8) + rawUs(2) + rawUs(3);
+    const uint64_t end = (uint64_t)I2C_BENCH_SECONDS * 1000000ULL;
+    uint64_t tick = 0;
+    uint64_t nextCheck = 1000000;
+    uint32_t wrongSeconds = 0;
+    uint32_t backwards = 0;
+    uint32_t lastServed = 0;
+    srand(13);
+
+    while (bus.nextDue() < end) {
+        uint64_t due = bus.nextDue();
+        while (tick < due) {
+            // Bus'ı tutan bir transaction sürerken mutex alınamaz
+            if (tick >= bus.busFree) {
+                nativeSetMicros(tick);
+                uint32_t before = arbiter.getStats(I2C_DEVICE_RTC).transactions;
+                clock.loop();
+                if (arbiter.getStats(I2C_DEVICE_RTC).transactions != before) {
+                    bus.rtc(tick, batchUs);
+                    bus.rtcTransactions += 3;
+                }
+            }
+            if (tick >= nextCheck) {
+                nativeSetMicros(tick);
+                uint32_t served = clock.unixtime();
+                if (served != reference.now().unixtime()) wrongSeconds++;
+                if (served < lastServed) backwards++;
+                lastServed = served;
+                nextCheck += 1000000;
+            }
+            tick += 900 + rand() % 200;
+        }
+        uint64_t start = bus.burst();
+        nativeSetMicros(start);
+        arbiter.beginBurst();
+        nativeSetMicros(start + bus.burstUs);
+        arbiter.endBurst(I2C_BENCH_RING_FILL, rate);
+    }
+    nativeUseRealClock();
+
+    const I2cDeviceStats& stats = arbiter.getStats(I2C_DEVICE_RTC);
+    const RtcClockStats& clockStats = clock.getStats();
+    char label[64];
+    snprintf(label, sizeof(label), "%u Hz, arbiter + RTC clock", (unsigned)rate);
+    reportTimeline(label, bus);
+    benchReport("  RTC batches", stats.transactions, "");
+    benchReport("  mean wait for slot", stats.transactions ? stats.totalWaitUs / 1000.0 / stats.transactions : 0, "ms");
+    benchReport("  deferred to a later slot", stats.deferred, "");
+    benchReport("  forced", stats.forced, "");
+    benchReport("  clock corrections", clockStats.corrections, "");
+    benchReport("  max correction", clockStats.maxErrorMs, "ms");
+    benchReport("  seconds off vs RTC", wrongSeconds, "");
+    benchReport("  backwards steps", backwards, "");
+}
+
+BENCH(i2c_bus_arbiter) {
+    runArbiter(8000);
+    runArbiter(16000);
+    runArbiter(20000);
+}
@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include "BenchRunner.h"
+
+std::vector<BenchCase>& benchRegistry() {
+    static std::vector<BenchCase> registry;
+    return registry;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    std::vector<BenchCase> cases = benchRegistry();
+    std::sort(cases.begin(), cases.end(), [](const BenchCase& a, const BenchCase& b) {
+        return strcmp(a.name, b.name) < 0;
+    });
+
+    // Modüllerin Serial log'ları ölçüm çıktısına karışmasın
+    Serial.setQuiet(true);
+
+    int ran = 0;
+    for (const auto& c : cases) {
+        if (filter && !strstr(c.name, filter)) continue;
+        printf("[%s]\n", c.name);
+        c.fn();
+        printf("\n");
+        ran++;
+    }
+
+    if (ran == 0) {
+        printf("No benchmark matches '%s'. Available:\n", filter ? filter : "");
+        for (const auto& c : cases) printf("  %s\n", c.name);
+        return 1;
+    }
+    return 0;
+}
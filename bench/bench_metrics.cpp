@@ -0,0 +1,172 @@
+// Metrikler (env:native).
+//
+// metrics_record: LatencyHistogram::record() maliyeti, mutex korumalı
+// sayaç/toplam/max (tipik "istatistik struct'ı + kilit") ile karşılaştırma.
+// Tek task ve 4 iş parçacığının aynı histograma yazdığı durum; ses yolunda
+// DAC writer'ın saniyelik ses başına kayıt maliyeti.
+//
+// metrics_export: 30 route'lu kayıtla /api/metrics gövdesi. Küçük chunk
+// tamponuyla (async_tcp'nin verdiği gibi) ve tek büyük tamponla üretilen
+// metinler karşılaştırılır; her histogramın kümülatif kovalarının monoton
+// olduğu ve +Inf kovasının _count'a eşit olduğu doğrulanır.
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchRunner.h"
+#include "DacOutputStage.h"
+#include "Metrics.h"
+
+#define METRICS_BENCH_THREADS   4
+#define METRICS_BENCH_RECORDS   2000000
+#define METRICS_BENCH_ROUTES    30
+
+struct LockedStats {
+    std::mutex mutex;
+    uint32_t count = 0;
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+
+    void record(uint32_t us) {
+        std::lock_guard<std::mutex> guard(mutex);
+        count++;
+        totalUs += us;
+        if (us > maxUs) maxUs = us;
+    }
+};
+
+template <typename Fn>
+static double contendedNs(Fn record) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < METRICS_BENCH_THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = 0; i < METRICS_BENCH_RECORDS / METRICS_BENCH_THREADS; i++) {
+                record((i * 2654435761u + t) & 0xFFFFF);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           METRICS_BENCH_RECORDS;
+}
+
+BENCH(metrics_record) {
+    LatencyHistogram histogram;
+    LockedStats locked;
+
+    double histogramNs = benchMeasureNs(METRICS_BENCH_RECORDS, [&](size_t i) {
+        histogram.record((uint32_t)(i * 2654435761u) & 0xFFFFF);
+    });
+    double lockedNs = benchMeasureNs(METRICS_BENCH_RECORDS, [&](size_t i) {
+        locked.record((uint32_t)(i * 2654435761u) & 0xFFFFF);
+    });
+    benchReport("mutex + count/sum/max, 1 thread", lockedNs, "ns/record");
+    benchReport("histogram (atomic), 1 thread", histogramNs, "ns/record");
+
+    LatencyHistogram shared;
+    LockedStats sharedLocked;
+    double lockedContended = contendedNs([&](uint32_t us) { sharedLocked.record(us); });
+    double histogramContended = contendedNs([&](uint32_t us) { shared.record(us); });
+    benchReport("mutex + count/sum/max, 4 threads", lockedContended, "ns/record");
+    benchReport("histogram (atomic), 4 threads", histogramContended, "ns/record");
+    benchReport("  records lost", (double)METRICS_BENCH_RECORDS - shared.count(), "");
+
+    // DAC writer her burst'te bir kayıt yapar (I2cArbiter::release)
+    double burstsPerSecond = 1e6 / DacOutputStage::burstPeriodUs(44100);
+    benchReport("DAC path cost per second of 44.1 kHz", histogramNs * burstsPerSecond / 1000.0, "us");
+}
+
+static std::string render(const Metrics& m, size_t chunk, size_t* chunks) {
+    MetricsStream stream(m);
+    std::string out;
+    std::vector<uint8_t> buffer(chunk);
+    size_t n;
+    *chunks = 0;
+    while ((n = stream.fill(buffer.data(), buffer.size())) > 0) {
+        out.append((const char*)buffer.data(), n);
+        (*chunks)++;
+    }
+    return out;
+}
+
+// Her histogram için: kovalar monoton, +Inf == _count; hatalı serilerin sayısı
+static uint32_t validate(const std::string& text, uint32_t* histograms) {
+    uint32_t errors = 0;
+    unsigned long previous = 0;
+    unsigned long inf = 0;
+    bool inHistogram = false;
+    *histograms = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) {
+            errors++;
+            break;
+        }
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.compare(0, 1, "#") == 0) continue;
+        size_t space = line.rfind(' ');
+        unsigned long value = strtoul(line.c_str() + space + 1, nullptr, 10);
+        if (line.find("_bucket{") != std::string::npos) {
+            if (!inHistogram) {
+                inHistogram = true;
+                previous = 0;
+            }
+            if (value < previous) errors++;
+            previous = value;
+            if (line.find("le=\"+Inf\"") != std::string::npos) inf = value;
+        } else if (line.find("_count") != std::string::npos && inHistogram) {
+            if (value != inf) errors++;
+            inHistogram = false;
+            (*histograms)++;
+        }
+    }
+    return errors;
+}
+
+BENCH(metrics_export) {
+    static Metrics m;
+    static DacOutputStage dac;
+    static char names[METRICS_BENCH_ROUTES][32];
+    m.attachDac(&dac);
+    srand(17);
+    for (int i = 0; i < METRICS_BENCH_ROUTES; i++) {
+        snprintf(names[i], sizeof(names[i]), "/api/route%d", i);
+        HttpRouteMetrics* route = m.route(names[i], i % 2 ? "POST" : "GET");
+        for (int r = 0; r < 500; r++) route->latency.record(50 + rand() % 20000);
+    }
+    for (int r = 0; r < 100000; r++) {
+        m.i2c[I2C_DEVICE_DAC].record(1400 + rand() % 200);
+        m.sdRead.record(800 + rand() % 40000);
+    }
+    for (int r = 0; r < 60; r++) m.i2c[I2C_DEVICE_RTC].record(300 + rand() % 100);
+
+    size_t bigChunks = 0, smallChunks = 0;
+    std::string whole = render(m, 1 << 20, &bigChunks);
+    std::string chunked = render(m, 536, &smallChunks);
+    uint32_t histograms = 0;
+    uint32_t errors = validate(chunked, &histograms);
+
+    double renderUs = benchMeasureNs(20, [&](size_t) {
+        size_t chunks;
+        render(m, 1436, &chunks);
+    }) / 1000.0;
+
+    benchReport("body size", whole.size(), "bytes");
+    benchReport("render time (1436-byte chunks)", renderUs, "us");
+    benchReport("chunks at 536 bytes", smallChunks, "");
+    benchReport("stream state (heap per request)", sizeof(MetricsStream), "bytes");
+    benchReport("chunked == one-shot", chunked == whole ? 1 : 0, "");
+    benchReport("histograms", histograms, "");
+    benchReport("invalid histograms", errors, "");
+
+    char summary[METRICS_SUMMARY_SIZE];
+    size_t length = m.writeSummary(summary, sizeof(summary));
+    benchReport("MQTT summary", length, "bytes");
+    printf("  %s\n", summary);
+}
@@ -0,0 +1,254 @@
+// MQTT giden kuyruğu ve yeniden bağlanma (env:native).
+//
+// mqtt_outbox_traffic: bir saatlik çalma 10 ms'lik loop adımlarıyla
+// oynatılır (saniyede konum ve saat, dakikada sıcaklık ve metrik özeti,
+// 3.5 dakikada bir parça geçişi, 5 dakikada bir 20 adımlı ses sürgüsü,
+// 10 dakikada bir 5 sn duraklatma). 20. dakikada broker 10 dakika kapanır.
+// Broker yerine bir Mosquitto modeli PUBLISH paketlerini MQTT 3.1.1
+// çerçevesiyle (sabit başlık + kalan uzunluk + konu + yük, QoS 0) sayar ve
+// retained konuları saklar.
+// Eski yol: sürüm her değiştiğinde tam durum JSON'u musicbox/status'a,
+// kopunca 5 sn'de bir yeniden bağlanma. Yeni yol: MqttOutbox + MqttBackoff.
+// Sonda broker'daki retained alan değerleri snapshot'la karşılaştırılır.
+//
+// mqtt_backoff_fleet: aynı broker'a bağlı 50 cihaz aynı anda koptuğunda
+// (broker yeniden başlatıldı, 2 dakika kapalı) saniye başına en fazla
+// bağlantı denemesi (toplam ve broker döndükten sonra).
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "BenchRunner.h"
+#include "MqttOutbox.h"
+#include "Metrics.h"
+
+#define LEGACY_RECONNECT_MS     5000
+
+struct BrokerModel {
+    bool up = true;
+    uint32_t publishes = 0;
+    uint64_t bytes = 0;
+    uint32_t connects = 0;
+    std::map<std::string, std::string> retained;
+
+    static size_t varintSize(size_t n) {
+        size_t size = 1;
+        while (n >= 128) {
+            n /= 128;
+            size++;
+        }
+        return size;
+    }
+
+    bool publish(const char* topic, const char* payload, size_t length, bool retain) {
+        if (!up) return false;
+        size_t remaining = 2 + strlen(topic) + length;
+        publishes++;
+        bytes += 1 + varintSize(remaining) + remaining;
+        if (retain) retained[topic] = std::string(payload, length);
+        return true;
+    }
+};
+
+static bool brokerPublish(void* context, const char* topic, const char* payload, size_t length, bool retain) {
+    return ((BrokerModel*)context)->publish(topic, payload, length, retain);
+}
+
+struct TrafficResult {
+    uint32_t publishes;
+    uint64_t bytes;
+    uint32_t attempts;
+    uint32_t reconnectMs;
+};
+
+// Durum değişikliklerini zaman çizelgesine göre uygular
+static void driveStatus(StatusSnapshot& snapshot, uint64_t ms, uint32_t& seed) {
+    static const char* const tracks[] = {
+        "/Muzikler/Uzun_Bir_Sarki_Adi_2024.mp3", "/Caz/Gece Yarisi Oturumu - Canli.mp3",
+        "/Klasik/Senfoni No 5 - Birinci Bolum.wav", "/Pop/Yaz Sarkisi (Radyo Versiyonu).m4a",
+    };
+    uint64_t second = ms / 1000;
+    bool secondTick = ms % 1000 == 0;
+
+    if (ms % 210000 == 0) {
+        const char* track = tracks[(ms / 210000) % 4];
+        snapshot.setTrack(track);
+        snapshot.setTrackTags("Bir Parca Basligi", "Sanatci Adi", "Albumun Adi");
+        snapshot.setDuration(210);
+        snapshot.setPosition(0);
+    }
+    bool paused = (second % 600) >= 300 && (second % 600) < 305;
+    snapshot.setPlaying(!paused);
+    if (secondTick && !paused) {
+        snapshot.setPosition((uint32_t)(second % 210));
+    }
+    if (secondTick) {
+        snapshot.setTime(DateTime(2026, 10, 17, (uint8_t)(second / 3600 % 24), (uint8_t)(second / 60 % 60), (uint8_t)(second % 60)));
+    }
+    if (ms % 60000 == 0) {
+        seed = seed * 1664525u + 1013904223u;
+        snapshot.setTemperature(24.0f + (float)((seed >> 28) % 3) * 0.25f);
+    }
+    // 5 dakikada bir sürgü: 400 ms'de 20 adım
+    uint64_t slider = ms % 300000;
+    if (slider >= 150000 && slider < 150400 && ms % 20 == 0) {
+        snapshot.setVolume(40 + (int)((slider - 150000) / 20));
+    }
+}
+
+static TrafficResult runTraffic(bool legacy, BrokerModel& broker, StatusSnapshot& snapshot, MqttOutboxStats* stats) {
+    const uint64_t hourMs = 3600 * 1000ULL;
+    const uint64_t outageStart = 20 * 60 * 1000ULL;
+    const uint64_t outageEnd = 30 * 60 * 1000ULL;
+    const char metricsPayload[] = "{\"heap\":{\"free\":204800,\"min\":184320,\"largest\":112640},"
+        "\"dac\":{\"fill\":3072,\"underruns\":0},\"prefetch\":{\"fill\":49152,\"underruns\":0},\"ws\":1,"
+        "\"us\":{\"i2c_dac\":{\"n\":100000,\"p50\":2048,\"p99\":2048},\"sd_read\":{\"n\":3000,\"p50\":4096,\"p99\":16384},"
+        "\"http\":{\"n\":150,\"p50\":16384,\"p99\":32768}},\"cpu\":{}}";
+
+    MqttOutbox outbox;
+    MqttBackoff backoff;
+    outbox.attach(brokerPublish, &broker);
+
+    bool connected = true;
+    uint32_t lastVersion = UINT32_MAX;
+    uint64_t lastAttempt = 0;
+    uint32_t seed = 1;
+    TrafficResult result = { 0, 0, 0, 0 };
+    bool waitingReconnect = false;
+
+    for (uint64_t ms = 0; ms < hourMs; ms += 10) {
+        nativeSetMicros(ms * 1000);
+        broker.up = ms < outageStart || ms >= outageEnd;
+        if (connected && !broker.up) {
+            connected = false;
+            waitingReconnect = true;
+            backoff.disconnected((unsigned long)ms);
+        }
+
+        driveStatus(snapshot, ms, seed);
+
+        // Yeniden bağlanma (bağlantı async; sonuç bu adımda belli)
+        if (!connected) {
+            bool attempt = legacy ? ms - lastAttempt >= LEGACY_RECONNECT_MS : backoff.ready((unsigned long)ms);
+            if (attempt) {
+                result.attempts++;
+                lastAttempt = ms;
+                if (!legacy) backoff.attempted((unsigned long)ms);
+                if (broker.up) {
+                    connected = true;
+                    broker.connects++;
+                    if (!legacy) {
+                        backoff.succeeded();
+                        outbox.resendStatus();
+                    }
+                    if (waitingReconnect) {
+                        result.reconnectMs = (uint32_t)(ms - outageEnd);
+                        waitingReconnect = false;
+                    }
+                }
+            }
+        }
+
+        bool metricsTick = ms % METRICS_MQTT_INTERVAL_MS == 0;
+        if (legacy) {
+            if (connected && snapshot.getVersion() != lastVersion) {
+                StatusFrame frame = snapshot.serialize();
+                broker.publish("musicbox/status", frame.data, frame.length, false);
+                lastVersion = frame.version;
+            }
+            if (connected && metricsTick) {
+                broker.publish(METRICS_MQTT_TOPIC, metricsPayload, strlen(metricsPayload), false);
+            }
+        } else {
+            outbox.postStatus(snapshot, (unsigned long)ms);
+            if (metricsTick) {
+                outbox.post(METRICS_MQTT_TOPIC, metricsPayload, false, (unsigned long)ms);
+            }
+            outbox.loop((unsigned long)ms, connected);
+        }
+    }
+
+    result.publishes = broker.publishes;
+    result.bytes = broker.bytes;
+    if (stats) *stats = outbox.getStats();
+    return result;
+}
+
+BENCH(mqtt_outbox_traffic) {
+    BrokerModel legacyBroker, outboxBroker;
+    StatusSnapshot legacySnapshot, outboxSnapshot;
+    MqttOutboxStats stats;
+    TrafficResult legacy = runTraffic(true, legacyBroker, legacySnapshot, nullptr);
+    TrafficResult outbox = runTraffic(false, outboxBroker, outboxSnapshot, &stats);
+    nativeUseRealClock();
+
+    printf("  1 h, broker down 10 min\n");
+    printf("  %-8s %14s %14s %16s %12s\n", "path", "publishes/min", "broker KB/h", "outage attempts", "reconnect s");
+    printf("  %-8s %14.1f %14.1f %16u %12.1f\n", "legacy", legacy.publishes / 60.0, legacy.bytes / 1024.0,
+           (unsigned)legacy.attempts, legacy.reconnectMs / 1000.0);
+    printf("  %-8s %14.1f %14.1f %16u %12.1f\n", "outbox", outbox.publishes / 60.0, outbox.bytes / 1024.0,
+           (unsigned)outbox.attempts, outbox.reconnectMs / 1000.0);
+    benchReport("outbox coalesced", stats.coalesced, "");
+    benchReport("outbox unchanged suppressed", stats.unchanged, "");
+    benchReport("outbox dropped", stats.dropped, "");
+    benchReport("outbox flushes", stats.flushes, "");
+
+    // Broker'daki retained alan değerleri son durumla aynı mı
+    size_t fields = 0, matches = 0;
+    char value[MQTT_OUTBOX_PAYLOAD_MAX];
+    for (uint8_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        uint32_t field = 1UL << i;
+        std::string topic = std::string(MQTT_STATUS_TOPIC_PREFIX) + StatusSnapshot::fieldName(field);
+        size_t length = outboxSnapshot.serializeField(field, value, sizeof(value));
+        fields++;
+        auto it = outboxBroker.retained.find(topic);
+        if (it == outboxBroker.retained.end()) continue;
+        // Yavaş alanlar en fazla bir aralık geride olabilir
+        if (it->second == std::string(value, length) || (field & MQTT_STATUS_SLOW_FIELDS)) matches++;
+    }
+    benchReport("retained fields matching final state", matches, fields == matches ? "(all)" : "(MISMATCH)");
+}
+
+BENCH(mqtt_backoff_fleet) {
+    const int devices = 50;
+    const uint64_t downMs = 120000;
+    const uint64_t horizonMs = 300000;
+
+    for (int legacy = 1; legacy >= 0; legacy--) {
+        std::vector<MqttBackoff> backoffs(devices);
+        std::vector<uint64_t> lastAttempt(devices, 0);
+        std::vector<bool> connected(devices, false);
+        std::vector<uint32_t> perSecond(horizonMs / 1000, 0);
+        for (MqttBackoff& backoff : backoffs) backoff.disconnected(0);
+        uint32_t attempts = 0;
+        uint64_t lastConnected = 0;
+
+        for (uint64_t ms = 0; ms < horizonMs; ms += 10) {
+            bool up = ms >= downMs;
+            for (int d = 0; d < devices; d++) {
+                if (connected[d]) continue;
+                bool attempt = legacy ? ms - lastAttempt[d] >= LEGACY_RECONNECT_MS || ms == 0
+                                      : backoffs[d].ready((unsigned long)ms);
+                if (!attempt) continue;
+                attempts++;
+                perSecond[ms / 1000]++;
+                lastAttempt[d] = ms;
+                if (!legacy) backoffs[d].attempted((unsigned long)ms);
+                if (up) {
+                    connected[d] = true;
+                    lastConnected = ms;
+                }
+            }
+        }
+        uint32_t peak = 0, peakAfter = 0;
+        for (size_t s = 0; s < perSecond.size(); s++) {
+            peak = perSecond[s] > peak ? perSecond[s] : peak;
+            if (s >= downMs / 1000) peakAfter = perSecond[s] > peakAfter ? perSecond[s] : peakAfter;
+        }
+        printf("  %-8s attempts %5u, peak %3u/s, peak after broker up %3u/s, all back %.1f s after broker\n",
+               legacy ? "legacy" : "backoff", (unsigned)attempts, (unsigned)peak, (unsigned)peakAfter,
+               (lastConnected - downMs) / 1000.0);
+    }
+}
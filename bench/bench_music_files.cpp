@@ -0,0 +1,128 @@
+// Müzik listesi çıkarma (env:native).
+//
+// get_music_files: eski yol, her istekte SD kök dizinini dolaşıp uzantıya
+// göre süzülmüş bir std::vector<String> kurar.
+// library_index: LibraryIndex'in tam tarama, açılışta yükleme ve
+// bellekten listeleme maliyetleri.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "LibraryIndex.h"
+
+static bool isMusicFile(const String& name) {
+    String lower = name;
+    lower.toLowerCase();
+    return lower.endsWith(".mp3") || lower.endsWith(".m4a") ||
+           lower.endsWith(".aac") || lower.endsWith(".wav");
+}
+
+static std::vector<String> getMusicFiles() {
+    std::vector<String> files;
+    File root = SD.open("/");
+    File file = root.openNextFile();
+    while (file) {
+        if (!file.isDirectory() && isMusicFile(file.name())) {
+            files.push_back("/" + String(file.name()));
+        }
+        file = root.openNextFile();
+    }
+    return files;
+}
+
+static void populate(size_t count) {
+    static const char* exts[] = { ".mp3", ".m4a", ".wav", ".aac", ".txt" };
+    for (size_t i = 0; i < count; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/track_%05u%s", (unsigned)i, exts[i % 5]);
+        File f = SD.open(name, FILE_WRITE);
+        f.write((const uint8_t*)"ID3", 3);
+        f.close();
+    }
+}
+
+BENCH(get_music_files) {
+    const size_t sizes[] = { 100, 1000, 5000 };
+
+    for (size_t count : sizes) {
+        BenchSdRoot sd("/tmp/musicbox_sd_XXXXXX");
+        if (!sd.ok()) {
+            return;
+        }
+        populate(count);
+
+        size_t found = 0;
+        double ns = benchMeasureNs(5, [&](size_t) {
+            std::vector<String> files = getMusicFiles();
+            found = files.size();
+        });
+
+        char label[64];
+        snprintf(label, sizeof(label), "%u entries (%u music)", (unsigned)count, (unsigned)found);
+        benchReport(label, ns / 1e6, "ms/call");
+    }
+}
+
+BENCH(library_index) {
+    const size_t sizes[] = { 100, 1000, 5000 };
+
+    for (size_t count : sizes) {
+        BenchSdRoot sd("/tmp/musicbox_sd_XXXXXX");
+        if (!sd.ok()) {
+            return;
+        }
+        populate(count);
+        Preferences::nativeReset();
+
+        printf("  %u entries\n", (unsigned)count);
+
+        double scan = benchMeasureNs(3, [&](size_t) { libraryIndex.rescan(); });
+        benchReport("full rescan + save", scan / 1e6, "ms");
+
+        double load = benchMeasureNs(5, [&](size_t) { libraryIndex.begin(); });
+        benchReport("boot load (signature match)", load / 1e6, "ms");
+
+        size_t tracks = libraryIndex.size();
+        double list = benchMeasureNs(20, [&](size_t) {
+            size_t bytes = 0;
+            for (size_t i = 0; i < tracks; i++) {
+                bytes += libraryIndex.getPath(i).length();
+            }
+            benchKeep(bytes);
+        });
+        benchReport("list all paths from memory", list / 1e6, "ms");
+
+        double upload = benchMeasureNs(20, [&](size_t i) {
+            char name[64];
+            snprintf(name, sizeof(name), "/new_%03u.mp3", (unsigned)(i % 10));
+            File f = SD.open(name, FILE_WRITE);
+            f.write((const uint8_t*)"ID3", 3);
+            f.close();
+            libraryIndex.addFile(name);
+        });
+        benchReport("incremental add after upload", upload / 1e6, "ms");
+
+        // Yarım upload kartın doluluğunu değiştirir; açılışta tarama gerekmez
+        SD.mkdir("/.uploads");
+        File part = SD.open("/.uploads/0000abcd.part", FILE_WRITE);
+        part.write((const uint8_t*)"ID3", 3);
+        part.close();
+        uint32_t before = libraryIndex.getGeneration();
+        libraryIndex.begin();
+        benchReport("rescan at boot after .part write", libraryIndex.getGeneration() != before ? 1 : 0, "");
+
+        // Kart PC'de değiştirildi: indekse girmemiş yeni dosya taranmalı
+        File added = SD.open("/pc_copy.mp3", FILE_WRITE);
+        added.write((const uint8_t*)"ID3", 3);
+        added.close();
+        before = libraryIndex.getGeneration();
+        libraryIndex.begin();
+        benchReport("rescan at boot after file added elsewhere",
+            libraryIndex.getGeneration() != before && libraryIndex.contains("/pc_copy.mp3") ? 1 : 0, "");
+        libraryIndex.queueRescan();
+        before = libraryIndex.getGeneration();
+        libraryIndex.loop();
+        benchReport("queued rescan applied", libraryIndex.getGeneration() != before ? 1 : 0, "");
+    }
+}
@@ -0,0 +1,263 @@
+// Akış halinde OTA (env:native).
+//
+// 1.5 MB'lık sahte ESP32 imajı ham, gzip ve heatshrink olarak gönderilir.
+// Eski yol Update.write'ı async_tcp callback'inde çağırıyordu; her yeni
+// sektörün silinmesi (~25 ms) o callback'i ve dolayısıyla tüm web
+// sunucusunu bekletir. OtaUpdater'da callback sadece kopyalar; çözme, özet
+// ve flash OTA task'ında yapılır. Her senaryoda yazılan imaj ve boot
+// edilebilirlik doğrulanır; bozuk özetle gönderilen imaj reddedilmelidir.
+
+#include <Arduino.h>
+#include <zlib.h>
+#include <stdlib.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "OtaUpdater.h"
+
+#define OTA_BENCH_SIZE          (1536 * 1024)
+#define OTA_BENCH_MSS           1436
+#define OTA_BENCH_SECTOR_US     25000   // 4 KB silme + programlama
+
+// Firmware'e benzer: tekrar eden kod kalıpları, tablolar ve sıfır dolgular
+static std::vector<uint8_t> makeImage() {
+    std::vector<uint8_t> image(OTA_BENCH_SIZE);
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < image.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        if ((i / 4096) % 5 == 4) {
+            image[i] = 0;
+        } else if ((seed >> 16) % 4 == 0) {
+            image[i] = (uint8_t)(seed >> 24);
+        } else {
+            image[i] = (uint8_t)(i % 61) ^ (uint8_t)((i / 256) % 7);
+        }
+    }
+    image[0] = 0xE9;
+    return image;
+}
+
+static std::string hexDigest(const std::vector<uint8_t>& data) {
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts_ret(&ctx, 0);
+    mbedtls_sha256_update_ret(&ctx, data.data(), data.size());
+    uint8_t digest[32];
+    mbedtls_sha256_finish_ret(&ctx, digest);
+    char hex[65];
+    for (int i = 0; i < 32; i++) snprintf(hex + i * 2, 3, "%02x", digest[i]);
+    return std::string(hex);
+}
+
+static std::vector<uint8_t> gzipImage(const std::vector<uint8_t>& image) {
+    z_stream stream = {};
+    deflateInit2(&stream, 9, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    std::vector<uint8_t> out(deflateBound(&stream, image.size()));
+    stream.next_in = (Bytef*)image.data();
+    stream.avail_in = image.size();
+    stream.next_out = out.data();
+    stream.avail_out = out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+// heatshrink biçiminde açgözlü LZSS kodlayıcı (sadece bench için)
+class BitWriter {
+private:
+    std::vector<uint8_t>& out;
+    uint8_t current = 0;
+    uint8_t count = 0;
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void put(uint32_t value, uint8_t bits) {
+        while (bits--) {
+            current = (current << 1) | ((value >> bits) & 1);
+            if (++count == 8) {
+                out.push_back(current);
+                current = 0;
+                count = 0;
+            }
+        }
+    }
+
+    void flush() {
+        if (count) out.push_back(current << (8 - count));
+    }
+};
+
+static std::vector<uint8_t> heatshrinkImage(const std::vector<uint8_t>& image, uint8_t windowBits,
+    uint8_t lookaheadBits) {
+    std::vector<uint8_t> out;
+    BitWriter bits(out);
+    const size_t window = (size_t)1 << windowBits;
+    const size_t maxLength = (size_t)1 << lookaheadBits;
+    // 3 byte'lık hash zinciri; her konumda en fazla 64 aday denenir
+    std::vector<int32_t> head(1 << 16, -1);
+    std::vector<int32_t> prev(image.size(), -1);
+    auto hash3 = [&](size_t p) {
+        return ((image[p] << 8) ^ (image[p + 1] << 4) ^ image[p + 2]) & 0xFFFF;
+    };
+    auto insert = [&](size_t p) {
+        if (p + 2 < image.size()) {
+            uint32_t h = hash3(p);
+            prev[p] = head[h];
+            head[h] = (int32_t)p;
+        }
+    };
+    size_t i = 0;
+    while (i < image.size()) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+        size_t limit = min(maxLength, image.size() - i);
+        int32_t candidate = i + 2 < image.size() ? head[hash3(i)] : -1;
+        for (int steps = 0; candidate >= 0 && i - candidate <= window && steps < 64; steps++) {
+            size_t length = 0;
+            while (length < limit && image[i + length] == image[candidate + length]) length++;
+            if (length > bestLength) {
+                bestLength = length;
+                bestDistance = i - candidate;
+                if (length == limit) break;
+            }
+            candidate = prev[candidate];
+        }
+        // Geri referans 1 + windowBits + lookaheadBits bit tutar
+        if (bestLength * 9 > 1u + windowBits + lookaheadBits) {
+            bits.put(0, 1);
+            bits.put(bestDistance - 1, windowBits);
+            bits.put(bestLength - 1, lookaheadBits);
+            for (size_t n = 0; n < bestLength; n++) insert(i++);
+        } else {
+            bits.put(1, 1);
+            bits.put(image[i], 8);
+            insert(i++);
+        }
+    }
+    bits.flush();
+    return out;
+}
+
+// Flash süresi simüle saatte; callback ve OTA task'ındaki işlem süresi
+// host'ta gerçek zamanla ölçülür
+struct OtaRun {
+    bool ok;
+    double callbackMs;
+    double maxCallbackMs;
+    double taskMs;
+    OtaStats stats;
+};
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static OtaRun sendImage(const std::vector<uint8_t>& payload, const std::string& sha, OtaCompression compression,
+    uint8_t windowBits = OTA_HEATSHRINK_WINDOW, uint8_t lookaheadBits = OTA_HEATSHRINK_LOOKAHEAD) {
+    OtaRun run = {};
+    Update.nativeSetSectorLatency(OTA_BENCH_SECTOR_US);
+    run.ok = otaUpdater.start(String(sha.c_str()), compression, payload.size(), nullptr, windowBits, lookaheadBits);
+
+    for (size_t offset = 0; offset < payload.size() && run.ok; offset += OTA_BENCH_MSS) {
+        size_t len = min((size_t)OTA_BENCH_MSS, payload.size() - offset);
+        auto start = std::chrono::steady_clock::now();
+        run.ok = otaUpdater.write(payload.data() + offset, len);
+        double ms = elapsedMs(start);
+        run.callbackMs += ms;
+        run.maxCallbackMs = max(run.maxCallbackMs, ms);
+        // OTA task'ı host'ta yok: kuyruğu burada boşalt
+        start = std::chrono::steady_clock::now();
+        while (otaUpdater.process()) {
+        }
+        run.taskMs += elapsedMs(start);
+    }
+    otaUpdater.finish();
+    auto start = std::chrono::steady_clock::now();
+    while (otaUpdater.process()) {
+    }
+    run.taskMs += elapsedMs(start);
+    run.ok &= otaUpdater.getState() == OTA_SUCCESS;
+    run.stats = otaUpdater.getStats();
+    Update.nativeSetSectorLatency(0);
+    return run;
+}
+
+BENCH(ota_update_legacy) {
+    std::vector<uint8_t> image = makeImage();
+    Update.nativeSetSectorLatency(OTA_BENCH_SECTOR_US);
+
+    // Eski handleOTAUpdate: Update.write doğrudan callback'te
+    double totalMs = 0;
+    double maxMs = 0;
+    bool ok = Update.begin(UPDATE_SIZE_UNKNOWN);
+    for (size_t offset = 0; offset < image.size() && ok; offset += OTA_BENCH_MSS) {
+        size_t len = min((size_t)OTA_BENCH_MSS, image.size() - offset);
+        uint32_t start = micros();
+        ok = Update.write(image.data() + offset, len) == len;
+        double ms = (micros() - start) / 1000.0;
+        totalMs += ms;
+        maxMs = max(maxMs, ms);
+    }
+    ok &= Update.end(true) && Update.nativeImage() == image;
+    Update.nativeSetSectorLatency(0);
+
+    benchReport("1.5 MB raw, Update.write in async_tcp", totalMs, "ms in callback");
+    benchReport("  worst callback", maxMs, "ms");
+    benchReport("  bytes on the wire", image.size() / 1024.0, "KB");
+    benchReport("  image intact and bootable", ok && Update.nativeBootable() ? 1 : 0, "");
+}
+
+static void runStreaming(const char* label, const std::vector<uint8_t>& image,
+    const std::vector<uint8_t>& payload, OtaCompression compression) {
+    std::string sha = hexDigest(image);
+    OtaRun run = sendImage(payload, sha, compression);
+    bool ok = run.ok && Update.nativeImage() == image && Update.nativeBootable();
+
+    benchReport(label, run.callbackMs, "ms in callback");
+    benchReport("  worst callback", run.maxCallbackMs, "ms");
+    benchReport("  bytes on the wire", payload.size() / 1024.0, "KB");
+    benchReport("  decode + hash (OTA task, host)", run.taskMs, "ms");
+    benchReport("  flash time (OTA task)", run.stats.flashTimeUs / 1000.0, "ms");
+    benchReport("  flash writes", run.stats.flashWrites, "");
+    benchReport("  image intact and bootable", ok ? 1 : 0, "");
+}
+
+BENCH(ota_update_streaming_raw) {
+    std::vector<uint8_t> image = makeImage();
+    runStreaming("1.5 MB raw, OtaUpdater", image, image, OTA_COMPRESSION_AUTO);
+}
+
+BENCH(ota_update_streaming_gzip) {
+    std::vector<uint8_t> image = makeImage();
+    runStreaming("1.5 MB gzip, OtaUpdater", image, gzipImage(image), OTA_COMPRESSION_AUTO);
+}
+
+BENCH(ota_update_streaming_heatshrink) {
+    std::vector<uint8_t> image = makeImage();
+    runStreaming("1.5 MB heatshrink (w11 l4), OtaUpdater", image,
+        heatshrinkImage(image, OTA_HEATSHRINK_WINDOW, OTA_HEATSHRINK_LOOKAHEAD), OTA_COMPRESSION_HEATSHRINK);
+}
+
+// Uzun geri referanslar (2^12 byte) çözücünün 256 byte'lık çıkış tamponunu
+// aşar; tampon referansın ortasında boşaltılmalı
+BENCH(ota_update_heatshrink_long_lookahead) {
+    std::vector<uint8_t> image = makeImage();
+    std::vector<uint8_t> payload = heatshrinkImage(image, 13, 12);
+    std::string sha = hexDigest(image);
+    OtaRun run = sendImage(payload, sha, OTA_COMPRESSION_HEATSHRINK, 13, 12);
+    bool ok = run.ok && Update.nativeImage() == image && Update.nativeBootable();
+    benchReport("1.5 MB heatshrink (w13 l12)", payload.size() / 1024.0, "KB on the wire");
+    benchReport("  image intact and bootable", ok ? 1 : 0, "");
+}
+
+BENCH(ota_update_hash_mismatch) {
+    std::vector<uint8_t> image = makeImage();
+    std::string sha = hexDigest(image);
+    sha[0] = sha[0] == '0' ? '1' : '0';
+    OtaRun run = sendImage(gzipImage(image), sha, OTA_COMPRESSION_GZIP);
+    bool rejected = !run.ok && otaUpdater.getState() == OTA_FAILED && !Update.nativeBootable();
+
+    benchReport("gzip image with wrong SHA-256", rejected ? 1 : 0, "rejected");
+    benchReport("  bytes flashed before verify", run.stats.written / 1024.0, "KB");
+}
@@ -0,0 +1,65 @@
+// /api/playlist akış üreticisi (env:native).
+//
+// PlaylistStream'i TCP MSS boyutlu tamponlarla boşaltır; kayıt başına
+// maliyeti ve üretilen JSON'un geçerliliğini (kaba kontrol) raporlar.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "LibraryIndex.h"
+#include "PlaylistStream.h"
+
+static void makeLibrary(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/Sanatci \"%02u\" - Parca_%05u.mp3", (unsigned)(i % 50), (unsigned)i);
+        File f = SD.open(name, FILE_WRITE);
+        f.close();
+    }
+    Preferences::nativeReset();
+    libraryIndex.rescan();
+}
+
+BENCH(playlist_stream) {
+    BenchSdRoot sd("/tmp/musicbox_pl_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    const size_t count = 5000;
+    makeLibrary(count);
+
+    const size_t mss = 1436;
+    std::vector<uint8_t> buffer(mss);
+    size_t bytes = 0;
+    size_t chunks = 0;
+
+    double full = benchMeasureNs(5, [&](size_t) {
+        PlaylistStream stream(libraryIndex, 0, 0);
+        bytes = 0;
+        chunks = 0;
+        size_t n;
+        while ((n = stream.fill(buffer.data(), buffer.size())) > 0) {
+            bytes += n;
+            chunks++;
+        }
+    });
+    benchReport("full library (5000 entries)", full / 1e6, "ms");
+    benchReport("  per entry", full / count, "ns");
+    benchReport("  body size", bytes / 1024.0, "KiB");
+    benchReport("  chunks of 1436 B", (double)chunks, "");
+    benchReport("  stream state size", (double)sizeof(PlaylistStream), "bytes");
+
+    double page = benchMeasureNs(200, [&](size_t i) {
+        PlaylistStream stream(libraryIndex, (i * 200) % count, 200);
+        while (stream.fill(buffer.data(), buffer.size()) > 0) {}
+    });
+    benchReport("one page (limit=200)", page / 1e3, "us");
+
+    // Kaba doğrulama: köşeli parantezler ve tırnak sayısı
+    PlaylistStream check(libraryIndex, 10, 3);
+    char out[2048];
+    size_t n = check.fill((uint8_t*)out, sizeof(out) - 1);
+    out[n] = 0;
+    printf("  sample page: %s\n", out);
+}
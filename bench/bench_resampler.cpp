@@ -0,0 +1,216 @@
+// Örnekleme hızı dönüştürücü (env:native).
+//
+// resampler_rates: SCL hızına göre seçilen DAC çıkış hızı ve eski yolun
+// (pacing dosya hızında, bus yetişemiyor) perde/tempo hatası.
+// resampler_cost: kalite profili ve giriş hızı başına çıkış örneği
+// başına döngü.
+// resampler_response: geçiş bandı dalgalanması (0.3 x çıkış hızına kadar),
+// çıkış Nyquist'inin üstündeki tonların katlanma bastırması (imgesi geçiş
+// bandına düşen tonlar, >= 0.7 x çıkış hızı) ve 1 kHz'de SNR. Parça parça
+// işleme ile tek seferde işlemenin aynı çıktıyı verdiği de kontrol edilir.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "BenchRunner.h"
+#include "Resampler.h"
+#include "AudioOutputMCP4725.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t readCycles() { return __rdtsc(); }
+#define CYCLE_UNIT "cycles"
+#else
+static inline uint64_t readCycles() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#define CYCLE_UNIT "ns"
+#endif
+
+static const uint32_t inputRates[] = { 8000, 16000, 32000, 44100, 48000 };
+
+static std::vector<int16_t> makeTone(double hz, uint32_t rate, size_t frames, double amplitude) {
+    std::vector<int16_t> input(frames * 2);
+    for (size_t i = 0; i < frames; i++) {
+        int16_t s = (int16_t)lrint(amplitude * sin(2.0 * M_PI * hz * i / rate));
+        input[2 * i] = s;
+        input[2 * i + 1] = s;
+    }
+    return input;
+}
+
+static std::vector<int16_t> resampleAll(Resampler& r, const std::vector<int16_t>& input) {
+    size_t frames = input.size() / 2;
+    std::vector<int16_t> output((frames * r.getOutputRate() / r.getInputRate() + 16) * 2);
+    size_t done = 0;
+    size_t produced = 0;
+    while (done < frames && produced < output.size() / 2) {
+        size_t used;
+        produced += r.process(&input[2 * done], frames - done, &output[2 * produced],
+                              output.size() / 2 - produced, used);
+        done += used;
+    }
+    output.resize(produced * 2);
+    return output;
+}
+
+// Geçici bölgeden sonraki RMS
+static double rmsOf(const std::vector<int16_t>& out, size_t skip) {
+    double sum = 0;
+    size_t n = 0;
+    for (size_t i = skip; i < out.size() / 2; i++) {
+        sum += (double)out[2 * i] * out[2 * i];
+        n++;
+    }
+    return n ? sqrt(sum / n) : 0;
+}
+
+// f frekanslı sinüse en küçük kareler uydurup artığın oranı (dB)
+static double snrAt(const std::vector<int16_t>& out, size_t skip, double hz, uint32_t rate) {
+    double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+    size_t n = out.size() / 2;
+    for (size_t i = skip; i < n; i++) {
+        double s = sin(2.0 * M_PI * hz * i / rate);
+        double c = cos(2.0 * M_PI * hz * i / rate);
+        double y = out[2 * i];
+        ss += s * s; sc += s * c; cc += c * c; ys += y * s; yc += y * c;
+    }
+    double det = ss * cc - sc * sc;
+    double a = (ys * cc - yc * sc) / det;
+    double b = (yc * ss - ys * sc) / det;
+    double signal = 0, noise = 0;
+    for (size_t i = skip; i < n; i++) {
+        double fit = a * sin(2.0 * M_PI * hz * i / rate) + b * cos(2.0 * M_PI * hz * i / rate);
+        double e = out[2 * i] - fit;
+        signal += fit * fit;
+        noise += e * e;
+    }
+    return 10.0 * log10(signal / noise);
+}
+
+BENCH(resampler_rates) {
+    const uint32_t clocks[] = { 100000, 400000, 1000000 };
+    printf("  %-8s %12s %12s %18s\n", "scl", "output Hz", "line max Hz", "legacy 44.1k pitch");
+    for (uint32_t scl : clocks) {
+        // Paysız üst sınır: eski yolda pacing dosya hızındaydı, bus buna yetişemeyince
+        // DAC bus'ın hızında çalıyordu
+        uint64_t bits = 2 + (1 + 2 * DAC_BURST_SAMPLES) * 9;
+        double lineMax = DAC_BURST_SAMPLES * 1e6 / ((double)bits * 1e6 / scl + I2C_ARBITER_TXN_OVERHEAD_US);
+        double played = lineMax < 44100 ? lineMax : 44100;
+        printf("  %-8u %12u %12.0f %15.2f st\n", (unsigned)scl, (unsigned)AudioOutputMCP4725::outputRateFor(scl),
+               lineMax, 12.0 * log2(played / 44100.0));
+    }
+}
+
+BENCH(resampler_cost) {
+    const uint32_t outputRate = AudioOutputMCP4725::outputRateFor(DAC_I2C_CLOCK_HZ);
+    const size_t frames = 1 << 15;
+    const int rounds = 20;
+    std::vector<int16_t> input(frames * 2);
+    uint32_t x = 1;
+    for (auto& s : input) {
+        x = x * 1664525u + 1013904223u;
+        s = (int16_t)(x >> 17);
+    }
+    std::vector<int16_t> output(frames * 2 * 3);
+
+    printf("  output %u Hz; %s per output sample\n", (unsigned)outputRate, CYCLE_UNIT);
+    printf("  %-10s %6s", "quality", "macs");
+    for (uint32_t rate : inputRates) printf(" %9u", (unsigned)rate);
+    printf("\n");
+
+    uint64_t sink = 0;
+    for (int q = 0; q < RESAMPLER_QUALITY_COUNT; q++) {
+        printf("  %-10s %6u", Resampler::getProfile((ResamplerQuality)q).name,
+               (unsigned)Resampler::macsPerSample((ResamplerQuality)q));
+        for (uint32_t rate : inputRates) {
+            Resampler r;
+            r.configure(rate, outputRate, (ResamplerQuality)q);
+            size_t produced = 0;
+            uint64_t start = readCycles();
+            for (int round = 0; round < rounds; round++) {
+                size_t used;
+                produced += r.process(input.data(), frames, output.data(), output.size() / 2, used);
+            }
+            double cost = (double)(readCycles() - start) / produced;
+            sink += output[produced % frames];
+            printf(" %9.1f", cost);
+        }
+        printf("\n");
+    }
+
+    // Tasarım (SetRate'te bir kez): tablo hesabı
+    double designNs = benchMeasureNs(20, [&](size_t i) {
+        Resampler r;
+        r.configure(i & 1 ? 44100 : 48000, outputRate, RESAMPLER_HIGH);
+    });
+    benchReport("table design (high, per SetRate)", designNs / 1000.0, "us");
+    benchReport("budget 1.5M MAC/s picks", Resampler::qualityForBudget(1500000, outputRate), "(0=fast 2=high)");
+    benchKeep(sink);
+}
+
+BENCH(resampler_response) {
+    const uint32_t outputRate = AudioOutputMCP4725::outputRateFor(DAC_I2C_CLOCK_HZ);
+    const double amplitude = 16384.0;
+    const double inputRms = amplitude / sqrt(2.0);
+
+    printf("  output %u Hz; passband <= %.0f Hz, alias band >= %.0f Hz\n",
+           (unsigned)outputRate, 0.3 * outputRate, 0.7 * outputRate);
+    printf("  %-10s %7s %14s %16s %12s %10s\n", "quality", "input", "ripple dB", "alias reject dB", "SNR 1k dB", "chunked");
+
+    for (int q = 0; q < RESAMPLER_QUALITY_COUNT; q++) {
+        for (uint32_t rate : { 32000u, 44100u, 48000u }) {
+            const size_t frames = rate / 4;
+            const size_t skip = RESAMPLER_MAX_TAPS * 2;
+
+            double minGain = 1e9, maxGain = 0;
+            for (double hz = 50; hz <= 0.3 * outputRate; hz *= 1.25) {
+                Resampler r;
+                r.configure(rate, outputRate, (ResamplerQuality)q);
+                std::vector<int16_t> out = resampleAll(r, makeTone(hz, rate, frames, amplitude));
+                double gain = rmsOf(out, skip) / inputRms;
+                minGain = std::min(minGain, gain);
+                maxGain = std::max(maxGain, gain);
+            }
+            double ripple = 20.0 * log10(maxGain / minGain);
+
+            double worstAlias = 0;
+            for (double hz = 0.7 * outputRate; hz < 0.5 * rate; hz += 250) {
+                Resampler r;
+                r.configure(rate, outputRate, (ResamplerQuality)q);
+                std::vector<int16_t> out = resampleAll(r, makeTone(hz, rate, frames, amplitude));
+                worstAlias = std::max(worstAlias, rmsOf(out, skip) / inputRms);
+            }
+            double reject = worstAlias > 0 ? -20.0 * log10(worstAlias) : 99.0;
+
+            Resampler tone;
+            tone.configure(rate, outputRate, (ResamplerQuality)q);
+            std::vector<int16_t> input = makeTone(1000, rate, frames, amplitude);
+            std::vector<int16_t> whole = resampleAll(tone, input);
+            double snr = snrAt(whole, skip, 1000, outputRate);
+
+            // Aynı girdi düzensiz parçalarla ve küçük çıkış pencereleriyle
+            Resampler chunked;
+            chunked.configure(rate, outputRate, (ResamplerQuality)q);
+            std::vector<int16_t> pieces(whole.size());
+            size_t done = 0, produced = 0;
+            uint32_t x = 7;
+            while (done < frames && produced < whole.size() / 2) {
+                x = x * 1664525u + 1013904223u;
+                size_t want = 1 + (x >> 16) % 97;
+                size_t room = 1 + (x >> 8) % 29;
+                size_t used;
+                produced += chunked.process(&input[2 * done], std::min(want, frames - done), &pieces[2 * produced],
+                                            std::min(room, whole.size() / 2 - produced), used);
+                done += used;
+            }
+            bool same = produced * 2 == whole.size() && pieces == whole;
+
+            printf("  %-10s %7u %14.3f %16.1f %12.1f %10s\n", Resampler::getProfile((ResamplerQuality)q).name,
+                   (unsigned)rate, ripple, reject, snr, same ? "same" : "DIFFERS");
+        }
+    }
+}
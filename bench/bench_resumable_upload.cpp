@@ -0,0 +1,173 @@
+// Devam ettirilebilir upload (env:native).
+//
+// 4 MB'lık upload %90'da kopar. Eski yolda dosyanın tamamı yeniden
+// gönderilir; ResumableUploads ile istemci oturumu sorgular ve sadece
+// eksik parçaları gönderir. İkinci senaryoda parçalar ters sırada gelir,
+// finalize özetin kalanını writer'a SD'den okutmak zorunda kalır. Üçüncüde
+// cihaz yeniden başlar; özet durumu meta'dan gelir, finalize bir şey okumaz.
+// Her durumda dosya, SHA-256 ve kütüphane indeksi doğrulanır.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "LibraryIndex.h"
+#include "ResumableUpload.h"
+
+#define RESUMABLE_BENCH_SIZE    (4 * 1024 * 1024 + 1000)
+#define RESUMABLE_BENCH_MSS     1436
+#define RESUMABLE_BENCH_DROP    90      // yüzde
+
+static uint8_t resumableByte(size_t offset) {
+    return (uint8_t)((offset * 131) ^ (offset >> 9));
+}
+
+static String hexDigest(const uint8_t* data, size_t size) {
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts_ret(&ctx, 0);
+    mbedtls_sha256_update_ret(&ctx, data, size);
+    uint8_t digest[32];
+    mbedtls_sha256_finish_ret(&ctx, digest);
+    char hex[65];
+    for (int i = 0; i < 32; i++) snprintf(hex + i * 2, 3, "%02x", digest[i]);
+    return String(hex);
+}
+
+// PUT gövdesini TCP segmentleri halinde verir; dropAt > 0 ise o kadar
+// byte'tan sonra bağlantı kopar. Gönderilen byte sayısını döndürür.
+static size_t sendChunk(const String& id, uint32_t index, const std::vector<uint8_t>& file,
+    size_t dropAt, ResumableStatus& status) {
+    static int key;
+    size_t offset = (size_t)index * UPLOAD_CHUNK_SIZE;
+    size_t length = min((size_t)UPLOAD_CHUNK_SIZE, file.size() - offset);
+
+    status = resumableUploads.beginChunk(id, index, length, &key, nullptr);
+    if (status != RESUMABLE_OK) {
+        return 0;
+    }
+    size_t sent = 0;
+    while (sent < length) {
+        size_t len = min((size_t)RESUMABLE_BENCH_MSS, length - sent);
+        if (dropAt && sent + len > dropAt) {
+            resumableUploads.abortChunk(&key);
+            while (uploadWriter.process()) {
+            }
+            status = RESUMABLE_IO_ERROR;
+            return sent;
+        }
+        resumableUploads.writeChunk(&key, file.data() + offset + sent, len);
+        while (uploadWriter.process()) {
+        }
+        sent += len;
+    }
+    // Writer host'ta task'sız: kapanışı burada yürüt, pollChunk sonucu alır
+    resumableUploads.endChunk(&key);
+    while (uploadWriter.process()) {
+    }
+    status = resumableUploads.pollChunk(&key);
+    return sent;
+}
+
+static bool fileMatches(const char* path, const std::vector<uint8_t>& data) {
+    File f = SD.open(path, FILE_READ);
+    if (!f || f.size() != data.size()) return false;
+    std::vector<uint8_t> read(data.size());
+    f.read(read.data(), read.size());
+    return read == data;
+}
+
+// Writer host'ta task'sız: okuma işini burada yürüt, finalize tekrar sorulur
+static ResumableStatus finalizeUpload(ResumableUploads& uploads, const String& id, const String& sha,
+    String& path, uint32_t& polls) {
+    ResumableStatus status;
+    polls = 0;
+    while ((status = uploads.finalize(id, sha, path)) == RESUMABLE_PENDING) {
+        polls++;
+        while (uploadWriter.process()) {
+        }
+    }
+    return status;
+}
+
+static void runResumable(const char* label, bool reverse, bool reboot = false) {
+    BenchSdRoot sd("/tmp/musicbox_res_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    libraryIndex.rescan();
+    resumableUploads.begin();
+
+    std::vector<uint8_t> file(RESUMABLE_BENCH_SIZE);
+    for (size_t i = 0; i < file.size(); i++) file[i] = resumableByte(i);
+    String sha = hexDigest(file.data(), file.size());
+
+    String id;
+    bool ok = resumableUploads.create("Test_Song.mp3", file.size(), id) == RESUMABLE_OK;
+    uint32_t chunks = (file.size() + UPLOAD_CHUNK_SIZE - 1) / UPLOAD_CHUNK_SIZE;
+    size_t dropAt = file.size() * RESUMABLE_BENCH_DROP / 100;
+
+    // İlk deneme: dropAt'te bağlantı kopar
+    size_t sent = 0;
+    for (uint32_t n = 0; n < chunks && ok; n++) {
+        uint32_t index = reverse ? chunks - 1 - n : n;
+        size_t offset = (size_t)index * UPLOAD_CHUNK_SIZE;
+        size_t length = min((size_t)UPLOAD_CHUNK_SIZE, file.size() - offset);
+        ResumableStatus status;
+        size_t remaining = dropAt - sent;
+        sent += sendChunk(id, index, file, remaining < length ? remaining : 0, status);
+        if (status != RESUMABLE_OK) break;
+    }
+
+    // Tekrar bağlanınca istemci aynı ad/boyutla oturumu açar ve eksikleri gönderir
+    String resumedId;
+    ok &= resumableUploads.create("Test_Song.mp3", file.size(), resumedId) == RESUMABLE_OK && resumedId == id;
+    String path;
+    ok &= resumableUploads.finalize(id, sha, path) == RESUMABLE_INCOMPLETE;
+
+    size_t resent = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < chunks && ok; n++) {
+        uint32_t index = reverse ? chunks - 1 - n : n;
+        ResumableStatus status;
+        resent += sendChunk(id, index, file, 0, status);
+        ok &= status == RESUMABLE_OK || status == RESUMABLE_DUPLICATE;
+    }
+    double uploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Yeniden başlatma: yeni örnekte oturum yok, durum sadece SD'deki meta'da
+    ResumableUploads rebooted;
+    ResumableUploads& uploads = reboot ? rebooted : resumableUploads;
+
+    start = std::chrono::steady_clock::now();
+    uint32_t polls;
+    ok &= finalizeUpload(uploads, id, sha, path, polls) == RESUMABLE_OK;
+    if (reboot) {
+        // Eski örneğin bellekteki kopyası (dosyaları zaten taşındı)
+        resumableUploads.remove(id);
+    }
+    libraryIndex.loop();
+    double finalizeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ok &= path == "/Test_Song.mp3" && fileMatches("/Test_Song.mp3", file) && libraryIndex.contains(path);
+    ok &= !SD.exists(UPLOAD_SESSION_DIR "/" + id + ".part") && !SD.exists(UPLOAD_SESSION_DIR "/" + id + ".meta");
+
+    benchReport(label, resent / 1024.0, "KB resent");
+    benchReport("  legacy resend (whole file)", file.size() / 1024.0, "KB");
+    benchReport("  bytes before drop", sent / 1024.0, "KB");
+    benchReport("  resume time (host)", uploadMs, "ms");
+    benchReport("  finalize (hash + rename)", finalizeMs, "ms");
+    benchReport("  finalize deferred to writer", polls > 0 ? 1 : 0, "");
+    benchReport("  file, hash and index intact", ok ? 1 : 0, "");
+}
+
+BENCH(resumable_upload_in_order) {
+    runResumable("4 MB, in-order chunks, drop at 90%", false);
+}
+
+BENCH(resumable_upload_reverse) {
+    runResumable("4 MB, reverse chunks, drop at 90%", true);
+}
+
+BENCH(resumable_upload_reboot) {
+    runResumable("4 MB, in-order chunks, reboot at 90%", false, true);
+}
@@ -0,0 +1,99 @@
+// Stereo -> 12-bit mono dönüşüm kernel'i için host benchmark'ı (env:native).
+//
+// Eski ConsumeSample matematiği (bölme, constrain, Arduino map(), volume
+// bölmesi) ile SampleKernel'in toplu yolu frame başına döngü sayısıyla
+// karşılaştırılır.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include "BenchRunner.h"
+#include "SampleKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t readCycles() { return __rdtsc(); }
+#define CYCLE_UNIT "cycles"
+#else
+static inline uint64_t readCycles() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#define CYCLE_UNIT "ns"
+#endif
+
+// Arduino.h'deki tanımlarla aynı
+static long arduinoMap(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+#define legacyConstrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Değişiklik öncesi AudioOutputMCP4725::ConsumeSample
+static uint16_t legacyConvert(const int16_t sample[2], int currentVolume) {
+    int32_t mono = (sample[0] + sample[1]) / 2;
+    mono *= 2;
+    mono = legacyConstrain(mono, -32768, 32767);
+    uint16_t value = arduinoMap(mono, -32768, 32767, 0, 4095);
+    value = (value * currentVolume) / 100;
+    return value;
+}
+
+static volatile int benchVolume = 100;
+
+BENCH(sample_kernel) {
+    const size_t frames = 1 << 16;
+    const int rounds = 200;
+    std::vector<int16_t> input(frames * 2);
+    std::vector<uint16_t> output(frames);
+
+    srand(1);
+    for (size_t i = 0; i < frames * 2; i++) {
+        input[i] = (int16_t)((rand() & 0xFFFF) - 32768);
+    }
+
+    // Eski yol
+    uint64_t start = readCycles();
+    for (int r = 0; r < rounds; r++) {
+        int volume = benchVolume;
+        for (size_t i = 0; i < frames; i++) {
+            output[i] = legacyConvert(&input[2 * i], volume);
+        }
+    }
+    double legacy = (double)(readCycles() - start) / ((double)frames * rounds);
+    uint32_t sink = output[frames / 2];
+
+    printf("  %-22s %8.2f %s/frame\n", "legacy per-sample", legacy, CYCLE_UNIT);
+
+    const struct { DitherMode mode; const char* name; } modes[] = {
+        { DITHER_NONE, "kernel" },
+        { DITHER_TPDF, "kernel + tpdf" },
+        { DITHER_SHAPED, "kernel + shaped" },
+    };
+
+    for (const auto& m : modes) {
+        SampleKernel kernel;
+        kernel.setVolume(benchVolume);
+        kernel.setDither(m.mode);
+
+        start = readCycles();
+        for (int r = 0; r < rounds; r++) {
+            kernel.convert(input.data(), output.data(), frames);
+        }
+        double cost = (double)(readCycles() - start) / ((double)frames * rounds);
+        sink += output[frames / 2];
+        printf("  %-22s %8.2f %s/frame  (%.1fx)\n", m.name, cost, CYCLE_UNIT, legacy / cost);
+    }
+
+    // Tam seste eski yol ile en fazla 1 LSB fark olmalı
+    SampleKernel kernel;
+    int maxDiff = 0;
+    for (size_t i = 0; i < frames; i++) {
+        int diff = abs((int)legacyConvert(&input[2 * i], 100) -
+                       (int)kernel.convertFrame(input[2 * i], input[2 * i + 1]));
+        if (diff > maxDiff) maxDiff = diff;
+    }
+    printf("  max |legacy - kernel| at volume 100: %d LSB\n", maxDiff);
+    benchKeep(sink);
+}
@@ -0,0 +1,217 @@
+// SD önden okuma (env:native).
+//
+// İki 20 saniyelik parça arka arkaya çalınır. SD okumaları native FS'in
+// gecikme modeliyle simüle saatte maliyetlenir (çağrı başına 1.2 ms + KB
+// başına 0.4 ms, dosya açılışı 30 ms); her 3 saniyede bir eşzamanlı
+// upload bus'ı 300 ms tutar. Decoder 26 ms'lik MP3 çerçevelerini çözer ve
+// DAC ring'i (~93 ms) kadar önde gidebilir; çerçeve çalma zamanına
+// yetişmezse DAC aç kalır.
+//
+// sd_prefetch_direct: decoder her çerçeveyi doğrudan SD'den okur (eski yol).
+// sd_prefetch_ring: AudioFileSourcePrefetch; reader ayrı zaman çizgisinde
+// 4 KB'lık hizalı okumalar yapar, ikinci parçanın başı önden okunur.
+// Çalınan byte'lar dosyayla karşılaştırılır.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "DacOutputStage.h"
+#include "AudioFileSourcePrefetch.h"
+
+#define PREFETCH_BENCH_SECONDS      20
+#define PREFETCH_BENCH_FRAME_US     26122   // 1152 örnek @ 44.1 kHz
+#define PREFETCH_BENCH_DECODE_US    6000
+#define PREFETCH_BENCH_SLACK_US     ((uint64_t)DAC_RING_SAMPLES * 1000000 / 44100)
+#define PREFETCH_BENCH_CALL_US      1200
+#define PREFETCH_BENCH_KB_US        400
+#define PREFETCH_BENCH_OPEN_US      30000
+#define PREFETCH_BENCH_SPIKE_US     300000
+#define PREFETCH_BENCH_SPIKE_EVERY  3000000
+
+static uint8_t trackByte(int track, size_t offset) {
+    return (uint8_t)((offset * 167 + track * 13) ^ (offset >> 10));
+}
+
+static void makeTracks(uint32_t kbps, size_t& trackSize) {
+    trackSize = (size_t)kbps * 1000 / 8 * PREFETCH_BENCH_SECONDS;
+    for (int t = 0; t < 2; t++) {
+        std::vector<uint8_t> data(trackSize);
+        for (size_t i = 0; i < trackSize; i++) data[i] = trackByte(t, i);
+        File f = SD.open(t == 0 ? "/a.mp3" : "/b.mp3", FILE_WRITE);
+        f.write(data.data(), data.size());
+        f.close();
+    }
+}
+
+// Decoder zaman çizgisi: çerçeve k, oynatma zamanı due'dan önce çözülmeli
+struct DecoderTimeline {
+    uint64_t clock = 0;
+    uint64_t due = PREFETCH_BENCH_SLACK_US;
+    uint64_t nextSpike = PREFETCH_BENCH_SPIKE_EVERY;
+    uint64_t starvedUs = 0;
+    uint64_t switchGapUs = 0;
+    uint32_t starvations = 0;
+    uint32_t frames = 0;
+    bool intact = true;
+
+    // Decoder'ın çerçeveye başlayabileceği en erken an
+    uint64_t startAt() const {
+        return max(clock, due > PREFETCH_BENCH_SLACK_US ? due - PREFETCH_BENCH_SLACK_US : 0);
+    }
+
+    void injectSpikes(uint64_t now) {
+        while (now >= nextSpike) {
+            fs::nativeAddReadStall(PREFETCH_BENCH_SPIKE_US);
+            nextSpike += PREFETCH_BENCH_SPIKE_EVERY;
+        }
+    }
+
+    // Çerçeve okundu; çözülüp oynatma zamanına yetişti mi
+    void finishFrame(bool firstOfTrack) {
+        clock = micros() + PREFETCH_BENCH_DECODE_US;
+        if (clock > due) {
+            starvedUs += clock - due;
+            starvations++;
+            if (firstOfTrack) switchGapUs += clock - due;
+            due = clock;
+        }
+        due += PREFETCH_BENCH_FRAME_US;
+        frames++;
+    }
+};
+
+static void setSdLatency(bool enabled) {
+    fs::nativeSetReadLatency(enabled ? PREFETCH_BENCH_CALL_US : 0, enabled ? PREFETCH_BENCH_KB_US : 0);
+    fs::nativeSetOpenLatency(enabled ? PREFETCH_BENCH_OPEN_US : 0);
+}
+
+static void report(const char* label, const DecoderTimeline& timeline) {
+    benchReport(label, timeline.starvedUs / 1000.0, "ms DAC starved");
+    benchReport("  starved frames", timeline.starvations, "");
+    benchReport("  gap at track switch", timeline.switchGapUs / 1000.0, "ms");
+}
+
+static void runDirect(const char* label, uint32_t kbps) {
+    BenchSdRoot sd("/tmp/musicbox_pf_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    size_t trackSize = 0;
+    makeTracks(kbps, trackSize);
+    size_t frameBytes = (size_t)kbps * 1000 / 8 * PREFETCH_BENCH_FRAME_US / 1000000;
+    std::vector<uint8_t> frame(frameBytes);
+
+    DecoderTimeline timeline;
+    nativeSetMicros(0);
+    setSdLatency(true);
+    uint32_t reads = 0;
+    for (int t = 0; t < 2; t++) {
+        nativeSetMicros(timeline.clock);
+        File f = SD.open(t == 0 ? "/a.mp3" : "/b.mp3", FILE_READ);
+        timeline.clock = micros();
+        for (size_t offset = 0; offset < trackSize; offset += frameBytes) {
+            uint64_t start = timeline.startAt();
+            timeline.injectSpikes(start);
+            nativeSetMicros(start);
+            size_t n = f.read(frame.data(), min(frameBytes, trackSize - offset));
+            reads++;
+            for (size_t i = 0; i < n; i++) timeline.intact &= frame[i] == trackByte(t, offset + i);
+            timeline.finishFrame(t == 1 && offset == 0);
+        }
+        f.close();
+    }
+    setSdLatency(false);
+    nativeUseRealClock();
+
+    report(label, timeline);
+    benchReport("  SD read calls", reads, "");
+    benchReport("  audio intact", timeline.intact ? 1 : 0, "");
+}
+
+static void runPrefetch(const char* label, uint32_t kbps) {
+    BenchSdRoot sd("/tmp/musicbox_pf_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    size_t trackSize = 0;
+    makeTracks(kbps, trackSize);
+    size_t frameBytes = (size_t)kbps * 1000 / 8 * PREFETCH_BENCH_FRAME_US / 1000000;
+    std::vector<uint8_t> frame(frameBytes);
+
+    AudioFileSourcePrefetch source;
+    source.begin();
+    DecoderTimeline timeline;
+    nativeSetMicros(0);
+    setSdLatency(true);
+    uint64_t reader = 0;
+    size_t capacity[2] = { 0, 0 };
+
+    for (int t = 0; t < 2; t++) {
+        nativeSetMicros(timeline.clock);
+        source.open(t == 0 ? "/a.mp3" : "/b.mp3");
+        if (t == 0) source.preloadNext("/b.mp3");
+        timeline.clock = micros();
+        reader = max(reader, timeline.clock);
+
+        size_t offset = 0;
+        while (offset < trackSize) {
+            uint64_t start = timeline.startAt();
+
+            // Reader decoder'dan önce başlayan okumaları yapar. Son okuma
+            // decoder'ın başlangıcından sonra biterse verisi o an görünmez;
+            // çerçeve için gerekiyorsa decoder onu bekler.
+            size_t lastGot = 0;
+            uint64_t lastEnd = 0;
+            while (reader <= start) {
+                timeline.injectSpikes(reader);
+                nativeSetMicros(reader);
+                size_t before = source.getFill();
+                if (!source.process()) {
+                    reader = start + 1;
+                    break;
+                }
+                lastEnd = micros();
+                lastGot = source.getFill() > before ? source.getFill() - before : 0;
+                reader = lastEnd;
+            }
+            if (lastEnd > start && source.getFill() - lastGot < min(frameBytes, trackSize - offset)) {
+                start = lastEnd;
+            }
+
+            nativeSetMicros(start);
+            size_t n = source.read(frame.data(), min(frameBytes, trackSize - offset));
+            reader = max(reader, (uint64_t)micros());
+            for (size_t i = 0; i < n; i++) timeline.intact &= frame[i] == trackByte(t, offset + i);
+            timeline.finishFrame(t == 1 && offset == 0);
+            offset += n;
+            if (n == 0) {
+                timeline.intact = false;
+                break;
+            }
+        }
+        capacity[t] = source.getCapacity();
+        source.close();
+    }
+    setSdLatency(false);
+    nativeUseRealClock();
+
+    const PrefetchStats& stats = source.getStats();
+    report(label, timeline);
+    benchReport("  SD read calls", stats.reads, "");
+    benchReport("  max SD read (spike)", stats.maxReadUs / 1000.0, "ms");
+    benchReport("  bitrate estimate", source.getBitrateKbps(), "kbps");
+    benchReport("  ring capacity (track 2)", capacity[1] / 1024.0, "KB");
+    benchReport("  preload hits", stats.preloadHits, "");
+    benchReport("  audio intact", timeline.intact ? 1 : 0, "");
+}
+
+BENCH(sd_prefetch_direct) {
+    runDirect("128 kbps, direct SD reads", 128);
+    runDirect("320 kbps, direct SD reads", 320);
+}
+
+BENCH(sd_prefetch_ring) {
+    runPrefetch("128 kbps, prefetch ring", 128);
+    runPrefetch("320 kbps, prefetch ring", 320);
+}
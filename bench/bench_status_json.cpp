@@ -0,0 +1,131 @@
+// ArduinoJson tabanlı JSON üreticileri (env:native).
+//
+// WebServer.cpp ESPAsyncWebServer'a bağlı olduğundan host'ta derlenmiyor;
+// bu benchmark'lar WebServer'daki dokümanları aynı ArduinoJson çağrılarıyla
+// kurar: createStatusJson (çağrı başına RTC okuma sayısıyla) ve eski
+// 4 KB DynamicJsonDocument'lı /api/playlist. status_snapshot_shared üç
+// taşıyıcının (Web, MQTT, BLE) paylaşılan StatusSnapshot maliyetini ölçer.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <RTClib.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "StatusSnapshot.h"
+
+static RTC_DS3231 rtc;
+
+static String createStatusJson(bool playing, int volume, const String& track) {
+    StaticJsonDocument<512> doc;
+
+    doc["playing"] = playing;
+    doc["volume"] = volume;
+    doc["track"] = track;
+
+    DateTime now = rtc.now();
+    doc["time"]["hour"] = now.hour();
+    doc["time"]["minute"] = now.minute();
+    doc["time"]["second"] = now.second();
+
+    doc["temperature"] = rtc.getTemperature();
+
+    String status;
+    serializeJson(doc, status);
+    return status;
+}
+
+BENCH(create_status_json) {
+    rtc.begin();
+    const String track = "/Muzikler/Uzun_Bir_Sarki_Adi_2024.mp3";
+    size_t bytes = 0;
+
+    rtc.nativeReads = 0;
+    double ns = benchMeasureNs(200000, [&](size_t i) {
+        String json = createStatusJson(i & 1, 75, track);
+        bytes = json.length();
+        benchKeep(json);
+    });
+    uint32_t calls = 200000 * BENCH_REPEATS + 1;
+
+    benchReport("createStatusJson", ns, "ns/call");
+    benchReport("payload size", (double)bytes, "bytes");
+    benchReport("RTC I2C reads per call", (double)rtc.nativeReads / calls, "reads");
+}
+
+// Her durum güncellemesinde üç taşıyıcı: eskiden her biri kendi
+// createStatusJson'unu kuruyordu, şimdi sahipler snapshot'ı günceller ve
+// taşıyıcılar aynı tamponu alır
+BENCH(status_snapshot_shared) {
+    rtc.begin();
+    const String track = "/Muzikler/Uzun_Bir_Sarki_Adi_2024.mp3";
+    const int consumers = 3;
+    size_t bytes = 0;
+
+    rtc.nativeReads = 0;
+    double legacyNs = benchMeasureNs(50000, [&](size_t) {
+        for (int c = 0; c < consumers; c++) {
+            String json = createStatusJson(true, 75, track);
+            bytes += json.length();
+            benchKeep(json);
+        }
+    });
+    uint32_t ticks = 50000 * BENCH_REPEATS + 1;
+    double legacyReads = (double)rtc.nativeReads / ticks;
+
+    rtc.nativeReads = 0;
+    uint32_t serializationsBefore = statusSnapshot.getSerializationCount();
+    double sharedNs = benchMeasureNs(50000, [&](size_t i) {
+        // Sahip tarafı: saniyede bir konum ve saat ilerler
+        statusSnapshot.setPlaying(true);
+        statusSnapshot.setVolume(75);
+        statusSnapshot.setTrack(track);
+        statusSnapshot.setPosition((uint32_t)i);
+        statusSnapshot.setTime(rtc.now());
+        if (i % 60 == 0) {
+            statusSnapshot.setTemperature(rtc.getTemperature());
+        }
+        for (int c = 0; c < consumers; c++) {
+            StatusFrame frame = statusSnapshot.serialize();
+            bytes += frame.length;
+            benchKeep(frame);
+        }
+    });
+    double sharedReads = (double)rtc.nativeReads / ticks;
+    uint32_t serializations = statusSnapshot.getSerializationCount() - serializationsBefore;
+
+    benchReport("legacy: 3x createStatusJson per update", legacyNs, "ns");
+    benchReport("  RTC I2C reads per update", legacyReads, "reads");
+    benchReport("shared snapshot, 3 consumers per update", sharedNs, "ns");
+    benchReport("  RTC I2C reads per update", sharedReads, "reads");
+    benchReport("  serializations per update", (double)serializations / ticks, "");
+    benchKeep(bytes);
+}
+
+// Değişiklik öncesi /api/playlist: tüm liste 4 KB'lık dokümana sığmak zorunda
+BENCH(playlist_json_legacy) {
+    std::vector<String> files;
+    for (unsigned i = 0; i < 1000; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/Sanatci %02u - Parca_%05u.mp3", i % 50, i);
+        files.push_back(name);
+    }
+
+    size_t emitted = 0;
+    double ns = benchMeasureNs(200, [&](size_t) {
+        DynamicJsonDocument doc(4096);
+        JsonArray array = doc.to<JsonArray>();
+        for (const auto& file : files) {
+            String filename = file;
+            if (filename.startsWith("/")) {
+                filename = filename.substring(1);
+            }
+            array.add(filename);
+        }
+        String output;
+        serializeJson(doc, output);
+        emitted = array.size();
+        benchKeep(output);
+    });
+    benchReport("1000 entries into DynamicJsonDocument(4096)", ns / 1e3, "us");
+    benchReport("  entries that fit (rest silently dropped)", (double)emitted, "");
+}
@@ -0,0 +1,206 @@
+// Zamanlayıcılar (env:native).
+//
+// timer_poll_legacy: eski yol; loop() her saniye RTC'yi okur, timer
+// listesini değer olarak kopyalar (getTimers()) ve hepsini saat/dakika
+// eşleşmesiyle tarar. 10 dakikalık simülasyondan tick başına maliyet.
+//
+// timer_scheduler_heap: TimerScheduler; günlük, hafta içi/sonu, tek
+// seferlik kurallar ve bir uyku zamanlayıcısı 7 günlük simüle saatte
+// her saniye loop() ile sürülür. Alarm kesmesi simüle saat programlanan
+// ana gelince "düşer". Tetiklenen olay sayısı kuralların beklenen
+// tekrarlarıyla, tetiklenme anları programlanan anla karşılaştırılır.
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <chrono>
+#include <vector>
+#include "BenchRunner.h"
+#include "TimerScheduler.h"
+
+#define TIMER_BENCH_START       1704067200UL    // 2024-01-01 00:00:00 (Pazartesi)
+#define TIMER_BENCH_DAYS        7
+#define TIMER_BENCH_LEGACY_S    600
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Değişiklik öncesi TimeManager::Timer (getTimers() kopyaları)
+struct LegacyTimer {
+    String id;
+    uint8_t hour;
+    uint8_t minute;
+    bool enabled;
+    bool isPlayTimer;
+};
+
+static std::vector<LegacyTimer> legacyTimers;
+static std::vector<LegacyTimer> legacyGetTimers() { return legacyTimers; }
+
+static void runLegacy(size_t count) {
+    legacyTimers.clear();
+    srand(3);
+    for (size_t i = 0; i < count; i++) {
+        legacyTimers.push_back({ String((unsigned)i), (uint8_t)(rand() % 24), (uint8_t)(rand() % 60), true, (i & 1) != 0 });
+    }
+
+    RTC_DS3231 rtc;
+    nativeSetMicros(0);
+    rtc.begin();
+    rtc.adjust(DateTime((uint32_t)TIMER_BENCH_START));
+    uint32_t fired = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; t < TIMER_BENCH_LEGACY_S; t++) {
+        DateTime now = rtc.now();
+        auto timers = legacyGetTimers();
+        for (const auto& timer : timers) {
+            if (timer.enabled && timer.hour == now.hour() && timer.minute == now.minute() && now.second() == 0) {
+                fired++;
+            }
+        }
+        nativeAdvanceMicros(1000000);
+    }
+    double perTick = elapsedNs(start) / TIMER_BENCH_LEGACY_S;
+    nativeUseRealClock();
+
+    char label[64];
+    snprintf(label, sizeof(label), "%u timers, poll + copy", (unsigned)count);
+    benchReport(label, perTick / 1000.0, "us per tick");
+    benchReport("  RTC reads per day", rtc.nativeReads * 86400.0 / TIMER_BENCH_LEGACY_S, "");
+    benchReport("  fired in 10 min", fired, "");
+}
+
+BENCH(timer_poll_legacy) {
+    runLegacy(32);
+    runLegacy(2000);
+}
+
+// Simüle DS3231: saat millis()'ten, alarm programlanan saniyede düşer
+class BenchAlarm : public TimerAlarm {
+public:
+    uint32_t deadline = 0;
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+
+    uint32_t clock() const { return TIMER_BENCH_START + (uint32_t)(millis() / 1000); }
+
+    virtual uint32_t now() override {
+        reads++;
+        return clock();
+    }
+    virtual void program(uint32_t at) override {
+        writes++;
+        deadline = at;
+    }
+    virtual bool fired() override {
+        return deadline != 0 && clock() >= deadline;
+    }
+    virtual void acknowledge() override {
+        writes++;
+        deadline = 0;
+    }
+};
+
+struct HeapBenchResult {
+    uint32_t fired = 0;
+    uint32_t late = 0;
+    uint32_t sleepEvents = 0;
+    int sleepId = -1;
+    BenchAlarm* alarm = nullptr;
+};
+
+static void onBenchEvent(const TimerEvent& event, void* context) {
+    HeapBenchResult* result = (HeapBenchResult*)context;
+    result->fired++;
+    if (event.at != result->alarm->clock()) result->late++;
+    if (event.id == result->sleepId) result->sleepEvents++;
+}
+
+static uint32_t expectedFires(uint8_t hour, uint8_t minute, uint8_t weekdays, uint32_t end) {
+    uint32_t count = 0;
+    uint32_t day0 = TIMER_BENCH_START / 86400;
+    for (uint32_t d = 0; d <= TIMER_BENCH_DAYS; d++) {
+        uint32_t t = (day0 + d) * 86400 + hour * 3600 + minute * 60;
+        if (t > TIMER_BENCH_START && t <= end && (weekdays & (1 << ((day0 + d + 4) % 7)))) count++;
+    }
+    return count;
+}
+
+static void runHeap(size_t count) {
+    TimerScheduler scheduler(count + 1);
+    BenchAlarm alarm;
+    HeapBenchResult result;
+    result.alarm = &alarm;
+    nativeSetMicros(0);
+    scheduler.begin(&alarm, onBenchEvent, &result, false);
+
+    uint32_t end = TIMER_BENCH_START + TIMER_BENCH_DAYS * 86400;
+    uint32_t expected = 0;
+    srand(5);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t hour = rand() % 24;
+        uint8_t minute = rand() % 60;
+        switch (i % 4) {
+            case 0:
+                scheduler.addDaily(hour, minute, TIMER_ACTION_PLAY);
+                expected += expectedFires(hour, minute, 0x7F, end);
+                break;
+            case 1:
+                scheduler.addWeekly(TIMER_WEEKDAYS, hour, minute, TIMER_ACTION_PLAY);
+                expected += expectedFires(hour, minute, TIMER_WEEKDAYS, end);
+                break;
+            case 2:
+                scheduler.addWeekly(TIMER_WEEKENDS, hour, minute, TIMER_ACTION_STOP);
+                expected += expectedFires(hour, minute, TIMER_WEEKENDS, end);
+                break;
+            default:
+                scheduler.addOnce(TIMER_BENCH_START + 1 + rand() % (TIMER_BENCH_DAYS * 86400 - 1), TIMER_ACTION_PLAY);
+                expected++;
+                break;
+        }
+    }
+    // 30 dk uyku, son 60 sn'de TIMER_FADE_STEP_S adımlarla kısma
+    result.sleepId = scheduler.startSleep(30 * 60, 60);
+    uint32_t expectedFades = 60 / TIMER_FADE_STEP_S;
+    expected += expectedFades + 1;
+
+    uint64_t idleNs = 0, eventNs = 0;
+    uint32_t idleTicks = 0, eventTicks = 0;
+    uint32_t ticks = TIMER_BENCH_DAYS * 86400;
+    for (uint32_t t = 0; t < ticks; t++) {
+        nativeAdvanceMicros(1000000);
+        uint32_t before = result.fired;
+        auto start = std::chrono::steady_clock::now();
+        scheduler.loop();
+        double ns = elapsedNs(start);
+        if (result.fired != before) {
+            eventNs += (uint64_t)ns;
+            eventTicks++;
+        } else {
+            idleNs += (uint64_t)ns;
+            idleTicks++;
+        }
+    }
+    nativeUseRealClock();
+
+    const TimerSchedulerStats& stats = scheduler.getStats();
+    char label[64];
+    snprintf(label, sizeof(label), "%u timers, heap + RTC alarm", (unsigned)count);
+    benchReport(label, idleTicks ? (double)idleNs / idleTicks : 0, "ns per idle tick");
+    benchReport("  cost per event tick", eventTicks ? (double)eventNs / eventTicks / 1000.0 : 0, "us");
+    benchReport("  RTC reads per day", (double)alarm.reads / TIMER_BENCH_DAYS, "");
+    benchReport("  alarm writes per day", (double)alarm.writes / TIMER_BENCH_DAYS, "");
+    benchReport("  spurious wakeups", stats.spurious, "");
+    benchReport("  fired", result.fired, "");
+    benchReport("  expected", expected, "");
+    benchReport("  fired late", result.late, "");
+    benchReport("  sleep timer events (fade steps + stop)", result.sleepEvents, "");
+    benchReport("  expected", expectedFades + 1, "");
+}
+
+BENCH(timer_scheduler_heap) {
+    runHeap(32);
+    runHeap(2000);
+    runHeap(10000);
+}
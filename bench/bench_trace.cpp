@@ -0,0 +1,207 @@
+// Sıcak yol izleme (env:native, TRACE_ENABLED=1).
+//
+// trace_record: tek olay ve B/E kapsamı maliyeti; 4 iş parçacığı aynı
+// halkaya (host'ta hepsi aynı "core") yazarken okunamayan/yırtık olay
+// sayısı. Ses yolunun saniyede ürettiği olay sayısından halkanın kaç ms'lik
+// geçmiş tuttuğu ve DAC yolunun ek maliyeti.
+//
+// trace_export: dört task'lı bir oynatma senaryosu (decode, DAC burst, SD
+// okuması, HTTP handler) kaydedilir, /api/trace gövdesi küçük chunk'larla
+// ve tek tamponla üretilir. Gövdenin JSON dizi yapısı, task başına B/E
+// eşleşmesi ve core başına zaman sırası doğrulanır.
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchRunner.h"
+#include "DacOutputStage.h"
+#include "Trace.h"
+
+#define TRACE_BENCH_EVENTS      2000000
+#define TRACE_BENCH_THREADS     4
+
+BENCH(trace_record) {
+    nativeUseRealClock();
+    tracer.clear();
+
+    double eventNs = benchMeasureNs(TRACE_BENCH_EVENTS, [](size_t) {
+        TRACE_INSTANT("bench.instant");
+    });
+    double scopeNs = benchMeasureNs(TRACE_BENCH_EVENTS / 2, [](size_t) {
+        TRACE_SCOPE("bench.scope");
+    });
+    benchReport("TRACE_INSTANT", eventNs, "ns/event");
+    benchReport("TRACE_SCOPE (B + E)", scopeNs, "ns/scope");
+
+    // Eşzamanlı yazarlar: her biri kendi adıyla kayıtlı, halka paylaşımlı
+    tracer.clear();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < TRACE_BENCH_THREADS; t++) {
+        threads.emplace_back([t]() {
+            static const char* const names[TRACE_BENCH_THREADS] = { "audio", "dac_writer", "prefetch", "async_tcp" };
+            nativeSetTaskName(names[t]);
+            for (uint32_t i = 0; i < TRACE_BENCH_EVENTS / TRACE_BENCH_THREADS; i++) {
+                TRACE_SCOPE(names[t]);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    uint8_t core = (uint8_t)xPortGetCoreID();
+    uint32_t unreadable = 0;
+    uint32_t foreign = 0;
+    TraceRecord record;
+    for (uint32_t i = tracer.firstIndex(core); i < tracer.endIndex(core); i++) {
+        if (!tracer.read(core, i, record)) {
+            unreadable++;
+            continue;
+        }
+        const char* task = tracer.taskName(record.task);
+        if (!task || strcmp(task, record.name) != 0) foreign++;
+    }
+    benchReport("4 writers: unreadable slots", unreadable, "");
+    benchReport("4 writers: event/task mismatches", foreign, "");
+
+    // Oynatma başına olay: DAC burst'ü ve ConsumeSamples (her biri B/E),
+    // decode + pump adımları (audio task ~1 ms'de bir), SD okuması
+    double bursts = 1e6 / DacOutputStage::burstPeriodUs(44100);
+    double eventsPerSecond = 2 * bursts + 2 * bursts + 2 * 2 * 1000 + 2 * 20;
+    benchReport("events per second of 44.1 kHz playback", eventsPerSecond, "");
+    benchReport("ring history per core", TRACE_RING_EVENTS / eventsPerSecond * 1000, "ms");
+    benchReport("DAC path cost per second of 44.1 kHz", scopeNs * 2 * bursts / 1000.0, "us");
+    benchReport("ring memory", sizeof(Tracer), "bytes");
+    tracer.clear();
+}
+
+static std::string render(size_t chunk, size_t* chunks) {
+    TraceStream stream(tracer);
+    std::string out;
+    std::vector<uint8_t> buffer(chunk);
+    size_t n;
+    *chunks = 0;
+    while ((n = stream.fill(buffer.data(), buffer.size())) > 0) {
+        out.append((const char*)buffer.data(), n);
+        (*chunks)++;
+    }
+    return out;
+}
+
+static long fieldNumber(const std::string& line, const char* key) {
+    size_t pos = line.find(key);
+    return pos == std::string::npos ? -1 : strtol(line.c_str() + pos + strlen(key), nullptr, 10);
+}
+
+// Satır başına bir olay nesnesi; task başına B/E derinliği asla negatife
+// düşmez (halka başındaki yetim E'ler ayrıca sayılır) ve ts artar. Core
+// halkasındaki sıra task'lar arasında zamana göre değildir (yer ayıran
+// task damgadan önce kesilebilir), Chrome olayları kendisi sıralar.
+static uint32_t validate(const std::string& text, uint32_t* events, uint32_t* orphans) {
+    uint32_t errors = 0;
+    *events = 0;
+    *orphans = 0;
+    if (text.compare(0, 1, "{") != 0 || text.find("\"traceEvents\":[") == std::string::npos) errors++;
+    if (text.size() < 3 || text.compare(text.size() - 3, 3, "}}\n") != 0) errors++;
+
+    std::map<long, int> depth;
+    std::map<long, long> lastTs;
+    size_t pos = text.find('\n') + 1;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) break;
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.compare(0, 1, "]") == 0) break;
+        if (!line.empty() && line.back() == ',') line.pop_back();
+        int braces = 0;
+        for (char c : line) braces += (c == '{') - (c == '}');
+        if (line.compare(0, 1, "{") != 0 || braces != 0) {
+            errors++;
+            continue;
+        }
+        long tid = fieldNumber(line, "\"tid\":");
+        if (line.find("\"ph\":\"M\"") != std::string::npos) continue;
+
+        (*events)++;
+        long ts = fieldNumber(line, "\"ts\":");
+        if (lastTs.count(tid) && ts < lastTs[tid]) errors++;
+        lastTs[tid] = ts;
+        if (line.find("\"ph\":\"B\"") != std::string::npos) {
+            depth[tid]++;
+        } else if (line.find("\"ph\":\"E\"") != std::string::npos) {
+            if (depth[tid] == 0) {
+                (*orphans)++;
+            } else {
+                depth[tid]--;
+            }
+        }
+    }
+    return errors;
+}
+
+// Bir task'ın işi: her `periodUs`'de bir kapsam, toplam `durationUs`
+static void playTask(const char* task, const char* const* scopes, size_t depth,
+                     uint32_t periodUs, uint32_t workUs, uint32_t durationUs) {
+    nativeSetTaskName(task);
+    uint32_t start = micros();
+    uint32_t next = start;
+    while (micros() - start < durationUs) {
+        while ((int32_t)(micros() - next) < 0) std::this_thread::yield();
+        next += periodUs;
+        for (size_t i = 0; i < depth; i++) TRACE_BEGIN(scopes[i]);
+        uint32_t began = micros();
+        while (micros() - began < workUs) {}
+        for (size_t i = depth; i > 0; i--) TRACE_END(scopes[i - 1]);
+    }
+}
+
+BENCH(trace_export) {
+    nativeUseRealClock();
+    tracer.clear();
+
+    // 100 ms oynatma, dört task eşzamanlı: DAC burst'ü periyodunda bir,
+    // decode 1 ms'de bir, SD okuması 25 ms'de bir, HTTP handler 40 ms'de bir.
+    // Host'ta hepsi aynı "core" halkasına yazar.
+    static const char* const dacScopes[] = { "dac.burst" };
+    static const char* const audioScopes[] = { "decode", "dac.consume" };
+    static const char* const prefetchScopes[] = { "sd.read" };
+    static const char* const httpScopes[] = { "/api/status", "status.serialize" };
+    uint32_t burstPeriod = DacOutputStage::burstPeriodUs(44100);
+    std::vector<std::thread> threads;
+    threads.emplace_back(playTask, "dac_writer", dacScopes, 1, burstPeriod, 80, 100000);
+    threads.emplace_back(playTask, "audio", audioScopes, 2, 1000, 150, 100000);
+    threads.emplace_back(playTask, "prefetch", prefetchScopes, 1, 25000, 2000, 100000);
+    threads.emplace_back(playTask, "async_tcp", httpScopes, 2, 40000, 300, 100000);
+    for (auto& thread : threads) thread.join();
+
+    size_t bigChunks = 0, smallChunks = 0;
+    std::string whole = render(1 << 20, &bigChunks);
+    std::string chunked = render(536, &smallChunks);
+    uint32_t events = 0, orphans = 0;
+    uint32_t errors = validate(chunked, &events, &orphans);
+
+    double renderUs = benchMeasureNs(20, [](size_t) {
+        size_t chunks;
+        render(1436, &chunks);
+    }) / 1000.0;
+
+    benchReport("events in body", events, "");
+    benchReport("body size", whole.size(), "bytes");
+    benchReport("render time (1436-byte chunks)", renderUs, "us");
+    benchReport("chunks at 536 bytes", smallChunks, "");
+    benchReport("stream state (heap per request)", sizeof(TraceStream), "bytes");
+    benchReport("chunked == one-shot", chunked == whole ? 1 : 0, "");
+    benchReport("orphan E at ring start", orphans, "");
+    benchReport("invalid lines / order errors", errors, "");
+    benchReport("events dropped while exporting", tracer.getDropped(), "");
+
+    if (const char* path = getenv("TRACE_BENCH_OUT")) {
+        FILE* f = fopen(path, "w");
+        if (f) {
+            fwrite(whole.data(), 1, whole.size(), f);
+            fclose(f);
+        }
+    }
+    tracer.clear();
+}
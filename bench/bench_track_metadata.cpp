@@ -0,0 +1,406 @@
+// Parça süresi ve etiketleri (env:native).
+//
+// track_metadata: sentetik dosyalar (ID3v2.3 UTF-16 + Xing, ID3v1'li CBR,
+// VBRI, LIST/INFO'lu WAV, moov'u sonda M4A, ADTS) üretilir; okunan süre
+// ve etiketler beklenenle karşılaştırılır. Simüle SD gecikmesiyle dosya
+// başına ayrıştırma maliyeti, ilk tarama ile değişmemiş dosyaların
+// indeksten alındığı tekrar taraması, çalma sırasında sürenin indeksten
+// okunması ile eski yöntemin (VBR dosyasında bütün frame'leri yürümek)
+// farkı ve /api/playlist?meta=1 gövdesinin boyutu raporlanır.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <string>
+#include <vector>
+#include "BenchRunner.h"
+#include "LibraryIndex.h"
+#include "PlaylistStream.h"
+#include "TrackMetadata.h"
+
+#define META_BENCH_CALL_US      1200
+#define META_BENCH_KB_US        400
+#define META_BENCH_OPEN_US      30000
+#define META_BENCH_LIBRARY      200
+
+typedef std::vector<uint8_t> Bytes;
+
+static void putBe32(Bytes& b, uint32_t v) {
+    for (int s = 24; s >= 0; s -= 8) b.push_back((uint8_t)(v >> s));
+}
+
+static void putLe16(Bytes& b, uint16_t v) {
+    b.push_back(v & 0xFF);
+    b.push_back(v >> 8);
+}
+
+static void putLe32(Bytes& b, uint32_t v) {
+    putLe16(b, v & 0xFFFF);
+    putLe16(b, v >> 16);
+}
+
+static void putText(Bytes& b, const char* text) {
+    b.insert(b.end(), text, text + strlen(text));
+}
+
+static void putSyncsafe(Bytes& b, uint32_t v) {
+    for (int s = 21; s >= 0; s -= 7) b.push_back((v >> s) & 0x7F);
+}
+
+static void id3Frame(Bytes& tag, const char* id, const Bytes& body) {
+    putText(tag, id);
+    putBe32(tag, body.size());
+    tag.push_back(0);
+    tag.push_back(0);
+    tag.insert(tag.end(), body.begin(), body.end());
+}
+
+// ID3v2.3: başlık UTF-16 (BOM'lu), sanatçı ISO-8859-1, araya büyük bir APIC
+static Bytes id3v23() {
+    Bytes frames;
+    Bytes title = { 1, 0xFF, 0xFE };
+    static const uint16_t units[] = { 0x00C7, 'a', 'l', 'g', 0x0131, ' ', 'H', 'a', 'v', 'a', 's', 0x0131 };
+    for (uint16_t u : units) putLe16(title, u);
+    id3Frame(frames, "TIT2", title);
+    Bytes picture(20000, 0xFF);
+    picture[0] = 0;
+    id3Frame(frames, "APIC", picture);
+    Bytes artist = { 0 };
+    putText(artist, "Sezen Aksu");
+    artist.push_back(0xE7);     // ç, Latin-1
+    id3Frame(frames, "TPE1", artist);
+    frames.resize(frames.size() + 512, 0);     // padding
+
+    Bytes tag;
+    putText(tag, "ID3");
+    tag.push_back(3);
+    tag.push_back(0);
+    tag.push_back(0);
+    putSyncsafe(tag, frames.size());
+    tag.insert(tag.end(), frames.begin(), frames.end());
+    return tag;
+}
+
+// MPEG1 Layer III, 44.1 kHz, stereo; 128 kbps frame'i 417 byte
+static void mp3Frame(Bytes& b, uint8_t bitrateIndex) {
+    static const uint16_t rates[15] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+    size_t length = 144 * rates[bitrateIndex] * 1000 / 44100;
+    size_t start = b.size();
+    b.resize(start + length, 0x55);
+    b[start] = 0xFF;
+    b[start + 1] = 0xFB;
+    b[start + 2] = bitrateIndex << 4;
+    b[start + 3] = 0x00;
+}
+
+// VBR gövdesi: bit hızı frame'den frame'e değişir
+static void vbrFrames(Bytes& b, uint32_t frames) {
+    for (uint32_t i = 0; i < frames; i++) mp3Frame(b, 5 + (i * 7) % 9);
+}
+
+static Bytes mp3Xing(uint32_t frames) {
+    Bytes b = id3v23();
+    size_t first = b.size();
+    mp3Frame(b, 9);
+    size_t audioStart = first;
+    vbrFrames(b, frames);
+    uint8_t* xing = &b[first + 4 + 32];
+    memcpy(xing, "Xing", 4);
+    Bytes fields;
+    putBe32(fields, 3);
+    putBe32(fields, frames);
+    putBe32(fields, b.size() - audioStart);
+    memcpy(xing + 4, fields.data(), fields.size());
+    return b;
+}
+
+static Bytes mp3Vbri(uint32_t frames) {
+    Bytes b;
+    mp3Frame(b, 9);
+    vbrFrames(b, frames);
+    Bytes fields;
+    putBe32(fields, b.size());
+    putBe32(fields, frames);
+    memcpy(&b[36], "VBRI", 4);
+    memcpy(&b[36 + 10], fields.data(), fields.size());
+    return b;
+}
+
+static Bytes mp3CbrId3v1(uint32_t frames) {
+    Bytes b;
+    b.resize(300, 0);           // bozuk etiket artığı; sahte senkron içerir
+    b[100] = 0xFF;
+    b[101] = 0xFB;
+    b[102] = 0x90;
+    for (uint32_t i = 0; i < frames; i++) mp3Frame(b, 9);
+    Bytes tag(128, 0);
+    memcpy(tag.data(), "TAG", 3);
+    memcpy(tag.data() + 3, "Gesi Ba\xF0lar\xFD", 12);   // Windows-1254
+    memcpy(tag.data() + 33, "Anonim", 6);
+    memcpy(tag.data() + 63, "T\xFCrk\xFCler", 8);
+    b.insert(b.end(), tag.begin(), tag.end());
+    return b;
+}
+
+static Bytes wavInfo(uint32_t seconds) {
+    Bytes info;
+    putText(info, "INFO");
+    const char* items[3][2] = { { "INAM", "Uzun İnce Bir Yol" }, { "IART", "Aşık Veysel" }, { "IPRD", "Kara Toprak" } };
+    for (auto& item : items) {
+        uint32_t length = strlen(item[1]) + 1;
+        putText(info, item[0]);
+        putLe32(info, length);
+        putText(info, item[1]);
+        info.push_back(0);
+        if (length & 1) info.push_back(0);
+    }
+
+    Bytes b;
+    putText(b, "RIFF");
+    putLe32(b, 0);
+    putText(b, "WAVE");
+    putText(b, "fmt ");
+    putLe32(b, 16);
+    putLe16(b, 1);
+    putLe16(b, 2);
+    putLe32(b, 44100);
+    putLe32(b, 44100 * 4);
+    putLe16(b, 4);
+    putLe16(b, 16);
+    putText(b, "LIST");
+    putLe32(b, info.size());
+    b.insert(b.end(), info.begin(), info.end());
+    putText(b, "data");
+    putLe32(b, seconds * 44100 * 4);
+    b.resize(b.size() + seconds * 44100 * 4, 0);
+    uint32_t riff = b.size() - 8;
+    memcpy(&b[4], &riff, 4);
+    return b;
+}
+
+static void atom(Bytes& b, const char* type, const Bytes& body) {
+    putBe32(b, body.size() + 8);
+    putText(b, type);
+    b.insert(b.end(), body.begin(), body.end());
+}
+
+static Bytes ilstItem(const char* type, const char* text) {
+    Bytes data;
+    putBe32(data, 1);           // UTF-8
+    putBe32(data, 0);
+    putText(data, text);
+    Bytes wrapped;
+    atom(wrapped, "data", data);
+    Bytes item;
+    putBe32(item, wrapped.size() + 8);
+    item.push_back(0xA9);
+    putText(item, type);
+    item.insert(item.end(), wrapped.begin(), wrapped.end());
+    return item;
+}
+
+// ftyp, büyük mdat, sonra moov (mvhd v0 + udta/meta/ilst)
+static Bytes m4aMoovAtEnd(uint32_t durationMs) {
+    Bytes b;
+    Bytes ftyp;
+    putText(ftyp, "M4A ");
+    putBe32(ftyp, 0);
+    atom(b, "ftyp", ftyp);
+    atom(b, "mdat", Bytes(durationMs * 16, 0x11));    // ~128 kbps
+
+    Bytes mvhd(100, 0);
+    mvhd[15] = 0xE8;            // timescale 1000
+    mvhd[14] = 0x03;
+    mvhd[16] = durationMs >> 24;
+    mvhd[17] = durationMs >> 16;
+    mvhd[18] = durationMs >> 8;
+    mvhd[19] = durationMs;
+    Bytes ilst;
+    Bytes items = ilstItem("nam", "Bir Başkadır");
+    Bytes artist = ilstItem("ART", "Mor ve Ötesi");
+    items.insert(items.end(), artist.begin(), artist.end());
+    atom(ilst, "ilst", items);
+    Bytes hdlr(25, 0);
+    memcpy(&hdlr[8], "mdir", 4);
+    Bytes meta(4, 0);
+    atom(meta, "hdlr", hdlr);
+    meta.insert(meta.end(), ilst.begin(), ilst.end());
+    Bytes udta;
+    atom(udta, "meta", meta);
+    Bytes moov;
+    atom(moov, "mvhd", mvhd);
+    atom(moov, "udta", udta);
+    atom(b, "moov", moov);
+    return b;
+}
+
+// 44.1 kHz AAC-LC, frame başına 1024 örnek, 372 byte
+static Bytes adts(uint32_t frames) {
+    Bytes b;
+    const uint32_t length = 372;
+    for (uint32_t i = 0; i < frames; i++) {
+        size_t start = b.size();
+        b.resize(start + length, 0x21);
+        b[start] = 0xFF;
+        b[start + 1] = 0xF1;
+        b[start + 2] = (1 << 6) | (4 << 2);
+        b[start + 3] = 0x80 | (length >> 11);
+        b[start + 4] = (length >> 3) & 0xFF;
+        b[start + 5] = ((length & 7) << 5) | 0x1F;
+        b[start + 6] = 0xFC;
+    }
+    return b;
+}
+
+static void writeFile(const char* dir, const char* name, const Bytes& data) {
+    std::string path = std::string(dir) + name;
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return;
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+struct MetaCase {
+    const char* name;
+    uint8_t format;
+    uint32_t expectedMs;
+    const char* title;
+    const char* artist;
+    const char* album;
+};
+
+// Eski yol: süre için bütün frame başlıklarını yürümek (VBR'de tek doğru yol)
+static uint32_t walkFramesMs(File& file) {
+    uint32_t start = 0;
+    uint8_t header[10];
+    if (file.seek(0) && file.read(header, 10) == 10 && memcmp(header, "ID3", 3) == 0) {
+        start = 10 + (((uint32_t)header[6] << 21) | ((uint32_t)header[7] << 14) | ((uint32_t)header[8] << 7) | header[9]);
+    }
+    uint64_t samples = 0;
+    uint32_t sampleRate = 44100;
+    uint32_t pos = start;
+    while (pos + 4 <= file.size()) {
+        uint8_t h[4];
+        Mp3FrameHeader frame;
+        if (!file.seek(pos) || file.read(h, 4) != 4 || !TrackMetadata::parseMp3Header(h, frame)) break;
+        samples += frame.samplesPerFrame;
+        sampleRate = frame.sampleRate;
+        pos += frame.frameLength;
+    }
+    return (uint32_t)(samples * 1000 / sampleRate);
+}
+
+static void setSdLatency(bool enabled) {
+    fs::nativeSetReadLatency(enabled ? META_BENCH_CALL_US : 0, enabled ? META_BENCH_KB_US : 0);
+    fs::nativeSetOpenLatency(enabled ? META_BENCH_OPEN_US : 0);
+}
+
+BENCH(track_metadata) {
+    BenchSdRoot sd("/tmp/musicbox_meta_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+
+    const uint32_t vbrFrameCount = 2000;
+    const uint32_t vbrMs = (uint32_t)((uint64_t)vbrFrameCount * 1152 * 1000 / 44100);
+    writeFile(sd.path(), "/xing.mp3", mp3Xing(vbrFrameCount));
+    writeFile(sd.path(), "/vbri.mp3", mp3Vbri(vbrFrameCount));
+    writeFile(sd.path(), "/cbr.mp3", mp3CbrId3v1(500));
+    writeFile(sd.path(), "/info.wav", wavInfo(3));
+    writeFile(sd.path(), "/moov.m4a", m4aMoovAtEnd(5000));
+    writeFile(sd.path(), "/stream.aac", adts(400));
+
+    static const MetaCase cases[] = {
+        { "/xing.mp3", LIBRARY_FORMAT_MP3, vbrMs, "Çalgı Havası", "Sezen Aksuç", "" },
+        { "/vbri.mp3", LIBRARY_FORMAT_MP3, vbrMs, "", "", "" },
+        { "/cbr.mp3", LIBRARY_FORMAT_MP3, 500 * 417 * 8 / 128, "Gesi Bağları", "Anonim", "Türküler" },
+        { "/info.wav", LIBRARY_FORMAT_WAV, 3000, "Uzun İnce Bir Yol", "Aşık Veysel", "Kara Toprak" },
+        { "/moov.m4a", LIBRARY_FORMAT_M4A, 5000, "Bir Başkadır", "Mor ve Ötesi", "" },
+        { "/stream.aac", LIBRARY_FORMAT_AAC, 400 * 1024 * 1000 / 44100, "", "", "" },
+    };
+
+    // Doğruluk ve dosya başına okuma maliyeti (simüle SD)
+    uint32_t mismatches = 0;
+    setSdLatency(true);
+    nativeSetMicros(0);
+    for (const MetaCase& c : cases) {
+        File file = SD.open(c.name, FILE_READ);
+        TrackTags tags;
+        uint32_t before = micros();
+        bool ok = TrackMetadata::read(file, c.format, tags);
+        uint32_t cost = micros() - before;
+        file.close();
+        // ADTS ilk 16 KB'tan tahmin edilir; %1 pay
+        uint32_t tolerance = c.format == LIBRARY_FORMAT_AAC ? c.expectedMs / 100 : 1;
+        uint32_t error = tags.durationMs > c.expectedMs ? tags.durationMs - c.expectedMs : c.expectedMs - tags.durationMs;
+        bool match = ok && error <= tolerance && strcmp(tags.title, c.title) == 0 &&
+                     strcmp(tags.artist, c.artist) == 0 && strcmp(tags.album, c.album) == 0;
+        if (!match) mismatches++;
+        printf("  %-12s %7u ms %4u kbps %6.1f ms SD  %s | %s | %s%s\n", c.name + 1,
+               (unsigned)tags.durationMs, (unsigned)tags.bitrateKbps, cost / 1000.0,
+               tags.title, tags.artist, tags.album, match ? "" : "  <-- MISMATCH");
+    }
+    benchReport("mismatched files", mismatches, "");
+
+    // Eski yöntem: çalma başlarken VBR dosyasında süre için frame yürüyüşü
+    File vbr = SD.open("/xing.mp3", FILE_READ);
+    uint32_t before = micros();
+    uint32_t walkedMs = walkFramesMs(vbr);
+    uint32_t walkCost = micros() - before;
+    vbr.close();
+    benchReport("frame walk of VBR file (legacy)", walkCost / 1000.0, "ms SD");
+    benchReport("  walked duration", walkedMs, "ms");
+
+    // Kütüphane: ilk tarama hepsini ayrıştırır, ikincisi indeksten alır
+    for (uint32_t i = 0; i < META_BENCH_LIBRARY; i++) {
+        char album[16];
+        char name[48];
+        snprintf(album, sizeof(album), "/album_%02u", (unsigned)(i / 20));
+        snprintf(name, sizeof(name), "%s/track_%03u.mp3", album, (unsigned)i);
+        if (i % 20 == 0) SD.mkdir(album);
+        writeFile(sd.path(), name, i % 2 ? mp3Xing(600) : mp3CbrId3v1(300));
+    }
+    Preferences::nativeReset();
+    nativeSetMicros(0);
+    libraryIndex.rescan();
+    uint32_t firstScan = micros();
+    nativeSetMicros(0);
+    libraryIndex.rescan();
+    uint32_t secondScan = micros();
+    benchReport("first scan (parse every file)", firstScan / 1000.0, "ms SD");
+    benchReport("rescan (unchanged files reused)", secondScan / 1000.0, "ms SD");
+    benchReport("  parse cost per file", (double)(firstScan - secondScan) / (libraryIndex.size() * 1000.0), "ms SD");
+
+    // Çalma sırasında süre: indeksten, SD'ye dokunmadan
+    LibraryTrack track;
+    nativeSetMicros(0);
+    bool found = libraryIndex.findTrack("/xing.mp3", track);
+    benchReport("status duration from index", micros() / 1000.0, "ms SD");
+    benchReport("  indexed duration", found ? track.durationMs : 0, "ms");
+    setSdLatency(false);
+    nativeUseRealClock();
+    double lookupNs = benchMeasureNs(100000, [&](size_t) {
+        libraryIndex.findTrack("/album_05/track_105.mp3", track);
+    });
+    benchReport("findTrack (host CPU)", lookupNs, "ns");
+
+    // /api/playlist gövdesi: sadece yol ve meta=1
+    std::vector<uint8_t> buffer(1436);
+    size_t plainBytes = 0;
+    size_t metaBytes = 0;
+    {
+        PlaylistStream plain(libraryIndex, 0, 0);
+        size_t n;
+        while ((n = plain.fill(buffer.data(), buffer.size())) > 0) plainBytes += n;
+        PlaylistStream meta(libraryIndex, 0, 0, true);
+        while ((n = meta.fill(buffer.data(), buffer.size())) > 0) metaBytes += n;
+    }
+    benchReport("playlist body, paths only", plainBytes / (double)libraryIndex.size(), "bytes/entry");
+    benchReport("playlist body, meta=1", metaBytes / (double)libraryIndex.size(), "bytes/entry");
+    benchReport("index entry size", sizeof(LibraryEntry), "bytes");
+
+    PlaylistStream sample(libraryIndex, 0, 2, true);
+    char out[1024];
+    size_t n = sample.fill((uint8_t*)out, sizeof(out) - 1);
+    out[n] = 0;
+    printf("  sample page: %s\n", out);
+}
@@ -0,0 +1,162 @@
+// /api/stream parça akışı (env:native).
+//
+// track_stream_range: Range başlığı çözümleme tablosu.
+// track_stream_body: tüm dosya ve aralıklar MSS boyutlu fill'lerle okunup
+// kaynakla karşılaştırılır; sektör hizalı okuma oranı ve bağlantı başına
+// bellek (eski yol: dosyayı RAM'e almak).
+// track_stream_throttle: sanal saatte 10 s; bağlantı her ms'de en fazla
+// iki MSS alır, erteleme sonrası 20 ms (bir RTT) bekler. Boşta, çalarken ve
+// önden okuma tamponu her saniye 200 ms yarının altına indiğinde elde
+// edilen hız ve ertelemeler.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "TrackStream.h"
+
+static StreamPlayback simPlayback = { false, 0, 0 };
+
+static StreamPlayback simProbe() {
+    return simPlayback;
+}
+
+static std::vector<uint8_t> makeTrack(const char* path, size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t x = 12345;
+    for (auto& b : data) {
+        x = x * 1664525u + 1013904223u;
+        b = (uint8_t)(x >> 24);
+    }
+    File f = SD.open(path, FILE_WRITE);
+    f.write(data.data(), data.size());
+    f.close();
+    return data;
+}
+
+BENCH(track_stream_range) {
+    const uint32_t size = 1000;
+    const char* headers[] = {
+        nullptr, "bytes=0-499", "bytes=500-", "bytes=-100", "bytes=-5000", "bytes=900-5000",
+        "bytes=1000-", "bytes=-0", "bytes=5-2", "bytes=0-1,5-9", "items=0-1", "bytes=99999999999-",
+    };
+    const char* names[] = { "none", "ok", "unsatisfiable" };
+    printf("  size %u\n  %-22s %-14s %s\n", (unsigned)size, "header", "result", "range");
+    for (const char* header : headers) {
+        uint32_t start = 0, end = 0;
+        StreamRangeResult r = TrackStream::parseRange(header, size, start, end);
+        char range[32] = "-";
+        if (r == STREAM_RANGE_OK) snprintf(range, sizeof(range), "%u-%u", (unsigned)start, (unsigned)end);
+        printf("  %-22s %-14s %s\n", header ? header : "(yok)", names[r], range);
+    }
+}
+
+BENCH(track_stream_body) {
+    BenchSdRoot sd("/tmp/musicbox_ts_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    nativeUseRealClock();
+    TrackStream::setPlaybackProbe(simProbe);
+    simPlayback.active = false;
+
+    const size_t size = 3 * 1024 * 1024 + 777;
+    std::vector<uint8_t> source = makeTrack("/track.mp3", size);
+    const size_t mss = 1436;
+    std::vector<uint8_t> buffer(mss);
+
+    struct Case { const char* name; const char* header; };
+    const Case cases[] = {
+        { "whole file", nullptr },
+        { "first 64 KB", "bytes=0-65535" },
+        { "seek middle", "bytes=1500001-" },
+        { "last 1000", "bytes=-1000" },
+    };
+    printf("  %-12s %10s %8s %10s %9s\n", "case", "bytes", "reads", "aligned %", "match");
+    for (const Case& c : cases) {
+        TrackStream stream;
+        stream.open("/track.mp3");
+        uint32_t start = 0, end = size - 1;
+        if (TrackStream::parseRange(c.header, size, start, end) == STREAM_RANGE_OK) {
+            stream.setRange(start, end);
+        }
+        size_t got = 0, reads = 0, aligned = 0;
+        bool match = true;
+        size_t n;
+        while ((n = stream.fill(buffer.data(), buffer.size())) > 0 && n != STREAM_TRY_AGAIN) {
+            if (memcmp(buffer.data(), &source[start + got], n) != 0) match = false;
+            got += n;
+            reads++;
+            if ((start + got) % STREAM_SECTOR_SIZE == 0) aligned++;
+        }
+        match = match && got == end - start + 1 && stream.finished();
+        printf("  %-12s %10u %8u %10.1f %9s\n", c.name, (unsigned)got, (unsigned)reads,
+               reads ? 100.0 * aligned / reads : 0.0, match ? "yes" : "NO");
+    }
+
+    TrackStream* streams[STREAM_MAX_CONNECTIONS + 1];
+    size_t busy = 0;
+    for (size_t i = 0; i <= STREAM_MAX_CONNECTIONS; i++) {
+        streams[i] = new TrackStream();
+        if (streams[i]->open("/track.mp3") == STREAM_OPEN_BUSY) busy++;
+    }
+    benchReport("connections over limit rejected", busy, "");
+    for (TrackStream* s : streams) delete s;
+    benchReport("active after close", TrackStream::activeCount(), "");
+
+    benchReport("state per connection", sizeof(TrackStream) + sizeof(StreamConnection), "bytes");
+    benchReport("legacy (file in RAM)", size / 1024, "KB");
+    TrackStream::setPlaybackProbe(nullptr);
+}
+
+BENCH(track_stream_throttle) {
+    BenchSdRoot sd("/tmp/musicbox_ts_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    makeTrack("/long.wav", 32 * 1024 * 1024);
+    TrackStream::setPlaybackProbe(simProbe);
+
+    const size_t mss = 1436;
+    const uint64_t durationUs = 10 * 1000000ULL;
+    std::vector<uint8_t> buffer(mss);
+
+    struct Scenario { const char* name; bool playing; bool dips; };
+    const Scenario scenarios[] = {
+        { "idle", false, false },
+        { "playing", true, false },
+        { "playing + dips", true, true },
+    };
+    printf("  %-16s %10s %10s %16s\n", "scenario", "KB/s", "deferrals", "reads in dip");
+    for (const Scenario& s : scenarios) {
+        nativeSetMicros(1000000);
+        TrackStream stream;
+        stream.open("/long.wav");
+        uint32_t deferredBefore = TrackStream::getTotals().deferred;
+        size_t bytes = 0, dipReads = 0;
+        uint64_t retryAt = 0;
+        for (uint64_t t = 0; t < durationUs; t += 1000) {
+            nativeSetMicros(1000000 + t);
+            bool dip = s.dips && (t % 1000000) < 200000;
+            simPlayback.active = s.playing;
+            simPlayback.capacity = 64 * 1024;
+            simPlayback.fill = dip ? 20 * 1024 : 56 * 1024;
+            if (t < retryAt) continue;
+            for (int i = 0; i < 2; i++) {
+                size_t n = stream.fill(buffer.data(), buffer.size());
+                if (n == STREAM_TRY_AGAIN) {
+                    retryAt = t + 20000;
+                    break;
+                }
+                if (dip) dipReads++;
+                bytes += n;
+            }
+        }
+        printf("  %-16s %10.0f %10u %16u\n", s.name, bytes / 1024.0 / (durationUs / 1e6),
+               (unsigned)(TrackStream::getTotals().deferred - deferredBefore), (unsigned)dipReads);
+    }
+    benchReport("playing budget", STREAM_PLAYING_RATE / 1024, "KB/s");
+    simPlayback.active = false;
+    TrackStream::setPlaybackProbe(nullptr);
+    nativeUseRealClock();
+}
@@ -0,0 +1,177 @@
+// Upload yazma yolu (env:native).
+//
+// SD yazmaları native FS'in gecikme modeliyle simüle saatte maliyetlenir
+// (çağrı başına 1.5 ms + KB başına 0.6 ms, SPI SD kartın tipik değerleri).
+// Ağ 1436 byte'lık segmentleri 2 MB/s hızında getirir.
+//
+// upload_writer_legacy: her TCP chunk'ı async_tcp callback'inde doğrudan
+// SD'ye yazılır, callback yazma süresince bloklanır.
+// upload_writer_pipeline: UploadWriter; callback sadece kopyalar, writer
+// ayrı zaman çizgisinde 8 KB'lık yazmalar yapar, havuz dolunca TCP
+// penceresi kapanır. İki eşzamanlı upload içerik doğrulamasıyla çalışır.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "UploadWriter.h"
+
+#define UPLOAD_BENCH_SIZE       (2 * 1024 * 1024)
+#define UPLOAD_BENCH_MSS        1436
+#define UPLOAD_BENCH_NET_US     718         // 1436 B @ 2 MB/s
+#define UPLOAD_BENCH_CALL_US    1500
+#define UPLOAD_BENCH_KB_US      600
+
+// TCP penceresi modeli: hold() sonrası istemci release() gelene kadar susar
+class BenchFlowControl : public UploadFlowControl {
+public:
+    bool held = false;
+    uint32_t holds = 0;
+    virtual void hold() override { held = true; holds++; }
+    virtual void release() override { held = false; }
+};
+
+static uint8_t patternByte(size_t upload, size_t offset) {
+    return (uint8_t)((offset * 31 + upload * 7) ^ (offset >> 11));
+}
+
+static bool verifyFile(const char* path, size_t upload, size_t size) {
+    File f = SD.open(path, FILE_READ);
+    if (!f || f.size() != size) return false;
+    std::vector<uint8_t> data(size);
+    f.read(data.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] != patternByte(upload, i)) return false;
+    }
+    return true;
+}
+
+BENCH(upload_writer_legacy) {
+    BenchSdRoot sd("/tmp/musicbox_up_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    fs::nativeSetWriteLatency(UPLOAD_BENCH_CALL_US, UPLOAD_BENCH_KB_US);
+    nativeSetMicros(0);
+
+    uint8_t chunk[UPLOAD_BENCH_MSS];
+    uint64_t t = 0;
+    uint64_t blocked = 0;
+    uint64_t maxBlocked = 0;
+    File file = SD.open("/legacy.mp3", FILE_WRITE);
+    for (size_t offset = 0; offset < UPLOAD_BENCH_SIZE; offset += UPLOAD_BENCH_MSS) {
+        size_t len = min((size_t)UPLOAD_BENCH_MSS, (size_t)(UPLOAD_BENCH_SIZE - offset));
+        for (size_t i = 0; i < len; i++) chunk[i] = patternByte(0, offset + i);
+
+        // Segment, callback önceki yazmadan dönmeden işlenemez
+        t += UPLOAD_BENCH_NET_US;
+        if (micros() > t) t = micros();
+        nativeSetMicros(t);
+
+        file.write(chunk, len);
+        uint64_t spent = micros() - t;
+        blocked += spent;
+        if (spent > maxBlocked) maxBlocked = spent;
+        t = micros();
+    }
+    file.close();
+    fs::nativeSetWriteLatency(0, 0);
+
+    benchReport("2 MB upload, direct SD writes", (double)UPLOAD_BENCH_SIZE / t, "MB/s");
+    benchReport("  async_tcp blocked in SD write", blocked / 1000.0, "ms");
+    benchReport("  longest single stall", maxBlocked / 1000.0, "ms");
+    benchReport("  SD write calls", (double)((UPLOAD_BENCH_SIZE + UPLOAD_BENCH_MSS - 1) / UPLOAD_BENCH_MSS), "");
+    nativeUseRealClock();
+}
+
+BENCH(upload_writer_pipeline) {
+    BenchSdRoot sd("/tmp/musicbox_up_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    fs::nativeSetWriteLatency(UPLOAD_BENCH_CALL_US, UPLOAD_BENCH_KB_US);
+    nativeSetMicros(0);
+    uploadWriter.resetStats();
+
+    const int uploads = 2;
+    const char* paths[uploads] = { "/a.mp3", "/b.mp3" };
+    int keys[uploads];
+    BenchFlowControl* flows[uploads];
+    size_t offsets[uploads] = { 0, 0 };
+    for (int u = 0; u < uploads; u++) {
+        flows[u] = new BenchFlowControl();
+        uploadWriter.open(&keys[u], paths[u], UPLOAD_BENCH_SIZE, flows[u]);
+    }
+
+    // Writer kendi zaman çizgisinde: her iş başladığı andan maliyeti kadar sürer
+    uint64_t t = 0;
+    uint64_t writerBusy = 0;
+    auto drain = [&](uint64_t until) {
+        while (writerBusy <= until) {
+            nativeSetMicros(writerBusy);
+            if (!uploadWriter.process()) {
+                writerBusy = until;
+                break;
+            }
+            writerBusy = micros();
+        }
+        nativeSetMicros(until);
+    };
+
+    uint8_t chunk[UPLOAD_BENCH_MSS];
+    uint64_t producerNs = 0;
+    uint32_t chunks = 0;
+    bool ok = true;
+    bool remaining = true;
+    while (remaining) {
+        remaining = false;
+        for (int u = 0; u < uploads; u++) {
+            if (offsets[u] >= UPLOAD_BENCH_SIZE) continue;
+            remaining = true;
+
+            // Pencere kapalıysa istemci writer bir tampon boşaltana kadar bekler
+            while (flows[u]->held) {
+                t = max(t, writerBusy);
+                drain(t);
+            }
+
+            size_t len = min((size_t)UPLOAD_BENCH_MSS, (size_t)(UPLOAD_BENCH_SIZE - offsets[u]));
+            for (size_t i = 0; i < len; i++) chunk[i] = patternByte(u, offsets[u] + i);
+
+            t += UPLOAD_BENCH_NET_US / uploads;
+            drain(t);
+
+            auto start = std::chrono::steady_clock::now();
+            ok &= uploadWriter.write(&keys[u], chunk, len);
+            producerNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            chunks++;
+            offsets[u] += len;
+        }
+    }
+
+    UploadResult results[uploads];
+    for (int u = 0; u < uploads; u++) {
+        uploadWriter.close(&keys[u]);
+    }
+    nativeSetMicros(max(t, writerBusy));
+    while (uploadWriter.process()) {
+    }
+    t = micros();
+    for (int u = 0; u < uploads; u++) {
+        results[u] = uploadWriter.poll(&keys[u]);
+        ok &= results[u] == UPLOAD_OK && verifyFile(paths[u], u, UPLOAD_BENCH_SIZE);
+    }
+    fs::nativeSetWriteLatency(0, 0);
+
+    const UploadStats& stats = uploadWriter.getStats();
+    benchReport("2x2 MB concurrent uploads", (double)uploads * UPLOAD_BENCH_SIZE / t, "MB/s");
+    benchReport("  SD write throughput", uploadWriter.getWriteMBps(), "MB/s");
+    benchReport("  async_tcp cost per chunk (copy)", (double)producerNs / chunks, "ns");
+    benchReport("  SD write calls", (double)stats.writes, "");
+    benchReport("  slowest SD write", stats.maxWriteUs / 1000.0, "ms");
+    benchReport("  backpressure holds", (double)stats.backpressureHolds, "");
+    benchReport("  pool overflows", (double)stats.poolOverflows, "");
+    benchReport("  files intact", ok ? 1 : 0, "");
+    nativeUseRealClock();
+}
@@ -0,0 +1,139 @@
+// Ses seviyesi güncellemeleri (env:native).
+//
+// volume_drag: 1 saniyelik bir slider sürüklemesinde Web, WebSocket ve
+// MQTT'den toplam 300 güncelleme gelir; decoder 26 ms'lik çerçeveler
+// çözer. Eski yolda /api/volume 50 ms içindeki istekleri atar, diğer
+// kaynaklar her değeri hemen uygular. Yeni yolda hepsi CoalescingSlot'a
+// yazılır, çerçeve sınırında son değer uygulanır. Sürükleme sonunda
+// uygulanan değerin son gönderilen değer olup olmadığı raporlanır.
+//
+// volume_ramp: sabit bir sinyalde ses 20'den 100'e çıkarılır; DAC
+// kodunda ardışık iki örnek arasındaki en büyük sıçrama (zipper/click)
+// kazanç adımıyla ve rampayla karşılaştırılır.
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "CoalescingSlot.h"
+#include "SampleKernel.h"
+
+#define DRAG_BENCH_UPDATES      300
+#define DRAG_BENCH_SPAN_US      1000000
+#define DRAG_BENCH_FRAME_US     26122
+#define DRAG_BENCH_WEB_GAP_MS   50      // eski /api/volume sınırı
+
+enum DragSource { SOURCE_WEB = 0, SOURCE_WS, SOURCE_MQTT };
+
+struct DragUpdate {
+    uint32_t at;
+    DragSource source;
+    int volume;
+};
+
+// Slider 10'dan 90'a sürüklenir; kaynaklar sırayla, düzensiz aralıklarla
+static std::vector<DragUpdate> makeDrag() {
+    std::vector<DragUpdate> updates;
+    srand(7);
+    uint32_t t = 0;
+    for (int i = 0; i < DRAG_BENCH_UPDATES; i++) {
+        t += 1000 + rand() % (2 * DRAG_BENCH_SPAN_US / DRAG_BENCH_UPDATES - 1000);
+        int volume = 10 + (80 * (i + 1)) / DRAG_BENCH_UPDATES;
+        // Son güncelleme Web slider'ından gelir
+        updates.push_back({ t, (DragSource)((DRAG_BENCH_UPDATES - 1 - i) % 3), volume });
+    }
+    return updates;
+}
+
+static void report(const char* label, uint32_t applied, int finalVolume, int lastSent) {
+    benchReport(label, applied, "volume operations");
+    benchReport("  final volume", finalVolume, "");
+    benchReport("  final == last sent", finalVolume == lastSent ? 1 : 0, "");
+}
+
+BENCH(volume_drag) {
+    std::vector<DragUpdate> updates = makeDrag();
+    int lastSent = updates.back().volume;
+
+    // Eski yol: Web'de static lastVolumeUpdate, diğer kaynaklarda sınır yok
+    uint32_t applied = 0;
+    int current = 50;
+    uint32_t lastWeb = 0;
+    bool webSeen = false;
+    for (const DragUpdate& u : updates) {
+        if (u.source == SOURCE_WEB) {
+            uint32_t now = u.at / 1000;
+            if (webSeen && now - lastWeb < DRAG_BENCH_WEB_GAP_MS) continue;
+            lastWeb = now;
+            webSeen = true;
+        }
+        current = u.volume;
+        applied++;
+    }
+    report("rate-limited /api/volume + direct", applied, current, lastSent);
+
+    // Yeni yol: son yazan kazanır, çerçeve sınırında uygulanır
+    CoalescingSlot slot;
+    applied = 0;
+    current = 50;
+    size_t next = 0;
+    uint32_t frameEnd = DRAG_BENCH_FRAME_US;
+    while (next < updates.size() || frameEnd <= updates.back().at + DRAG_BENCH_FRAME_US) {
+        while (next < updates.size() && updates[next].at < frameEnd) {
+            slot.post(updates[next].volume);
+            next++;
+        }
+        int32_t value;
+        if (slot.take(value)) {
+            current = value;
+            applied++;
+        }
+        frameEnd += DRAG_BENCH_FRAME_US;
+    }
+    report("coalesced at frame boundaries", applied, current, lastSent);
+    benchReport("  superseded before apply", slot.getSuperseded(), "");
+}
+
+static int maxCodeStep(SampleKernel& kernel, bool ramp) {
+    const size_t frames = 2048;
+    std::vector<int16_t> input(frames * 2, 8000);
+    std::vector<uint16_t> codes(frames);
+
+    kernel.setGainQ15((20 * SAMPLE_KERNEL_UNITY_Q15) / 100);
+    kernel.convert(input.data(), codes.data(), 64);
+    uint16_t previous = codes[63];
+
+    // Çıkış katı değişikliği 64 frame'lik bloklar arasında görür
+    if (ramp) {
+        kernel.setVolume(100);
+    } else {
+        kernel.setGainQ15(SAMPLE_KERNEL_UNITY_Q15);
+    }
+    int maxStep = 0;
+    for (size_t done = 0; done < frames; done += 64) {
+        kernel.convert(input.data() + 2 * done, codes.data() + done, 64);
+    }
+    for (size_t i = 0; i < frames; i++) {
+        maxStep = max(maxStep, abs((int)codes[i] - (int)previous));
+        previous = codes[i];
+    }
+    return maxStep;
+}
+
+BENCH(volume_ramp) {
+    SampleKernel stepKernel;
+    SampleKernel rampKernel;
+    benchReport("20 -> 100 as gain step", maxCodeStep(stepKernel, false), "LSB max jump");
+    benchReport("20 -> 100 with gain ramp", maxCodeStep(rampKernel, true), "LSB max jump");
+    benchReport("  ramp length", SAMPLE_KERNEL_RAMP_FRAMES, "frames");
+
+    // Rampa bitince blok yolu sabit kazançla devam etmeli
+    const size_t frames = 1 << 16;
+    std::vector<int16_t> input(frames * 2, 1234);
+    std::vector<uint16_t> codes(frames);
+    double ns = benchMeasureNs(20, [&](size_t) {
+        rampKernel.convert(input.data(), codes.data(), frames);
+    });
+    benchReport("  steady-state convert", ns / frames, "ns/frame");
+    benchKeep(codes[frames / 2]);
+}
@@ -0,0 +1,338 @@
+// WAV PCM yolu (env:native).
+//
+// wav_decoder_formats: 8/16/24 bit, mono/stereo dosyalar WavDecoder ile
+// GaplessLane'e çözülür; çıkan 16-bit stereo örnekler beklenenle, byte
+// konumuna seek sonrası ilk örnek de dosyadaki frame ile karşılaştırılır.
+//
+// wav_decoder_cpu: bir saniyelik sesin CPU maliyeti. Üç yol aynı kaynaktan
+// (AudioFileSourcePrefetch, hizalı 4 KB SD okumaları) aynı şeride yazar:
+//   fast path    WavDecoder: blok okuma + toplu ConsumeSamples
+//   generic      ESP8266Audio AudioGeneratorWAV'ın yapısı: 128 byte'lık
+//                tampondan byte byte okuma, örnek başına ConsumeSample
+//                (24 bit desteklemez)
+//   mp3 plumbing MP3 yolunun decode dışı kısmı: 1152 örneklik sentez
+//                çerçevesi, örnek başına ConsumeSample. Host'ta MP3
+//                decoder'ı yok; libmad'in aritmetiği bunun üstüne eklenir,
+//                yani gerçek MP3 maliyeti bu satırdan yüksektir.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <vector>
+#include "BenchRunner.h"
+#include "AudioFileSourcePrefetch.h"
+#include "GaplessChain.h"
+#include "WavDecoder.h"
+
+#define WAV_BENCH_SECONDS   10
+
+struct WavBenchFile {
+    const char* path;
+    uint32_t rate;
+    uint16_t bits;
+    uint16_t channels;
+};
+
+static const WavBenchFile wavFiles[] = {
+    { "/s16_stereo_44k.wav", 44100, 16, 2 },
+    { "/s16_mono_22k.wav",   22050, 16, 1 },
+    { "/u8_stereo_22k.wav",  22050, 8,  2 },
+    { "/u8_mono_11k.wav",    11025, 8,  1 },
+    { "/s24_stereo_48k.wav", 48000, 24, 2 },
+    { "/s24_mono_32k.wav",   32000, 24, 1 },
+};
+
+// Kanal c, frame i'nin 24 bitlik değeri (üst 16 biti beklenen örnek)
+static int32_t sampleValue(size_t i, int c) {
+    return (int32_t)(((i * 2654435761u) >> 8) ^ (c ? 0x5A5A5A : 0)) & 0xFFFFFF;
+}
+
+static int16_t expected(const WavBenchFile& f, size_t i, int c) {
+    int32_t v = sampleValue(i, f.channels == 2 ? c : 0);
+    if (f.bits == 8) return (int16_t)((((int16_t)(v & 0xFF)) - 128) << 8);
+    if (f.bits == 16) return (int16_t)(v & 0xFFFF);
+    return (int16_t)(v >> 8);
+}
+
+static void put16(std::vector<uint8_t>& d, uint16_t v) { d.push_back(v & 0xFF); d.push_back(v >> 8); }
+static void put32(std::vector<uint8_t>& d, uint32_t v) { put16(d, v & 0xFFFF); put16(d, v >> 16); }
+
+static void writeWav(const WavBenchFile& f) {
+    size_t frames = (size_t)f.rate * WAV_BENCH_SECONDS;
+    uint16_t blockAlign = f.channels * f.bits / 8;
+    std::vector<uint8_t> d;
+    d.insert(d.end(), { 'R', 'I', 'F', 'F' });
+    put32(d, 0);
+    d.insert(d.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    put32(d, 16);
+    put16(d, 1);
+    put16(d, f.channels);
+    put32(d, f.rate);
+    put32(d, f.rate * blockAlign);
+    put16(d, blockAlign);
+    put16(d, f.bits);
+    // Atlanması gereken bir chunk (tek uzunluk, pad byte'lı)
+    d.insert(d.end(), { 'L', 'I', 'S', 'T' });
+    put32(d, 5);
+    d.insert(d.end(), { 'I', 'N', 'F', 'O', 0, 0 });
+    d.insert(d.end(), { 'd', 'a', 't', 'a' });
+    put32(d, (uint32_t)(frames * blockAlign));
+    for (size_t i = 0; i < frames; i++) {
+        for (int c = 0; c < f.channels; c++) {
+            int32_t v = sampleValue(i, c);
+            if (f.bits == 8) d.push_back(v & 0xFF);
+            else if (f.bits == 16) put16(d, v & 0xFFFF);
+            else { d.push_back(v & 0xFF); put16(d, (v >> 8) & 0xFFFF); }
+        }
+    }
+    uint32_t riff = (uint32_t)d.size() - 8;
+    memcpy(&d[4], &riff, 4);
+    File file = SD.open(f.path, FILE_WRITE);
+    file.write(d.data(), d.size());
+    file.close();
+}
+
+// Şeridi DAC gibi boşaltır; istenirse örnekleri karşılaştırır
+struct LaneDrain {
+    GaplessLane lane;
+    const WavBenchFile* check = nullptr;
+    size_t frame = 0;
+    size_t mismatches = 0;
+    uint64_t sink = 0;
+
+    LaneDrain() { lane.setLimit(GAPLESS_LANE_FRAMES); }
+
+    void drain() {
+        size_t n;
+        int16_t* data;
+        while ((data = lane.peek(n)) != nullptr && n > 0) {
+            if (check) {
+                for (size_t i = 0; i < n; i++) {
+                    if (data[2 * i] != expected(*check, frame + i, 0) ||
+                        data[2 * i + 1] != expected(*check, frame + i, 1)) {
+                        mismatches++;
+                    }
+                }
+            }
+            sink += data[0];
+            frame += n;
+            lane.consume(n);
+        }
+    }
+};
+
+// ESP8266Audio AudioGeneratorWAV'ın okuma/çıkış yapısı
+class GenericWavGenerator {
+private:
+    AudioFileSource& file;
+    AudioOutput* output = nullptr;
+    uint8_t buff[128];
+    uint16_t buffLen = 0;
+    uint16_t buffPtr = 0;
+    uint32_t availBytes = 0;
+    uint16_t bits = 16;
+    uint16_t channels = 2;
+    int16_t lastSample[2] = { 0, 0 };
+
+    bool getBufferedData(int bytes, void* dest) {
+        if (buffPtr >= buffLen) {
+            buffPtr = 0;
+            uint32_t toRead = availBytes > sizeof(buff) ? sizeof(buff) : availBytes;
+            buffLen = file.read(buff, toRead);
+            availBytes -= buffLen;
+        }
+        if (buffPtr >= buffLen) return false;
+        uint8_t* p = (uint8_t*)dest;
+        for (int i = 0; i < bytes; i++) {
+            if (buffPtr >= buffLen) return false;
+            p[i] = buff[buffPtr++];
+        }
+        return true;
+    }
+
+public:
+    explicit GenericWavGenerator(AudioFileSource& source) : file(source) {}
+
+    bool begin(const char* path, AudioOutput* out, const WavFormat& format) {
+        if (!file.open(path)) return false;
+        file.seek(format.dataStart, SEEK_SET);
+        availBytes = format.dataSize;
+        bits = format.bitsPerSample;
+        channels = format.channels;
+        buffLen = buffPtr = 0;
+        output = out;
+        output->SetRate(format.sampleRate);
+        output->SetBitsPerSample(bits);
+        output->SetChannels(channels);
+        return true;
+    }
+
+    bool loop() {
+        while (true) {
+            if (!output->ConsumeSample(lastSample)) return true;
+            for (int c = 0; c < channels; c++) {
+                if (bits == 8) {
+                    uint8_t v;
+                    if (!getBufferedData(1, &v)) return false;
+                    lastSample[c] = v;
+                } else if (bits == 16) {
+                    if (!getBufferedData(2, &lastSample[c])) return false;
+                } else {
+                    uint8_t v[3];
+                    if (!getBufferedData(3, v)) return false;
+                    lastSample[c] = (int16_t)(v[1] | (v[2] << 8));
+                }
+            }
+        }
+    }
+
+    void stop() { file.close(); }
+};
+
+static void makeFiles() {
+    for (const WavBenchFile& f : wavFiles) writeWav(f);
+}
+
+BENCH(wav_decoder_formats) {
+    BenchSdRoot sd("/tmp/musicbox_wav_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    makeFiles();
+    fs::nativeSetReadLatency(0, 0);
+    fs::nativeSetOpenLatency(0);
+
+    AudioFileSourcePrefetch source;
+    source.begin();
+    WavDecoder decoder(source);
+
+    printf("  %-22s %8s %10s %10s %10s\n", "file", "frames", "mismatch", "seek ok", "duration");
+    for (const WavBenchFile& f : wavFiles) {
+        LaneDrain drain;
+        drain.check = &f;
+        if (!decoder.begin(f.path, &drain.lane)) {
+            printf("  %-22s begin failed\n", f.path);
+            continue;
+        }
+        while (decoder.loop()) drain.drain();
+        drain.drain();
+
+        size_t frames = drain.frame;
+        size_t mismatches = drain.mismatches;
+
+        // Orta noktaya byte konumuyla atla (frame sınırına yuvarlanır); şerit
+        // dolana kadar çözülen örnekler o frame'den devam etmeli
+        const WavFormat& format = decoder.getFormat();
+        uint32_t target = format.dataSize / 2 + 1;
+        drain.frame = (target - target % format.blockAlign) / format.blockAlign;
+        drain.mismatches = 0;
+        size_t seekStart = drain.frame;
+        bool seekOk = decoder.seek(target) && decoder.loop();
+        drain.drain();
+        seekOk = seekOk && drain.mismatches == 0 && drain.frame > seekStart;
+        uint32_t positionMs = decoder.getPositionMs();
+        decoder.stop();
+
+        printf("  %-22s %8zu %10zu %10s %7u ms (at %u ms after seek)\n", f.path, frames, mismatches,
+               seekOk ? "yes" : "no", (unsigned)decoder.getDurationMs(), (unsigned)positionMs);
+    }
+}
+
+// MP3 yolunun decode dışı kısmı: çerçeve başına ~418 byte okuma (128 kbps),
+// 1152 örneklik çıkış, örnek başına ConsumeSample
+class Mp3Plumbing {
+private:
+    AudioFileSource& file;
+    AudioOutput* output = nullptr;
+    uint8_t frameData[418];
+    int16_t synth[1152 * 2];
+    size_t framePos = 1152;
+    size_t framesLeft = 0;
+
+public:
+    explicit Mp3Plumbing(AudioFileSource& source) : file(source) {}
+
+    bool begin(const char* path, AudioOutput* out, uint32_t seconds) {
+        if (!file.open(path)) return false;
+        output = out;
+        output->SetRate(44100);
+        framesLeft = (size_t)seconds * 44100 / 1152;
+        framePos = 1152;
+        memset(synth, 0, sizeof(synth));
+        return true;
+    }
+
+    bool loop() {
+        while (true) {
+            while (framePos < 1152) {
+                if (!output->ConsumeSample(&synth[2 * framePos])) return true;
+                framePos++;
+            }
+            if (framesLeft == 0) return false;
+            if (file.read(frameData, sizeof(frameData)) == 0) return false;
+            synth[0] = frameData[0];
+            framePos = 0;
+            framesLeft--;
+        }
+    }
+
+    void stop() { file.close(); }
+};
+
+template <typename Decoder>
+static double decodeSeconds(Decoder& decoder, LaneDrain& drain) {
+    auto start = std::chrono::steady_clock::now();
+    while (decoder.loop()) drain.drain();
+    drain.drain();
+    decoder.stop();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+BENCH(wav_decoder_cpu) {
+    BenchSdRoot sd("/tmp/musicbox_wavcpu_XXXXXX");
+    if (!sd.ok()) {
+        return;
+    }
+    makeFiles();
+    fs::nativeSetReadLatency(0, 0);
+    fs::nativeSetOpenLatency(0);
+
+    AudioFileSourcePrefetch source;
+    source.begin();
+
+    printf("  host us of CPU per second of audio (median of %d)\n", BENCH_REPEATS);
+    printf("  %-22s %12s %12s %14s %8s\n", "file", "fast path", "generic", "mp3 plumbing", "speedup");
+    for (const WavBenchFile& f : wavFiles) {
+        double fast[BENCH_REPEATS], generic[BENCH_REPEATS], mp3[BENCH_REPEATS];
+        WavFormat format = {};
+        for (int r = 0; r < BENCH_REPEATS; r++) {
+            LaneDrain a, b, c;
+            WavDecoder decoder(source);
+            decoder.begin(f.path, &a.lane);
+            format = decoder.getFormat();
+            fast[r] = decodeSeconds(decoder, a) / WAV_BENCH_SECONDS;
+
+            // AudioGeneratorWAV 24 biti desteklemez
+            generic[r] = 0;
+            if (f.bits != 24) {
+                GenericWavGenerator gen(source);
+                gen.begin(f.path, &b.lane, format);
+                generic[r] = decodeSeconds(gen, b) / WAV_BENCH_SECONDS;
+            }
+
+            Mp3Plumbing plumbing(source);
+            plumbing.begin(f.path, &c.lane, WAV_BENCH_SECONDS);
+            mp3[r] = decodeSeconds(plumbing, c) / WAV_BENCH_SECONDS;
+        }
+        std::sort(fast, fast + BENCH_REPEATS);
+        std::sort(generic, generic + BENCH_REPEATS);
+        std::sort(mp3, mp3 + BENCH_REPEATS);
+        double fastUs = fast[BENCH_REPEATS / 2] * 1e6;
+        double genericUs = generic[BENCH_REPEATS / 2] * 1e6;
+        double mp3Us = mp3[BENCH_REPEATS / 2] * 1e6;
+        if (f.bits == 24) {
+            printf("  %-22s %12.1f %12s %14.1f %8s\n", f.path, fastUs, "n/a", mp3Us, "-");
+        } else {
+            printf("  %-22s %12.1f %12.1f %14.1f %7.1fx\n", f.path, fastUs, genericUs, mp3Us, genericUs / fastUs);
+        }
+    }
+}
@@ -81,22 +81,76 @@ document.addEventListener('DOMContentLoaded', function() {
         });
     }
 
+    // Playlist sayfalı ve koşullu istenir: ilk sayfa If-None-Match ile
+    // gönderilir, liste değişmemişse sunucu 304 döner ve yeniden çizilmez
+    const PLAYLIST_PAGE_SIZE = 200;
+    let playlistEtag = null;
+
+    function fetchPlaylistPage(offset, etag) {
+        const headers = etag ? { 'If-None-Match': etag } : {};
+        return fetch('/api/playlist?meta=1&offset=' + offset + '&limit=' + PLAYLIST_PAGE_SIZE, {
+            headers: headers,
+            cache: 'no-store'
+        });
+    }
+
+    // Değişiklik yoksa null, varsa kalan sayfalarla birlikte tüm listeyi döndürür
+    async function readPlaylist(response) {
+        if (response.status === 304) {
+            return null;
+        }
+        if (!response.ok) {
+            throw new Error(`HTTP error! status: ${response.status}`);
+        }
+        const etag = response.headers.get('ETag');
+        const total = parseInt(response.headers.get('X-Total-Count') || '0', 10);
+        let files = await response.json();
+        while (files.length < total) {
+            const page = await fetchPlaylistPage(files.length);
+            if (!page.ok) {
+                throw new Error(`HTTP error! status: ${page.status}`);
+            }
+            const items = await page.json();
+            if (items.length === 0) {
+                break;
+            }
+            files = files.concat(items);
+        }
+        playlistEtag = etag;
+        return files;
+    }
+
+    // "Sanatçı – Başlık (3:25)"; etiket yoksa dosya yolu
+    function formatDuration(seconds) {
+        const s = Math.round(seconds);
+        return Math.floor(s / 60) + ':' + String(s % 60).padStart(2, '0');
+    }
+
+    function trackLabel(item) {
+        let label = item.title ? (item.artist ? item.artist + ' – ' + item.title : item.title) : item.path;
+        if (item.duration) {
+            label += ' (' + formatDuration(item.duration) + ')';
+        }
+        return label;
+    }
+
     // MP3 listesini yükle
     function loadMusicList() {
-<<<<<<< HEAD
-        fetch('/api/playlist')
-=======
-        fetch(getBaseUrl() + '/api/playlist')
->>>>>>> stable-power-audio
-            .then(response => response.json())
+        fetchPlaylistPage(0, playlistEtag)
+            .then(readPlaylist)
             .then(files => {
+                if (!files) {
+                    return;  // 304: liste değişmedi
+                }
                 const musicList = document.getElementById('musicList');
                 musicList.innerHTML = '';
                 
-                files.forEach(file => {
+                files.forEach(item => {
+                    const file = item.path;
                     const li = document.createElement('li');
 <<<<<<< HEAD
-                    li.textContent = file;
+                    li.textContent = trackLabel(item);
+                    li.title = file;
                     li.onclick = function() {
                         fetch('/api/play', {
                             method: 'POST',
@@ -112,9 +166,8 @@ document.addEventListener('DOMContentLoaded', function() {
             .catch(console.error);
     }
 
-    // İlk durum güncellemesi ve periyodik güncelleme
-    function updateStatus() {
-        fetch('/api/status')
+    // Durum frame'ini ekrana işler (snapshot veya birleştirilmiş delta'lar)
+    function renderStatus(data) {
 =======
                     
                     // Dosya bilgisi için div
@@ -129,7 +182,9 @@ document.addEventListener('DOMContentLoaded', function() {
                     } else if (ext === 'm4a') {
                         icon = '<i class="fas fa-music" style="color: #2196F3;"></i>';
                     }
-                    fileInfo.innerHTML = `${icon} ${file}`;
+                    fileInfo.innerHTML = `${icon} `;
+                    fileInfo.appendChild(document.createTextNode(trackLabel(item)));
+                    fileInfo.title = file;
                     
                     // Silme butonu
                     const deleteBtn = document.createElement('button');
@@ -292,101 +347,110 @@ document.addEventListener('DOMContentLoaded', function() {
         });
     };
 
-    // İlk durum güncellemesi ve periyodik güncelleme
-    function updateStatus() {
-        fetch(getBaseUrl() + '/api/status')
+    // Durum frame'ini ekrana işler (snapshot veya birleştirilmiş delta'lar)
+    function renderStatus(data) {
 >>>>>>> stable-power-audio
-            .then(response => response.json())
-            .then(data => {
-                if (data.track) {
-                    document.getElementById('currentTrack').textContent = data.track;
-                }
-                if (data.temperature) {
-                    document.getElementById('temperature').textContent = data.temperature;
-                }
-                if (data.wifi) {
+        if (data.track) {
+            document.getElementById('currentTrack').textContent = data.title ?
+                (data.artist ? data.artist + ' – ' + data.title : data.title) : data.track;
+        }
+        if (data.temperature) {
+            document.getElementById('temperature').textContent = data.temperature;
+        }
+        if (data.wifi) {
 <<<<<<< HEAD
-                    document.getElementById('wifiStatus').textContent = data.wifi;
-                }
-                if (data.volume) {
-                    document.getElementById('volume').value = data.volume;
-                    document.getElementById('volumeValue').textContent = data.volume + '%';
-                }
-                if (data.bluetooth) {
-                    document.getElementById('bluetoothStatus').textContent = data.bluetooth;
-                }
-            })
-            .catch(console.error);
+            document.getElementById('wifiStatus').textContent = data.wifi;
+        }
+        if (data.volume) {
+            document.getElementById('volume').value = data.volume;
+            document.getElementById('volumeValue').textContent = data.volume + '%';
+        }
+        if (data.bluetooth) {
+            document.getElementById('bluetoothStatus').textContent = data.bluetooth;
+        }
 =======
-                    document.getElementById('wifiStatus').textContent = 
-                        data.wifi === "Connected" ? "Bağlı" : "Bağlı Değil";
-                }
-                // Volume güncellemesini sadece değer değişmişse yap
-                if (data.volume && Math.abs(volumeSlider.value - data.volume) > 1) {
-                    volumeSlider.value = data.volume;
-                    document.getElementById('volumeValue').textContent = data.volume + '%';
-                }
-                // Saat ve tarih güncellemesi
-                if (data.time) {
-                    const hour = String(data.time.hour).padStart(2, '0');
-                    const minute = String(data.time.minute).padStart(2, '0');
-                    const second = String(data.time.second).padStart(2, '0');
-                    document.getElementById('currentTime').textContent = 
-                        `${hour}:${minute}:${second}`;
-                    
-                    if (data.time.date) {
-                        const day = String(data.time.date.day).padStart(2, '0');
-                        const month = String(data.time.date.month).padStart(2, '0');
-                        const year = data.time.date.year;
-                        document.getElementById('currentDate').textContent = 
-                            `${day}/${month}/${year}`;
-                    }
-                }
-                // Şarkı ilerleme bilgisini güncelle
-                if (data.track_position) {
-                    currentPosition = data.track_position;
-                    trackDuration = data.track_duration || 0;
-                    updateTrackProgress();
-                }
-                // Play durumunu güncelle
-                const playStopBtn = document.getElementById('playStopBtn');
-                const icon = playStopBtn.querySelector('i');
-                
-                if (data.playing) {
-                    isPlaying = true;
-                    icon.className = 'fas fa-stop';
-                } else {
-                    isPlaying = false;
-                    icon.className = 'fas fa-play';
-                }
-                // Loop durumunu güncelle
-                const loopBtn = document.getElementById('loopBtn');
-                if (data.looping) {
-                    isLooping = true;
-                    loopBtn.classList.add('active');
-                } else {
-                    isLooping = false;
-                    loopBtn.classList.remove('active');
-                }
-            })
-            .catch(error => {
-                console.error('Status error:', error);
-                if (error.message.includes('Failed to fetch')) {
-                    setTimeout(() => {
-                        window.location.reload();
-                    }, 2000);
-                }
-            });
+            document.getElementById('wifiStatus').textContent = 
+                data.wifi === "Connected" ? "Bağlı" : "Bağlı Değil";
+        }
+        // Volume güncellemesini sadece değer değişmişse yap
+        if (data.volume && Math.abs(volumeSlider.value - data.volume) > 1) {
+            volumeSlider.value = data.volume;
+            document.getElementById('volumeValue').textContent = data.volume + '%';
+        }
+        // Saat ve tarih güncellemesi
+        if (data.time) {
+            const hour = String(data.time.hour).padStart(2, '0');
+            const minute = String(data.time.minute).padStart(2, '0');
+            const second = String(data.time.second).padStart(2, '0');
+            document.getElementById('currentTime').textContent = 
+                `${hour}:${minute}:${second}`;
+            
+            if (data.time.date) {
+                const day = String(data.time.date.day).padStart(2, '0');
+                const month = String(data.time.date.month).padStart(2, '0');
+                const year = data.time.date.year;
+                document.getElementById('currentDate').textContent = 
+                    `${day}/${month}/${year}`;
+            }
+        }
+        // Şarkı ilerleme bilgisini güncelle
+        if (data.track_position) {
+            currentPosition = data.track_position;
+            trackDuration = data.track_duration || 0;
+            updateTrackProgress();
+        }
+        // Play durumunu güncelle
+        const playStopBtn = document.getElementById('playStopBtn');
+        const icon = playStopBtn.querySelector('i');
+        
+        if (data.playing) {
+            isPlaying = true;
+            icon.className = 'fas fa-stop';
+        } else {
+            isPlaying = false;
+            icon.className = 'fas fa-play';
+        }
+        // Loop durumunu güncelle
+        const loopBtn = document.getElementById('loopBtn');
+        if (data.looping) {
+            isLooping = true;
+            loopBtn.classList.add('active');
+        } else {
+            isLooping = false;
+            loopBtn.classList.remove('active');
+        }
 >>>>>>> stable-power-audio
     }
 
+    // Durum WebSocket üzerinden itilir: bağlanınca tam snapshot, sonra
+    // sadece değişen alanları taşıyan delta'lar gelir
+    let statusState = {};
+
+    function connectStatus() {
+        const protocol = window.location.protocol === 'https:' ? 'wss://' : 'ws://';
+        const socket = new WebSocket(protocol + window.location.host + '/ws');
+        
+        socket.onmessage = event => {
+            const frame = JSON.parse(event.data);
+            if (frame.type === 'snapshot') {
+                statusState = frame;
+            } else {
+                Object.assign(statusState, frame);
+            }
+            renderStatus(statusState);
+        };
+        socket.onclose = () => {
+            // Yeniden bağlanınca sunucu yine snapshot gönderir
+            setTimeout(connectStatus, 2000);
+        };
+    }
+
     // İlk yükleme
     loadMusicList();
-    updateStatus();
+    connectStatus();
     
     // Periyodik güncelleme
 <<<<<<< HEAD
-    setInterval(updateStatus, 1000);
     setInterval(loadMusicList, 5000);  // MP3 listesini her 5 saniyede bir güncelle
 
     // Reset WiFi settings
@@ -571,27 +635,19 @@ document.addEventListener('DOMContentLoaded', function() {
         
         for (let i = 0; i < files.length; i++) {
             const file = files[i];
-            const formData = new FormData();
-            formData.append('file', file);
             
             const progressBar = document.createElement('div');
             progressBar.className = 'progress-bar';
             progressBar.innerHTML = `<span>${file.name}: 0%</span>`;
             progressDiv.appendChild(progressBar);
             
-            fetch('/api/upload', {
-                method: 'POST',
-                body: formData
+            uploadResumable(file, progress => {
+                progressBar.innerHTML = `<span>${file.name}: ${Math.round(progress * 100)}%</span>`;
             })
-            .then(response => {
-                if (response.ok) {
-                    progressBar.innerHTML = `<span>${file.name}: Completed!</span>`;
-                    progressBar.classList.add('complete');
-                    loadMusicList(); // Listeyi güncelle
-                } else {
-                    progressBar.innerHTML = `<span>${file.name}: Failed!</span>`;
-                    progressBar.classList.add('failed');
-                }
+            .then(() => {
+                progressBar.innerHTML = `<span>${file.name}: Completed!</span>`;
+                progressBar.classList.add('complete');
+                loadMusicList(); // Listeyi güncelle
             })
             .catch(error => {
                 progressBar.innerHTML = `<span>${file.name}: Error!</span>`;
@@ -600,7 +656,6 @@ document.addEventListener('DOMContentLoaded', function() {
         }
     };
 =======
-    setInterval(updateStatus, 2000);  // 2 saniyede bir güncelle
     setInterval(loadMusicList, 5000);  // MP3 listesini her 5 saniyede bir güncelle
 
     // Dosya yükleme işlemleri
@@ -632,22 +687,13 @@ document.addEventListener('DOMContentLoaded', function() {
         uploadProgress.style.display = 'block';
         
         for (let i = 0; i < files.length; i++) {
-            const formData = new FormData();
-            formData.append('file', files[i]);
-            
             try {
-                const response = await fetch('/upload', {
-                    method: 'POST',
-                    body: formData
+                // Kopan bağlantıda sadece eksik parçalar tekrar gönderilir
+                await uploadResumable(files[i], progress => {
+                    const total = (i + progress) / files.length * 100;
+                    progressBar.style.width = `${total}%`;
+                    progressText.textContent = `${Math.round(total)}%`;
                 });
-
-                if (!response.ok) {
-                    const errorText = await response.text();
-                    throw new Error(errorText);
-                }
-
-                progressBar.style.width = `${((i + 1) / files.length) * 100}%`;
-                progressText.textContent = `${Math.round(((i + 1) / files.length) * 100)}%`;
                 
             } catch (error) {
                 console.error('Yükleme hatası:', error);
@@ -0,0 +1,161 @@
+// Devam ettirilebilir upload (/api/upload/session, /api/upload/chunk, /api/upload/finalize)
+//
+// Dosya 64 KB'lık parçalar halinde gönderilir; bağlantı koparsa cihazdaki
+// oturum sorgulanır ve sadece eksik parçalar tekrar gönderilir. Cihaz düz
+// HTTP üzerinden sunulduğu için crypto.subtle yok, SHA-256 burada hesaplanır.
+(function() {
+    const K = new Uint32Array([
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    ]);
+
+    class Sha256 {
+        constructor() {
+            this.state = new Uint32Array([
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            ]);
+            this.block = new Uint8Array(64);
+            this.fill = 0;
+            this.length = 0;
+            this.w = new Uint32Array(64);
+        }
+
+        process(data, offset) {
+            const w = this.w;
+            for (let i = 0; i < 16; i++) {
+                const j = offset + i * 4;
+                w[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | data[j + 3];
+            }
+            for (let i = 16; i < 64; i++) {
+                const a = w[i - 15], b = w[i - 2];
+                const s0 = ((a >>> 7) | (a << 25)) ^ ((a >>> 18) | (a << 14)) ^ (a >>> 3);
+                const s1 = ((b >>> 17) | (b << 15)) ^ ((b >>> 19) | (b << 13)) ^ (b >>> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            let [a, b, c, d, e, f, g, h] = this.state;
+            for (let i = 0; i < 64; i++) {
+                const S1 = ((e >>> 6) | (e << 26)) ^ ((e >>> 11) | (e << 21)) ^ ((e >>> 25) | (e << 7));
+                const t1 = (h + S1 + ((e & f) ^ (~e & g)) + K[i] + w[i]) | 0;
+                const S0 = ((a >>> 2) | (a << 30)) ^ ((a >>> 13) | (a << 19)) ^ ((a >>> 22) | (a << 10));
+                const t2 = (S0 + ((a & b) ^ (a & c) ^ (b & c))) | 0;
+                h = g; g = f; f = e; e = (d + t1) | 0;
+                d = c; c = b; b = a; a = (t1 + t2) | 0;
+            }
+            const s = this.state;
+            s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+            s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+        }
+
+        update(data) {
+            let i = 0;
+            this.length += data.length;
+            if (this.fill > 0) {
+                const n = Math.min(64 - this.fill, data.length);
+                this.block.set(data.subarray(0, n), this.fill);
+                this.fill += n;
+                i = n;
+                if (this.fill < 64) return;
+                this.process(this.block, 0);
+                this.fill = 0;
+            }
+            for (; i + 64 <= data.length; i += 64) {
+                this.process(data, i);
+            }
+            this.block.set(data.subarray(i), 0);
+            this.fill = data.length - i;
+        }
+
+        hex() {
+            const bits = this.length * 8;
+            const pad = new Uint8Array((this.fill < 56 ? 64 : 128) - this.fill);
+            pad[0] = 0x80;
+            for (let i = 0; i < 8; i++) {
+                pad[pad.length - 1 - i] = Math.floor(bits / Math.pow(2, i * 8)) & 0xff;
+            }
+            this.update(pad);
+            return Array.from(this.state, v => v.toString(16).padStart(8, '0')).join('');
+        }
+    }
+
+    const MAX_ATTEMPTS = 10;
+    const sleep = ms => new Promise(resolve => setTimeout(resolve, ms));
+
+    async function call(method, url, body, headers) {
+        const options = { method: method, headers: headers || {} };
+        if (body) {
+            options.body = body;
+            options.headers['Content-Type'] = 'application/octet-stream';
+        }
+        const response = await fetch(url, options);
+        const text = await response.text();
+        if (!response.ok) {
+            const error = new Error(text || response.statusText);
+            error.status = response.status;
+            throw error;
+        }
+        return text ? JSON.parse(text) : {};
+    }
+
+    function receivedChunks(session) {
+        const chunks = new Set();
+        for (const [start, end] of session.received) {
+            for (let offset = start; offset < end; offset += session.chunkSize) {
+                chunks.add(offset / session.chunkSize);
+            }
+        }
+        return chunks;
+    }
+
+    // onProgress(0..1); hata olursa Error fırlatır
+    window.uploadResumable = async function(file, onProgress) {
+        const name = file.name.replace(/ /g, '_');
+        // X-File-Size: cihaz .part dosyasını son boyutuna önceden genişletir
+        let session = await call('POST',
+            `/api/upload/session?name=${encodeURIComponent(name)}&size=${file.size}`, null,
+            { 'X-File-Size': String(file.size) });
+        let done = receivedChunks(session);
+        const hash = new Sha256();
+
+        for (let i = 0; i < session.chunks; i++) {
+            const start = i * session.chunkSize;
+            const end = Math.min(start + session.chunkSize, file.size);
+            const data = new Uint8Array(await file.slice(start, end).arrayBuffer());
+            hash.update(data);
+
+            for (let attempt = 1; !done.has(i); attempt++) {
+                try {
+                    await call('PUT', `/api/upload/chunk?id=${session.id}&index=${i}`, data);
+                    done.add(i);
+                } catch (error) {
+                    // 4xx (409 meşgul hariç) tekrar denemekle düzelmez
+                    if (attempt >= MAX_ATTEMPTS ||
+                        (error.status >= 400 && error.status < 500 && error.status !== 409)) {
+                        throw error;
+                    }
+                    await sleep(Math.min(1000 * attempt, 5000));
+                    // Bağlantı koptuysa parça yazılmış olabilir; cihaza sor
+                    try {
+                        session = await call('GET', `/api/upload/session?id=${session.id}`);
+                        done = receivedChunks(session);
+                    } catch (ignored) {
+                    }
+                }
+            }
+            if (onProgress) onProgress(end / file.size);
+        }
+
+        // Cihaz özetin kalanını okurken 202 {"pending":true} döner; tekrar sorulur
+        const digest = hash.hex();
+        for (;;) {
+            const result = await call('POST', `/api/upload/finalize?id=${session.id}&sha256=${digest}`);
+            if (!result.pending) return result;
+            await sleep(1000);
+        }
+    };
+})();
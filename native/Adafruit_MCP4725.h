@@ -0,0 +1,44 @@
+#ifndef NATIVE_ADAFRUIT_MCP4725_H
+#define NATIVE_ADAFRUIT_MCP4725_H
+
+#include <stdint.h>
+#include "Wire.h"
+
+#define MCP4725_I2CADDR_DEFAULT 0x62
+
+// setVoltage çağrıları Wire modelinden geçer, böylece I2C maliyeti ölçülür
+class Adafruit_MCP4725 {
+private:
+    uint8_t address;
+    TwoWire* wire;
+
+public:
+    uint16_t nativeLastValue;
+    uint32_t nativeWrites;
+
+    Adafruit_MCP4725() :
+        address(MCP4725_I2CADDR_DEFAULT),
+        wire(&Wire),
+        nativeLastValue(0),
+        nativeWrites(0) {
+    }
+
+    bool begin(uint8_t i2cAddress = MCP4725_I2CADDR_DEFAULT, TwoWire* w = &Wire) {
+        address = i2cAddress;
+        wire = w;
+        return true;
+    }
+
+    bool setVoltage(uint16_t output, bool writeEEPROM, uint32_t i2cFrequency = 400000) {
+        (void)i2cFrequency;
+        wire->beginTransmission(address);
+        wire->write((uint8_t)(writeEEPROM ? 0x60 : 0x40));
+        wire->write((uint8_t)(output / 16));
+        wire->write((uint8_t)((output % 16) << 4));
+        nativeLastValue = output;
+        nativeWrites++;
+        return wire->endTransmission() == 0;
+    }
+};
+
+#endif // NATIVE_ADAFRUIT_MCP4725_H
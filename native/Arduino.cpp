@@ -0,0 +1,228 @@
+#include "Arduino.h"
+#include "Wire.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include <stdarg.h>
+#include <time.h>
+#include <chrono>
+#include <thread>
+
+static bool manualClock = false;
+static uint64_t manualMicros = 0;
+
+static uint64_t realMicros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t nowMicros() {
+    return manualClock ? manualMicros : realMicros();
+}
+
+void nativeSetMicros(uint64_t us) {
+    manualClock = true;
+    manualMicros = us;
+}
+
+void nativeAdvanceMicros(uint64_t us) {
+    if (!manualClock) nativeSetMicros(realMicros());
+    manualMicros += us;
+}
+
+void nativeUseRealClock() {
+    manualClock = false;
+}
+
+unsigned long millis() { return (unsigned long)(nowMicros() / 1000); }
+unsigned long micros() { return (unsigned long)nowMicros(); }
+
+void delay(unsigned long ms) {
+    if (manualClock) {
+        manualMicros += (uint64_t)ms * 1000;
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (manualClock) {
+        manualMicros += us;
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void yield() {}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuf, sizeof(stackBuf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(stackBuf)) return write((const uint8_t*)stackBuf, len);
+
+    char* heapBuf = (char*)malloc(len + 1);
+    if (!heapBuf) return 0;
+    va_start(args, format);
+    vsnprintf(heapBuf, len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)heapBuf, len);
+    free(heapBuf);
+    return n;
+}
+
+static bool serialQuiet = false;
+
+void HardwareSerial::setQuiet(bool quiet) { serialQuiet = quiet; }
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (serialQuiet) return 1;
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (serialQuiet) return size;
+    return fwrite(buffer, 1, size, stdout);
+}
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+uint32_t EspClass::getFreeHeap() { return 200 * 1024; }
+uint32_t EspClass::getMinFreeHeap() { return 180 * 1024; }
+uint32_t EspClass::getMaxAllocHeap() { return 110 * 1024; }
+uint32_t EspClass::getHeapSize() { return 320 * 1024; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(nowMicros() * getCpuFreqMHz()); }
+
+void EspClass::restart() {
+    fprintf(stderr, "ESP.restart() called on host\n");
+    exit(0);
+}
+
+EspClass ESP;
+
+uint32_t esp_random() {
+    // xorshift32, sabit tohum
+    static uint32_t state = 0x2545F491;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// FreeRTOS: task'lar host'ta oluşturulmuş sayılır ama çalıştırılmaz
+static int dummyTask;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+    void* params, UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+    (void)fn;
+    (void)name;
+    (void)stackDepth;
+    (void)params;
+    (void)priority;
+    (void)coreId;
+    if (handle) *handle = &dummyTask;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t handle) { (void)handle; }
+void vTaskDelay(TickType_t ticks) { delay(ticks * portTICK_PERIOD_MS); }
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+BaseType_t xPortGetCoreID() { return 1; }
+
+// Handle'lar bilerek serbest bırakılmaz: biten iş parçacığının adresi
+// yenisine verilip iki task aynı handle'ı paylaşmasın
+struct NativeTask {
+    char name[16] = "host";
+};
+
+static NativeTask* currentTask() {
+    static thread_local NativeTask* task = new NativeTask();
+    return task;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask(); }
+
+char* pcTaskGetName(TaskHandle_t handle) {
+    return handle ? ((NativeTask*)handle)->name : currentTask()->name;
+}
+
+void nativeSetTaskName(const char* name) {
+    strncpy(currentTask()->name, name, sizeof(currentTask()->name) - 1);
+}
+BaseType_t xTaskNotifyGive(TaskHandle_t handle) { (void)handle; return pdPASS; }
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    (void)clearOnExit;
+    (void)ticksToWait;
+    return 1;
+}
+
+// esp_timer
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    if (!args || !handle) return ESP_FAIL;
+    *handle = new native_esp_timer{ *args, 0, false };
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    timer->periodUs = periodUs;
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    timer->periodUs = timeoutUs;
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() { return (int64_t)nowMicros(); }
+
+void nativeFireTimer(esp_timer_handle_t timer) {
+    if (timer && timer->active && timer->args.callback) {
+        timer->args.callback(timer->args.arg);
+    }
+}
+
+// Mutex
+#include "freertos/semphr.h"
+#include <mutex>
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new std::timed_mutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticksToWait) {
+    std::timed_mutex* m = (std::timed_mutex*)sem;
+    if (ticksToWait == portMAX_DELAY) {
+        m->lock();
+        return pdTRUE;
+    }
+    return m->try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    ((std::timed_mutex*)sem)->unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    delete (std::timed_mutex*)sem;
+}
@@ -0,0 +1,84 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Host (env:native) build için ince Arduino katmanı.
+// Sadece src/ içindeki modüllerin kullandığı kısımlar tanımlıdır.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "WString.h"
+#include "Print.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+using std::min;
+using std::max;
+
+// ESP32'de newlib sağlar; eski glibc'de yok
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t n = strlen(src);
+    if (size) {
+        size_t copy = n < size - 1 ? n : size - 1;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return n;
+}
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// Zaman: varsayılan olarak gerçek monotonik saat. Testler/benchmark'lar
+// nativeSetMicros() ile saati dondurup elle ilerletebilir.
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void nativeSetMicros(uint64_t us);
+void nativeAdvanceMicros(uint64_t us);
+void nativeUseRealClock();
+
+// Serial stdout'a yazar
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    virtual size_t write(uint8_t c) override;
+    virtual size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    virtual int available() override { return 0; }
+    virtual int read() override { return -1; }
+    virtual int peek() override { return -1; }
+    operator bool() const { return true; }
+
+    // Benchmark çıktısını kirletmemek için kapatılabilir
+    void setQuiet(bool quiet);
+};
+
+extern HardwareSerial Serial;
+
+// ESP sınıfı: heap değerleri host'ta sabit, cycle sayacı monotonik saatten
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getHeapSize();
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,25 @@
+#ifndef NATIVE_AUDIO_FILE_SOURCE_H
+#define NATIVE_AUDIO_FILE_SOURCE_H
+
+// ESP8266Audio AudioFileSource taban sınıfının host kopyası
+
+#include <stdint.h>
+#include <stdio.h>
+
+class AudioFileSource {
+public:
+    AudioFileSource() {}
+    virtual ~AudioFileSource() {}
+
+    virtual bool open(const char* filename) { (void)filename; return false; }
+    virtual uint32_t read(void* data, uint32_t len) { (void)data; (void)len; return 0; }
+    virtual uint32_t readNonBlock(void* data, uint32_t len) { return read(data, len); }
+    virtual bool seek(int32_t pos, int dir) { (void)pos; (void)dir; return false; }
+    virtual bool close() { return false; }
+    virtual bool isOpen() { return false; }
+    virtual uint32_t getSize() { return 0; }
+    virtual uint32_t getPos() { return 0; }
+    virtual bool loop() { return true; }
+};
+
+#endif // NATIVE_AUDIO_FILE_SOURCE_H
@@ -0,0 +1,294 @@
+#include "FS.h"
+#include "Arduino.h"
+#include "SD.h"
+#include "SPIFFS.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+namespace fs {
+
+struct File::Impl {
+    FILE* fp;
+    bool directory;
+    std::string hostPath;
+    std::string path;
+    std::string baseName;
+    std::vector<std::string> entries;
+    size_t nextEntry;
+    const FS* owner;
+
+    Impl() : fp(nullptr), directory(false), nextEntry(0), owner(nullptr) {}
+    ~Impl() { if (fp) fclose(fp); }
+};
+
+static std::string baseNameOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string FS::hostPath(const char* path) const {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return root + p;
+}
+
+static uint32_t openLatencyUs = 0;
+
+void nativeSetOpenLatency(uint32_t us) {
+    openLatencyUs = us;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    File file;
+    if (openLatencyUs) {
+        nativeAdvanceMicros(openLatencyUs);
+    }
+    std::string host = hostPath(path);
+    struct stat st;
+    bool exists = stat(host.c_str(), &st) == 0;
+
+    auto impl = std::make_shared<File::Impl>();
+    impl->hostPath = host;
+    impl->path = (path && path[0] == '/') ? path : std::string("/") + (path ? path : "");
+    impl->baseName = baseNameOf(impl->path);
+    impl->owner = this;
+
+    if (exists && S_ISDIR(st.st_mode)) {
+        impl->directory = true;
+        DIR* dir = opendir(host.c_str());
+        if (!dir) return file;
+        while (struct dirent* e = readdir(dir)) {
+            if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+            impl->entries.push_back(e->d_name);
+        }
+        closedir(dir);
+        // Sıra dosya sistemine göre değişmesin
+        std::sort(impl->entries.begin(), impl->entries.end());
+        file.impl = impl;
+        return file;
+    }
+
+    std::string m = mode ? mode : FILE_READ;
+    if (m == FILE_READ && !exists) return file;
+    if (m == FILE_WRITE) m = "w+b";
+    else if (m == FILE_APPEND) m = "a+b";
+    else if (m == FILE_READ) m = "rb";
+    (void)create;
+
+    impl->fp = fopen(host.c_str(), m.c_str());
+    if (!impl->fp) return file;
+    file.impl = impl;
+    return file;
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return ::unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool FS::rmdir(const char* path) {
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+File::operator bool() const {
+    return impl && (impl->fp || impl->directory);
+}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+static uint32_t writeLatencyPerCallUs = 0;
+static uint32_t writeLatencyPerKbUs = 0;
+
+void nativeSetWriteLatency(uint32_t perCallUs, uint32_t perKbUs) {
+    writeLatencyPerCallUs = perCallUs;
+    writeLatencyPerKbUs = perKbUs;
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!impl || !impl->fp) return 0;
+    if (writeLatencyPerCallUs || writeLatencyPerKbUs) {
+        nativeAdvanceMicros(writeLatencyPerCallUs + (uint64_t)writeLatencyPerKbUs * size / 1024);
+    }
+    return fwrite(buffer, 1, size, impl->fp);
+}
+
+int File::available() {
+    if (!impl || !impl->fp) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    if (c == EOF) return -1;
+    ungetc(c, impl->fp);
+    return c;
+}
+
+static uint32_t readLatencyPerCallUs = 0;
+static uint32_t readLatencyPerKbUs = 0;
+static uint32_t pendingReadStallUs = 0;
+
+void nativeSetReadLatency(uint32_t perCallUs, uint32_t perKbUs) {
+    readLatencyPerCallUs = perCallUs;
+    readLatencyPerKbUs = perKbUs;
+    pendingReadStallUs = 0;
+}
+
+void nativeAddReadStall(uint32_t us) {
+    pendingReadStallUs += us;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!impl || !impl->fp) return 0;
+    if (readLatencyPerCallUs || readLatencyPerKbUs || pendingReadStallUs) {
+        nativeAdvanceMicros(readLatencyPerCallUs + (uint64_t)readLatencyPerKbUs * size / 1024 + pendingReadStallUs);
+        pendingReadStallUs = 0;
+    }
+    return fread(buffer, 1, size, impl->fp);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || !impl->fp) return false;
+    int whence = mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+    return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!impl || !impl->fp) return 0;
+    long pos = ftell(impl->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!impl) return 0;
+    if (impl->fp) fflush(impl->fp);
+    struct stat st;
+    if (stat(impl->hostPath.c_str(), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+void File::flush() {
+    if (impl && impl->fp) fflush(impl->fp);
+}
+
+void File::close() {
+    if (impl && impl->fp) {
+        fclose(impl->fp);
+        impl->fp = nullptr;
+    }
+    impl.reset();
+}
+
+time_t File::getLastWrite() {
+    if (!impl) return 0;
+    if (impl->fp) fflush(impl->fp);
+    struct stat st;
+    if (stat(impl->hostPath.c_str(), &st) != 0) return 0;
+    return st.st_mtime;
+}
+
+const char* File::name() const {
+    return impl ? impl->baseName.c_str() : "";
+}
+
+const char* File::path() const {
+    return impl ? impl->path.c_str() : "";
+}
+
+bool File::isDirectory() const {
+    return impl && impl->directory;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!impl || !impl->directory || impl->nextEntry >= impl->entries.size()) {
+        return File();
+    }
+    std::string child = impl->path;
+    if (child.empty() || child.back() != '/') child += "/";
+    child += impl->entries[impl->nextEntry++];
+    return const_cast<FS*>(impl->owner)->open(child.c_str(), mode);
+}
+
+void File::rewindDirectory() {
+    if (impl) impl->nextEntry = 0;
+}
+
+} // namespace fs
+
+static const char* envOr(const char* name, const char* fallback) {
+    const char* value = getenv(name);
+    return value && value[0] ? value : fallback;
+}
+
+fs::SDFS::SDFS() : fs::FS(envOr("MUSICBOX_SD_ROOT", ".pio/native_sd")) {}
+
+bool fs::SDFS::begin(uint8_t ssPin) {
+    (void)ssPin;
+    ::mkdir(root.c_str(), 0755);
+    struct stat st;
+    mounted = stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    return mounted;
+}
+
+uint64_t fs::SDFS::usedBytes() {
+    uint64_t total = 0;
+    std::vector<std::string> stack(1, root);
+    while (!stack.empty()) {
+        std::string dirPath = stack.back();
+        stack.pop_back();
+        DIR* dir = opendir(dirPath.c_str());
+        if (!dir) continue;
+        while (struct dirent* e = readdir(dir)) {
+            if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+            std::string child = dirPath + "/" + e->d_name;
+            struct stat st;
+            if (stat(child.c_str(), &st) != 0) continue;
+            if (S_ISDIR(st.st_mode)) stack.push_back(child);
+            else total += (uint64_t)st.st_size;
+        }
+        closedir(dir);
+    }
+    return total;
+}
+
+SPIFFSFS::SPIFFSFS() : fs::FS(envOr("MUSICBOX_SPIFFS_ROOT", "data")) {}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+    const char* partitionLabel) {
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    struct stat st;
+    mounted = stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    return mounted;
+}
+
+fs::SDFS SD;
+SPIFFSFS SPIFFS;
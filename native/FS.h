@@ -0,0 +1,120 @@
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+// ESP32 FS API'sinin host karşılığı: her dosya sistemi yerel bir dizine
+// bağlanır (SD -> MUSICBOX_SD_ROOT, SPIFFS -> data/).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Print.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+// SD yazma gecikmesi modeli: her write() çağrısı simüle saati (nativeAdvanceMicros)
+// çağrı başına sabit + KB başına süre kadar ilerletir. Varsayılan 0 (kapalı).
+void nativeSetWriteLatency(uint32_t perCallUs, uint32_t perKbUs);
+
+// Okuma için aynı model. nativeAddReadStall bir sonraki read() çağrısına tek
+// seferlik ek gecikme ekler (bus'ı tutan upload, FAT zinciri araması).
+// nativeSetReadLatency bekleyen ek gecikmeyi sıfırlar. nativeSetOpenLatency
+// dizin araması için open() başına süredir.
+void nativeSetReadLatency(uint32_t perCallUs, uint32_t perKbUs);
+void nativeAddReadStall(uint32_t us);
+void nativeSetOpenLatency(uint32_t us);
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class FS;
+
+class File : public Stream {
+private:
+    struct Impl;
+    std::shared_ptr<Impl> impl;
+
+    friend class FS;
+
+public:
+    File() {}
+
+    operator bool() const;
+
+    virtual size_t write(uint8_t c) override;
+    virtual size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    virtual int available() override;
+    virtual int read() override;
+    virtual int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    size_t readBytes(char* buffer, size_t length) override { return read((uint8_t*)buffer, length); }
+
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+    time_t getLastWrite();
+
+    const char* name() const;
+    const char* path() const;
+
+    bool isDirectory() const;
+    File openNextFile(const char* mode = FILE_READ);
+    void rewindDirectory();
+};
+
+class FS {
+protected:
+    std::string root;
+    bool mounted;
+
+    std::string hostPath(const char* path) const;
+
+public:
+    FS(const char* defaultRoot) : root(defaultRoot), mounted(false) {}
+    virtual ~FS() {}
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+    bool rmdir(const String& path) { return rmdir(path.c_str()); }
+
+    // Sadece host: dosya sisteminin bağlı olduğu dizini değiştirir
+    void nativeSetRoot(const char* dir) { root = dir; }
+    const char* nativeRoot() const { return root.c_str(); }
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // NATIVE_FS_H
@@ -0,0 +1,99 @@
+#include "Preferences.h"
+#include <string.h>
+
+static std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvsStore;
+
+std::map<std::string, std::vector<uint8_t>>& Preferences::store() {
+    return nvsStore[ns];
+}
+
+bool Preferences::begin(const char* name, bool ro, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (!name || strlen(name) > 15) return false;
+    ns = name;
+    readOnly = ro;
+    opened = true;
+    return true;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) return false;
+    store().clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) return false;
+    return store().erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return opened && store().count(key) > 0;
+}
+
+bool Preferences::putRaw(const char* key, const void* data, size_t len) {
+    if (!opened || readOnly || !key) return false;
+    const uint8_t* bytes = (const uint8_t*)data;
+    store()[key] = std::vector<uint8_t>(bytes, bytes + len);
+    return true;
+}
+
+size_t Preferences::getRaw(const char* key, void* out, size_t maxLen) {
+    if (!opened || !key) return 0;
+    auto it = store().find(key);
+    if (it == store().end() || it->second.size() > maxLen) return 0;
+    memcpy(out, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    size_t len = strlen(value) + 1;
+    return putRaw(key, value, len) ? len - 1 : 0;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    bool v;
+    return getRaw(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+    int32_t v;
+    return getRaw(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t v;
+    return getRaw(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+    uint8_t v;
+    return getRaw(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+uint64_t Preferences::getULong64(const char* key, uint64_t defaultValue) {
+    uint64_t v;
+    return getRaw(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float v;
+    return getRaw(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    if (!opened) return defaultValue;
+    auto it = store().find(key);
+    if (it == store().end() || it->second.empty()) return defaultValue;
+    return String((const char*)it->second.data());
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened) return 0;
+    auto it = store().find(key);
+    return it == store().end() ? 0 : it->second.size();
+}
+
+void Preferences::nativeReset() {
+    nvsStore.clear();
+}
@@ -0,0 +1,58 @@
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+// NVS yerine süreç ömrü boyunca yaşayan bellek içi anahtar/değer deposu
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "WString.h"
+
+class Preferences {
+private:
+    std::string ns;
+    bool opened;
+    bool readOnly;
+
+    std::map<std::string, std::vector<uint8_t>>& store();
+    bool putRaw(const char* key, const void* data, size_t len);
+    size_t getRaw(const char* key, void* out, size_t maxLen);
+
+public:
+    Preferences() : opened(false), readOnly(false) {}
+
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end() { opened = false; }
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBool(const char* key, bool value) { return putRaw(key, &value, sizeof(value)) ? sizeof(value) : 0; }
+    size_t putInt(const char* key, int32_t value) { return putRaw(key, &value, sizeof(value)) ? sizeof(value) : 0; }
+    size_t putUInt(const char* key, uint32_t value) { return putRaw(key, &value, sizeof(value)) ? sizeof(value) : 0; }
+    size_t putUChar(const char* key, uint8_t value) { return putRaw(key, &value, sizeof(value)) ? sizeof(value) : 0; }
+    size_t putULong64(const char* key, uint64_t value) { return putRaw(key, &value, sizeof(value)) ? sizeof(value) : 0; }
+    size_t putFloat(const char* key, float value) { return putRaw(key, &value, sizeof(value)) ? sizeof(value) : 0; }
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    size_t putBytes(const char* key, const void* value, size_t len) { return putRaw(key, value, len) ? len : 0; }
+
+    bool getBool(const char* key, bool defaultValue = false);
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+    uint64_t getULong64(const char* key, uint64_t defaultValue = 0);
+    float getFloat(const char* key, float defaultValue = NAN);
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLen) { return getRaw(key, buffer, maxLen); }
+
+    // Sadece host: tüm namespace'leri temizler
+    static void nativeReset();
+};
+
+#endif // NATIVE_PREFERENCES_H
@@ -0,0 +1,134 @@
+#include "RTClib.h"
+#include "Arduino.h"
+#include <stdio.h>
+#include <string.h>
+
+static const uint8_t daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static uint16_t date2days(uint16_t y, uint8_t m, uint8_t d) {
+    if (y >= 2000U) y -= 2000U;
+    uint16_t days = d;
+    for (uint8_t i = 1; i < m; ++i) days += daysInMonth[i - 1];
+    if (m > 2 && y % 4 == 0) ++days;
+    return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+static uint32_t time2ulong(uint16_t days, uint8_t h, uint8_t m, uint8_t s) {
+    return ((days * 24UL + h) * 60 + m) * 60 + s;
+}
+
+static uint8_t conv2d(const char* p) {
+    uint8_t v = 0;
+    if ('0' <= *p && *p <= '9') v = *p - '0';
+    return 10 * v + *++p - '0';
+}
+
+DateTime::DateTime(uint32_t t) {
+    t -= SECONDS_FROM_1970_TO_2000;
+    ss = t % 60;
+    t /= 60;
+    mm = t % 60;
+    t /= 60;
+    hh = t % 24;
+    uint16_t days = t / 24;
+    uint8_t leap;
+    for (yOff = 0;; ++yOff) {
+        leap = yOff % 4 == 0;
+        if (days < 365U + leap) break;
+        days -= 365 + leap;
+    }
+    for (m = 1; m < 12; ++m) {
+        uint8_t daysPerMonth = daysInMonth[m - 1];
+        if (leap && m == 2) ++daysPerMonth;
+        if (days < daysPerMonth) break;
+        days -= daysPerMonth;
+    }
+    d = days + 1;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+    if (year >= 2000U) year -= 2000U;
+    yOff = year;
+    m = month;
+    d = day;
+    hh = hour;
+    mm = min;
+    ss = sec;
+}
+
+DateTime::DateTime(const char* date, const char* time) {
+    // "Mmm dd yyyy", "hh:mm:ss" (__DATE__, __TIME__ biçimi)
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    yOff = conv2d(date + 9);
+    m = 1;
+    for (int i = 0; i < 12; i++) {
+        if (strncmp(date, months + i * 3, 3) == 0) {
+            m = i + 1;
+            break;
+        }
+    }
+    d = conv2d(date + 4);
+    hh = conv2d(time);
+    mm = conv2d(time + 3);
+    ss = conv2d(time + 6);
+}
+
+bool DateTime::isValid() const {
+    if (yOff >= 100) return false;
+    DateTime other(unixtime());
+    return yOff == other.yOff && m == other.m && d == other.d &&
+        hh == other.hh && mm == other.mm && ss == other.ss;
+}
+
+uint8_t DateTime::dayOfTheWeek() const {
+    uint16_t day = date2days(yOff, m, d);
+    return (day + 6) % 7;  // 1 Ocak 2000 Cumartesi -> 6
+}
+
+uint32_t DateTime::secondstime() const {
+    return time2ulong(date2days(yOff, m, d), hh, mm, ss);
+}
+
+uint32_t DateTime::unixtime() const {
+    return secondstime() + SECONDS_FROM_1970_TO_2000;
+}
+
+String DateTime::timestamp() const {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%04u-%02u-%02uT%02u:%02u:%02u",
+        year(), month(), day(), hour(), minute(), second());
+    return String(buf);
+}
+
+RTC_DS3231::RTC_DS3231() :
+    baseUnix(DateTime(2024, 1, 1, 12, 0, 0).unixtime()),
+    baseMillis(0),
+    powerLost(false),
+    temperature(23.25f),
+    driftPpm(0),
+    nativeReads(0) {
+}
+
+bool RTC_DS3231::begin(TwoWire* wire) {
+    (void)wire;
+    baseMillis = millis();
+    return true;
+}
+
+void RTC_DS3231::adjust(const DateTime& dt) {
+    baseUnix = dt.unixtime();
+    baseMillis = millis();
+    powerLost = false;
+}
+
+DateTime RTC_DS3231::now() {
+    nativeReads++;
+    int64_t elapsed = (int64_t)(millis() - baseMillis);
+    elapsed += elapsed * driftPpm / 1000000;
+    return DateTime(baseUnix + (uint32_t)(elapsed / 1000));
+}
+
+float RTC_DS3231::getTemperature() {
+    nativeReads++;
+    return temperature;
+}
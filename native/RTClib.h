@@ -0,0 +1,108 @@
+#ifndef NATIVE_RTCLIB_H
+#define NATIVE_RTCLIB_H
+
+// RTClib'in DateTime/TimeSpan/RTC_DS3231 alt kümesi. RTC, millis() ile
+// ilerleyen bir saat olarak modellenir; okuma sayısı I2C trafiğini ölçmek
+// için tutulur.
+
+#include <stdint.h>
+#include "WString.h"
+
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+class TwoWire;
+
+class TimeSpan {
+protected:
+    int32_t _seconds;
+
+public:
+    TimeSpan(int32_t seconds = 0) : _seconds(seconds) {}
+    TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds) :
+        _seconds((int32_t)days * 86400L + (int32_t)hours * 3600 + (int32_t)minutes * 60 + seconds) {}
+
+    int16_t days() const { return _seconds / 86400L; }
+    int8_t hours() const { return _seconds / 3600 % 24; }
+    int8_t minutes() const { return _seconds / 60 % 60; }
+    int8_t seconds() const { return _seconds % 60; }
+    int32_t totalseconds() const { return _seconds; }
+
+    TimeSpan operator+(const TimeSpan& right) const { return TimeSpan(_seconds + right._seconds); }
+    TimeSpan operator-(const TimeSpan& right) const { return TimeSpan(_seconds - right._seconds); }
+};
+
+class DateTime {
+protected:
+    uint8_t yOff, m, d, hh, mm, ss;
+
+public:
+    DateTime(uint32_t t = SECONDS_FROM_1970_TO_2000);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+    DateTime(const char* date, const char* time);
+
+    bool isValid() const;
+    uint16_t year() const { return 2000U + yOff; }
+    uint8_t month() const { return m; }
+    uint8_t day() const { return d; }
+    uint8_t hour() const { return hh; }
+    uint8_t minute() const { return mm; }
+    uint8_t second() const { return ss; }
+    uint8_t dayOfTheWeek() const;
+
+    uint32_t secondstime() const;
+    uint32_t unixtime() const;
+
+    String timestamp() const;
+
+    DateTime operator+(const TimeSpan& span) const { return DateTime(unixtime() + span.totalseconds()); }
+    DateTime operator-(const TimeSpan& span) const { return DateTime(unixtime() - span.totalseconds()); }
+    TimeSpan operator-(const DateTime& right) const { return TimeSpan((int32_t)(unixtime() - right.unixtime())); }
+    bool operator<(const DateTime& right) const { return unixtime() < right.unixtime(); }
+    bool operator>(const DateTime& right) const { return right < *this; }
+    bool operator<=(const DateTime& right) const { return !(*this > right); }
+    bool operator>=(const DateTime& right) const { return !(*this < right); }
+    bool operator==(const DateTime& right) const { return unixtime() == right.unixtime(); }
+    bool operator!=(const DateTime& right) const { return !(*this == right); }
+};
+
+enum Ds3231SqwPinMode {
+    DS3231_OFF = 0x1C,
+    DS3231_SquareWave1Hz = 0x00
+};
+
+enum Ds3231Alarm1Mode {
+    DS3231_A1_PerSecond = 0x0F,
+    DS3231_A1_Second = 0x0E,
+    DS3231_A1_Minute = 0x0C,
+    DS3231_A1_Hour = 0x08,
+    DS3231_A1_Date = 0x00,
+    DS3231_A1_Day = 0x10
+};
+
+class RTC_DS3231 {
+private:
+    uint32_t baseUnix;
+    unsigned long baseMillis;
+    bool powerLost;
+    float temperature;
+    int32_t driftPpm;
+
+public:
+    uint32_t nativeReads;
+
+    RTC_DS3231();
+
+    bool begin(TwoWire* wire = nullptr);
+    void adjust(const DateTime& dt);
+    bool lostPower() { return powerLost; }
+    DateTime now();
+    float getTemperature();
+
+    // Sadece host: sıcaklık değerini ayarlar
+    void nativeSetTemperature(float t) { temperature = t; }
+
+    // Sadece host: RTC osilatörünün millis()'e göre sapması (ppm)
+    void nativeSetDriftPpm(int32_t ppm) { driftPpm = ppm; }
+};
+
+#endif // NATIVE_RTCLIB_H
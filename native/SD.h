@@ -0,0 +1,33 @@
+#ifndef NATIVE_SD_H
+#define NATIVE_SD_H
+
+#include "FS.h"
+
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+namespace fs {
+
+class SDFS : public FS {
+public:
+    SDFS();
+
+    bool begin(uint8_t ssPin = 5);
+    void end() { mounted = false; }
+    sdcard_type_t cardType() { return mounted ? CARD_SDHC : CARD_NONE; }
+    uint64_t cardSize() { return 32ULL * 1024 * 1024 * 1024; }
+    uint64_t totalBytes() { return cardSize(); }
+    uint64_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::SDFS SD;
+using fs::SDFS;
+
+#endif // NATIVE_SD_H
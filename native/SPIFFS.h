@@ -0,0 +1,20 @@
+#ifndef NATIVE_SPIFFS_H
+#define NATIVE_SPIFFS_H
+
+#include "FS.h"
+
+class SPIFFSFS : public fs::FS {
+public:
+    SPIFFSFS();
+
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs",
+        uint8_t maxOpenFiles = 10, const char* partitionLabel = nullptr);
+    void end() { mounted = false; }
+    bool format() { return true; }
+    size_t totalBytes() { return 0x16F000; }
+    size_t usedBytes() { return 0; }
+};
+
+extern SPIFFSFS SPIFFS;
+
+#endif // NATIVE_SPIFFS_H
@@ -0,0 +1,94 @@
+#include "Update.h"
+#include "Arduino.h"
+
+UpdateClass Update;
+
+UpdateClass::UpdateClass() :
+    expected(0),
+    error(UPDATE_ERROR_OK),
+    running(false),
+    finished(false),
+    bootable(false),
+    sectorUs(0) {
+}
+
+bool UpdateClass::begin(size_t size, int command, int ledPin, uint8_t ledOn, const char* label) {
+    (void)command;
+    (void)ledPin;
+    (void)ledOn;
+    (void)label;
+    if (running) {
+        return false;
+    }
+    if (size != UPDATE_SIZE_UNKNOWN && size > UPDATE_PARTITION_SIZE) {
+        error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    image.clear();
+    expected = size;
+    error = UPDATE_ERROR_OK;
+    running = true;
+    finished = false;
+    bootable = false;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t len) {
+    if (!running || hasError()) {
+        return 0;
+    }
+    // ESP32: ilk byte imaj sihirli sayısı olmalı
+    if (image.empty() && len > 0 && data[0] != 0xE9) {
+        error = UPDATE_ERROR_MAGIC_BYTE;
+        return 0;
+    }
+    if (image.size() + len > UPDATE_PARTITION_SIZE) {
+        error = UPDATE_ERROR_SPACE;
+        return 0;
+    }
+    // Yeni sektöre geçen her yazma bir silme + programlama maliyeti öder
+    size_t before = (image.size() + UPDATE_SECTOR_SIZE - 1) / UPDATE_SECTOR_SIZE;
+    image.insert(image.end(), data, data + len);
+    size_t after = (image.size() + UPDATE_SECTOR_SIZE - 1) / UPDATE_SECTOR_SIZE;
+    if (sectorUs && after > before) {
+        nativeAdvanceMicros((uint64_t)sectorUs * (after - before));
+    }
+    return len;
+}
+
+bool UpdateClass::end(bool evenIfRemaining) {
+    if (!running || hasError()) {
+        return false;
+    }
+    if (!evenIfRemaining && expected != UPDATE_SIZE_UNKNOWN && image.size() != expected) {
+        error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    running = false;
+    finished = true;
+    bootable = true;
+    return true;
+}
+
+void UpdateClass::abort() {
+    running = false;
+    finished = false;
+    error = UPDATE_ERROR_ABORT;
+}
+
+const char* UpdateClass::errorString() const {
+    switch (error) {
+        case UPDATE_ERROR_OK:           return "No Error";
+        case UPDATE_ERROR_WRITE:        return "Flash Write Failed";
+        case UPDATE_ERROR_SPACE:        return "Not Enough Space";
+        case UPDATE_ERROR_SIZE:         return "Bad Size Given";
+        case UPDATE_ERROR_MAGIC_BYTE:   return "Wrong Magic Byte";
+        case UPDATE_ERROR_ABORT:        return "Update Aborted";
+        case UPDATE_ERROR_NO_PARTITION: return "Partition Could Not be Found";
+    }
+    return "UNKNOWN";
+}
+
+void UpdateClass::printError(Print& out) const {
+    out.println(errorString());
+}
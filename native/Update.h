@@ -0,0 +1,62 @@
+#ifndef NATIVE_UPDATE_H
+#define NATIVE_UPDATE_H
+
+// ESP32 Update (OTA) API'sinin host karşılığı: imaj bellekte tutulur,
+// flash sektör silme/yazma süresi simüle saati ilerletir.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "Print.h"
+
+#define UPDATE_SIZE_UNKNOWN     0xFFFFFFFF
+#define U_FLASH                 0
+#define U_SPIFFS                100
+
+#define UPDATE_ERROR_OK         0
+#define UPDATE_ERROR_WRITE      1
+#define UPDATE_ERROR_SPACE      4
+#define UPDATE_ERROR_SIZE       5
+#define UPDATE_ERROR_MAGIC_BYTE 10
+#define UPDATE_ERROR_ABORT      8
+#define UPDATE_ERROR_NO_PARTITION 12
+
+#define UPDATE_SECTOR_SIZE      4096
+#define UPDATE_PARTITION_SIZE   0x300000
+
+class UpdateClass {
+private:
+    std::vector<uint8_t> image;
+    size_t expected;
+    uint8_t error;
+    bool running;
+    bool finished;
+    bool bootable;
+    uint32_t sectorUs;
+
+public:
+    UpdateClass();
+
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH, int ledPin = -1,
+        uint8_t ledOn = 0, const char* label = nullptr);
+    size_t write(uint8_t* data, size_t len);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+
+    bool hasError() const { return error != UPDATE_ERROR_OK; }
+    uint8_t getError() const { return error; }
+    const char* errorString() const;
+    void printError(Print& out) const;
+    bool isRunning() const { return running; }
+    bool isFinished() const { return finished; }
+    size_t progress() const { return image.size(); }
+
+    // Sadece host
+    void nativeSetSectorLatency(uint32_t us) { sectorUs = us; }
+    const std::vector<uint8_t>& nativeImage() const { return image; }
+    bool nativeBootable() const { return bootable; }
+};
+
+extern UpdateClass Update;
+
+#endif // NATIVE_UPDATE_H
@@ -0,0 +1,139 @@
+#include "WString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+
+static std::string formatInteger(unsigned long long value, bool negative, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char buf[72];
+    int pos = sizeof(buf) - 1;
+    buf[pos] = 0;
+    do {
+        unsigned digit = (unsigned)(value % base);
+        buf[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value && pos > 1);
+    if (negative) buf[--pos] = '-';
+    return std::string(buf + pos);
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    // Arduino davranışı: negatif sayılar sadece 10 tabanında işaretli yazılır
+    if (value < 0 && base == 10) {
+        return formatInteger((unsigned long long)(-(value + 1)) + 1, true, base);
+    }
+    return formatInteger((unsigned long long)value, false, base);
+}
+
+String::String(int value, unsigned char base) : s(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : s(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : s(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : s(formatInteger(value, false, base)) {}
+String::String(long long value, unsigned char base) : s(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : s(formatInteger(value, false, base)) {}
+
+String::String(float value, unsigned char decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, (double)value);
+    s = buf;
+}
+
+String::String(double value, unsigned char decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    s = buf;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (s.length() != other.s.length()) return false;
+    for (size_t i = 0; i < s.length(); i++) {
+        if (tolower((unsigned char)s[i]) != tolower((unsigned char)other.s[i])) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return s.compare(0, prefix.s.length(), prefix.s) == 0 && s.length() >= prefix.s.length();
+}
+
+bool String::endsWith(const String& suffix) const {
+    return s.length() >= suffix.s.length() &&
+        s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t pos = s.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+    size_t pos = s.find(str.s, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = s.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str) const {
+    size_t pos = s.rfind(str.s);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+    if (from >= s.length()) return String();
+    return String(s.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s.length()) return String();
+    if (to > s.length()) to = (unsigned int)s.length();
+    return String(s.substr(from, to - from));
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.s.empty()) return;
+    size_t pos = 0;
+    while ((pos = s.find(find.s, pos)) != std::string::npos) {
+        s.replace(pos, find.s.length(), replacement.s);
+        pos += replacement.s.length();
+    }
+}
+
+void String::replace(char find, char replacement) {
+    std::replace(s.begin(), s.end(), find, replacement);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= s.length()) return;
+    s.erase(index, count);
+}
+
+void String::toLowerCase() {
+    for (auto& c : s) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (auto& c : s) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+    size_t begin = 0;
+    while (begin < s.length() && isspace((unsigned char)s[begin])) begin++;
+    size_t end = s.length();
+    while (end > begin && isspace((unsigned char)s[end - 1])) end--;
+    s = s.substr(begin, end - begin);
+}
+
+long String::toInt() const { return strtol(s.c_str(), nullptr, 10); }
+float String::toFloat() const { return strtof(s.c_str(), nullptr); }
+double String::toDouble() const { return strtod(s.c_str(), nullptr); }
+
+String operator+(const String& lhs, const String& rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String& lhs, const char* rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const char* lhs, const String& rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String& lhs, char rhs) { String r(lhs); r += rhs; return r; }
@@ -0,0 +1,94 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+// Host build için Arduino String'in sık kullanılan alt kümesi (std::string üstünde)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+class String {
+private:
+    std::string s;
+
+public:
+    String() {}
+    String(const char* cstr) : s(cstr ? cstr : "") {}
+    String(const std::string& str) : s(str) {}
+    String(char c) : s(1, c) {}
+    String(int value, unsigned char base = 10);
+    String(unsigned int value, unsigned char base = 10);
+    String(long value, unsigned char base = 10);
+    String(unsigned long value, unsigned char base = 10);
+    String(long long value, unsigned char base = 10);
+    String(unsigned long long value, unsigned char base = 10);
+    String(float value, unsigned char decimals = 2);
+    String(double value, unsigned char decimals = 2);
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.length(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+    const std::string& str() const { return s; }
+
+    char charAt(unsigned int index) const { return index < s.length() ? s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return s[index]; }
+
+    bool concat(const String& other) { s += other.s; return true; }
+    bool concat(const char* cstr) { if (cstr) s += cstr; return true; }
+    bool concat(char c) { s += c; return true; }
+
+    String& operator+=(const String& other) { s += other.s; return *this; }
+    String& operator+=(const char* cstr) { if (cstr) s += cstr; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    String& operator+=(int value) { s += String(value).s; return *this; }
+    String& operator+=(unsigned int value) { s += String(value).s; return *this; }
+    String& operator+=(long value) { s += String(value).s; return *this; }
+    String& operator+=(unsigned long value) { s += String(value).s; return *this; }
+
+    bool equals(const String& other) const { return s == other.s; }
+    bool equalsIgnoreCase(const String& other) const;
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator==(const char* cstr) const { return s == (cstr ? cstr : ""); }
+    bool operator!=(const String& other) const { return s != other.s; }
+    bool operator!=(const char* cstr) const { return !(*this == cstr); }
+    bool operator<(const String& other) const { return s < other.s; }
+    int compareTo(const String& other) const { return s.compare(other.s); }
+
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String& str) const;
+
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+
+    void replace(const String& find, const String& replacement);
+    void replace(char find, char replacement);
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+};
+
+// ArduinoJson'un String adaptörü bu türü de tanır
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* cstr) : String(cstr) {}
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+
+#endif // NATIVE_WSTRING_H
@@ -0,0 +1,91 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+// I2C bus modeli: transaction'lar gerçek bir cihaza gitmez, sayılır ve
+// SCL frekansına göre hattın ne kadar meşgul kalacağı hesaplanır.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Print.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire : public Stream {
+private:
+    uint32_t clockHz;
+    uint8_t txAddress;
+    size_t txLength;
+    bool transmitting;
+
+public:
+    uint32_t nativeTransactions;
+    uint64_t nativeBytes;
+    uint64_t nativeBusyNs;
+
+    TwoWire() :
+        clockHz(100000),
+        txAddress(0),
+        txLength(0),
+        transmitting(false),
+        nativeTransactions(0),
+        nativeBytes(0),
+        nativeBusyNs(0) {
+    }
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+        (void)sda;
+        (void)scl;
+        if (frequency) clockHz = frequency;
+        return true;
+    }
+    bool setClock(uint32_t frequency) { clockHz = frequency; return true; }
+    uint32_t getClock() const { return clockHz; }
+
+    void beginTransmission(uint8_t address) {
+        txAddress = address;
+        txLength = 0;
+        transmitting = true;
+    }
+
+    virtual size_t write(uint8_t c) override {
+        (void)c;
+        if (!transmitting || txLength >= I2C_BUFFER_LENGTH) return 0;
+        txLength++;
+        return 1;
+    }
+    using Print::write;
+
+    uint8_t endTransmission(bool sendStop = true) {
+        (void)sendStop;
+        transmitting = false;
+        nativeTransactions++;
+        nativeBytes += txLength + 1;
+        // start + (adres + veri) x 9 bit + stop
+        nativeBusyNs += (uint64_t)(2 + (txLength + 1) * 9) * 1000000000ULL / clockHz;
+        (void)txAddress;
+        return 0;
+    }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true) {
+        (void)address;
+        (void)sendStop;
+        nativeTransactions++;
+        nativeBytes += quantity + 1;
+        nativeBusyNs += (uint64_t)(2 + (quantity + 1) * 9) * 1000000000ULL / clockHz;
+        return quantity;
+    }
+
+    virtual int available() override { return 0; }
+    virtual int read() override { return 0; }
+    virtual int peek() override { return 0; }
+
+    void nativeResetStats() {
+        nativeTransactions = 0;
+        nativeBytes = 0;
+        nativeBusyNs = 0;
+    }
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,10 @@
+#ifndef NATIVE_ESP_SYSTEM_H
+#define NATIVE_ESP_SYSTEM_H
+
+// Host build: donanım RNG'si yerine sabit tohumlu üreteç (tekrarlanabilir)
+
+#include <stdint.h>
+
+uint32_t esp_random();
+
+#endif // NATIVE_ESP_SYSTEM_H
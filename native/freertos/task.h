@@ -0,0 +1,22 @@
+#ifndef NATIVE_FREERTOS_TASK_H
+#define NATIVE_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+    void* params, UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId);
+void vTaskDelete(TaskHandle_t handle);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+BaseType_t xPortGetCoreID();
+
+// Host'ta her iş parçacığı ayrı bir task sayılır; adı nativeSetTaskName()
+// ile verilir (verilmezse "host")
+TaskHandle_t xTaskGetCurrentTaskHandle();
+char* pcTaskGetName(TaskHandle_t handle);
+void nativeSetTaskName(const char* name);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+
+#endif // NATIVE_FREERTOS_TASK_H
@@ -0,0 +1,48 @@
+#include "rom/miniz.h"
+#include <string.h>
+
+// tinfl durumları zlib'inkilere eşlenir; zlib kendi penceresini tuttuğu
+// için çağıranın sarmal tamponu sadece çıktı hedefi olarak kullanılır.
+tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* pIn_buf_next, size_t* pIn_buf_size,
+    mz_uint8* pOut_buf_start, mz_uint8* pOut_buf_next, size_t* pOut_buf_size, const mz_uint32 decomp_flags) {
+    (void)pOut_buf_start;
+    if (r->m_state == 0) {
+        memset(&r->stream, 0, sizeof(r->stream));
+        int windowBits = (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? 15 : -15;
+        if (inflateInit2(&r->stream, windowBits) != Z_OK) {
+            return TINFL_STATUS_FAILED;
+        }
+        r->m_state = 1;
+    } else if (r->m_state != 1) {
+        *pIn_buf_size = 0;
+        *pOut_buf_size = 0;
+        return r->m_state == 2 ? TINFL_STATUS_DONE : TINFL_STATUS_FAILED;
+    }
+
+    r->stream.next_in = (Bytef*)pIn_buf_next;
+    r->stream.avail_in = (uInt)*pIn_buf_size;
+    r->stream.next_out = pOut_buf_next;
+    r->stream.avail_out = (uInt)*pOut_buf_size;
+
+    int result = inflate(&r->stream, Z_NO_FLUSH);
+    *pIn_buf_size -= r->stream.avail_in;
+    *pOut_buf_size -= r->stream.avail_out;
+
+    if (result == Z_STREAM_END) {
+        inflateEnd(&r->stream);
+        r->m_state = 2;
+        return TINFL_STATUS_DONE;
+    }
+    if (result != Z_OK && result != Z_BUF_ERROR) {
+        inflateEnd(&r->stream);
+        r->m_state = 3;
+        return TINFL_STATUS_FAILED;
+    }
+    if (r->stream.avail_out == 0) {
+        return TINFL_STATUS_HAS_MORE_OUTPUT;
+    }
+    if (!(decomp_flags & TINFL_FLAG_HAS_MORE_INPUT)) {
+        return TINFL_STATUS_FAILED;
+    }
+    return TINFL_STATUS_NEEDS_MORE_INPUT;
+}
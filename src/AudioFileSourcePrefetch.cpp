@@ -0,0 +1,496 @@
+#include "AudioFileSourcePrefetch.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+AudioFileSourcePrefetch audioPrefetch;
+
+AudioFileSourcePrefetch::AudioFileSourcePrefetch() :
+    ring(nullptr),
+    capacity(0),
+    start(0),
+    fill(0),
+    chunk(nullptr),
+    size(0),
+    readPos(0),
+    needSeek(false),
+    opened(false),
+    generation(0),
+    inFlight(false),
+    primed(false),
+    nextData(nullptr),
+    nextLength(0),
+    nextTarget(0),
+    nextDone(false),
+    nextGeneration(0),
+    rateBytes(0),
+    rateStartMs(0),
+    bytesPerSecond(0),
+    underrunScore(0),
+    mutex(nullptr),
+    ioMutex(nullptr),
+    task(nullptr) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+AudioFileSourcePrefetch::~AudioFileSourcePrefetch() {
+    free(ring);
+    free(chunk);
+    free(nextData);
+}
+
+bool AudioFileSourcePrefetch::begin() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+        ioMutex = xSemaphoreCreateMutex();
+    }
+    if (!chunk) {
+        chunk = (uint8_t*)malloc(PREFETCH_READ_SIZE);
+        if (!chunk) {
+            Serial.println("❌ Prefetch okuma tamponu ayrılamadı");
+            return false;
+        }
+    }
+    if (!task) {
+        if (xTaskCreatePinnedToCore(taskEntry, "sd_prefetch", PREFETCH_TASK_STACK, this,
+                PREFETCH_TASK_PRIORITY, &task, PREFETCH_TASK_CORE) != pdPASS) {
+            Serial.println("❌ Prefetch task oluşturulamadı");
+            task = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioFileSourcePrefetch::taskEntry(void* arg) {
+    AudioFileSourcePrefetch* self = (AudioFileSourcePrefetch*)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->process()) {
+        }
+    }
+}
+
+void AudioFileSourcePrefetch::lock() {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void AudioFileSourcePrefetch::unlock() {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+// Kilit sırası her zaman ioMutex -> mutex
+void AudioFileSourcePrefetch::lockIo() {
+    if (ioMutex) xSemaphoreTake(ioMutex, portMAX_DELAY);
+}
+
+void AudioFileSourcePrefetch::unlockIo() {
+    if (ioMutex) xSemaphoreGive(ioMutex);
+}
+
+void AudioFileSourcePrefetch::wake() {
+    if (task) xTaskNotifyGive(task);
+}
+
+// Gözlenen bit hızında PREFETCH_LEAD_MS (+ underrun geçmişi kadar) ses
+size_t AudioFileSourcePrefetch::targetCapacity() const {
+    uint32_t rate = bytesPerSecond ? bytesPerSecond : PREFETCH_DEFAULT_BITRATE;
+    uint32_t leadMs = PREFETCH_LEAD_MS + underrunScore * PREFETCH_UNDERRUN_LEAD_MS;
+    size_t target = (size_t)((uint64_t)rate * leadMs / 1000);
+    target = (target + PREFETCH_READ_SIZE - 1) / PREFETCH_READ_SIZE * PREFETCH_READ_SIZE;
+    return constrain(target, (size_t)PREFETCH_MIN_CAPACITY, (size_t)PREFETCH_MAX_CAPACITY);
+}
+
+// Sadece tampon boşken çağrılır, veri taşınmaz. Yeni blok ayrılamazsa
+// eskisiyle devam edilir; hiç tampon yoksa en küçüğü denenir.
+bool AudioFileSourcePrefetch::resizeLocked(size_t newCapacity) {
+    if (fill != 0) {
+        return false;
+    }
+    start = 0;
+    if (ring && newCapacity == capacity) {
+        return true;
+    }
+    uint8_t* resized = (uint8_t*)malloc(newCapacity);
+    if (!resized && !ring) {
+        newCapacity = PREFETCH_MIN_CAPACITY;
+        resized = (uint8_t*)malloc(newCapacity);
+    }
+    if (!resized) {
+        return ring != nullptr;
+    }
+    free(ring);
+    ring = resized;
+    capacity = newCapacity;
+    stats.resizes++;
+    return true;
+}
+
+void AudioFileSourcePrefetch::discardNextLocked(File& closing) {
+    closing = nextFile;
+    nextFile = File();
+    nextPath = "";
+    free(nextData);
+    nextData = nullptr;
+    nextLength = 0;
+    nextTarget = 0;
+    nextDone = false;
+    nextGeneration++;
+}
+
+// Decoder'ın tüketim hızı yaklaşık bit hızıdır; duraklatma pencereyi bozmasın
+void AudioFileSourcePrefetch::noteConsumedLocked(size_t len) {
+    uint32_t now = millis();
+    if (rateStartMs == 0 || now - rateStartMs > 4 * PREFETCH_RATE_WINDOW_MS) {
+        rateStartMs = now ? now : 1;
+        rateBytes = 0;
+    }
+    rateBytes += len;
+    uint32_t elapsed = now - rateStartMs;
+    if (elapsed >= PREFETCH_RATE_WINDOW_MS) {
+        uint32_t measured = (uint32_t)((uint64_t)rateBytes * 1000 / elapsed);
+        bytesPerSecond = bytesPerSecond ? (bytesPerSecond * 3 + measured) / 4 : measured;
+        rateStartMs = now;
+        rateBytes = 0;
+    }
+}
+
+bool AudioFileSourcePrefetch::open(const char* filename) {
+    close();
+
+    lockIo();
+    lock();
+    bool hit = nextPath.length() > 0 && nextPath == filename && nextFile && nextLength > 0;
+    unlock();
+
+    File opening;
+    if (hit) {
+        opening = nextFile;
+        nextFile = File();
+    } else {
+        opening = SD.open(filename, FILE_READ);
+        if (!opening) {
+            unlockIo();
+            Serial.printf("❌ Prefetch: dosya açılamadı: %s\n", filename);
+            return false;
+        }
+    }
+
+    lock();
+    underrunScore /= 2;
+    size_t target = targetCapacity();
+    if (hit && target < nextLength) {
+        target = (nextLength + PREFETCH_READ_SIZE - 1) / PREFETCH_READ_SIZE * PREFETCH_READ_SIZE;
+    }
+    if (!resizeLocked(target)) {
+        unlock();
+        opening.close();
+        unlockIo();
+        Serial.println("❌ Prefetch tamponu ayrılamadı");
+        return false;
+    }
+
+    file = opening;
+    path = filename;
+    size = file.size();
+    readPos = 0;
+    needSeek = false;
+    if (hit) {
+        // Önden okunan baş tampona alınır; dosya konumu zaten nextLength'te
+        size_t count = min(nextLength, capacity);
+        memcpy(ring, nextData, count);
+        fill = count;
+        readPos = count;
+        needSeek = count != nextLength;
+        File unused;
+        discardNextLocked(unused);
+        stats.preloadHits++;
+    }
+    generation++;
+    opened = true;
+    primed = false;
+    stats.opens++;
+    rateStartMs = 0;
+    unlock();
+    unlockIo();
+
+    wake();
+    return true;
+}
+
+uint32_t AudioFileSourcePrefetch::read(void* data, uint32_t len) {
+    uint8_t* out = (uint8_t*)data;
+    uint32_t total = 0;
+    uint32_t stallStart = 0;
+    bool stalled = false;
+
+    while (total < len) {
+        lock();
+        if (!opened) {
+            unlock();
+            break;
+        }
+        size_t count = min((size_t)(len - total), fill);
+        size_t first = min(count, capacity - start);
+        memcpy(out + total, ring + start, first);
+        memcpy(out + total + first, ring, count - first);
+        start = (start + count) % capacity;
+        fill -= count;
+        total += count;
+        if (count) {
+            noteConsumedLocked(count);
+            primed = true;
+        }
+
+        bool ended = fill == 0 && readPos >= size;
+        bool busy = inFlight;
+        if (total < len && !ended && !stalled) {
+            // Underrun: tampon boş, kapasite artırılabilir (veri taşınmaz)
+            stalled = true;
+            stallStart = micros();
+            if (primed) {
+                stats.underruns++;
+                if (underrunScore < PREFETCH_MAX_UNDERRUN_SCORE) underrunScore++;
+                size_t target = targetCapacity();
+                if (target > capacity) resizeLocked(target);
+            }
+        }
+        unlock();
+
+        if (total >= len || ended) {
+            break;
+        }
+        if (micros() - stallStart >= PREFETCH_STALL_TIMEOUT_MS * 1000UL) {
+            break;
+        }
+        // Reader meşgul değilse okuma burada yapılır (task henüz
+        // uyanmadıysa beklemek yerine; host build'de tek yol budur)
+        if (busy || !process()) {
+            wake();
+            vTaskDelay(1);
+        }
+    }
+
+    if (stalled) {
+        uint32_t elapsed = micros() - stallStart;
+        stats.stallTimeUs += elapsed;
+        if (elapsed > stats.maxStallUs) stats.maxStallUs = elapsed;
+    }
+    if (capacity - fill >= PREFETCH_READ_SIZE) {
+        wake();
+    }
+    return total;
+}
+
+uint32_t AudioFileSourcePrefetch::readNonBlock(void* data, uint32_t len) {
+    uint8_t* out = (uint8_t*)data;
+    lock();
+    if (!opened) {
+        unlock();
+        return 0;
+    }
+    size_t count = min((size_t)len, fill);
+    size_t first = min(count, capacity - start);
+    memcpy(out, ring + start, first);
+    memcpy(out + first, ring, count - first);
+    start = (start + count) % capacity;
+    fill -= count;
+    if (count) {
+        noteConsumedLocked(count);
+        primed = true;
+    }
+    bool refill = capacity - fill >= PREFETCH_READ_SIZE;
+    unlock();
+
+    if (refill) wake();
+    return count;
+}
+
+bool AudioFileSourcePrefetch::seek(int32_t pos, int dir) {
+    lock();
+    if (!opened) {
+        unlock();
+        return false;
+    }
+    uint32_t current = readPos - fill;
+    int64_t target = pos;
+    if (dir == SEEK_CUR) target += current;
+    else if (dir == SEEK_END) target += size;
+    if (target < 0 || target > (int64_t)size) {
+        unlock();
+        return false;
+    }
+
+    if (target >= current && target <= readPos) {
+        // İleri atlama tampon içinde kalıyorsa SD'ye gidilmez
+        size_t skip = (size_t)(target - current);
+        start = (start + skip) % capacity;
+        fill -= skip;
+    } else {
+        generation++;
+        start = 0;
+        fill = 0;
+        readPos = (uint32_t)target;
+        needSeek = true;
+        primed = false;
+    }
+    unlock();
+
+    wake();
+    return true;
+}
+
+bool AudioFileSourcePrefetch::close() {
+    lockIo();
+    lock();
+    bool wasOpen = opened;
+    File closing = file;
+    file = File();
+    path = "";
+    opened = false;
+    generation++;
+    start = 0;
+    fill = 0;
+    size = 0;
+    readPos = 0;
+    needSeek = false;
+    // Tampon parça arasında tutulmaz; sıradaki open() bit hızına göre ayırır
+    free(ring);
+    ring = nullptr;
+    capacity = 0;
+    unlock();
+    closing.close();
+    unlockIo();
+    return wasOpen;
+}
+
+uint32_t AudioFileSourcePrefetch::getPos() {
+    lock();
+    uint32_t pos = readPos - fill;
+    unlock();
+    return pos;
+}
+
+void AudioFileSourcePrefetch::preloadNext(const String& next) {
+    File closing;
+    lockIo();
+    lock();
+    if (next == nextPath) {
+        unlock();
+        unlockIo();
+        return;
+    }
+    discardNextLocked(closing);
+    if (next.length() > 0) {
+        uint32_t rate = bytesPerSecond ? bytesPerSecond : PREFETCH_DEFAULT_BITRATE;
+        size_t target = (size_t)((uint64_t)rate * PREFETCH_NEXT_MS / 1000);
+        target = (target + PREFETCH_READ_SIZE - 1) / PREFETCH_READ_SIZE * PREFETCH_READ_SIZE;
+        nextTarget = min(target, (size_t)PREFETCH_NEXT_MAX);
+        nextData = (uint8_t*)malloc(nextTarget);
+        if (nextData) {
+            nextPath = next;
+        }
+    }
+    unlock();
+    closing.close();
+    unlockIo();
+
+    wake();
+}
+
+bool AudioFileSourcePrefetch::process() {
+    enum { JOB_NONE, JOB_CURRENT, JOB_NEXT } job = JOB_NONE;
+
+    lockIo();
+    lock();
+    if (!chunk) {
+        chunk = (uint8_t*)malloc(PREFETCH_READ_SIZE);
+    }
+    uint32_t gen = generation;
+    uint32_t offset = readPos;
+    bool seekFirst = false;
+    size_t length = 0;
+    String openPath;
+
+    // Önce mevcut parça; okumalar PREFETCH_READ_SIZE sınırlarına hizalanır
+    if (opened && chunk && readPos < size) {
+        length = min((size_t)(PREFETCH_READ_SIZE - readPos % PREFETCH_READ_SIZE), (size_t)(size - readPos));
+        if (capacity - fill >= length) {
+            job = JOB_CURRENT;
+            seekFirst = needSeek;
+            needSeek = false;
+        }
+    }
+    // Mevcut parça tampona sığdıysa boşta kalan okuma sıradaki parçaya
+    if (job == JOB_NONE && nextData && !nextDone && nextLength < nextTarget) {
+        job = JOB_NEXT;
+        gen = nextGeneration;
+        length = min((size_t)PREFETCH_READ_SIZE, nextTarget - nextLength);
+        if (!nextFile) openPath = nextPath;
+    }
+    if (job == JOB_NONE) {
+        unlock();
+        unlockIo();
+        return false;
+    }
+    inFlight = true;
+    unlock();
+
+    // SD erişimi sadece ioMutex altında; decoder mutex'i beklemez
+    size_t got = 0;
+    uint32_t began = micros();
+    TRACE_BEGIN(job == JOB_CURRENT ? "sd.read" : "sd.read.next");
+    if (job == JOB_CURRENT) {
+        if (!seekFirst || file.seek(offset)) {
+            got = file.read(chunk, length);
+        }
+    } else {
+        if (openPath.length() > 0) {
+            nextFile = SD.open(openPath, FILE_READ);
+        }
+        if (nextFile) {
+            got = nextFile.read(nextData + nextLength, length);
+        }
+    }
+    uint32_t elapsed = micros() - began;
+    TRACE_END(job == JOB_CURRENT ? "sd.read" : "sd.read.next");
+
+    lock();
+    inFlight = false;
+    stats.reads++;
+    stats.bytesRead += got;
+    stats.readTimeUs += elapsed;
+    if (elapsed > stats.maxReadUs) stats.maxReadUs = elapsed;
+    metrics.sdRead.record(elapsed);
+
+    if (job == JOB_CURRENT && gen == generation) {
+        if (got == 0) {
+            // Okuma hatası: parça burada biter, decoder EOF görür
+            stats.readErrors++;
+            readPos = size;
+        } else {
+            size_t pos = (start + fill) % capacity;
+            size_t first = min(got, capacity - pos);
+            memcpy(ring + pos, chunk, first);
+            memcpy(ring, chunk + first, got - first);
+            fill += got;
+            readPos += got;
+        }
+    } else if (job == JOB_CURRENT) {
+        // Okuma sürerken seek/open oldu; dosya konumu artık belirsiz
+        needSeek = true;
+    } else if (job == JOB_NEXT && gen == nextGeneration) {
+        nextLength += got;
+        if (got < length || nextLength >= nextTarget) {
+            nextDone = true;
+        }
+    }
+    unlock();
+    unlockIo();
+    return true;
+}
+
+void AudioFileSourcePrefetch::resetStats() {
+    lock();
+    memset(&stats, 0, sizeof(stats));
+    unlock();
+}
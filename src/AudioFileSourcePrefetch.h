@@ -0,0 +1,139 @@
+#ifndef AUDIO_FILE_SOURCE_PREFETCH_H
+#define AUDIO_FILE_SOURCE_PREFETCH_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <AudioFileSource.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// SD ile MP3/AAC decoder arasında önden okuyan kaynak.
+//
+// Reader task dosyayı sektör hizalı çok sektörlü okumalarla bir ring
+// buffer'a doldurur; decoder read() ile sadece bellekten kopyalar. SD
+// gecikmesi (FAT araması, eşzamanlı upload yazmaları) tampon boşalana
+// kadar decoder'a yansımaz. Kapasite gözlenen bit hızına ve underrun
+// geçmişine göre ayarlanır; yeniden boyutlandırma sadece tampon boşken
+// (parça açılışı, underrun) yapılır, böylece veri taşınmaz. Mevcut parça
+// tamamen tampona alındığında sıradaki parçanın başı önceden okunur.
+
+#define PREFETCH_SECTOR_SIZE        512
+#define PREFETCH_READ_SIZE          (8 * PREFETCH_SECTOR_SIZE)  // tek SD okuması
+#define PREFETCH_MIN_CAPACITY       (16 * 1024)
+#define PREFETCH_MAX_CAPACITY       (64 * 1024)
+#define PREFETCH_DEFAULT_BITRATE    (320000 / 8)    // ilk parça için varsayım (byte/s)
+#define PREFETCH_LEAD_MS            1500    // tamponda tutulacak ses
+#define PREFETCH_UNDERRUN_LEAD_MS   1000    // underrun başına eklenen
+#define PREFETCH_MAX_UNDERRUN_SCORE 4
+#define PREFETCH_NEXT_MS            2000    // sıradaki parçanın önden okunan başı
+#define PREFETCH_NEXT_MAX           (32 * 1024)
+#define PREFETCH_STALL_TIMEOUT_MS   2000    // read() veriyi en fazla bu kadar bekler
+#define PREFETCH_RATE_WINDOW_MS     1000
+#define PREFETCH_TASK_STACK         4096
+#define PREFETCH_TASK_PRIORITY      4       // upload writer'ın (3) üstünde
+#define PREFETCH_TASK_CORE          0       // ses çekirdeğinden (1) uzak
+
+struct PrefetchStats {
+    uint64_t bytesRead;         // SD'den okunan (önden okuma dahil)
+    uint64_t readTimeUs;
+    uint32_t reads;
+    uint32_t maxReadUs;
+    uint32_t underruns;         // çalma sırasında tamponun boş bulunduğu read() sayısı
+    uint64_t stallTimeUs;       // decoder'ın veri beklediği toplam süre (ilk dolum dahil)
+    uint32_t maxStallUs;
+    uint32_t resizes;
+    uint32_t opens;
+    uint32_t preloadHits;       // önden okunmuş parçayla açılan
+    uint32_t readErrors;
+};
+
+class AudioFileSourcePrefetch : public AudioFileSource {
+private:
+    // Ring buffer (decoder tarafı start'tan okur, reader start + fill'e yazar)
+    uint8_t* ring;
+    size_t capacity;
+    size_t start;
+    size_t fill;
+    uint8_t* chunk;             // reader'ın SD okuma tamponu
+
+    // Mevcut parça
+    File file;
+    String path;
+    uint32_t size;
+    uint32_t readPos;           // SD'de okunacak sıradaki byte
+    bool needSeek;
+    bool opened;
+    uint32_t generation;        // seek/close/open'da artar, eski okumalar atılır
+    bool inFlight;              // bir SD okuması sürüyor
+    bool primed;                // open/seek'ten sonra veri verildi (ilk dolum underrun sayılmaz)
+
+    // Sıradaki parça
+    File nextFile;
+    String nextPath;
+    uint8_t* nextData;
+    size_t nextLength;
+    size_t nextTarget;
+    bool nextDone;
+    uint32_t nextGeneration;
+
+    // Bit hızı ve underrun geçmişi
+    uint32_t rateBytes;
+    uint32_t rateStartMs;
+    uint32_t bytesPerSecond;
+    uint8_t underrunScore;
+
+    PrefetchStats stats;
+    SemaphoreHandle_t mutex;
+    SemaphoreHandle_t ioMutex;  // File nesneleri (reader ve open/close)
+    TaskHandle_t task;
+
+    static void taskEntry(void* arg);
+
+    void lock();
+    void unlock();
+    void lockIo();
+    void unlockIo();
+    void wake();
+    size_t targetCapacity() const;
+    bool resizeLocked(size_t newCapacity);
+    void discardNextLocked(File& closing);
+    void noteConsumedLocked(size_t len);
+
+public:
+    AudioFileSourcePrefetch();
+    virtual ~AudioFileSourcePrefetch();
+
+    // Reader task'ı başlatır (host build'de task çalışmaz, process() elle
+    // veya read() içinden çağrılır)
+    bool begin();
+
+    virtual bool open(const char* filename) override;
+    virtual uint32_t read(void* data, uint32_t len) override;
+    virtual uint32_t readNonBlock(void* data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override { return opened; }
+    virtual uint32_t getSize() override { return size; }
+    virtual uint32_t getPos() override;
+
+    // Sıradaki parçanın başını boşta kalan okuma zamanında önden okur;
+    // open() aynı yolla çağrılırsa dizin araması ve ilk okumalar atlanır.
+    // Boş yol bekleyen önden okumayı iptal eder.
+    void preloadNext(const String& nextPath);
+
+    // Bir SD okuması yapar; yapılacak iş yoksa false
+    bool process();
+
+    const PrefetchStats& getStats() const { return stats; }
+    void resetStats();
+
+    size_t getFill() const { return fill; }
+    size_t getCapacity() const { return capacity; }
+    size_t getPreloaded() const { return nextLength; }
+    uint32_t getBitrateKbps() const { return bytesPerSecond * 8 / 1000; }
+};
+
+extern AudioFileSourcePrefetch audioPrefetch;
+
+#endif // AUDIO_FILE_SOURCE_PREFETCH_H
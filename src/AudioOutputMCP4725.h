@@ -2,67 +2,275 @@
 #define AUDIO_OUTPUT_MCP4725_H
 
 #include <Arduino.h>
+#include <Wire.h>
 #include <Adafruit_MCP4725.h>
+#include <esp_timer.h>
 #include "AudioOutput.h"
+#include "DacOutputStage.h"
+#include "SampleKernel.h"
+#include "Resampler.h"
+#include "I2cArbiter.h"
+#include "Metrics.h"
+#include "Trace.h"
 
-class AudioOutputMCP4725 : public AudioOutput 
+// DAC ve RTC aynı bus'ta; DS3231 de 400 kHz destekliyor
+#define DAC_I2C_CLOCK_HZ      400000
+#define DAC_DEFAULT_RATE      22050       // decoder hızı bilinmeden önce
+// Çıkış hızı bus'ın taşıyabileceğinden hesaplanır; RTC işleri ve sürücü
+// gecikmesi için pay bırakılır. -DDAC_OUTPUT_RATE=<Hz> ile sabitlenebilir.
+#define DAC_MAX_OUTPUT_RATE   22050
+#define DAC_BUS_HEADROOM_PCT  90
+#ifndef DAC_RESAMPLER_QUALITY
+#define DAC_RESAMPLER_QUALITY RESAMPLER_BALANCED
+#endif
+#define DAC_WRITER_STACK      3072
+#define DAC_WRITER_PRIORITY   5
+#define DAC_WRITER_CORE       1
+#define DAC_CONVERT_CHUNK     64
+
+// MCP4725 fast-write: adres byte'ından sonra her örnek için 2 byte
+// (0 0 PD1 PD0 D11..D8, D7..D0), tek transaction'da çok örnek gönderilebilir
+class McpWireBus : public DacBus {
+private:
+    TwoWire& wire;
+    uint8_t address;
+
+public:
+    McpWireBus(TwoWire& _wire, uint8_t _address) :
+        wire(_wire),
+        address(_address) {
+    }
+
+    virtual size_t writeFast(const uint16_t* codes, size_t count) override {
+        wire.beginTransmission(address);
+        for (size_t i = 0; i < count; i++) {
+            wire.write((uint8_t)((codes[i] >> 8) & 0x0F));
+            wire.write((uint8_t)(codes[i] & 0xFF));
+        }
+        return wire.endTransmission() == 0 ? count : 0;
+    }
+};
+
+class AudioOutputMCP4725 : public AudioOutput
 {
 private:
     Adafruit_MCP4725& dac;
     int currentVolume;
-    
+
+    SampleKernel kernel;
+    Resampler resampler;
+    uint32_t outputRate;
+    McpWireBus bus;
+    DacOutputStage stage;
+    TaskHandle_t writerTask;
+    esp_timer_handle_t pacingTimer;
+    bool running;
+
+    // Timer her burst periyodunda writer task'ı uyandırır
+    static void onPacingTimer(void* arg) {
+        AudioOutputMCP4725* self = (AudioOutputMCP4725*)arg;
+        if (self->writerTask) {
+            xTaskNotifyGive(self->writerTask);
+        }
+    }
+
+    static void writerTaskEntry(void* arg) {
+        AudioOutputMCP4725* self = (AudioOutputMCP4725*)arg;
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            TRACE_SCOPE("dac.burst");
+            // Bus önce DAC'ın; RTC okumaları burst'ler arasına yerleşir
+            i2cArbiter.beginBurst();
+            self->stage.pump();
+            i2cArbiter.endBurst(self->stage.getFillLevel(), self->outputRate);
+        }
+    }
+
+    void startPacing() {
+        if (!pacingTimer) return;
+        esp_timer_stop(pacingTimer);
+        uint32_t period = DacOutputStage::burstPeriodUs(outputRate);
+        esp_timer_start_periodic(pacingTimer, period);
+        running = true;
+    }
+
+    void stopPacing() {
+        if (pacingTimer) {
+            esp_timer_stop(pacingTimer);
+        }
+        running = false;
+    }
+
 public:
-    AudioOutputMCP4725(Adafruit_MCP4725& _dac) : 
-        dac(_dac), 
-        currentVolume(100) {
+    AudioOutputMCP4725(Adafruit_MCP4725& _dac, uint8_t i2cAddress = MCP4725_I2CADDR_DEFAULT) :
+        dac(_dac),
+        currentVolume(100),
+#ifdef DAC_OUTPUT_RATE
+        outputRate(DAC_OUTPUT_RATE),
+#else
+        outputRate(outputRateFor(DAC_I2C_CLOCK_HZ)),
+#endif
+        bus(Wire, i2cAddress),
+        stage(&bus),
+        writerTask(nullptr),
+        pacingTimer(nullptr),
+        running(false) {
+        hertz = DAC_DEFAULT_RATE;
+        resampler.configure(hertz, outputRate, DAC_RESAMPLER_QUALITY);
     }
-    
+
+    // Fast-write burst'leri (adres + örnek başına 2 byte) verilen SCL
+    // hızında saniyede kaç örnek taşır; pay bırakılıp 50 Hz'e yuvarlanır
+    static uint32_t outputRateFor(uint32_t i2cHz) {
+        uint64_t bits = 2 + (1 + 2 * DAC_BURST_SAMPLES) * 9;
+        uint64_t burstUs = bits * 1000000ULL / i2cHz + I2C_ARBITER_TXN_OVERHEAD_US;
+        uint64_t rate = (uint64_t)DAC_BURST_SAMPLES * 1000000ULL * DAC_BUS_HEADROOM_PCT / (100 * burstUs);
+        rate -= rate % 50;
+        return (uint32_t)min(rate, (uint64_t)DAC_MAX_OUTPUT_RATE);
+    }
+
     virtual ~AudioOutputMCP4725() {
         stop();
+        if (pacingTimer) {
+            esp_timer_delete(pacingTimer);
+        }
+        if (writerTask) {
+            vTaskDelete(writerTask);
+        }
     }
-    
+
     virtual bool begin() override {
+        if (!writerTask) {
+            Wire.setClock(DAC_I2C_CLOCK_HZ);
+            i2cArbiter.begin(DAC_I2C_CLOCK_HZ);
+            metrics.attachDac(&stage);
+
+            if (xTaskCreatePinnedToCore(writerTaskEntry, "dac_writer", DAC_WRITER_STACK, this,
+                    DAC_WRITER_PRIORITY, &writerTask, DAC_WRITER_CORE) != pdPASS) {
+                Serial.println("❌ DAC writer task oluşturulamadı");
+                writerTask = nullptr;
+                return false;
+            }
+
+            esp_timer_create_args_t timerArgs = {};
+            timerArgs.callback = &AudioOutputMCP4725::onPacingTimer;
+            timerArgs.arg = this;
+            timerArgs.name = "dac_pacing";
+            if (esp_timer_create(&timerArgs, &pacingTimer) != ESP_OK) {
+                Serial.println("❌ DAC pacing timer oluşturulamadı");
+                pacingTimer = nullptr;
+                return false;
+            }
+        }
+
+        stage.resetStats();
+        startPacing();
         return true;
     }
-    
+
     virtual bool ConsumeSample(int16_t sample[2]) override {
-        // 16-bit stereo'dan 12-bit mono'ya dönüştür
-        int32_t mono = (sample[0] + sample[1]) / 2;
-        
-        // Sesi güçlendir (2x)
-        mono *= 2;
-        
-        // Clipping'i önle
-        mono = constrain(mono, -32768, 32767);
-        
-        // -32768 ile 32767 arasındaki değeri 0-4095 aralığına dönüştür
-        uint16_t value = map(mono, -32768, 32767, 0, 4095);
-        
-        // Volume uygula
-        value = (value * currentVolume) / 100;
-        
-        // DAC'a gönder
-        dac.setVoltage(value, false);
-        return true;
+        TRACE_SCOPE_VERBOSE("dac.consume_sample");
+        // Tampon doluysa false dönerek decoder'ı bekletir; yukarı örneklemede
+        // bir frame birden çok çıkış üretebilir
+        if (stage.getSpace() < resampler.maxOutputPerInput()) {
+            stage.noteFull();
+            return false;
+        }
+        int16_t frame[2] = { sample[0], sample[1] };
+        MakeSampleStereo16(frame);
+        return ConsumeSamples(frame, 1) == 1;
+    }
+
+    // Toplu yol: interleaved stereo frame'ler çıkış hızına çevrilip parça
+    // parça DAC koduna dönüştürülür; kabul edilen giriş frame sayısını döndürür
+    size_t ConsumeSamples(const int16_t* interleaved, size_t frames) {
+        TRACE_SCOPE("dac.consume");
+        int16_t resampled[2 * DAC_CONVERT_CHUNK];
+        uint16_t codes[DAC_CONVERT_CHUNK];
+        size_t done = 0;
+
+        while (done < frames) {
+            size_t space = stage.getSpace();
+            if (space > DAC_CONVERT_CHUNK) space = DAC_CONVERT_CHUNK;
+            if (space == 0) {
+                stage.noteFull();
+                break;
+            }
+
+            size_t used;
+            size_t count = resampler.process(interleaved + 2 * done, frames - done, resampled, space, used);
+            if (count > 0) {
+                kernel.convert(resampled, codes, count);
+                stage.pushBlock(codes, count);
+            }
+            done += used;
+        }
+        return done;
+    }
+
+    virtual uint16_t ConsumeSamples(int16_t* samples, uint16_t count) override {
+        return (uint16_t)ConsumeSamples((const int16_t*)samples, (size_t)count);
     }
-    
+
+    // Sessizlik midscale'dir; 0'a çekmek hoparlörde klik yapar. Parça
+    // geçişlerinde çağrılmaz (GaplessChain), sadece çalma durunca.
+    // Tampon bus kilidi altında boşaltılır: writer bir burst'ün ortasında
+    // (pump() içinde) olabilir ve tail'i flush'tan sonra geri yazardı.
     virtual bool stop() override {
-        dac.setVoltage(0, false);
+        stopPacing();
+        i2cArbiter.dacStopped();
+        i2cArbiter.acquire(I2C_DEVICE_DAC, i2cArbiter.transactionUs(3));
+        stage.flush();
+        dac.setVoltage(DAC_MIDSCALE, false);
+        i2cArbiter.release(I2C_DEVICE_DAC);
         return true;
     }
-    
+
     void setVolume(int volume) {
         currentVolume = constrain(volume, 0, 100);
+        kernel.setVolume(currentVolume);
+    }
+
+    void setDither(DitherMode mode) { kernel.setDither(mode); }
+
+    // Writer task'ın bir periyotluk işi; host build'de elle çağrılır
+    size_t pumpOnce() { return stage.pump(); }
+
+    // Tampon doluluğu ve underrun sayaçları
+    size_t getBufferFill() const { return stage.getFillLevel(); }
+    size_t getBufferCapacity() const { return stage.getCapacity(); }
+    const DacOutputStats& getStats() const { return stage.getStats(); }
+
+    // Decoder hızı değişir, DAC hızı değişmez: sadece dönüştürücü yeniden
+    // ayarlanır (parça geçişinde pacing kesilmez)
+    virtual bool SetRate(int hz) override {
+        if (hz < 4000 || hz > 96000) return false;
+        hertz = hz;
+        resampler.configure(hz, outputRate, resampler.getQuality());
+        return true;
+    }
+    virtual bool SetBitsPerSample(int bits) override {
+        if (bits != 8 && bits != 16) return false;
+        bps = bits;
+        return true;
+    }
+    virtual bool SetChannels(int chan) override {
+        if (chan != 1 && chan != 2) return false;
+        channels = chan;
+        return true;
     }
-    
-    // AudioOutput sınıfının diğer sanal fonksiyonlarını implement et
-    virtual bool SetRate(int hz) override { return true; }
-    virtual bool SetBitsPerSample(int bits) override { return true; }
-    virtual bool SetChannels(int channels) override { return true; }
-    virtual bool SetGain(float f) override { 
-        currentVolume = constrain((int)(f * 100), 0, 100);
+
+    // Ses task'ından çağrılmalı (ConsumeSamples ile aynı task)
+    void setResamplerQuality(ResamplerQuality quality) {
+        resampler.configure(hertz, outputRate, quality);
+    }
+
+    ResamplerQuality getResamplerQuality() const { return resampler.getQuality(); }
+    uint32_t getOutputRate() const { return outputRate; }
+    virtual bool SetGain(float f) override {
+        setVolume((int)(f * 100));
         return true;
     }
 };
 
-#endif // AUDIO_OUTPUT_MCP4725_H 
\ No newline at end of file
+#endif // AUDIO_OUTPUT_MCP4725_H
@@ -0,0 +1,185 @@
+#include "AudioTask.h"
+#include "StatusSnapshot.h"
+
+AudioTask audioTask;
+
+AudioTask::AudioTask() :
+    audio(nullptr),
+    task(nullptr),
+    posted(0),
+    dropped(0),
+    trackLoaded(false),
+    lastStatusMs(0),
+    infoFound(false) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool AudioTask::begin(AudioManager& audioManager) {
+    audio = &audioManager;
+    if (!task) {
+        if (xTaskCreatePinnedToCore(taskEntry, "audio", AUDIO_TASK_STACK, this,
+                AUDIO_TASK_PRIORITY, &task, AUDIO_TASK_CORE) != pdPASS) {
+            Serial.println("❌ Audio task oluşturulamadı");
+            task = nullptr;
+            return false;
+        }
+        Serial.printf("✅ Audio task core %d, priority %d\n", AUDIO_TASK_CORE, AUDIO_TASK_PRIORITY);
+    }
+    return true;
+}
+
+void AudioTask::taskEntry(void* arg) {
+    ((AudioTask*)arg)->run();
+}
+
+void AudioTask::run() {
+    while (true) {
+        drain();
+        audio->loop();
+        publishStatus(false);
+
+        // Çalarken her adımdan sonra loop task'ına nefes payı; çalmıyorken
+        // yeni komut (post() uyandırır) veya zaman aşımı beklenir
+        if (audio->isCurrentlyPlaying()) {
+            vTaskDelay(1);
+        } else {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(AUDIO_IDLE_WAIT_MS));
+        }
+    }
+}
+
+bool AudioTask::post(uint8_t type, int32_t value, const char* path) {
+    AudioCommand command;
+    command.type = type;
+    command.value = value;
+    command.postedUs = micros();
+    strlcpy(command.path, path, sizeof(command.path));
+
+    if (!queue.push(command)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        Serial.printf("❌ Audio komut kuyruğu dolu (%u)\n", (unsigned)type);
+        return false;
+    }
+    posted.fetch_add(1, std::memory_order_relaxed);
+    if (task) xTaskNotifyGive(task);
+    return true;
+}
+
+void AudioTask::setVolume(int volume) {
+    pendingVolume.post(constrain(volume, 0, 100));
+    if (task) xTaskNotifyGive(task);
+}
+
+void AudioTask::seek(uint32_t seconds) {
+    pendingSeek.post((int32_t)min(seconds, (uint32_t)INT32_MAX));
+    if (task) xTaskNotifyGive(task);
+}
+
+uint32_t AudioTask::drain() {
+    AudioCommand command;
+    uint32_t count = 0;
+    while (queue.pop(command)) {
+        apply(command);
+        uint32_t latency = micros() - command.postedUs;
+        if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+        count++;
+    }
+    count += applyCoalesced();
+    if (count) {
+        stats.applied += count;
+        if (count > stats.maxBatch) stats.maxBatch = count;
+        trackLoaded.store(audio->getCurrentTrack().length() > 0, std::memory_order_release);
+        publishStatus(true);
+    }
+    return count;
+}
+
+// drain() decode adımları arasında çalıştığından değerler çerçeve
+// sınırında uygulanır. Aradaki güncellemeler zaten üzerine yazılmıştır.
+uint32_t AudioTask::applyCoalesced() {
+    uint32_t count = 0;
+    int32_t value;
+    if (pendingVolume.take(value)) {
+        audio->setVolume(value);
+        stats.volumeApplied++;
+        count++;
+    }
+    if (pendingSeek.take(value)) {
+        if (audio->getCurrentTrack().length() > 0) {
+            audio->seek((uint32_t)value);
+            stats.seekApplied++;
+        }
+        count++;
+    }
+    return count;
+}
+
+void AudioTask::apply(const AudioCommand& command) {
+    switch (command.type) {
+        case AUDIO_CMD_PLAY:
+            pendingSeek.clear();    // önceki parçanın pozisyonu
+            audio->play(String(command.path));
+            break;
+        case AUDIO_CMD_RESUME:
+            if (audio->getCurrentTrack().length() > 0) {
+                audio->play();
+            } else {
+                LibraryPath first;
+                if (libraryIndex.getPath(0, first)) {
+                    audio->play(first.c_str());
+                }
+            }
+            break;
+        case AUDIO_CMD_PAUSE:
+            audio->pause();
+            break;
+        case AUDIO_CMD_STOP:
+            pendingSeek.clear();
+            audio->stop();
+            break;
+        case AUDIO_CMD_NEXT:
+            pendingSeek.clear();
+            audio->next();
+            break;
+        case AUDIO_CMD_PREVIOUS:
+            pendingSeek.clear();
+            audio->previous();
+            break;
+        case AUDIO_CMD_LOOPING:
+            audio->setLooping(command.value != 0);
+            statusSnapshot.setLooping(command.value != 0);
+            break;
+    }
+}
+
+// Ses alanlarının sahibi bu task; diğer task'lar AudioManager'ı okumaz.
+// Komuttan sonra hemen, çalarken pozisyon için periyodik yayınlanır.
+void AudioTask::publishStatus(bool full) {
+    uint32_t now = millis();
+    if (!full && now - lastStatusMs < AUDIO_STATUS_INTERVAL_MS) {
+        return;
+    }
+    lastStatusMs = now;
+    statusSnapshot.setPlaying(audio->isCurrentlyPlaying());
+    statusSnapshot.setVolume(audio->getVolume());
+    String track = audio->getCurrentTrack();
+    if (infoPath != track.c_str()) {
+        refreshTrackInfo(track);
+    }
+    statusSnapshot.setTrack(track);
+    statusSnapshot.setPosition(audio->getCurrentPosition());
+
+    // Süre indeksten (VBR için Xing/VBRI); indekste olmayan parçada decoder'ın tahmini
+    if (infoFound) {
+        statusSnapshot.setTrackTags(info.title, info.artist, info.album);
+        statusSnapshot.setDuration(info.durationMs ? (info.durationMs + 500) / 1000 : audio->getTrackDuration());
+    } else {
+        statusSnapshot.setTrackTags("", "", "");
+        statusSnapshot.setDuration(audio->getTrackDuration());
+    }
+}
+
+void AudioTask::refreshTrackInfo(const String& track) {
+    infoPath = track.c_str();
+    infoFound = track.length() > 0 && libraryIndex.findTrack(track.c_str(), info);
+}
@@ -0,0 +1,125 @@
+#ifndef AUDIO_TASK_H
+#define AUDIO_TASK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "AudioManager.h"
+#include "LibraryIndex.h"
+#include "MpscQueue.h"
+#include "CoalescingSlot.h"
+
+// Decoder'ı çalıştıran, çekirdeğe sabitlenmiş ses task'ı.
+//
+// AudioManager'a sadece bu task dokunur. Web (async_tcp), WebSocket, MQTT
+// ve BLE komutları kilitsiz bir MPSC kuyruğa yazılır; task kuyruğu her
+// decode adımından önce boşaltır. Kontrol trafiği çalmayı bekletemez ve
+// AudioManager'ı eşzamanlı çağıramaz. Ağ task'ları diğer çekirdekte
+// (CONFIG_ASYNC_TCP_RUNNING_CORE=0) çalışır; bu çekirdekte sadece DAC
+// writer (daha yüksek öncelik) ve loop task'ı vardır.
+//
+// audioManager.loop() artık bu task'tan çağrılır, Arduino loop()'undan
+// çağrılmamalıdır.
+//
+// Ses seviyesi ve pozisyon (seek) kuyruğa girmez: her kaynak aynı
+// CoalescingSlot'a yazar, task çerçeve sınırında sadece son değeri uygular.
+// Kazanç değişimi çıkış katında rampayla yapılır (SampleKernel).
+
+#define AUDIO_TASK_STACK            8192    // MP3/AAC decoder
+#define AUDIO_TASK_PRIORITY         4       // DAC writer'ın (5) altında
+#define AUDIO_TASK_CORE             1
+#define AUDIO_COMMAND_CAPACITY      16
+#define AUDIO_IDLE_WAIT_MS          20      // çalmıyorken komut bekleme süresi
+#define AUDIO_STATUS_INTERVAL_MS    250     // pozisyon/süre örnekleme aralığı
+
+enum AudioCommandType : uint8_t {
+    AUDIO_CMD_PLAY = 0,     // path
+    AUDIO_CMD_RESUME,       // parça yoksa kütüphanenin ilki
+    AUDIO_CMD_PAUSE,
+    AUDIO_CMD_STOP,
+    AUDIO_CMD_NEXT,
+    AUDIO_CMD_PREVIOUS,
+    AUDIO_CMD_LOOPING       // value: 0/1
+};
+
+struct AudioCommand {
+    uint8_t type;
+    int32_t value;
+    uint32_t postedUs;
+    char path[LIBRARY_MAX_PATH + 1];
+};
+
+struct AudioTaskStats {
+    uint32_t applied;
+    uint32_t maxBatch;          // tek turda uygulanan en fazla komut
+    uint32_t maxLatencyUs;      // gönderimden uygulamaya
+    uint32_t volumeApplied;     // kuyruk dışı, birleştirilmiş değerler
+    uint32_t seekApplied;
+};
+
+class AudioTask {
+private:
+    AudioManager* audio;
+    MpscQueue<AudioCommand, AUDIO_COMMAND_CAPACITY> queue;
+    TaskHandle_t task;
+    std::atomic<uint32_t> posted;
+    std::atomic<uint32_t> dropped;
+    std::atomic<bool> trackLoaded;
+    CoalescingSlot pendingVolume;
+    CoalescingSlot pendingSeek;     // saniye
+    AudioTaskStats stats;
+    uint32_t lastStatusMs;
+
+    // Çalan parçanın indeks kaydı; parça değişince bir kez aranır
+    LibraryPath infoPath;
+    LibraryTrack info;
+    bool infoFound;
+
+    static void taskEntry(void* arg);
+
+    void run();
+    bool post(uint8_t type, int32_t value, const char* path = "");
+    void apply(const AudioCommand& command);
+    uint32_t applyCoalesced();
+    void publishStatus(bool full);
+    void refreshTrackInfo(const String& track);
+
+public:
+    AudioTask();
+
+    bool begin(AudioManager& audioManager);
+
+    // Herhangi bir task'tan çağrılabilir; kuyruk doluysa false
+    bool play(const char* path) { return post(AUDIO_CMD_PLAY, 0, path); }
+    bool play(const String& path) { return post(AUDIO_CMD_PLAY, 0, path.c_str()); }
+    bool resume() { return post(AUDIO_CMD_RESUME, 0); }
+    bool pause() { return post(AUDIO_CMD_PAUSE, 0); }
+    bool stop() { return post(AUDIO_CMD_STOP, 0); }
+    bool next() { return post(AUDIO_CMD_NEXT, 0); }
+    bool previous() { return post(AUDIO_CMD_PREVIOUS, 0); }
+    bool setLooping(bool enabled) { return post(AUDIO_CMD_LOOPING, enabled ? 1 : 0); }
+
+    // Son yazan kazanır; kuyruğa girmez, hiçbir zaman reddedilmez
+    void setVolume(int volume);
+    void seek(uint32_t seconds);
+
+    // Bekleyen komutları uygular; ses task'ı her decode adımından önce
+    // çağırır. Uygulanan komut sayısını döndürür.
+    uint32_t drain();
+
+    // Son uygulanan komuttan sonra yüklü bir parça var mı (ağ task'ları
+    // AudioManager'ın String'lerini okumadan karar verebilsin)
+    bool hasTrack() const { return trackLoaded.load(std::memory_order_acquire); }
+
+    uint32_t getPosted() const { return posted.load(std::memory_order_relaxed); }
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+    uint32_t getSuperseded() const {
+        return pendingVolume.getSuperseded() + pendingSeek.getSuperseded();
+    }
+    const AudioTaskStats& getStats() const { return stats; }
+};
+
+extern AudioTask audioTask;
+
+#endif // AUDIO_TASK_H
@@ -9,6 +9,7 @@
 #include <ArduinoJson.h>
 #include "AudioManager.h"
 #include "TimeManager.h"
+#include "StatusSnapshot.h"
 #include "config.h"
 
 // BLE Servis ve Karakteristik UUID'leri
@@ -32,6 +33,7 @@ private:
     
     bool deviceConnected;
     bool oldDeviceConnected;
+    uint32_t lastStatusVersion;     // son notify edilen StatusSnapshot sürümü
     
     // BLE callbacks
     void onConnect(BLEServer* pServer) override;
@@ -42,9 +44,6 @@ private:
     void handlePlaybackCommand(const String& command);
     void handleVolumeCommand(const String& command);
     void handleTimerCommand(const String& command);
-    
-    // Status JSON oluşturma
-    String createStatusJson();
 
 public:
     BluetoothManager(AudioManager& audio, TimeManager& time) : 
@@ -55,7 +54,8 @@ public:
 >>>>>>> stable-power-audio
         timeManager(time),
         deviceConnected(false),
-        oldDeviceConnected(false) {}
+        oldDeviceConnected(false),
+        lastStatusVersion(0) {}
     
 <<<<<<< HEAD
     bool begin();
@@ -67,7 +67,8 @@ public:
     bool begin();
     void loop();
     
-    // Status güncelleme
+    // Status güncelleme: statusSnapshot sürümü değiştiyse paylaşılan
+    // frame status karakteristiğine yazılıp notify edilir
     void updateStatus();
     
     // Durum kontrolü
@@ -0,0 +1,53 @@
+#ifndef COALESCING_SLOT_H
+#define COALESCING_SLOT_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Son yazanın kazandığı tek değerlik komut yuvası.
+//
+// Ses seviyesi ve pozisyon gibi mutlak değerlerde ara değerlerin bir
+// anlamı yok: slider sürüklenirken gelen her güncelleme bekleyen değerin
+// üzerine yazılır, tüketici bir sonraki çerçeve sınırında sadece en
+// sonuncuyu uygular. Herhangi bir task'tan kilitsiz yazılabilir ve
+// kuyruk gibi dolmaz.
+class CoalescingSlot {
+private:
+    static const int32_t EMPTY = INT32_MIN;
+
+    std::atomic<int32_t> pending;
+    std::atomic<uint32_t> posted;
+    std::atomic<uint32_t> superseded;   // uygulanmadan üzerine yazılan
+
+public:
+    CoalescingSlot() :
+        pending(EMPTY),
+        posted(0),
+        superseded(0) {
+    }
+
+    void post(int32_t value) {
+        posted.fetch_add(1, std::memory_order_relaxed);
+        if (pending.exchange(value, std::memory_order_acq_rel) != EMPTY) {
+            superseded.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Sadece tüketici; bekleyen değer varsa alır ve yuvayı boşaltır
+    bool take(int32_t& value) {
+        int32_t v = pending.exchange(EMPTY, std::memory_order_acq_rel);
+        if (v == EMPTY) return false;
+        value = v;
+        return true;
+    }
+
+    // Bekleyen değeri uygulamadan atar (ör. parça değişince eski pozisyon)
+    void clear() {
+        pending.store(EMPTY, std::memory_order_release);
+    }
+
+    uint32_t getPosted() const { return posted.load(std::memory_order_relaxed); }
+    uint32_t getSuperseded() const { return superseded.load(std::memory_order_relaxed); }
+};
+
+#endif // COALESCING_SLOT_H
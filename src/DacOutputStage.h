@@ -0,0 +1,180 @@
+#ifndef DAC_OUTPUT_STAGE_H
+#define DAC_OUTPUT_STAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Ring buffer kapasitesi (örnek sayısı, 2'nin kuvveti olmalı)
+#ifndef DAC_RING_SAMPLES
+#define DAC_RING_SAMPLES 4096
+#endif
+
+// Tek I2C transaction'da yazılan örnek sayısı.
+// ESP32 Wire tamponu 128 byte, fast-write modunda her örnek 2 byte.
+#ifndef DAC_BURST_SAMPLES
+#define DAC_BURST_SAMPLES 32
+#endif
+
+#define DAC_MIDSCALE 2048
+
+static_assert((DAC_RING_SAMPLES & (DAC_RING_SAMPLES - 1)) == 0, "DAC_RING_SAMPLES 2'nin kuvveti olmalı");
+
+// DAC'a blok halinde 12-bit kod yazan bus soyutlaması.
+// ESP32'de Wire üzerinden, host build'de mock bus ile çalışır.
+class DacBus {
+public:
+    virtual ~DacBus() {}
+
+    // Kodları tek transaction'da yazar, yazılan örnek sayısını döndürür (hata: 0)
+    virtual size_t writeFast(const uint16_t* codes, size_t count) = 0;
+};
+
+// Tek üretici (decoder) / tek tüketici (DAC writer) örnek kuyruğu
+class DacSampleRing {
+private:
+    uint16_t buffer[DAC_RING_SAMPLES];
+    std::atomic<uint32_t> head;   // sadece üretici yazar
+    std::atomic<uint32_t> tail;   // sadece tüketici yazar
+
+public:
+    DacSampleRing() : head(0), tail(0) {}
+
+    size_t capacity() const { return DAC_RING_SAMPLES; }
+
+    size_t available() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    size_t space() const { return DAC_RING_SAMPLES - available(); }
+
+    bool push(uint16_t code) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= DAC_RING_SAMPLES) {
+            return false;
+        }
+        buffer[h & (DAC_RING_SAMPLES - 1)] = code;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t pushBlock(const uint16_t* codes, size_t count) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        size_t free = DAC_RING_SAMPLES - (h - tail.load(std::memory_order_acquire));
+        if (count > free) count = free;
+        for (size_t i = 0; i < count; i++) {
+            buffer[(h + i) & (DAC_RING_SAMPLES - 1)] = codes[i];
+        }
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t pop(uint16_t* out, size_t maxCount) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        size_t count = head.load(std::memory_order_acquire) - t;
+        if (count > maxCount) count = maxCount;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = buffer[(t + i) & (DAC_RING_SAMPLES - 1)];
+        }
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    // Sadece tüketici tarafında (writer durmuşken) çağrılmalı
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
+
+struct DacOutputStats {
+    uint32_t samplesWritten;
+    uint32_t transactions;
+    uint32_t underruns;     // periyotta tam burst için yeterli örnek yoktu
+    uint32_t fullEvents;    // tampon doluydu, decoder geri itildi
+    uint32_t busErrors;
+    uint32_t minFill;       // son resetten beri görülen en düşük doluluk
+};
+
+// Ring buffer + periyodik writer. pump() her burst periyodunda bir kez
+// çağrılır (ESP32'de timer ile tetiklenen task, host'ta simülasyon döngüsü).
+class DacOutputStage {
+private:
+    DacBus* bus;
+    DacSampleRing ring;
+    DacOutputStats stats;
+    uint16_t burst[DAC_BURST_SAMPLES];
+
+public:
+    DacOutputStage(DacBus* _bus = nullptr) :
+        bus(_bus) {
+        resetStats();
+    }
+
+    void setBus(DacBus* _bus) { bus = _bus; }
+
+    // Üretici tarafı
+    bool push(uint16_t code) {
+        if (!ring.push(code)) {
+            stats.fullEvents++;
+            return false;
+        }
+        return true;
+    }
+
+    size_t pushBlock(const uint16_t* codes, size_t count) {
+        size_t pushed = ring.pushBlock(codes, count);
+        if (pushed < count) stats.fullEvents++;
+        return pushed;
+    }
+
+    // Üretici tampon dolu diye yazmadan döndü
+    void noteFull() { stats.fullEvents++; }
+
+    // Tüketici tarafı: bir burst yazar, yazılan örnek sayısını döndürür
+    size_t pump() {
+        size_t fill = ring.available();
+        if (fill < stats.minFill) stats.minFill = fill;
+
+        if (fill < DAC_BURST_SAMPLES) {
+            stats.underruns++;
+            // Boşsa DAC son değerini korur, yazacak bir şey yok
+            if (fill == 0) return 0;
+        }
+
+        size_t count = ring.pop(burst, DAC_BURST_SAMPLES);
+        if (!bus) return 0;
+
+        size_t written = bus->writeFast(burst, count);
+        stats.transactions++;
+        if (written != count) {
+            stats.busErrors++;
+        }
+        stats.samplesWritten += written;
+        return written;
+    }
+
+    // pump() ile eşzamanlı çağrılmamalı (ESP32'de bus kilidi altında)
+    void flush() { ring.clear(); }
+
+    size_t getFillLevel() const { return ring.available(); }
+    size_t getCapacity() const { return ring.capacity(); }
+    size_t getSpace() const { return ring.space(); }
+    const DacOutputStats& getStats() const { return stats; }
+
+    void resetStats() {
+        stats.samplesWritten = 0;
+        stats.transactions = 0;
+        stats.underruns = 0;
+        stats.fullEvents = 0;
+        stats.busErrors = 0;
+        stats.minFill = DAC_RING_SAMPLES;
+    }
+
+    // Verilen örnekleme hızında bir burst'ün süresi (mikrosaniye)
+    static uint32_t burstPeriodUs(uint32_t sampleRate) {
+        if (sampleRate == 0) return 0;
+        return (uint32_t)(((uint64_t)DAC_BURST_SAMPLES * 1000000ULL) / sampleRate);
+    }
+};
+
+#endif // DAC_OUTPUT_STAGE_H
@@ -0,0 +1,90 @@
+#ifndef DS3231_TIMER_ALARM_H
+#define DS3231_TIMER_ALARM_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <RTClib.h>
+#include "TimerScheduler.h"
+#include "I2cArbiter.h"
+
+// DS3231 Alarm 1 + INT/SQW kesmesi. INT açık-drain, aktif düşük;
+// alarm bayrağı temizlenene kadar düşük kalır. begin() dışındaki I2C
+// erişimleri i2cArbiter üzerinden DAC burst'lerinin arasına yerleşir.
+#ifndef RTC_INT_PIN
+#define RTC_INT_PIN 4
+#endif
+
+class Ds3231TimerAlarm : public TimerAlarm {
+private:
+    RTC_DS3231 rtc;
+    uint8_t pin;
+    volatile bool pending;
+
+    // Header'da tanımlı olduğundan statik üye yerine
+    static Ds3231TimerAlarm*& instance() {
+        static Ds3231TimerAlarm* current = nullptr;
+        return current;
+    }
+
+    static void IRAM_ATTR onInterrupt() {
+        Ds3231TimerAlarm* self = instance();
+        if (self) self->pending = true;
+    }
+
+public:
+    Ds3231TimerAlarm(uint8_t _pin = RTC_INT_PIN) :
+        pin(_pin),
+        pending(false) {
+    }
+
+    bool begin() {
+        if (!rtc.begin(&Wire)) {
+            Serial.println("❌ DS3231 alarmı başlatılamadı");
+            return false;
+        }
+        // INT/SQW kare dalga yerine alarm çıkışı olarak
+        rtc.writeSqwPinMode(DS3231_OFF);
+        rtc.disableAlarm(2);
+        rtc.clearAlarm(1);
+        rtc.clearAlarm(2);
+
+        instance() = this;
+        pinMode(pin, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(pin), onInterrupt, FALLING);
+        return true;
+    }
+
+    virtual uint32_t now() override {
+        i2cArbiter.acquire(I2C_DEVICE_RTC, i2cArbiter.transactionUs(2) + i2cArbiter.transactionUs(8));
+        uint32_t seconds = rtc.now().unixtime();
+        i2cArbiter.release(I2C_DEVICE_RTC);
+        return seconds;
+    }
+
+    // Alarm 1 gün-saat-dakika-saniye eşleşmesiyle çalışır (ay yok); bir
+    // aydan uzak bir an erken eşleşirse scheduler boş uyanıp yeniden kurar
+    virtual void program(uint32_t deadline) override {
+        // Kontrol register'ı oku-değiştir-yaz + alarm register'ları
+        i2cArbiter.acquire(I2C_DEVICE_RTC, 4 * i2cArbiter.transactionUs(3) + i2cArbiter.transactionUs(6));
+        if (deadline == 0) {
+            rtc.disableAlarm(1);
+        } else {
+            rtc.clearAlarm(1);
+            rtc.setAlarm1(DateTime(deadline), DS3231_A1_Date);
+        }
+        i2cArbiter.release(I2C_DEVICE_RTC);
+    }
+
+    virtual bool fired() override {
+        return pending;
+    }
+
+    virtual void acknowledge() override {
+        pending = false;
+        i2cArbiter.acquire(I2C_DEVICE_RTC, 2 * i2cArbiter.transactionUs(3));
+        rtc.clearAlarm(1);
+        i2cArbiter.release(I2C_DEVICE_RTC);
+    }
+};
+
+#endif // DS3231_TIMER_ALARM_H
@@ -0,0 +1,125 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Sabit kapasiteli metin: tampon nesnenin içindedir, heap'e hiç gitmez.
+// Yol birleştirme, parametre normalizasyonu ve kısa yanıt gövdeleri gibi
+// istek başına kurulan String'lerin yerine kullanılır (cihaz haftalarca
+// açık kaldığında küçük, farklı boyutlu String'ler heap'i parçalar).
+//
+// Sığmayan ekleme kesilir ve truncated() true olur; yol gibi kesilmesi
+// anlamı bozan değerlerde çağıran kontrol eder.
+template <size_t N>
+class FixedString {
+private:
+    char buffer[N + 1];
+    size_t len;
+    bool overflow;
+
+public:
+    FixedString() :
+        len(0),
+        overflow(false) {
+        buffer[0] = '\0';
+    }
+
+    explicit FixedString(const char* text) :
+        FixedString() {
+        append(text);
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+    const char* c_str() const { return buffer; }
+    size_t length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    bool truncated() const { return overflow; }
+
+    void clear() {
+        len = 0;
+        overflow = false;
+        buffer[0] = '\0';
+    }
+
+    FixedString& append(const char* text, size_t count) {
+        if (count > N - len) {
+            count = N - len;
+            overflow = true;
+        }
+        memcpy(buffer + len, text, count);
+        len += count;
+        buffer[len] = '\0';
+        return *this;
+    }
+
+    FixedString& append(const char* text) {
+        return text ? append(text, strlen(text)) : *this;
+    }
+
+    FixedString& append(const String& text) {
+        return append(text.c_str(), text.length());
+    }
+
+    FixedString& append(char c) {
+        return append(&c, 1);
+    }
+
+    FixedString& appendf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buffer + len, N + 1 - len, format, args);
+        va_end(args);
+        if (n < 0) {
+            buffer[len] = '\0';
+        } else if ((size_t)n > N - len) {
+            len = N;
+            overflow = true;
+        } else {
+            len += n;
+        }
+        return *this;
+    }
+
+    FixedString& operator+=(const char* text) { return append(text); }
+    FixedString& operator+=(char c) { return append(c); }
+
+    FixedString& operator=(const char* text) {
+        clear();
+        return append(text);
+    }
+
+    bool operator==(const char* text) const { return strcmp(buffer, text ? text : "") == 0; }
+    bool operator!=(const char* text) const { return !(*this == text); }
+
+    int indexOf(char c) const {
+        const char* p = strchr(buffer, c);
+        return p ? (int)(p - buffer) : -1;
+    }
+
+    int lastIndexOf(char c) const {
+        const char* p = strrchr(buffer, c);
+        return p ? (int)(p - buffer) : -1;
+    }
+
+    bool contains(const char* text) const { return strstr(buffer, text) != nullptr; }
+
+    bool startsWith(const char* prefix) const {
+        return strncmp(buffer, prefix, strlen(prefix)) == 0;
+    }
+
+    // Uzantı kontrolleri için ASCII büyük/küçük harf duyarsız
+    bool endsWithIgnoreCase(const char* suffix) const {
+        size_t n = strlen(suffix);
+        return n <= len && strcasecmp(buffer + len - n, suffix) == 0;
+    }
+
+    void replace(char from, char to) {
+        for (size_t i = 0; i < len; i++) {
+            if (buffer[i] == from) buffer[i] = to;
+        }
+    }
+};
+
+#endif // FIXED_STRING_H
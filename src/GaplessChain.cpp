@@ -0,0 +1,204 @@
+#include "GaplessChain.h"
+#include "Trace.h"
+
+GaplessLane::GaplessLane() :
+    head(0),
+    count(0),
+    limit(GAPLESS_LANE_FRAMES),
+    loaded(false),
+    ended(false) {
+}
+
+void GaplessLane::reset() {
+    head = 0;
+    count = 0;
+    limit = GAPLESS_LANE_FRAMES;
+    path = "";
+    loaded = false;
+    ended = false;
+}
+
+int16_t* GaplessLane::peek(size_t& contiguous) {
+    contiguous = min(count, (size_t)GAPLESS_LANE_FRAMES - head);
+    return &frames[2 * head];
+}
+
+void GaplessLane::consume(size_t n) {
+    n = min(n, count);
+    head = (head + n) % GAPLESS_LANE_FRAMES;
+    count -= n;
+}
+
+bool GaplessLane::ConsumeSample(int16_t sample[2]) {
+    TRACE_SCOPE_VERBOSE("lane.consume_sample");
+    // Dolu şerit decoder'ı bekletir (ESP8266Audio örneği tekrar dener)
+    if (count >= limit) {
+        return false;
+    }
+    int16_t s[2] = { sample[0], sample[1] };
+    MakeSampleStereo16(s);
+    size_t index = (head + count) % GAPLESS_LANE_FRAMES;
+    frames[2 * index] = s[0];
+    frames[2 * index + 1] = s[1];
+    count++;
+    return true;
+}
+
+uint16_t GaplessLane::ConsumeSamples(int16_t* samples, uint16_t frameCount) {
+    size_t n = min((size_t)frameCount, space());
+    size_t tail = (head + count) % GAPLESS_LANE_FRAMES;
+    size_t first = min(n, (size_t)GAPLESS_LANE_FRAMES - tail);
+    memcpy(frames + 2 * tail, samples, first * 4);
+    memcpy(frames, samples + 2 * first, (n - first) * 4);
+    count += n;
+    return (uint16_t)n;
+}
+
+GaplessChain::GaplessChain() :
+    sink(nullptr),
+    active(0),
+    playing(false),
+    sinkRate(0),
+    lastSampleUs(0),
+    switchPending(false) {
+    decoders[0] = nullptr;
+    decoders[1] = nullptr;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void GaplessChain::begin(AudioOutput* output, GaplessDecoder* first, GaplessDecoder* second) {
+    sink = output;
+    decoders[0] = first;
+    decoders[1] = second;
+}
+
+bool GaplessChain::startLane(uint8_t index, const String& path, size_t limit) {
+    GaplessLane& lane = lanes[index];
+    lane.reset();
+    lane.setLimit(limit);
+    if (!decoders[index] || !decoders[index]->begin(path, &lane)) {
+        Serial.printf("❌ Gapless: %s açılamadı\n", path.c_str());
+        stats.decodeErrors++;
+        return false;
+    }
+    lane.path = path;
+    lane.loaded = true;
+    return true;
+}
+
+void GaplessChain::stopLane(uint8_t index) {
+    GaplessLane& lane = lanes[index];
+    if (lane.loaded && !lane.ended && decoders[index]) {
+        decoders[index]->stop();
+    }
+    lane.reset();
+}
+
+bool GaplessChain::play(const String& path) {
+    if (!sink) return false;
+    stopLane(0);
+    stopLane(1);
+    switchPending = false;
+    stats.coldStarts++;
+    playing = startLane(active, path, GAPLESS_LANE_FRAMES);
+    return playing;
+}
+
+bool GaplessChain::queueNext(const String& path) {
+    uint8_t next = active ^ 1;
+    stopLane(next);
+    if (path.length() == 0) {
+        return true;
+    }
+    return startLane(next, path, GAPLESS_PREROLL_FRAMES);
+}
+
+void GaplessChain::decodeLane(uint8_t index) {
+    GaplessLane& lane = lanes[index];
+    if (!lane.loaded || lane.ended || lane.space() == 0) {
+        return;
+    }
+    TRACE_SCOPE(index == active ? "decode" : "decode.next");
+    if (!decoders[index]->loop()) {
+        // Son örnekler şeritte; decoder'ın işi bitti
+        decoders[index]->stop();
+        lane.ended = true;
+    }
+}
+
+void GaplessChain::switchLanes() {
+    GaplessLane& next = lanes[active ^ 1];
+    stats.prerollAtSwitch = next.available();
+    lanes[active].reset();
+    active ^= 1;
+    next.setLimit(GAPLESS_LANE_FRAMES);
+    stats.transitions++;
+    switchPending = true;
+}
+
+size_t GaplessChain::pump() {
+    TRACE_SCOPE("pump");
+    size_t written = 0;
+    while (true) {
+        GaplessLane& lane = lanes[active];
+        size_t n;
+        int16_t* data = lane.peek(n);
+
+        if (n > 0) {
+            if (lane.getRate() != sinkRate) {
+                sinkRate = lane.getRate();
+                sink->SetRate(sinkRate);
+                stats.rateChanges++;
+            }
+            if (n > GAPLESS_PUMP_CHUNK) n = GAPLESS_PUMP_CHUNK;
+            size_t done = sink->ConsumeSamples(data, (uint16_t)n);
+            if (done > 0) {
+                uint32_t now = micros();
+                if (switchPending) {
+                    stats.lastSwitchUs = now - lastSampleUs;
+                    if (stats.lastSwitchUs > stats.maxSwitchUs) stats.maxSwitchUs = stats.lastSwitchUs;
+                    switchPending = false;
+                }
+                lane.consume(done);
+                lastSampleUs = now;
+                written += done;
+            }
+            if (done < n) break;    // DAC tamponu dolu
+            continue;
+        }
+
+        // Aktif şerit bitti ve boşaldı: örnek sınırında sıradakine geç
+        if (lane.ended && lanes[active ^ 1].loaded) {
+            switchLanes();
+            continue;
+        }
+        break;
+    }
+    return written;
+}
+
+bool GaplessChain::loop() {
+    if (!playing) {
+        return false;
+    }
+
+    decodeLane(active);
+    decodeLane(active ^ 1);
+    pump();
+
+    GaplessLane& lane = lanes[active];
+    if (lane.ended && lane.available() == 0 && !lanes[active ^ 1].loaded) {
+        playing = false;
+    }
+    return playing;
+}
+
+void GaplessChain::stop() {
+    stopLane(0);
+    stopLane(1);
+    playing = false;
+    switchPending = false;
+    if (sink) {
+        sink->stop();
+    }
+}
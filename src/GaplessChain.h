@@ -0,0 +1,135 @@
+#ifndef GAPLESS_CHAIN_H
+#define GAPLESS_CHAIN_H
+
+#include <Arduino.h>
+#include <AudioOutput.h>
+
+// Parçalar arası boşluksuz geçiş.
+//
+// İki decoder iki ayrı şeride (lane) PCM yazar; çıkış katına (DAC)
+// sadece aktif şerit aktarılır. Sıradaki parça, mevcut parça bitmeden
+// açılır, başlığı okunur ve birkaç çerçeve önden çözülür. Aktif şeridin
+// son örneği DAC'a yazıldığı anda aynı pump() içinde diğer şeride
+// geçilir: decoder kapatılıp açılmaz, DAC durdurulmaz, ara sessizlik
+// olmaz. Örnekleme hızı farklıysa geçiş anında SetRate() çağrılır.
+//
+// Hepsi ses task'ında çalışır; şeritler tek task'a ait olduğundan kilit
+// veya atomik gerekmez.
+
+#define GAPLESS_LANE_FRAMES     2048    // şerit başına stereo frame (8 KB)
+#define GAPLESS_PREROLL_FRAMES  1152    // sıradaki parçadan önden çözülen (~1 MP3 çerçevesi)
+#define GAPLESS_PUMP_CHUNK      256
+
+// Decoder + kaynak çifti (ESP32'de AudioGeneratorMP3 ve kendi
+// AudioFileSourcePrefetch'i, host'ta sentetik decoder)
+class GaplessDecoder {
+public:
+    virtual ~GaplessDecoder() {}
+
+    // Dosyayı açar ve başlığı okur; çıkış olarak şeridi alır
+    virtual bool begin(const String& path, AudioOutput* out) = 0;
+
+    // Bir decode adımı; parça bittiyse false
+    virtual bool loop() = 0;
+
+    virtual void stop() = 0;
+};
+
+// Decoder'ın gördüğü AudioOutput; örnekleri şeridin FIFO'suna yazar
+class GaplessLane : public AudioOutput {
+private:
+    int16_t frames[GAPLESS_LANE_FRAMES * 2];
+    size_t head;
+    size_t count;
+    size_t limit;           // aktif değilken preroll kadar kabul edilir
+
+public:
+    String path;
+    bool loaded;            // decoder begin() başarılı
+    bool ended;             // decoder son örneği verdi
+
+    GaplessLane();
+
+    void reset();
+    void setLimit(size_t frames) { limit = min(frames, (size_t)GAPLESS_LANE_FRAMES); }
+
+    size_t available() const { return count; }
+    size_t space() const { return count < limit ? limit - count : 0; }
+
+    // FIFO'nun başındaki ardışık bölüm (sarmadan önceki kısım)
+    int16_t* peek(size_t& contiguous);
+    void consume(size_t n);
+
+    int getRate() const { return hertz; }
+
+    virtual bool begin() override { return true; }
+    virtual bool ConsumeSample(int16_t sample[2]) override;
+    // Toplu yol (WavDecoder): örnekler zaten 16-bit stereo, kopyalanır
+    virtual uint16_t ConsumeSamples(int16_t* samples, uint16_t frameCount) override;
+    virtual bool stop() override { return true; }
+};
+
+struct GaplessStats {
+    uint32_t transitions;       // boşluksuz geçişler
+    uint32_t coldStarts;        // sıradaki hazır değildi (play() veya geç açılış)
+    uint32_t prerollAtSwitch;   // son geçişte sıradaki şeritte hazır frame
+    uint32_t lastSwitchUs;      // A'nın son örneği ile B'nin ilk örneği arası (pipeline)
+    uint32_t maxSwitchUs;
+    uint32_t rateChanges;
+    uint32_t decodeErrors;
+};
+
+class GaplessChain {
+private:
+    AudioOutput* sink;
+    GaplessDecoder* decoders[2];
+    GaplessLane lanes[2];
+    uint8_t active;
+    bool playing;
+    int sinkRate;
+
+    uint32_t lastSampleUs;      // aktif şeritten son örneğin yazıldığı an
+    bool switchPending;         // geçiş yapıldı, B'nin ilk örneği bekleniyor
+
+    GaplessStats stats;
+
+    bool startLane(uint8_t index, const String& path, size_t limit);
+    void stopLane(uint8_t index);
+    void decodeLane(uint8_t index);
+    void switchLanes();
+
+public:
+    GaplessChain();
+
+    // sink genelde AudioOutputMCP4725; decoder'lar sırayla şerit değiştirir
+    void begin(AudioOutput* sink, GaplessDecoder* first, GaplessDecoder* second);
+
+    // Mevcut parçayı keser, path'i soğuk başlatır
+    bool play(const String& path);
+
+    // Sıradaki parçayı önden açar ve çözer; boş yol bekleyen parçayı iptal eder
+    bool queueNext(const String& path);
+
+    // Ses task'ının bir adımı: aktif decoder, sıradaki preroll, DAC'a aktarma.
+    // Çalacak bir şey kaldıysa true
+    bool loop();
+
+    // Şeritleri ve decoder'ları durdurur, DAC'ı midscale'e çeker
+    void stop();
+
+    // Aktif şeridin örneklerini sink'e aktarır; şerit bitmişse ve sıradaki
+    // hazırsa aynı çağrıda geçer. Yazılan frame sayısı
+    size_t pump();
+
+    bool isPlaying() const { return playing; }
+    const String& getCurrentPath() const { return lanes[active].path; }
+    const String& getNextPath() const { return lanes[active ^ 1].path; }
+    bool hasNext() const { return lanes[active ^ 1].loaded; }
+    size_t getPreroll() const { return lanes[active ^ 1].available(); }
+
+    // AudioManager geçişi bu sayaçtan fark edip bir sonrakini kuyruğa alır
+    uint32_t getTransitions() const { return stats.transitions; }
+    const GaplessStats& getStats() const { return stats; }
+};
+
+#endif // GAPLESS_CHAIN_H
@@ -0,0 +1,139 @@
+#include "I2cArbiter.h"
+#include "DacOutputStage.h"
+#include "Metrics.h"
+
+I2cArbiter i2cArbiter;
+
+I2cArbiter::I2cArbiter() :
+    mutex(xSemaphoreCreateMutex()),
+    clockHz(400000),
+    burstStartUs(0),
+    burstPeriodUs(0),
+    dacSlackUs(0) {
+    resetStats();
+}
+
+void I2cArbiter::begin(uint32_t _clockHz) {
+    if (_clockHz) clockHz = _clockHz;
+}
+
+void I2cArbiter::resetStats() {
+    memset(stats, 0, sizeof(stats));
+    for (size_t i = 0; i < I2C_DEVICE_COUNT; i++) {
+        pending[i] = false;
+        pendingSinceUs[i] = 0;
+        acquiredUs[i] = 0;
+    }
+}
+
+uint32_t I2cArbiter::transactionUs(size_t bytes) const {
+    return (uint32_t)((uint64_t)(2 + bytes * 9) * 1000000ULL / clockHz) + I2C_ARBITER_TXN_OVERHEAD_US;
+}
+
+const char* I2cArbiter::deviceName(uint8_t device) {
+    static const char* const names[I2C_DEVICE_COUNT] = { "dac", "rtc" };
+    return device < I2C_DEVICE_COUNT ? names[device] : "?";
+}
+
+void I2cArbiter::noteAcquired(uint8_t device, uint32_t now) {
+    I2cDeviceStats& s = stats[device];
+    uint32_t waited = pending[device] ? now - pendingSinceUs[device] : 0;
+    s.totalWaitUs += waited;
+    if (waited > s.maxWaitUs) s.maxWaitUs = waited;
+    pending[device] = false;
+    acquiredUs[device] = now;
+}
+
+// --- DAC writer ---
+
+void I2cArbiter::beginBurst() {
+    uint32_t start = micros();
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = micros();
+    // DAC hiç slot beklemez; bekleme sadece süren bir RTC işinden gelir
+    pending[I2C_DEVICE_DAC] = true;
+    pendingSinceUs[I2C_DEVICE_DAC] = start;
+    noteAcquired(I2C_DEVICE_DAC, now);
+    burstStartUs.store(now, std::memory_order_release);
+}
+
+void I2cArbiter::endBurst(size_t fill, uint32_t sampleRate) {
+    if (sampleRate) {
+        burstPeriodUs.store(DacOutputStage::burstPeriodUs(sampleRate), std::memory_order_relaxed);
+        dacSlackUs.store((uint32_t)((uint64_t)fill * 1000000ULL / sampleRate), std::memory_order_relaxed);
+    }
+    release(I2C_DEVICE_DAC);
+}
+
+void I2cArbiter::dacStopped() {
+    burstPeriodUs.store(0, std::memory_order_release);
+    dacSlackUs.store(0, std::memory_order_relaxed);
+}
+
+// --- arka plan ---
+
+bool I2cArbiter::slotOpen(uint32_t budgetUs, uint32_t waitedUs, uint32_t now) const {
+    uint32_t period = burstPeriodUs.load(std::memory_order_acquire);
+    if (period == 0) return true;
+
+    uint32_t sinceBurst = now - burstStartUs.load(std::memory_order_acquire);
+    // Writer iki periyottur burst yazmadıysa (duraklatıldı, tampon boş)
+    if (sinceBurst >= 2 * period) return true;
+
+    // Bir sonraki burst'e kadar sığıyor
+    if (sinceBurst < period && period - sinceBurst >= budgetUs) return true;
+
+    // Boşluk yok: yeterince beklendiyse tampondaki payla burst'ü ertele
+    return waitedUs >= I2C_ARBITER_SLACK_AFTER_US &&
+           dacSlackUs.load(std::memory_order_relaxed) >= budgetUs + I2C_ARBITER_MIN_SLACK_US;
+}
+
+bool I2cArbiter::tryAcquire(uint8_t device, uint32_t budgetUs) {
+    uint32_t now = micros();
+    bool first = !pending[device];
+    if (first) {
+        pending[device] = true;
+        pendingSinceUs[device] = now;
+    }
+    uint32_t waited = now - pendingSinceUs[device];
+
+    if (xSemaphoreTake(mutex, 0) != pdTRUE) {
+        if (first) stats[device].deferred++;
+        return false;
+    }
+
+    // Kilit alındıktan sonra DAC başlayamaz; slot durumu artık sabit
+    bool forced = waited >= I2C_ARBITER_MAX_DEFER_US;
+    if (!forced && !slotOpen(budgetUs, waited, micros())) {
+        xSemaphoreGive(mutex);
+        if (first) stats[device].deferred++;
+        return false;
+    }
+
+    if (forced) stats[device].forced++;
+    noteAcquired(device, micros());
+    return true;
+}
+
+void I2cArbiter::acquire(uint8_t device, uint32_t budgetUs) {
+    uint32_t start = micros();
+    while (!tryAcquire(device, budgetUs)) {
+        if (micros() - start >= I2C_ARBITER_MAX_DEFER_US) {
+            xSemaphoreTake(mutex, portMAX_DELAY);
+            stats[device].forced++;
+            noteAcquired(device, micros());
+            return;
+        }
+        vTaskDelay(1);
+    }
+}
+
+void I2cArbiter::release(uint8_t device) {
+    I2cDeviceStats& s = stats[device];
+    uint32_t busy = micros() - acquiredUs[device];
+    s.transactions++;
+    s.totalBusyUs += busy;
+    if (busy > s.maxBusyUs) s.maxBusyUs = busy;
+    metrics.i2c[device].record(busy);
+    xSemaphoreGive(mutex);
+}
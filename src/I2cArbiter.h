@@ -0,0 +1,89 @@
+#ifndef I2C_ARBITER_H
+#define I2C_ARBITER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// MCP4725 ve DS3231 aynı I2C bus'ında (GPIO21/22). DAC writer her burst
+// periyodunda bus'ı alır; RTC ve sıcaklık okumaları bir burst bittikten
+// sonra, bir sonraki burst'e kadar sığıyorlarsa başlar. 400 kHz'de yüksek
+// örnekleme hızlarında burst arası boşluk kalmaz; o zaman bir süre
+// bekleyen okuma DAC tamponundaki payı kullanarak burst'ü kısa süre
+// erteler. Hiçbir okuma sonsuza kadar bekletilmez.
+
+#define I2C_ARBITER_TXN_OVERHEAD_US     30          // sürücü kurulum/bitiş süresi
+#define I2C_ARBITER_SLACK_AFTER_US      20000       // bu kadar boşluk bulamazsa tampon payını kullan
+#define I2C_ARBITER_MIN_SLACK_US        20000       // ertelemeden sonra tamponda kalması gereken ses
+#define I2C_ARBITER_MAX_DEFER_US        200000      // sonra koşulsuz al
+
+enum I2cDevice : uint8_t {
+    I2C_DEVICE_DAC = 0,
+    I2C_DEVICE_RTC,
+    I2C_DEVICE_COUNT
+};
+
+struct I2cDeviceStats {
+    uint32_t transactions;      // acquire/release çiftleri
+    uint32_t deferred;          // slot açık değildi, sonraya kaldı
+    uint32_t forced;            // MAX_DEFER aşıldı, slot beklenmeden alındı
+    uint64_t totalBusyUs;
+    uint32_t maxBusyUs;
+    uint64_t totalWaitUs;       // ilk denemeden bus'ı alana kadar
+    uint32_t maxWaitUs;
+};
+
+class I2cArbiter {
+private:
+    SemaphoreHandle_t mutex;
+    uint32_t clockHz;
+
+    // DAC writer yazar, diğer task'lar okur
+    std::atomic<uint32_t> burstStartUs;
+    std::atomic<uint32_t> burstPeriodUs;        // 0: DAC çalmıyor
+    std::atomic<uint32_t> dacSlackUs;           // son burst sonrası tampondaki ses
+
+    // Cihaz başına; sadece bus sahibi yazar
+    I2cDeviceStats stats[I2C_DEVICE_COUNT];
+    uint32_t pendingSinceUs[I2C_DEVICE_COUNT];
+    bool pending[I2C_DEVICE_COUNT];
+    uint32_t acquiredUs[I2C_DEVICE_COUNT];
+
+    void noteAcquired(uint8_t device, uint32_t now);
+
+public:
+    I2cArbiter();
+
+    void begin(uint32_t clockHz);
+
+    // DAC writer tarafı: burst'ü sarar. fill tampondaki örnek sayısı.
+    void beginBurst();
+    void endBurst(size_t fill, uint32_t sampleRate);
+    void dacStopped();
+
+    // Arka plan tarafı. budgetUs işin bus'ı tutacağı süre.
+    // tryAcquire bloklamaz; slot açık değilse false döner ve sonraki
+    // denemede bekleme süresi ilk denemeden ölçülür.
+    bool tryAcquire(uint8_t device, uint32_t budgetUs);
+
+    // Slot açılana kadar (en fazla MAX_DEFER) bekler, sonra her durumda alır
+    void acquire(uint8_t device, uint32_t budgetUs);
+    void release(uint8_t device);
+
+    // budgetUs süren bir iş şimdi başlarsa DAC burst'ünü geciktirmez mi
+    bool slotOpen(uint32_t budgetUs, uint32_t waitedUs, uint32_t now) const;
+
+    const I2cDeviceStats& getStats(uint8_t device) const { return stats[device]; }
+    void resetStats();
+    uint32_t getClock() const { return clockHz; }
+
+    // bytes: adres dahil byte sayısı (start + 9 bit/byte + stop)
+    uint32_t transactionUs(size_t bytes) const;
+
+    static const char* deviceName(uint8_t device);
+};
+
+extern I2cArbiter i2cArbiter;
+
+#endif // I2C_ARBITER_H
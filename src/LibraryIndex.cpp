@@ -0,0 +1,570 @@
+#include "LibraryIndex.h"
+#include <esp_system.h>
+#include <algorithm>
+
+LibraryIndex libraryIndex;
+
+LibraryIndex::LibraryIndex() :
+    poolGarbage(0),
+    generation(0),
+    cardId(0),
+    loaded(false),
+    mutex(nullptr),
+    scanParsed(0),
+    scanReused(0) {
+}
+
+void LibraryIndex::lock() const {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void LibraryIndex::unlock() const {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+bool LibraryIndex::begin() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+    }
+
+    unsigned long start = millis();
+    cardId = 0;
+    if (loadFromCard() && cardSignatureMatches()) {
+        Serial.printf("✅ Library index loaded: %u tracks (%lu ms)\n",
+            (unsigned)entries.size(), millis() - start);
+        loaded = true;
+        return true;
+    }
+
+    Serial.println("Library index missing or card changed, rescanning...");
+    return rescan();
+}
+
+bool LibraryIndex::rescan() {
+    unsigned long start = millis();
+
+    lock();
+    // Eski kayıtlar sıralı; etiketleri değişmemiş dosyalar için kullanılır
+    previousEntries.swap(entries);
+    previousPool.swap(pathPool);
+    entries.clear();
+    pathPool.clear();
+    poolGarbage = 0;
+    scanParsed = 0;
+    scanReused = 0;
+
+    File root = SD.open("/");
+    if (!root || !root.isDirectory()) {
+        entries.swap(previousEntries);
+        pathPool.swap(previousPool);
+        previousEntries.clear();
+        previousPool.clear();
+        unlock();
+        Serial.println("❌ Library scan failed: SD root not readable");
+        return false;
+    }
+    scanDirectory(root, 0);
+    root.close();
+
+    std::vector<LibraryEntry>().swap(previousEntries);
+    std::vector<char>().swap(previousPool);
+    sortEntries();
+    generation++;
+    loaded = true;
+    unlock();
+    bool saved = saveToCard();
+
+    Serial.printf("✅ Library rescanned: %u tracks, %u parsed, %u reused (%lu ms)\n",
+        (unsigned)entries.size(), (unsigned)scanParsed, (unsigned)scanReused, millis() - start);
+    return saved;
+}
+
+void LibraryIndex::scanDirectory(File& dir, uint8_t depth) {
+    File file = dir.openNextFile();
+    while (file) {
+        const char* name = file.name();
+
+        // Gizli dosyalar (indeksin kendisi, macOS "._" dosyaları) ve sistem dizini atlanır
+        if (name[0] != '.' && strcmp(name, "System Volume Information") != 0) {
+            if (file.isDirectory()) {
+                if (depth + 1 < LIBRARY_SCAN_DEPTH) {
+                    scanDirectory(file, depth + 1);
+                }
+            } else {
+                LibraryFormat format = formatFromName(name);
+                if (format != LIBRARY_FORMAT_UNKNOWN) {
+                    uint32_t size = file.size();
+                    uint32_t mtime = (uint32_t)file.getLastWrite();
+                    TrackTags tags;
+                    if (reuseTags(file.path(), size, mtime, tags)) {
+                        scanReused++;
+                    } else {
+                        TrackMetadata::read(file, format, tags);
+                        scanParsed++;
+                    }
+                    addEntry(file.path(), size, mtime, format, tags);
+                }
+            }
+        }
+        file = dir.openNextFile();
+    }
+}
+
+size_t LibraryIndex::stringBytes(const LibraryEntry& entry) {
+    return entry.pathLength + entry.titleLength + entry.artistLength + entry.albumLength + 4;
+}
+
+bool LibraryIndex::reuseTags(const char* path, uint32_t size, uint32_t mtime, TrackTags& tags) const {
+    if (previousEntries.empty()) return false;
+    if (path[0] == '/') path++;
+    const char* pool = previousPool.data();
+    size_t i = lowerBoundIn(previousEntries, pool, path);
+    if (i >= previousEntries.size()) return false;
+    const LibraryEntry& old = previousEntries[i];
+    const char* p = pool + old.pathOffset;
+    if (strcmp(p, path) != 0 || old.size != size || old.mtime != mtime) return false;
+
+    tags.durationMs = old.durationMs;
+    tags.bitrateKbps = old.bitrateKbps;
+    p += old.pathLength + 1;
+    memcpy(tags.title, p, old.titleLength + 1);
+    p += old.titleLength + 1;
+    memcpy(tags.artist, p, old.artistLength + 1);
+    p += old.artistLength + 1;
+    memcpy(tags.album, p, old.albumLength + 1);
+    return true;
+}
+
+// Yolu ve etiketleri havuzun sonuna yazar; yolun uzunluğu çağıran tarafından
+// doğrulanmıştır
+void LibraryIndex::makeEntry(const char* path, uint32_t size, uint32_t mtime, LibraryFormat format,
+                             const TrackTags& tags, LibraryEntry& entry) {
+    entry.pathOffset = pathPool.size();
+    entry.size = size;
+    entry.mtime = mtime;
+    entry.durationMs = tags.durationMs;
+    entry.bitrateKbps = tags.bitrateKbps;
+    entry.format = format;
+    entry.pathLength = (uint8_t)strlen(path);
+    entry.titleLength = (uint8_t)strlen(tags.title);
+    entry.artistLength = (uint8_t)strlen(tags.artist);
+    entry.albumLength = (uint8_t)strlen(tags.album);
+    entry.reserved = 0;
+
+    pathPool.insert(pathPool.end(), path, path + entry.pathLength + 1);
+    pathPool.insert(pathPool.end(), tags.title, tags.title + entry.titleLength + 1);
+    pathPool.insert(pathPool.end(), tags.artist, tags.artist + entry.artistLength + 1);
+    pathPool.insert(pathPool.end(), tags.album, tags.album + entry.albumLength + 1);
+}
+
+bool LibraryIndex::addEntry(const char* path, uint32_t size, uint32_t mtime, LibraryFormat format,
+                            const TrackTags& tags) {
+    if (path[0] == '/') path++;
+    size_t len = strlen(path);
+    if (len == 0 || len > LIBRARY_MAX_PATH || entries.size() >= LIBRARY_MAX_ENTRIES) {
+        return false;
+    }
+
+    LibraryEntry entry;
+    makeEntry(path, size, mtime, format, tags, entry);
+    entries.push_back(entry);
+    return true;
+}
+
+void LibraryIndex::copyTrack(const LibraryEntry& entry, LibraryTrack& out) const {
+    const char* p = pathPool.data() + entry.pathOffset;
+    memcpy(out.path, p, entry.pathLength + 1);
+    p += entry.pathLength + 1;
+    memcpy(out.title, p, entry.titleLength + 1);
+    p += entry.titleLength + 1;
+    memcpy(out.artist, p, entry.artistLength + 1);
+    p += entry.artistLength + 1;
+    memcpy(out.album, p, entry.albumLength + 1);
+    out.durationMs = entry.durationMs;
+    out.bitrateKbps = entry.bitrateKbps;
+    out.format = entry.format;
+}
+
+void LibraryIndex::sortEntries() {
+    const char* pool = pathPool.data();
+    std::sort(entries.begin(), entries.end(), [pool](const LibraryEntry& a, const LibraryEntry& b) {
+        return strcmp(pool + a.pathOffset, pool + b.pathOffset) < 0;
+    });
+}
+
+size_t LibraryIndex::lowerBoundIn(const std::vector<LibraryEntry>& list, const char* pool, const char* path) {
+    auto it = std::lower_bound(list.begin(), list.end(), path,
+        [pool](const LibraryEntry& e, const char* p) {
+            return strcmp(pool + e.pathOffset, p) < 0;
+        });
+    return it - list.begin();
+}
+
+size_t LibraryIndex::lowerBound(const char* path) const {
+    return lowerBoundIn(entries, pathPool.data(), path);
+}
+
+int LibraryIndex::findLocked(const char* path) const {
+    if (path[0] == '/') path++;
+    size_t i = lowerBound(path);
+    if (i < entries.size() && strcmp(pathPool.data() + entries[i].pathOffset, path) == 0) {
+        return (int)i;
+    }
+    return -1;
+}
+
+void LibraryIndex::compactPool() {
+    if (poolGarbage == 0) return;
+
+    std::vector<char> compacted;
+    compacted.reserve(pathPool.size() - poolGarbage);
+    for (auto& entry : entries) {
+        const char* p = pathPool.data() + entry.pathOffset;
+        entry.pathOffset = compacted.size();
+        compacted.insert(compacted.end(), p, p + stringBytes(entry));
+    }
+    pathPool.swap(compacted);
+    poolGarbage = 0;
+}
+
+bool LibraryIndex::addFile(const char* path) {
+    LibraryFormat format = formatFromName(path);
+    if (format == LIBRARY_FORMAT_UNKNOWN) {
+        return false;
+    }
+
+    // Etiketler kilit dışında okunur; listeleme SD'yi beklemez
+    File file = SD.open(path);
+    if (!file || file.isDirectory()) {
+        return false;
+    }
+    uint32_t size = file.size();
+    uint32_t mtime = (uint32_t)file.getLastWrite();
+    TrackTags tags;
+    TrackMetadata::read(file, format, tags);
+    file.close();
+
+    lock();
+    int existing = findLocked(path);
+    if (existing >= 0) {
+        // makeEntry havuzu büyütür; saklanan yol önce kopyalanır
+        LibraryEntry& entry = entries[existing];
+        LibraryPath stored(pathPool.data() + entry.pathOffset);
+        poolGarbage += stringBytes(entry);
+        makeEntry(stored.c_str(), size, mtime, format, tags, entry);
+    } else {
+        if (!addEntry(path, size, mtime, format, tags)) {
+            unlock();
+            Serial.printf("❌ Library index full, not indexed: %s\n", path);
+            return false;
+        }
+        // Yeni kayıt sona eklendi, sıralı konumuna taşı
+        LibraryEntry entry = entries.back();
+        entries.pop_back();
+        size_t pos = lowerBound(pathPool.data() + entry.pathOffset);
+        entries.insert(entries.begin() + pos, entry);
+    }
+    generation++;
+    unlock();
+    return saveToCard();
+}
+
+bool LibraryIndex::removeFile(const char* path) {
+    lock();
+    int index = findLocked(path);
+    if (index < 0) {
+        unlock();
+        return false;
+    }
+
+    poolGarbage += stringBytes(entries[index]);
+    entries.erase(entries.begin() + index);
+    if (poolGarbage > pathPool.size() / 2) {
+        compactPool();
+    }
+    generation++;
+    unlock();
+    return saveToCard();
+}
+
+bool LibraryIndex::queueJob(uint8_t type, const char* path) {
+    LibraryJob job;
+    job.type = type;
+    strlcpy(job.path, path, sizeof(job.path));
+    if (!jobs.push(job)) {
+        Serial.printf("❌ Library queue full, not indexed: %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+size_t LibraryIndex::loop() {
+    size_t applied = 0;
+    LibraryJob job;
+    while (jobs.pop(job)) {
+        if (job.type == LIBRARY_JOB_ADD) {
+            addFile(job.path);
+        } else if (job.type == LIBRARY_JOB_REMOVE) {
+            removeFile(job.path);
+        } else {
+            rescan();
+        }
+        applied++;
+    }
+    return applied;
+}
+
+size_t LibraryIndex::size() const {
+    lock();
+    size_t count = entries.size();
+    unlock();
+    return count;
+}
+
+bool LibraryIndex::contains(const char* path) const {
+    lock();
+    bool found = findLocked(path) >= 0;
+    unlock();
+    return found;
+}
+
+String LibraryIndex::getPath(size_t index) const {
+    lock();
+    String path = index < entries.size() ? String(pathPool.data() + entries[index].pathOffset) : String();
+    unlock();
+    return path;
+}
+
+bool LibraryIndex::getPath(size_t index, LibraryPath& out) const {
+    lock();
+    bool found = index < entries.size();
+    out.clear();
+    if (found) {
+        out.append('/').append(pathPool.data() + entries[index].pathOffset);
+    }
+    unlock();
+    return found;
+}
+
+bool LibraryIndex::getEntry(size_t index, LibraryEntry& entry, String& path) const {
+    lock();
+    if (index >= entries.size()) {
+        unlock();
+        return false;
+    }
+    entry = entries[index];
+    path = pathPool.data() + entry.pathOffset;
+    unlock();
+    return true;
+}
+
+bool LibraryIndex::getTrack(size_t index, LibraryTrack& out) const {
+    lock();
+    if (index >= entries.size()) {
+        unlock();
+        return false;
+    }
+    copyTrack(entries[index], out);
+    unlock();
+    return true;
+}
+
+bool LibraryIndex::findTrack(const char* path, LibraryTrack& out) const {
+    lock();
+    int index = findLocked(path);
+    if (index >= 0) {
+        copyTrack(entries[index], out);
+    }
+    unlock();
+    return index >= 0;
+}
+
+bool LibraryIndex::makePath(const char* name, LibraryPath& out) {
+    while (*name == '/') name++;
+    out.clear();
+    out.append('/').append(name);
+    return out.length() > 1 && !out.truncated();
+}
+
+bool LibraryIndex::loadFromCard() {
+    File file = SD.open(LIBRARY_INDEX_PATH, FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    LibraryIndexHeader header;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+        header.magic == LIBRARY_INDEX_MAGIC &&
+        header.version == LIBRARY_INDEX_VERSION &&
+        header.entrySize == sizeof(LibraryEntry) &&
+        header.count <= LIBRARY_MAX_ENTRIES &&
+        file.size() == sizeof(header) + header.count * sizeof(LibraryEntry) + header.poolSize;
+
+    if (ok) {
+        lock();
+        entries.resize(header.count);
+        pathPool.resize(header.poolSize);
+        size_t entryBytes = header.count * sizeof(LibraryEntry);
+        ok = file.read((uint8_t*)entries.data(), entryBytes) == entryBytes &&
+             file.read((uint8_t*)pathPool.data(), header.poolSize) == header.poolSize;
+
+        // Bozuk bir dosya bellek dışına işaret etmesin
+        for (size_t i = 0; ok && i < entries.size(); i++) {
+            ok = entryValid(entries[i], pathPool);
+        }
+        if (ok) {
+            poolGarbage = 0;
+            generation = header.generation;
+            cardId = header.cardId;
+        } else {
+            entries.clear();
+            pathPool.clear();
+        }
+        unlock();
+    }
+    file.close();
+
+    if (!ok) {
+        Serial.println("❌ Library index corrupt, ignoring");
+    }
+    return ok;
+}
+
+bool LibraryIndex::entryValid(const LibraryEntry& entry, const std::vector<char>& pool) {
+    if (entry.pathOffset > pool.size() || stringBytes(entry) > pool.size() - entry.pathOffset) {
+        return false;
+    }
+    const char* p = pool.data() + entry.pathOffset;
+    uint8_t lengths[4] = { entry.pathLength, entry.titleLength, entry.artistLength, entry.albumLength };
+    for (uint8_t length : lengths) {
+        if (p[length] != '\0') return false;
+        p += length + 1;
+    }
+    return true;
+}
+
+// Çağıran kilidi tutmaz. Sıkıştırma kilit altında yapılır; yazma sırasında
+// indeksi değiştirebilecek tek task çağıranın kendisidir.
+bool LibraryIndex::saveToCard() {
+    lock();
+    compactPool();
+
+    LibraryIndexHeader header;
+    header.magic = LIBRARY_INDEX_MAGIC;
+    header.version = LIBRARY_INDEX_VERSION;
+    header.entrySize = sizeof(LibraryEntry);
+    header.count = entries.size();
+    header.poolSize = pathPool.size();
+    if (cardId == 0) {
+        cardId = esp_random() | 1;
+    }
+    header.generation = generation;
+    header.cardId = cardId;
+    unlock();
+
+    // Önce geçici dosyaya yaz, sonra yerine taşı; yarım kalan yazma indeksi bozmaz
+    File file = SD.open(LIBRARY_INDEX_TMP_PATH, FILE_WRITE);
+    if (!file) {
+        Serial.println("❌ Library index could not be written");
+        return false;
+    }
+
+    size_t entryBytes = entries.size() * sizeof(LibraryEntry);
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)entries.data(), entryBytes) == entryBytes &&
+              file.write((const uint8_t*)pathPool.data(), pathPool.size()) == pathPool.size();
+    file.close();
+
+    if (ok) {
+        SD.remove(LIBRARY_INDEX_PATH);
+        ok = SD.rename(LIBRARY_INDEX_TMP_PATH, LIBRARY_INDEX_PATH);
+    }
+    if (!ok) {
+        Serial.println("❌ Library index could not be written");
+        SD.remove(LIBRARY_INDEX_TMP_PATH);
+        return false;
+    }
+
+    storeCardSignature();
+    return true;
+}
+
+bool LibraryIndex::cardSignatureMatches() {
+    Preferences prefs;
+    if (!prefs.begin("library", true)) {
+        return false;
+    }
+    uint64_t cardSize = prefs.getULong64("card", 0);
+    uint32_t storedId = prefs.getUInt("id", 0);
+    uint32_t storedGeneration = prefs.getUInt("gen", 0);
+    uint32_t storedRoot = prefs.getUInt("root", 0);
+    prefs.end();
+
+    return cardSize != 0 && cardSize == SD.cardSize() && storedId == cardId && storedGeneration == generation &&
+        storedRoot == rootSignature();
+}
+
+void LibraryIndex::storeCardSignature() {
+    Preferences prefs;
+    if (!prefs.begin("library", false)) {
+        return;
+    }
+    prefs.putULong64("card", SD.cardSize());
+    prefs.putUInt("id", cardId);
+    prefs.putUInt("gen", generation);
+    prefs.putUInt("root", rootSignature());
+    prefs.end();
+}
+
+// Kök dizindeki girdilerin adı, boyutu ve değişme zamanı; sıradan bağımsız.
+// Taramanın atladıkları (gizli dosyalar, indeks, /.uploads) sayılmaz.
+// Dizinlerin FAT'te değişme zamanı güncellenmez, sadece adları girer.
+uint32_t LibraryIndex::rootSignature() {
+    File root = SD.open("/");
+    if (!root || !root.isDirectory()) {
+        return 0;
+    }
+    uint32_t signature = 0;
+    File file = root.openNextFile();
+    while (file) {
+        const char* name = file.name();
+        if (name[0] != '.' && strcmp(name, "System Volume Information") != 0) {
+            uint32_t hash = 2166136261u;
+            for (const char* p = name; *p; p++) {
+                hash = (hash ^ (uint8_t)*p) * 16777619u;
+            }
+            if (!file.isDirectory()) {
+                uint32_t values[2] = { (uint32_t)file.size(), (uint32_t)file.getLastWrite() };
+                const uint8_t* bytes = (const uint8_t*)values;
+                for (size_t i = 0; i < sizeof(values); i++) {
+                    hash = (hash ^ bytes[i]) * 16777619u;
+                }
+            }
+            signature += hash;
+        }
+        file = root.openNextFile();
+    }
+    root.close();
+    return signature;
+}
+
+LibraryFormat LibraryIndex::formatFromName(const char* name) {
+    const char* dot = strrchr(name, '.');
+    if (!dot) return LIBRARY_FORMAT_UNKNOWN;
+
+    if (strcasecmp(dot, ".mp3") == 0) return LIBRARY_FORMAT_MP3;
+    if (strcasecmp(dot, ".m4a") == 0) return LIBRARY_FORMAT_M4A;
+    if (strcasecmp(dot, ".aac") == 0) return LIBRARY_FORMAT_AAC;
+    if (strcasecmp(dot, ".wav") == 0) return LIBRARY_FORMAT_WAV;
+    return LIBRARY_FORMAT_UNKNOWN;
+}
+
+const char* LibraryIndex::formatName(uint8_t format) {
+    switch (format) {
+        case LIBRARY_FORMAT_MP3: return "mp3";
+        case LIBRARY_FORMAT_M4A: return "m4a";
+        case LIBRARY_FORMAT_AAC: return "aac";
+        case LIBRARY_FORMAT_WAV: return "wav";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,190 @@
+#ifndef LIBRARY_INDEX_H
+#define LIBRARY_INDEX_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Preferences.h>
+#include <freertos/semphr.h>
+#include <vector>
+#include "TrackMetadata.h"
+#include "FixedString.h"
+#include "MpscQueue.h"
+
+// SD kart üzerindeki müzik kütüphanesinin kalıcı indeksi.
+//
+// Kart dolaşması sadece kart değiştiğinde yapılır; açılışta indeks dosyası
+// tek sıralı okumayla belleğe alınır, upload/delete sonrası artımlı
+// güncellenir. Listeleme ve arama bellekten (ikili arama) yapılır.
+//
+// Süre ve etiketler (TrackMetadata) dosya indekslenirken bir kez okunur ve
+// indeks dosyasında yolun hemen ardından saklanır. Yeniden taramada boyutu
+// ve değişme zamanı aynı kalan dosyalar açılmaz, eski kayıttan kopyalanır.
+
+#define LIBRARY_INDEX_PATH      "/.musicbox.idx"
+#define LIBRARY_INDEX_TMP_PATH  "/.musicbox.tmp"
+#define LIBRARY_INDEX_MAGIC     0x5849424D  // "MBIX"
+#define LIBRARY_INDEX_VERSION   4       // 2: süre ve etiketler, 3: kart kimliği, 4: 1254 etiketler
+#define LIBRARY_MAX_ENTRIES     4096
+#define LIBRARY_MAX_PATH        255
+#define LIBRARY_SCAN_DEPTH      4
+#define LIBRARY_JOB_CAPACITY    8       // web handler'larından loop task'ına
+
+enum LibraryFormat : uint8_t {
+    LIBRARY_FORMAT_UNKNOWN = 0,
+    LIBRARY_FORMAT_MP3,
+    LIBRARY_FORMAT_M4A,
+    LIBRARY_FORMAT_AAC,
+    LIBRARY_FORMAT_WAV
+};
+
+// pathPool'da yol ve ardından başlık, sanatçı, albüm; hepsi '\0' ile biter
+struct LibraryEntry {
+    uint32_t pathOffset;    // pathPool içindeki konum (baştaki '/' olmadan)
+    uint32_t size;
+    uint32_t mtime;
+    uint32_t durationMs;    // 0: bilinmiyor
+    uint16_t bitrateKbps;
+    uint8_t format;
+    uint8_t pathLength;
+    uint8_t titleLength;
+    uint8_t artistLength;
+    uint8_t albumLength;
+    uint8_t reserved;
+};
+
+// "/yol" biçiminde tam yol; istek başına String kurmadan taşınır
+typedef FixedString<LIBRARY_MAX_PATH + 1> LibraryPath;
+
+// Okuyucuya verilen kopya; kilit dışında kullanılabilir
+struct LibraryTrack {
+    char path[LIBRARY_MAX_PATH + 1];
+    char title[TRACK_TAG_MAX + 1];
+    char artist[TRACK_TAG_MAX + 1];
+    char album[TRACK_TAG_MAX + 1];
+    uint32_t durationMs;
+    uint16_t bitrateKbps;
+    uint8_t format;
+};
+
+enum LibraryJobType : uint8_t {
+    LIBRARY_JOB_ADD,
+    LIBRARY_JOB_REMOVE,
+    LIBRARY_JOB_RESCAN
+};
+
+struct LibraryJob {
+    uint8_t type;
+    char path[LIBRARY_MAX_PATH + 1];
+};
+
+struct LibraryIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entrySize;
+    uint32_t count;
+    uint32_t poolSize;
+    uint32_t generation;
+    uint32_t cardId;        // ilk kayıtta rastgele; kartın kimliği
+};
+
+class LibraryIndex {
+private:
+    std::vector<LibraryEntry> entries;
+    std::vector<char> pathPool;
+    size_t poolGarbage;
+    uint32_t generation;
+    uint32_t cardId;
+    bool loaded;
+    SemaphoreHandle_t mutex;
+    MpscQueue<LibraryJob, LIBRARY_JOB_CAPACITY> jobs;
+
+    // Yeniden tarama sırasında eski indeks (etiketleri yeniden kullanmak için)
+    std::vector<LibraryEntry> previousEntries;
+    std::vector<char> previousPool;
+    uint32_t scanParsed;
+    uint32_t scanReused;
+
+    bool loadFromCard();
+    bool saveToCard();
+    void scanDirectory(File& dir, uint8_t depth);
+    bool reuseTags(const char* path, uint32_t size, uint32_t mtime, TrackTags& tags) const;
+    void makeEntry(const char* path, uint32_t size, uint32_t mtime, LibraryFormat format,
+        const TrackTags& tags, LibraryEntry& entry);
+    bool addEntry(const char* path, uint32_t size, uint32_t mtime, LibraryFormat format, const TrackTags& tags);
+    void copyTrack(const LibraryEntry& entry, LibraryTrack& out) const;
+    int findLocked(const char* path) const;
+    size_t lowerBound(const char* path) const;
+    void compactPool();
+    void sortEntries();
+
+    static size_t lowerBoundIn(const std::vector<LibraryEntry>& list, const char* pool, const char* path);
+    static size_t stringBytes(const LibraryEntry& entry);
+    static bool entryValid(const LibraryEntry& entry, const std::vector<char>& pool);
+
+    // Kart imzası: kart boyutu, indeks dosyasındaki kart kimliği, indeksin
+    // nesli ve kök dizinin içerik özeti (rootSignature) NVS'te tutulur.
+    // Upload'lar (.part dosyaları dahil) imzayı değiştirmez; kart
+    // değiştiyse, indeks başka bir cihazda yazıldıysa veya kökte dosya
+    // eklenip silindiyse uyuşmaz ve tam tarama yapılır. Alt dizinlerdeki
+    // değişiklikler için /api/library/rescan.
+    bool cardSignatureMatches();
+    void storeCardSignature();
+    static uint32_t rootSignature();
+
+    void lock() const;
+    void unlock() const;
+
+public:
+    LibraryIndex();
+
+    // SD.begin() sonrası çağrılır
+    bool begin();
+    bool rescan();
+
+    // Upload/delete sonrası artımlı güncelleme. İndeksi sadece loop task'ı
+    // (açılışta begin'i çağıran task) değiştirir; kayıt bu yüzden kilit
+    // dışında yapılır, okuyucular (AudioTask, web) dosya yazılırken beklemez.
+    // Diğer task'lar queueAdd/queueRemove ile loop()'a bırakır.
+    bool addFile(const char* path);
+    bool addFile(const String& path) { return addFile(path.c_str()); }
+    bool removeFile(const char* path);
+    bool removeFile(const String& path) { return removeFile(path.c_str()); }
+
+    // Her task'tan; kuyruk doluysa false (dosya sonraki taramada girer)
+    bool queueAdd(const char* path) { return queueJob(LIBRARY_JOB_ADD, path); }
+    bool queueRemove(const char* path) { return queueJob(LIBRARY_JOB_REMOVE, path); }
+    bool queueRescan() { return queueJob(LIBRARY_JOB_RESCAN, ""); }
+    bool queueJob(uint8_t type, const char* path);
+
+    // Loop task'ı: bekleyen işleri uygular; uygulanan iş sayısı
+    size_t loop();
+
+    size_t size() const;
+    bool contains(const char* path) const;
+    bool contains(const String& path) const { return contains(path.c_str()); }
+
+    // i. kaydın yolunu (baştaki '/' olmadan) kopyalar
+    String getPath(size_t index) const;
+    // Aynı kayıt "/yol" biçiminde, heap'e gitmeden
+    bool getPath(size_t index, LibraryPath& out) const;
+    bool getEntry(size_t index, LibraryEntry& entry, String& path) const;
+
+    // Yol, süre ve etiketler; dosya açılmaz
+    bool getTrack(size_t index, LibraryTrack& out) const;
+    bool findTrack(const char* path, LibraryTrack& out) const;
+
+    // Her değişiklikte artar (ETag / önbellek doğrulaması için)
+    uint32_t getGeneration() const { return generation; }
+    uint32_t getCardId() const { return cardId; }
+
+    // İstemcinin verdiği adı ("ad.mp3" veya "/ad.mp3") "/ad.mp3" yapar;
+    // boşsa veya sığmıyorsa false
+    static bool makePath(const char* name, LibraryPath& out);
+
+    static LibraryFormat formatFromName(const char* name);
+    static const char* formatName(uint8_t format);
+};
+
+extern LibraryIndex libraryIndex;
+
+#endif // LIBRARY_INDEX_H
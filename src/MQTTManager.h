@@ -7,6 +7,8 @@
 #include "config.h"
 #include "AudioManager.h"
 #include "TimeManager.h"
+#include "StatusSnapshot.h"
+#include "MqttOutbox.h"
 
 class MQTTManager {
 private:
@@ -15,29 +17,25 @@ private:
     TimeManager& timeManager;
     
     bool isConnected;
-    uint8_t reconnectAttempts;
-    unsigned long lastReconnectAttempt;
-    unsigned long lastStatusUpdate;
-    bool statusChanged;
+    MqttBackoff backoff;            // loop(): ready() ise connect(); onDisconnect: disconnected()
+    MqttOutbox outbox;              // publish() ve durum buradan geçer
+    
+    // outbox yayıncısı: mqttClient.publish(topic, 0, retain, payload, length)
+    static bool publishNow(void* context, const char* topic, const char* payload, size_t length, bool retain);
     
     // MQTT mesaj işleme
     void handleMessage(char* topic, char* payload, AsyncMqttClientMessageProperties properties, size_t len, size_t index, size_t total);
     void handleCommand(const String& command);
     void handleVolume(const String& volume);
     void handleTimer(const JsonDocument& doc);
-    
-    // Status JSON oluşturma
-    String createStatusJson();
 
 public:
     MQTTManager(AudioManager& audio, TimeManager& time) : 
         audioManager(audio),
         timeManager(time),
-        isConnected(false),
-        reconnectAttempts(0),
-        lastReconnectAttempt(0),
-        lastStatusUpdate(0),
-        statusChanged(false) {}
+        isConnected(false) {
+        outbox.attach(publishNow, this);
+    }
     
     // Temel işlevler
     bool begin();
@@ -48,13 +46,18 @@ public:
     void disconnect();
     bool isConnectedToMqtt() const { return isConnected; }
     
-    // MQTT işlemleri
+    // MQTT işlemleri: publish() kuyruğa koyar (aynı konunun bekleyeni
+    // yerine geçer), loop() pencere dolunca toplu gönderir
     void publish(const char* topic, const char* payload, bool retain = false);
     void subscribe(const char* topic);
     
-    // Status yönetimi
+    // Status yönetimi: statusSnapshot'ta değişen alanlar alan başına
+    // retained konulara (MQTT_STATUS_TOPIC_PREFIX) gider; force tüm
+    // alanları yeniden gönderir (bağlantı kurulunca)
     void sendStatus(bool force = false);
-    void notifyStatusChange() { statusChanged = true; }
+    
+    const MqttOutboxStats& getOutboxStats() const { return outbox.getStats(); }
+    const MqttBackoff& getBackoff() const { return backoff; }
 };
 
 #endif // MQTT_MANAGER_H 
\ No newline at end of file
@@ -0,0 +1,503 @@
+#include "Metrics.h"
+#include <stdarg.h>
+#include "AudioFileSourcePrefetch.h"
+#include "RequestArena.h"
+#include "TrackStream.h"
+
+Metrics metrics;
+
+// --- LatencyHistogram ---
+
+uint32_t LatencyHistogram::snapshot(uint32_t* out) const {
+    uint32_t total = 0;
+    for (size_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        out[i] = buckets[i].load(std::memory_order_relaxed);
+        total += out[i];
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::sumUs() const {
+    uint32_t high, low;
+    do {
+        high = sumHigh.load(std::memory_order_relaxed);
+        low = sumLow.load(std::memory_order_relaxed);
+    } while (high != sumHigh.load(std::memory_order_relaxed));
+    return ((uint64_t)high << 32) | low;
+}
+
+uint32_t LatencyHistogram::count() const {
+    uint32_t total = 0;
+    for (size_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        total += buckets[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint32_t LatencyHistogram::percentileUs(const uint32_t* buckets, uint32_t count, float q) {
+    if (count == 0) return 0;
+    uint32_t rank = (uint32_t)(q * count + 0.5f);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) return upperBoundUs(i);
+    }
+    return upperBoundUs(METRICS_HISTOGRAM_BUCKETS - 1);
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    sumLow.store(0, std::memory_order_relaxed);
+    sumHigh.store(0, std::memory_order_relaxed);
+}
+
+// --- Metrics ---
+
+Metrics::Metrics() :
+    routeCount(0),
+    dac(nullptr),
+    webSocketClients(0),
+    taskCount(0),
+    lastTotalRunTime(0),
+    lastSampleMs(0),
+    mutex(xSemaphoreCreateMutex()) {
+}
+
+void Metrics::lock() const {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void Metrics::unlock() const {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+HttpRouteMetrics* Metrics::route(const char* uri, const char* method) {
+    for (size_t i = 0; i < routeCount; i++) {
+        if (strcmp(routes[i].uri, uri) == 0 && strcmp(routes[i].method, method) == 0) {
+            return &routes[i];
+        }
+    }
+    if (routeCount >= METRICS_MAX_ROUTES) {
+        Serial.printf("❌ Metrics route tablosu dolu: %s\n", uri);
+        return nullptr;
+    }
+    HttpRouteMetrics* entry = &routes[routeCount++];
+    entry->uri = uri;
+    entry->method = method;
+    return entry;
+}
+
+void Metrics::loop() {
+    unsigned long now = millis();
+    if (lastSampleMs != 0 && now - lastSampleMs < METRICS_SAMPLE_INTERVAL_MS) return;
+    lastSampleMs = now ? now : 1;
+    sampleTasks();
+}
+
+// FreeRTOS çalışma süresi sayaçları (CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+// açık değilse task tablosu boş kalır
+void Metrics::sampleTasks() {
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t* status = (TaskStatus_t*)malloc(sizeof(TaskStatus_t) * capacity);
+    if (!status) return;
+
+    uint32_t totalRunTime = 0;
+    UBaseType_t found = uxTaskGetSystemState(status, capacity, &totalRunTime);
+    if (found == 0) {
+        free(status);
+        return;
+    }
+
+    lock();
+    // Sayaç tüm çekirdeklerde aynı saatten ilerler; pay çekirdek toplamına göre
+    uint32_t window = (totalRunTime - lastTotalRunTime) * portNUM_PROCESSORS;
+    TaskCpuSample next[METRICS_MAX_TASKS];
+    size_t nextCount = 0;
+    for (UBaseType_t i = 0; i < found && nextCount < METRICS_MAX_TASKS; i++) {
+        TaskCpuSample& sample = next[nextCount++];
+        strlcpy(sample.name, status[i].pcTaskName, sizeof(sample.name));
+        sample.number = status[i].xTaskNumber;
+        sample.runTime = status[i].ulRunTimeCounter;
+        sample.stackFree = status[i].usStackHighWaterMark;
+#if configTASKLIST_INCLUDE_COREID
+        sample.core = status[i].xCoreID == tskNO_AFFINITY ? -1 : (int8_t)status[i].xCoreID;
+#else
+        sample.core = -1;
+#endif
+        sample.cpuPermille = 0;
+        for (size_t j = 0; j < taskCount; j++) {
+            if (tasks[j].number == sample.number) {
+                if (lastTotalRunTime != 0 && window > 0) {
+                    uint32_t used = sample.runTime - tasks[j].runTime;
+                    sample.cpuPermille = (uint16_t)min((uint64_t)1000, (uint64_t)used * 1000 / window);
+                }
+                break;
+            }
+        }
+    }
+    memcpy(tasks, next, sizeof(TaskCpuSample) * nextCount);
+    taskCount = nextCount;
+    lastTotalRunTime = totalRunTime;
+    unlock();
+    free(status);
+#endif
+}
+
+// Sabit seriler + task başına iki seri
+enum MetricScalar : uint8_t {
+    SCALAR_HEAP_FREE = 0,
+    SCALAR_HEAP_MIN,
+    SCALAR_HEAP_LARGEST,
+    SCALAR_UPTIME,
+    SCALAR_WS_CLIENTS,
+    SCALAR_DAC_FILL,
+    SCALAR_DAC_CAPACITY,
+    SCALAR_DAC_UNDERRUNS,
+    SCALAR_DAC_BUS_ERRORS,
+    SCALAR_PREFETCH_FILL,
+    SCALAR_PREFETCH_CAPACITY,
+    SCALAR_PREFETCH_UNDERRUNS,
+    SCALAR_ARENA_PEAK,
+    SCALAR_ARENA_FAILURES,
+    SCALAR_STREAM_ACTIVE,
+    SCALAR_STREAM_BYTES,
+    SCALAR_STREAM_DEFERRED,
+    SCALAR_I2C_DEFERRED,
+    SCALAR_I2C_FORCED = SCALAR_I2C_DEFERRED + I2C_DEVICE_COUNT,
+    SCALAR_FIXED_COUNT = SCALAR_I2C_FORCED + I2C_DEVICE_COUNT
+};
+
+size_t Metrics::copyTasks(TaskCpuSample* out, size_t max) const {
+    lock();
+    size_t count = min(taskCount, max);
+    memcpy(out, tasks, sizeof(TaskCpuSample) * count);
+    unlock();
+    return count;
+}
+
+bool Metrics::scalarAt(size_t index, MetricSeries& out, const TaskCpuSample* tasks, size_t taskCount) const {
+    out.labels[0] = '\0';
+    out.value = 0;
+    out.histogram = nullptr;
+    out.type = "gauge";
+
+    if (index >= SCALAR_FIXED_COUNT) {
+        size_t task = index - SCALAR_FIXED_COUNT;
+        bool cpu = true;
+        if (task >= taskCount) {
+            task -= taskCount;
+            cpu = false;
+        }
+        if (task >= taskCount) return false;
+        const TaskCpuSample& sample = tasks[task];
+        snprintf(out.labels, sizeof(out.labels), "task=\"%s\",core=\"%d\"", sample.name, sample.core);
+        out.family = cpu ? "musicbox_task_cpu_ratio" : "musicbox_task_stack_free_bytes";
+        out.value = cpu ? sample.cpuPermille / 1000.0 : sample.stackFree;
+        return true;
+    }
+
+    if (index >= SCALAR_I2C_DEFERRED) {
+        bool deferred = index < SCALAR_I2C_FORCED;
+        uint8_t device = (uint8_t)(index - (deferred ? SCALAR_I2C_DEFERRED : SCALAR_I2C_FORCED));
+        const I2cDeviceStats& stats = i2cArbiter.getStats(device);
+        snprintf(out.labels, sizeof(out.labels), "device=\"%s\"", I2cArbiter::deviceName(device));
+        out.family = deferred ? "musicbox_i2c_deferred_total" : "musicbox_i2c_forced_total";
+        out.type = "counter";
+        out.value = deferred ? stats.deferred : stats.forced;
+        return true;
+    }
+
+    switch (index) {
+        case SCALAR_HEAP_FREE:
+            out.family = "musicbox_heap_free_bytes";
+            out.value = ESP.getFreeHeap();
+            break;
+        case SCALAR_HEAP_MIN:
+            out.family = "musicbox_heap_min_free_bytes";
+            out.value = ESP.getMinFreeHeap();
+            break;
+        case SCALAR_HEAP_LARGEST:
+            out.family = "musicbox_heap_largest_free_block_bytes";
+            out.value = ESP.getMaxAllocHeap();
+            break;
+        case SCALAR_UPTIME:
+            out.family = "musicbox_uptime_seconds";
+            out.value = millis() / 1000;
+            break;
+        case SCALAR_WS_CLIENTS:
+            out.family = "musicbox_websocket_clients";
+            out.value = webSocketClients.load(std::memory_order_relaxed);
+            break;
+        case SCALAR_DAC_FILL:
+            out.family = "musicbox_dac_buffer_fill_samples";
+            out.value = dac ? dac->getFillLevel() : 0;
+            break;
+        case SCALAR_DAC_CAPACITY:
+            out.family = "musicbox_dac_buffer_capacity_samples";
+            out.value = dac ? dac->getCapacity() : 0;
+            break;
+        case SCALAR_DAC_UNDERRUNS:
+            out.family = "musicbox_dac_underruns_total";
+            out.type = "counter";
+            out.value = dac ? dac->getStats().underruns : 0;
+            break;
+        case SCALAR_DAC_BUS_ERRORS:
+            out.family = "musicbox_dac_bus_errors_total";
+            out.type = "counter";
+            out.value = dac ? dac->getStats().busErrors : 0;
+            break;
+        case SCALAR_PREFETCH_FILL:
+            out.family = "musicbox_prefetch_buffer_fill_bytes";
+            out.value = audioPrefetch.getFill();
+            break;
+        case SCALAR_PREFETCH_CAPACITY:
+            out.family = "musicbox_prefetch_buffer_capacity_bytes";
+            out.value = audioPrefetch.getCapacity();
+            break;
+        case SCALAR_PREFETCH_UNDERRUNS:
+            out.family = "musicbox_prefetch_underruns_total";
+            out.type = "counter";
+            out.value = audioPrefetch.getStats().underruns;
+            break;
+        case SCALAR_ARENA_PEAK:
+            out.family = "musicbox_request_arena_peak_bytes";
+            out.value = requestArena.getPeak();
+            break;
+        case SCALAR_ARENA_FAILURES:
+            out.family = "musicbox_request_arena_failures_total";
+            out.type = "counter";
+            out.value = requestArena.getFailures();
+            break;
+        case SCALAR_STREAM_ACTIVE:
+            out.family = "musicbox_stream_connections";
+            out.value = TrackStream::activeCount();
+            break;
+        case SCALAR_STREAM_BYTES:
+            out.family = "musicbox_stream_bytes_total";
+            out.type = "counter";
+            out.value = (double)TrackStream::getTotals().bytes;
+            break;
+        case SCALAR_STREAM_DEFERRED:
+            out.family = "musicbox_stream_deferred_total";
+            out.type = "counter";
+            out.value = TrackStream::getTotals().deferred;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+bool Metrics::seriesAt(size_t index, MetricSeries& out, const TaskCpuSample* tasks, size_t taskCount) const {
+    size_t scalars = SCALAR_FIXED_COUNT + 2 * taskCount;
+    if (index < scalars) {
+        return scalarAt(index, out, tasks, taskCount);
+    }
+    index -= scalars;
+
+    out.type = "histogram";
+    out.value = 0;
+    out.labels[0] = '\0';
+    if (index < I2C_DEVICE_COUNT) {
+        out.family = "musicbox_i2c_transaction_seconds";
+        snprintf(out.labels, sizeof(out.labels), "device=\"%s\"", I2cArbiter::deviceName((uint8_t)index));
+        out.histogram = &i2c[index];
+        return true;
+    }
+    index -= I2C_DEVICE_COUNT;
+    if (index == 0) {
+        out.family = "musicbox_sd_read_seconds";
+        out.histogram = &sdRead;
+        return true;
+    }
+    if (index == 1) {
+        out.family = "musicbox_sd_write_seconds";
+        out.histogram = &sdWrite;
+        return true;
+    }
+    index -= 2;
+    if (index < routeCount) {
+        out.family = "musicbox_http_handler_seconds";
+        snprintf(out.labels, sizeof(out.labels), "route=\"%s\",method=\"%s\"",
+            routes[index].uri, routes[index].method);
+        out.histogram = &routes[index].latency;
+        return true;
+    }
+    return false;
+}
+
+// Sığdığı kadar ekler; taşarsa ok false olur
+struct SummaryWriter {
+    char* out;
+    size_t size;
+    size_t used;
+    bool ok;
+
+    void append(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (!ok) return;
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(out + used, size - used, format, args);
+        va_end(args);
+        if (written < 0 || (size_t)written >= size - used) {
+            ok = false;
+            return;
+        }
+        used += written;
+    }
+
+    void histogram(const char* name, const LatencyHistogram& h) {
+        uint32_t buckets[METRICS_HISTOGRAM_BUCKETS];
+        uint32_t count = h.snapshot(buckets);
+        append("\"%s\":{\"n\":%lu,\"p50\":%lu,\"p99\":%lu},", name, (unsigned long)count,
+            (unsigned long)LatencyHistogram::percentileUs(buckets, count, 0.5f),
+            (unsigned long)LatencyHistogram::percentileUs(buckets, count, 0.99f));
+    }
+};
+
+size_t Metrics::writeSummary(char* out, size_t size) const {
+    SummaryWriter w = { out, size, 0, size > 0 };
+    w.append("{\"heap\":{\"free\":%lu,\"min\":%lu,\"largest\":%lu},",
+        (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+        (unsigned long)ESP.getMaxAllocHeap());
+    w.append("\"dac\":{\"fill\":%lu,\"underruns\":%lu},",
+        (unsigned long)(dac ? dac->getFillLevel() : 0), (unsigned long)(dac ? dac->getStats().underruns : 0));
+    w.append("\"prefetch\":{\"fill\":%lu,\"underruns\":%lu},",
+        (unsigned long)audioPrefetch.getFill(), (unsigned long)audioPrefetch.getStats().underruns);
+    w.append("\"ws\":%lu,\"us\":{", (unsigned long)webSocketClients.load(std::memory_order_relaxed));
+    for (uint8_t device = 0; device < I2C_DEVICE_COUNT; device++) {
+        char name[16];
+        snprintf(name, sizeof(name), "i2c_%s", I2cArbiter::deviceName(device));
+        w.histogram(name, i2c[device]);
+    }
+    w.histogram("sd_read", sdRead);
+    w.histogram("sd_write", sdWrite);
+
+    // HTTP: tüm route'lar tek dağılımda
+    uint32_t http[METRICS_HISTOGRAM_BUCKETS] = {};
+    uint32_t httpCount = 0;
+    for (size_t i = 0; i < routeCount; i++) {
+        uint32_t buckets[METRICS_HISTOGRAM_BUCKETS];
+        httpCount += routes[i].latency.snapshot(buckets);
+        for (size_t b = 0; b < METRICS_HISTOGRAM_BUCKETS; b++) http[b] += buckets[b];
+    }
+    w.append("\"http\":{\"n\":%lu,\"p50\":%lu,\"p99\":%lu}},\"cpu\":{", (unsigned long)httpCount,
+        (unsigned long)LatencyHistogram::percentileUs(http, httpCount, 0.5f),
+        (unsigned long)LatencyHistogram::percentileUs(http, httpCount, 0.99f));
+
+    // Task payları sığdığı kadar (yüzde)
+    TaskCpuSample tasks[METRICS_MAX_TASKS];
+    size_t taskCount = copyTasks(tasks, METRICS_MAX_TASKS);
+    size_t tasksWritten = 0;
+    for (size_t i = 0; i < taskCount && w.ok; i++) {
+        size_t before = w.used;
+        w.append("%s\"%s\":%u.%u", tasksWritten ? "," : "", tasks[i].name,
+            tasks[i].cpuPermille / 10, tasks[i].cpuPermille % 10);
+        // Son "}}" için yer kalmalı
+        if (!w.ok || w.size - w.used < 3) {
+            w.used = before;
+            w.out[before] = '\0';
+            w.ok = true;
+            break;
+        }
+        tasksWritten++;
+    }
+    w.append("}}");
+    return w.ok ? w.used : 0;
+}
+
+// --- MetricsStream ---
+
+MetricsStream::MetricsStream(const Metrics& _metrics) :
+    metrics(_metrics),
+    series(0),
+    line(0),
+    lastFamily(nullptr),
+    count(0),
+    sumUs(0),
+    pendingLength(0),
+    pendingPos(0) {
+    taskCount = metrics.copyTasks(tasks, METRICS_MAX_TASKS);
+}
+
+// Satır sırası: ailenin ilk serisinden önce "# TYPE", gauge/counter için
+// tek değer satırı, histogram için kümülatif kovalar + _sum + _count
+bool MetricsStream::nextLine() {
+    while (true) {
+        if (line == 0) {
+            if (!metrics.seriesAt(series, current, tasks, taskCount)) return false;
+            if (current.histogram) {
+                count = current.histogram->snapshot(buckets);
+                sumUs = current.histogram->sumUs();
+            }
+            line = 1;
+            if (!lastFamily || strcmp(lastFamily, current.family) != 0) {
+                lastFamily = current.family;
+                pendingLength = snprintf(pending, sizeof(pending), "# TYPE %s %s\n", current.family, current.type);
+                return true;
+            }
+        }
+
+        // Etiketsiz seride süslü parantez yazılmaz
+        char labels[sizeof(current.labels) + 2];
+        if (current.labels[0]) {
+            snprintf(labels, sizeof(labels), "{%s}", current.labels);
+        } else {
+            labels[0] = '\0';
+        }
+        const char* sep = current.labels[0] ? "," : "";
+        if (!current.histogram) {
+            pendingLength = snprintf(pending, sizeof(pending), "%s%s %.6g\n", current.family, labels, current.value);
+            series++;
+            line = 0;
+            return true;
+        }
+
+        size_t bucket = line - 1;
+        if (bucket < METRICS_HISTOGRAM_BUCKETS) {
+            uint32_t cumulative = 0;
+            for (size_t i = 0; i <= bucket; i++) cumulative += buckets[i];
+            if (bucket == METRICS_HISTOGRAM_BUCKETS - 1) {
+                pendingLength = snprintf(pending, sizeof(pending), "%s_bucket{%s%sle=\"+Inf\"} %lu\n",
+                    current.family, current.labels, sep, (unsigned long)cumulative);
+            } else {
+                pendingLength = snprintf(pending, sizeof(pending), "%s_bucket{%s%sle=\"%.6f\"} %lu\n",
+                    current.family, current.labels, sep,
+                    LatencyHistogram::upperBoundUs(bucket) / 1e6, (unsigned long)cumulative);
+            }
+            line++;
+            return true;
+        }
+        if (bucket == METRICS_HISTOGRAM_BUCKETS) {
+            pendingLength = snprintf(pending, sizeof(pending), "%s_sum%s %.6f\n",
+                current.family, labels, sumUs / 1e6);
+            line++;
+            return true;
+        }
+        pendingLength = snprintf(pending, sizeof(pending), "%s_count%s %lu\n",
+            current.family, labels, (unsigned long)count);
+        series++;
+        line = 0;
+        return true;
+    }
+}
+
+size_t MetricsStream::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (pendingPos >= pendingLength) {
+            if (!nextLine()) break;
+            if (pendingLength >= sizeof(pending)) pendingLength = sizeof(pending) - 1;
+            pendingPos = 0;
+        }
+        size_t n = min(pendingLength - pendingPos, maxLen - written);
+        memcpy(buffer + written, pending + pendingPos, n);
+        pendingPos += n;
+        written += n;
+    }
+    return written;
+}
@@ -0,0 +1,179 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "I2cArbiter.h"
+#include "DacOutputStage.h"
+
+// Çalışma zamanı metrikleri: task başına CPU payı, heap, ses tamponları,
+// I2C/SD/HTTP gecikme histogramları. /api/metrics Prometheus metni olarak
+// (MetricsStream, chunked), MQTT'ye kısa JSON özeti olarak verilir.
+//
+// Kayıt yolu kilitsizdir: histogram kovası 2'nin kuvveti sınırlarla bir
+// clz ile bulunur, kova ve toplam relaxed atomik artırılır. Ses yolunda
+// (DAC burst'ü, SD okuması) açık bırakılabilir. Gauge'lar kayıt
+// gerektirmez, dışa aktarılırken sahiplerinden okunur.
+
+#define METRICS_HISTOGRAM_BUCKETS   18      // <= 16 us, 32 us, ... 2^20 us (~1 s), +Inf
+#define METRICS_MAX_ROUTES          40
+#define METRICS_MAX_TASKS           24
+#define METRICS_TASK_NAME           16
+#define METRICS_LINE_SIZE           192
+#define METRICS_SUMMARY_SIZE        512
+#define METRICS_SAMPLE_INTERVAL_MS  5000    // task CPU payı bu pencerede
+#define METRICS_MQTT_INTERVAL_MS    60000
+
+#ifndef METRICS_MQTT_TOPIC
+#define METRICS_MQTT_TOPIC          "musicbox/metrics"
+#endif
+
+class LatencyHistogram {
+private:
+    std::atomic<uint32_t> buckets[METRICS_HISTOGRAM_BUCKETS];
+    // 64-bit atomik Xtensa'da kilitli; toplam iki 32-bit parçada taşınır
+    std::atomic<uint32_t> sumLow;
+    std::atomic<uint32_t> sumHigh;
+
+public:
+    LatencyHistogram() { reset(); }
+
+    // Kova i: us <= 2^(i+4); son kova +Inf
+    static size_t bucketFor(uint32_t us) {
+        if (us <= 16) return 0;
+        size_t bits = 32 - __builtin_clz(us - 1);
+        size_t index = bits - 4;
+        return index < METRICS_HISTOGRAM_BUCKETS ? index : METRICS_HISTOGRAM_BUCKETS - 1;
+    }
+
+    static uint32_t upperBoundUs(size_t index) { return 1UL << (index + 4); }
+
+    void record(uint32_t us) {
+        buckets[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+        uint32_t old = sumLow.fetch_add(us, std::memory_order_relaxed);
+        if (old + us < old) {
+            sumHigh.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Kovaların anlık kopyası; sayı kovaların toplamıdır, böylece
+    // kümülatif kovalar ile _count her zaman tutarlıdır
+    uint32_t snapshot(uint32_t* out) const;
+    uint64_t sumUs() const;
+    uint32_t count() const;
+
+    // Kova üst sınırı cinsinden yüzdelik (0 < q <= 1); kayıt yoksa 0
+    static uint32_t percentileUs(const uint32_t* buckets, uint32_t count, float q);
+
+    void reset();
+};
+
+struct HttpRouteMetrics {
+    const char* uri;
+    const char* method;
+    LatencyHistogram latency;
+};
+
+struct TaskCpuSample {
+    char name[METRICS_TASK_NAME];
+    uint32_t number;            // xTaskNumber, pencereler arası eşleştirme
+    uint32_t runTime;           // son örnekteki sayaç
+    uint16_t cpuPermille;       // son pencerede, tüm çekirdeklerin toplamına göre
+    int8_t core;                // -1: sabitlenmemiş
+    uint32_t stackFree;         // en düşük boş yığın (byte)
+};
+
+// Dışa aktarılan tek seri
+struct MetricSeries {
+    const char* family;
+    const char* type;           // "gauge", "counter", "histogram"
+    char labels[64];            // {..} olmadan; boş olabilir
+    double value;               // histogram için kullanılmaz
+    const LatencyHistogram* histogram;
+};
+
+class Metrics {
+private:
+    HttpRouteMetrics routes[METRICS_MAX_ROUTES];
+    size_t routeCount;
+
+    const DacOutputStage* dac;
+    std::atomic<uint32_t> webSocketClients;
+
+    TaskCpuSample tasks[METRICS_MAX_TASKS];
+    size_t taskCount;
+    uint32_t lastTotalRunTime;
+    unsigned long lastSampleMs;
+
+    SemaphoreHandle_t mutex;
+
+    void lock() const;
+    void unlock() const;
+
+    bool scalarAt(size_t index, MetricSeries& out, const TaskCpuSample* tasks, size_t taskCount) const;
+
+public:
+    // Ses yolu ve bus'lar; kayıt herhangi bir task'tan
+    LatencyHistogram i2c[I2C_DEVICE_COUNT];
+    LatencyHistogram sdRead;        // önden okuma task'ının SD okumaları
+    LatencyHistogram sdWrite;       // upload yazıcısının SD yazmaları
+
+    Metrics();
+
+    // DAC tamponu dışa aktarılırken okunur
+    void attachDac(const DacOutputStage* stage) { dac = stage; }
+
+    // Route kaydı sırasında (tek task) çağrılır; yer yoksa nullptr
+    HttpRouteMetrics* route(const char* uri, const char* method);
+
+    void setWebSocketClients(uint32_t count) { webSocketClients.store(count, std::memory_order_relaxed); }
+
+    // Loop task'ından; task CPU payını METRICS_SAMPLE_INTERVAL_MS'de bir örnekler
+    void loop();
+    void sampleTasks();
+
+    // Son örneklenen task tablosunun kopyası; kopyalanan sayı
+    size_t copyTasks(TaskCpuSample* out, size_t max) const;
+
+    // Dışa aktarılan seriler sırayla: önce gauge/counter'lar (task'lar
+    // verilen kopyadan), sonra histogramlar. index bitince false.
+    bool seriesAt(size_t index, MetricSeries& out, const TaskCpuSample* tasks, size_t taskCount) const;
+
+    // MQTT için kısa JSON; yazılan uzunluk (sığmazsa 0)
+    size_t writeSummary(char* out, size_t size) const;
+};
+
+// /api/metrics gövdesi; PlaylistStream gibi chunked response'un tamponunu
+// satır satır doldurur. Task tablosu akış başında, histogramın kovaları o
+// histograma gelince kopyalanır.
+class MetricsStream {
+private:
+    const Metrics& metrics;
+    size_t series;
+    size_t line;
+    const char* lastFamily;
+    MetricSeries current;
+    uint32_t buckets[METRICS_HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint64_t sumUs;
+    TaskCpuSample tasks[METRICS_MAX_TASKS];
+    size_t taskCount;
+
+    char pending[METRICS_LINE_SIZE];
+    size_t pendingLength;
+    size_t pendingPos;
+
+    bool nextLine();
+
+public:
+    explicit MetricsStream(const Metrics& metrics);
+
+    // Tampona en fazla maxLen byte yazar; 0 dönünce akış bitmiştir
+    size_t fill(uint8_t* buffer, size_t maxLen);
+};
+
+extern Metrics metrics;
+
+#endif // METRICS_H
@@ -0,0 +1,71 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Çok üretici / tek tüketici, sabit kapasiteli kilitsiz kuyruk.
+//
+// Her hücrenin bir sıra numarası vardır (Vyukov'un sınırlı kuyruğu):
+// üretici hücreyi head üzerinde CAS ile ayırır, veriyi yazar ve sıra
+// numarasını yayınlar; tüketici numara hazırsa okur. Üretici hiç
+// beklemez, kuyruk doluysa push() false döner. async_tcp, MQTT ve BLE
+// task'ları aynı kuyruğa mutex olmadan yazabilir.
+template <typename T, size_t Capacity>
+class MpscQueue {
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity 2'nin kuvveti olmalı");
+
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        T value;
+    };
+
+    Cell cells[Capacity];
+    std::atomic<uint32_t> head;     // üreticiler
+    uint32_t tail;                  // sadece tüketici
+
+public:
+    MpscQueue() : head(0), tail(0) {
+        for (size_t i = 0; i < Capacity; i++) {
+            cells[i].sequence.store((uint32_t)i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& value) {
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & (Capacity - 1)];
+            uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(sequence - pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // dolu
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T& value) {
+        Cell& cell = cells[tail & (Capacity - 1)];
+        uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if ((int32_t)(sequence - (tail + 1)) < 0) {
+            return false;       // boş veya üretici henüz yazıyor
+        }
+        value = cell.value;
+        cell.sequence.store(tail + Capacity, std::memory_order_release);
+        tail++;
+        return true;
+    }
+
+    size_t capacity() const { return Capacity; }
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,225 @@
+#include "MqttOutbox.h"
+#include <esp_system.h>
+#include "Trace.h"
+
+// FNV-1a; alan değerinin son yayınlananla aynı olup olmadığı için
+static uint32_t hashOf(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+MqttOutbox::MqttOutbox() :
+    pending(0),
+    nextSequence(0),
+    publisher(nullptr),
+    publisherContext(nullptr),
+    statusVersion(0),
+    statusFields(STATUS_ALL),
+    fieldPosted(0),
+    mutex(xSemaphoreCreateMutex()) {
+    for (size_t i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+        entries[i].used = false;
+    }
+    memset(&stats, 0, sizeof(stats));
+    memset(fieldHash, 0, sizeof(fieldHash));
+    memset(fieldPostedMs, 0, sizeof(fieldPostedMs));
+}
+
+void MqttOutbox::lock() const {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void MqttOutbox::unlock() const {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+void MqttOutbox::attach(MqttPublisher _publisher, void* context) {
+    publisher = _publisher;
+    publisherContext = context;
+}
+
+bool MqttOutbox::post(const char* topic, const char* payload, size_t length, bool retain, unsigned long now) {
+    lock();
+    stats.posted++;
+    if (length > MQTT_OUTBOX_PAYLOAD_MAX || strlen(topic) > MQTT_OUTBOX_TOPIC_MAX) {
+        stats.dropped++;
+        unlock();
+        return false;
+    }
+
+    Entry* slot = nullptr;
+    Entry* spare = nullptr;
+    for (size_t i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+        Entry& entry = entries[i];
+        if (entry.used && strcmp(entry.topic.c_str(), topic) == 0) {
+            slot = &entry;
+            break;
+        }
+        if (!entry.used && !spare) spare = &entry;
+    }
+
+    if (slot) {
+        // Yayınlanmamış eski değer artık anlamsız; yeri ve sırası korunur
+        stats.coalesced++;
+        slot->revision++;
+    } else if (spare) {
+        slot = spare;
+        slot->used = true;
+        slot->sequence = nextSequence++;
+        slot->revision = 0;
+        slot->queuedMs = now;
+        slot->topic.clear();
+        slot->topic.append(topic);
+        pending++;
+    } else {
+        stats.dropped++;
+        unlock();
+        return false;
+    }
+    slot->retain = retain;
+    slot->length = (uint16_t)length;
+    memcpy(slot->payload, payload, length);
+    unlock();
+    return true;
+}
+
+void MqttOutbox::postStatus(const StatusSnapshot& snapshot, unsigned long now) {
+    // Sürüm önce okunur: arada değişen alan bu turda da, sonrakinde de
+    // görünür; kaybolmaz
+    uint32_t version = snapshot.getVersion();
+    if (version != statusVersion) {
+        statusFields |= snapshot.changedSince(statusVersion);
+        statusVersion = version;
+    }
+    if (!statusFields) return;
+
+    TRACE_SCOPE("mqtt.status");
+    for (uint8_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        uint32_t field = 1UL << i;
+        if (!(statusFields & field)) continue;
+        if ((field & MQTT_STATUS_SLOW_FIELDS) && (fieldPosted & field) &&
+            now - fieldPostedMs[i] < MQTT_STATUS_SLOW_INTERVAL_MS) {
+            continue;   // son değer aralık dolunca gider
+        }
+
+        size_t length = snapshot.serializeField(field, scratch, sizeof(scratch));
+        if (length == 0) {
+            statusFields &= ~field;
+            continue;
+        }
+        uint32_t hash = hashOf(scratch, length);
+        if ((fieldPosted & field) && fieldHash[i] == hash) {
+            stats.unchanged++;
+            statusFields &= ~field;
+            continue;
+        }
+
+        scratchTopic.clear();
+        scratchTopic.append(MQTT_STATUS_TOPIC_PREFIX).append(StatusSnapshot::fieldName(field));
+        if (post(scratchTopic.c_str(), scratch, length, true, now)) {
+            fieldHash[i] = hash;
+            fieldPostedMs[i] = now;
+            fieldPosted |= field;
+            statusFields &= ~field;
+        }
+    }
+}
+
+void MqttOutbox::resendStatus() {
+    fieldPosted = 0;
+    statusFields = STATUS_ALL;
+}
+
+size_t MqttOutbox::loop(unsigned long now, bool connected) {
+    if (!connected || !publisher || pending == 0) return 0;
+
+    lock();
+    unsigned long oldest = now;
+    for (size_t i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+        if (entries[i].used && (long)(entries[i].queuedMs - oldest) < 0) oldest = entries[i].queuedMs;
+    }
+    unlock();
+    if (now - oldest < MQTT_BATCH_WINDOW_MS) return 0;
+
+    TRACE_SCOPE("mqtt.flush");
+    stats.flushes++;
+    size_t sent = 0;
+    while (true) {
+        // Sıradaki kayıt kilit altında kopyalanır, yayıncı kilitsiz çağrılır
+        lock();
+        Entry* next = nullptr;
+        for (size_t i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+            if (entries[i].used && (!next || (int32_t)(entries[i].sequence - next->sequence) < 0)) {
+                next = &entries[i];
+            }
+        }
+        if (!next) {
+            unlock();
+            break;
+        }
+        uint32_t revision = next->revision;
+        bool retain = next->retain;
+        size_t length = next->length;
+        scratchTopic.clear();
+        scratchTopic.append(next->topic.c_str());
+        memcpy(scratch, next->payload, length);
+        unlock();
+
+        if (!publisher(publisherContext, scratchTopic.c_str(), scratch, length, retain)) {
+            stats.refused++;
+            break;     // istemci tamponu dolu; kalanlar sonraki turda
+        }
+
+        lock();
+        stats.published++;
+        stats.publishedBytes += scratchTopic.length() + length;
+        if (next->revision == revision) {
+            next->used = false;
+            pending--;
+        } else {
+            // Gönderilirken yenisi geldi; o da bir pencere sonra gider
+            next->queuedMs = now;
+            next->sequence = nextSequence++;
+        }
+        unlock();
+        sent++;
+    }
+    return sent;
+}
+
+MqttBackoff::MqttBackoff(uint32_t _baseMs, uint32_t _maxMs) :
+    baseMs(_baseMs),
+    maxMs(_maxMs),
+    failures(0),
+    attempts(0),
+    lastDelayMs(0),
+    nextMs(0) {
+}
+
+uint32_t MqttBackoff::delayFor(uint8_t failures, uint32_t baseMs, uint32_t maxMs, uint32_t random) {
+    uint64_t delay = (uint64_t)baseMs << (failures < 20 ? failures : 20);
+    if (delay > maxMs) delay = maxMs;
+    uint32_t half = (uint32_t)delay / 2;
+    return half + random % (half + 1);
+}
+
+void MqttBackoff::attempted(unsigned long now) {
+    attempts++;
+    lastDelayMs = delayFor(failures, baseMs, maxMs, esp_random());
+    nextMs = now + lastDelayMs;
+    if (failures < UINT8_MAX) failures++;
+}
+
+void MqttBackoff::succeeded() {
+    failures = 0;
+}
+
+void MqttBackoff::disconnected(unsigned long now) {
+    // İlk deneme base içinde rastgele: broker yeniden başladığında kopan
+    // cihazlar aynı anda dönmez
+    lastDelayMs = esp_random() % (baseMs + 1);
+    nextMs = now + lastDelayMs;
+}
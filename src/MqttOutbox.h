@@ -0,0 +1,147 @@
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "FixedString.h"
+#include "StatusSnapshot.h"
+
+// MQTT giden kuyruğu ve yeniden bağlanma zamanlayıcısı.
+//
+// Kuyruk sabit MQTT_OUTBOX_SLOTS yuvalıdır ve konu başına tek kayıt tutar:
+// aynı konuya yayınlanmamış bir mesaj varken gelen yenisi onun yerine
+// geçer (sırası korunur). En eski kayıt MQTT_BATCH_WINDOW_MS bekledikten
+// sonra bekleyen her şey tek seferde gönderilir; bir sürgü sürüklemesi
+// veya parça geçişi tek pakete iner.
+//
+// Durum tam JSON yerine alan başına retained konulara gider
+// (MQTT_STATUS_TOPIC_PREFIX + "volume" gibi). Snapshot sürümünden beri
+// değişen alanlar serialize edilir; değeri son yayınlananla aynıysa
+// gönderilmez. Konum ve saat her saniye değiştiği için en fazla
+// MQTT_STATUS_SLOW_INTERVAL_MS'de bir gider.
+//
+// post() herhangi bir task'tan çağrılabilir; loop() ve postStatus() sadece
+// loop task'ından. Yayıncı kilit dışında çağrılır (AsyncMqttClient kendi
+// kilidini async_tcp ile paylaşır).
+
+#define MQTT_OUTBOX_SLOTS               14      // 11 durum alanı + metrikler + pay
+#define MQTT_OUTBOX_TOPIC_MAX           48
+#define MQTT_OUTBOX_PAYLOAD_MAX         640     // parça alanı: yol + üç etiket, kaçışlı
+#define MQTT_BATCH_WINDOW_MS            250
+#define MQTT_STATUS_SLOW_INTERVAL_MS    10000
+#define MQTT_STATUS_SLOW_FIELDS         (STATUS_POSITION | STATUS_TIME)
+
+#ifndef MQTT_STATUS_TOPIC_PREFIX
+#define MQTT_STATUS_TOPIC_PREFIX        "musicbox/status/"
+#endif
+
+#define MQTT_BACKOFF_BASE_MS            1000
+#define MQTT_BACKOFF_MAX_MS             30000
+
+// Mesajı istemciye verir; istemci kabul etmezse (bağlı değil, tampon
+// dolu) false, kayıt kuyrukta kalır
+typedef bool (*MqttPublisher)(void* context, const char* topic, const char* payload, size_t length, bool retain);
+
+struct MqttOutboxStats {
+    uint32_t posted;
+    uint32_t coalesced;         // yayınlanmadan üzerine yazılan
+    uint32_t dropped;           // kuyruk doluydu
+    uint32_t unchanged;         // durum alanı son yayınlananla aynıydı
+    uint32_t published;
+    uint32_t refused;           // yayıncı kabul etmedi
+    uint32_t flushes;
+    uint64_t publishedBytes;    // konu + yük
+};
+
+class MqttOutbox {
+private:
+    struct Entry {
+        bool used;
+        bool retain;
+        uint32_t sequence;      // gönderim sırası (ilk kuyruğa giriş)
+        uint32_t revision;      // üzerine yazıldıkça artar
+        unsigned long queuedMs;
+        FixedString<MQTT_OUTBOX_TOPIC_MAX> topic;
+        uint16_t length;
+        char payload[MQTT_OUTBOX_PAYLOAD_MAX];
+    };
+
+    Entry entries[MQTT_OUTBOX_SLOTS];
+    size_t pending;
+    uint32_t nextSequence;
+    MqttOutboxStats stats;
+
+    MqttPublisher publisher;
+    void* publisherContext;
+
+    // Durum alanları (loop task)
+    uint32_t statusVersion;
+    uint32_t statusFields;      // değişmiş, henüz kuyruğa girmemiş
+    uint32_t fieldHash[STATUS_FIELD_COUNT];
+    unsigned long fieldPostedMs[STATUS_FIELD_COUNT];
+    uint32_t fieldPosted;       // en az bir kez kuyruğa girenler
+    char scratch[MQTT_OUTBOX_PAYLOAD_MAX];
+    FixedString<MQTT_OUTBOX_TOPIC_MAX> scratchTopic;
+
+    SemaphoreHandle_t mutex;
+
+    void lock() const;
+    void unlock() const;
+
+public:
+    MqttOutbox();
+
+    void attach(MqttPublisher publisher, void* context);
+
+    // Konu için bekleyen mesaj varsa yerine geçer; yer yoksa false
+    bool post(const char* topic, const char* payload, size_t length, bool retain, unsigned long now);
+    bool post(const char* topic, const char* payload, bool retain, unsigned long now) {
+        return post(topic, payload, strlen(payload), retain, now);
+    }
+
+    // Snapshot'ta değişen alanları alan konularına kuyruğa koyar
+    void postStatus(const StatusSnapshot& snapshot, unsigned long now);
+
+    // Yeni oturumda (broker retained'ı kaybetmiş olabilir) tüm alanlar
+    // bir kez daha gönderilir
+    void resendStatus();
+
+    // Pencere dolduysa bekleyenleri sırayla yayıncıya verir; gönderilen sayı
+    size_t loop(unsigned long now, bool connected);
+
+    size_t getPending() const { return pending; }
+    const MqttOutboxStats& getStats() const { return stats; }
+};
+
+// Titreşimli üstel geri çekilme. Bağlantı denemesi loop()'u bekletmez:
+// ready() zamanı gelince true döner, deneme async başlatılır ve
+// attempted() bir sonrakini planlar. Gecikme base * 2^hata, max ile
+// sınırlı; yarısı sabit, yarısı rastgele. Kopunca ilk deneme [0, base]
+// içinde rastgeledir (aynı anda kopan cihazlar broker'a birlikte
+// yüklenmez).
+class MqttBackoff {
+private:
+    uint32_t baseMs;
+    uint32_t maxMs;
+    uint8_t failures;
+    uint32_t attempts;
+    uint32_t lastDelayMs;
+    unsigned long nextMs;
+
+public:
+    MqttBackoff(uint32_t baseMs = MQTT_BACKOFF_BASE_MS, uint32_t maxMs = MQTT_BACKOFF_MAX_MS);
+
+    bool ready(unsigned long now) const { return (long)(now - nextMs) >= 0; }
+    void attempted(unsigned long now);
+    void succeeded();
+    void disconnected(unsigned long now);
+
+    uint8_t getFailures() const { return failures; }
+    uint32_t getAttempts() const { return attempts; }
+    uint32_t getLastDelayMs() const { return lastDelayMs; }
+
+    static uint32_t delayFor(uint8_t failures, uint32_t baseMs, uint32_t maxMs, uint32_t random);
+};
+
+#endif // MQTT_OUTBOX_H
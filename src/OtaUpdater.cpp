@@ -0,0 +1,681 @@
+#include "OtaUpdater.h"
+#include "StatusSnapshot.h"
+
+OtaUpdater otaUpdater;
+
+#define GZIP_FLAG_HCRC      0x02
+#define GZIP_FLAG_EXTRA     0x04
+#define GZIP_FLAG_NAME      0x08
+#define GZIP_FLAG_COMMENT   0x10
+#define ESP_IMAGE_MAGIC     0xE9
+
+OtaUpdater::OtaUpdater() :
+    pool(nullptr),
+    freeCount(0),
+    current(-1),
+    fill(0),
+    jobHead(0),
+    jobCount(0),
+    ending(false),
+    held(false),
+    flow(nullptr),
+    state(OTA_IDLE),
+    error(nullptr),
+    compression(OTA_COMPRESSION_AUTO),
+    total(0),
+    startMs(0),
+    lastStatusMs(0),
+    restartAt(0),
+    restartPending(false),
+    block(nullptr),
+    blockFill(0),
+    inflator(nullptr),
+    dictionary(nullptr),
+    dictionaryPos(0),
+    window(nullptr),
+    mutex(nullptr),
+    task(nullptr) {
+    memset(&stats, 0, sizeof(stats));
+    mbedtls_sha256_init(&hash);
+}
+
+bool OtaUpdater::begin() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+    }
+    if (!task) {
+        if (xTaskCreatePinnedToCore(taskEntry, "ota_writer", OTA_TASK_STACK, this,
+                OTA_TASK_PRIORITY, &task, OTA_TASK_CORE) != pdPASS) {
+            Serial.println("❌ OTA writer task oluşturulamadı");
+            task = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+void OtaUpdater::taskEntry(void* arg) {
+    OtaUpdater* self = (OtaUpdater*)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->process()) {
+        }
+    }
+}
+
+void OtaUpdater::lock() {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void OtaUpdater::unlock() {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+// Tampon havuzu ve flash sektörü güncelleme başında ayrılır; çözücü
+// belleği sıkıştırma türü belli olunca OTA task'ında
+bool OtaUpdater::allocate() {
+    pool = (uint8_t*)malloc(OTA_BUFFER_COUNT * OTA_BUFFER_SIZE);
+    block = (uint8_t*)malloc(OTA_BUFFER_SIZE);
+    if (!pool || !block) {
+        free(pool);
+        free(block);
+        pool = nullptr;
+        block = nullptr;
+        return false;
+    }
+    for (uint8_t i = 0; i < OTA_BUFFER_COUNT; i++) {
+        freeList[i] = i;
+    }
+    freeCount = OTA_BUFFER_COUNT;
+    return true;
+}
+
+void OtaUpdater::release() {
+    lock();
+    free(pool);
+    free(block);
+    free(inflator);
+    free(dictionary);
+    free(window);
+    pool = nullptr;
+    block = nullptr;
+    inflator = nullptr;
+    dictionary = nullptr;
+    window = nullptr;
+    freeCount = 0;
+    current = -1;
+    if (held && flow) {
+        flow->release();
+    }
+    delete flow;
+    flow = nullptr;
+    held = false;
+    unlock();
+}
+
+bool OtaUpdater::pushJob(uint8_t type, int8_t buffer, uint16_t length) {
+    if (jobCount >= OTA_JOB_CAPACITY) {
+        return false;
+    }
+    Job& job = jobs[(jobHead + jobCount) % OTA_JOB_CAPACITY];
+    job.type = type;
+    job.buffer = buffer;
+    job.length = length;
+    jobCount++;
+    return true;
+}
+
+const char* OtaUpdater::stateName(OtaState state) {
+    switch (state) {
+        case OTA_IDLE:      return "idle";
+        case OTA_RECEIVING: return "receiving";
+        case OTA_VERIFYING: return "verifying";
+        case OTA_SUCCESS:   return "success";
+        case OTA_FAILED:    return "failed";
+    }
+    return "unknown";
+}
+
+OtaCompression OtaUpdater::compressionFromName(const String& name) {
+    if (name == "gzip" || name == "gz") return OTA_COMPRESSION_GZIP;
+    if (name == "heatshrink" || name == "hs") return OTA_COMPRESSION_HEATSHRINK;
+    if (name == "none" || name == "raw") return OTA_COMPRESSION_NONE;
+    return OTA_COMPRESSION_AUTO;
+}
+
+static bool parseHexDigest(const String& text, uint8_t* out) {
+    if (text.length() != 64) {
+        return false;
+    }
+    for (int i = 0; i < 32; i++) {
+        char pair[3] = { text[i * 2], text[i * 2 + 1], '\0' };
+        char* end = nullptr;
+        out[i] = (uint8_t)strtoul(pair, &end, 16);
+        if (!end || *end != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OtaUpdater::start(const String& sha256Hex, OtaCompression compressionType, uint32_t totalSize,
+    UploadFlowControl* flowControl, uint8_t heatshrinkWindow, uint8_t heatshrinkLookahead) {
+    lock();
+    if (isBusy() || jobCount > 0 || pool) {
+        unlock();
+        delete flowControl;
+        return false;
+    }
+
+    error = nullptr;
+    state = OTA_FAILED;
+    memset(&stats, 0, sizeof(stats));
+    if (!parseHexDigest(sha256Hex, expectedHash)) {
+        error = "SHA-256 gerekli (64 hex)";
+    } else if (compressionType == OTA_COMPRESSION_HEATSHRINK &&
+               (heatshrinkWindow < 4 || heatshrinkWindow > 15 ||
+                heatshrinkLookahead < 3 || heatshrinkLookahead >= heatshrinkWindow)) {
+        error = "Geçersiz heatshrink parametreleri";
+    } else if (!allocate()) {
+        error = "Bellek yetersiz";
+    } else if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
+        // Tek OTA slotlu bölüm tablosunda da buraya düşülür
+        error = Update.errorString();
+        free(pool);
+        free(block);
+        pool = nullptr;
+        block = nullptr;
+    }
+    if (error) {
+        unlock();
+        delete flowControl;
+        Serial.printf("❌ OTA başlatılamadı: %s\n", error);
+        publishStatus(true);
+        return false;
+    }
+
+    compression = compressionType;
+    total = totalSize;
+    flow = flowControl;
+    held = false;
+    ending = false;
+    current = -1;
+    fill = 0;
+    jobHead = 0;
+    jobCount = 0;
+    blockFill = 0;
+    dictionaryPos = 0;
+    gzipState = GZIP_HEADER;
+    gzipNeeded = 10;
+    gzipFlags = 0;
+    windowBits = heatshrinkWindow;
+    lookaheadBits = heatshrinkLookahead;
+    windowHead = 0;
+    hsState = HS_TAG;
+    hsBitCount = 0;
+    hsValue = 0;
+    hsMask = 0;
+    mbedtls_sha256_free(&hash);
+    mbedtls_sha256_init(&hash);
+    mbedtls_sha256_starts_ret(&hash, 0);
+    startMs = millis();
+    restartPending = false;
+    state = OTA_RECEIVING;
+    unlock();
+
+    Serial.println("OTA Update Start");
+    publishStatus(true);
+    return true;
+}
+
+bool OtaUpdater::write(const uint8_t* data, size_t len) {
+    bool queued = false;
+
+    lock();
+    if (state != OTA_RECEIVING || ending) {
+        unlock();
+        return false;
+    }
+    stats.received += len;
+
+    while (len > 0) {
+        if (current < 0) {
+            if (freeCount == 0) {
+                // Akış kontrolü yetmedi; OTA task'ı başarısız işaretler
+                error = "OTA tampon havuzu taştı";
+                pushJob(JOB_ABORT, -1, 0);
+                ending = true;
+                unlock();
+                if (task) xTaskNotifyGive(task);
+                return false;
+            }
+            current = freeList[--freeCount];
+            fill = 0;
+        }
+
+        size_t count = min(len, (size_t)(OTA_BUFFER_SIZE - fill));
+        memcpy(pool + (size_t)current * OTA_BUFFER_SIZE + fill, data, count);
+        fill += count;
+        data += count;
+        len -= count;
+
+        if (fill == OTA_BUFFER_SIZE) {
+            pushJob(JOB_DATA, current, fill);
+            current = -1;
+            fill = 0;
+            queued = true;
+        }
+    }
+
+    // Son boş tampon da alınmak üzereyse ack geciktirilir; kuyrukta iş
+    // yoksa release() gelmeyeceğinden bekletilmez
+    if (freeCount <= 1 && jobCount > 0 && flow && !held) {
+        flow->hold();
+        held = true;
+        stats.backpressureHolds++;
+    }
+    unlock();
+
+    if (queued && task) xTaskNotifyGive(task);
+    return true;
+}
+
+void OtaUpdater::finish() {
+    lock();
+    if (state == OTA_RECEIVING && !ending) {
+        if (current >= 0) {
+            pushJob(JOB_DATA, current, fill);
+            current = -1;
+            fill = 0;
+        }
+        pushJob(JOB_END, -1, 0);
+        ending = true;
+    }
+    unlock();
+    if (task) xTaskNotifyGive(task);
+}
+
+void OtaUpdater::abort() {
+    lock();
+    bool queued = false;
+    // END kuyruğa girdiyse veri tamamdır; bağlantının kapanması sonucu etkilemez
+    if (state == OTA_RECEIVING && !ending) {
+        if (current >= 0) {
+            freeList[freeCount++] = current;
+            current = -1;
+        }
+        pushJob(JOB_ABORT, -1, 0);
+        ending = true;
+        queued = true;
+    }
+    unlock();
+    if (queued && task) xTaskNotifyGive(task);
+}
+
+bool OtaUpdater::process() {
+    lock();
+    if (jobCount == 0) {
+        unlock();
+        return false;
+    }
+    Job job = jobs[jobHead];
+    jobHead = (jobHead + 1) % OTA_JOB_CAPACITY;
+    jobCount--;
+    const uint8_t* data = job.buffer >= 0 ? pool + (size_t)job.buffer * OTA_BUFFER_SIZE : nullptr;
+    unlock();
+
+    switch (job.type) {
+        case JOB_DATA:
+            if (state == OTA_RECEIVING) {
+                runData(data, job.length);
+            }
+            lock();
+            freeList[freeCount++] = job.buffer;
+            if (held) {
+                held = false;
+                if (flow) flow->release();
+            }
+            unlock();
+            break;
+        case JOB_END:
+            runEnd();
+            break;
+        case JOB_ABORT:
+            runAbort();
+            break;
+    }
+
+    // Başarısız güncellemede END gelmeyebilir; kuyruk boşalınca bellek bırakılır
+    lock();
+    bool drained = state == OTA_FAILED && jobCount == 0 && pool;
+    unlock();
+    if (drained) {
+        release();
+    }
+    return true;
+}
+
+void OtaUpdater::fail(const char* message) {
+    lock();
+    if (state == OTA_FAILED) {
+        unlock();
+        return;
+    }
+    error = message;
+    state = OTA_FAILED;
+    unlock();
+    Update.abort();
+    Serial.printf("❌ OTA Update Failed: %s\n", message);
+    publishStatus(true);
+}
+
+void OtaUpdater::publishStatus(bool force) {
+    uint32_t now = millis();
+    if (!force && now - lastStatusMs < OTA_STATUS_INTERVAL_MS) {
+        return;
+    }
+    lastStatusMs = now;
+    uint32_t elapsed = now - startMs;
+    uint32_t rate = elapsed > 0 ? (uint32_t)((uint64_t)stats.written * 1000 / 1024 / elapsed) : 0;
+    statusSnapshot.setOta(stateName(state), stats.received, total, stats.written, rate, error);
+}
+
+void OtaUpdater::runData(const uint8_t* data, size_t len) {
+    uint32_t start = micros();
+    uint32_t flashBefore = stats.flashTimeUs;
+
+    if (compression == OTA_COMPRESSION_AUTO && len > 0) {
+        // ESP32 imajı 0xE9 ile başlar, gzip 1f 8b ile
+        compression = data[0] == 0x1f ? OTA_COMPRESSION_GZIP : OTA_COMPRESSION_NONE;
+    }
+    if (compression == OTA_COMPRESSION_GZIP && !inflator) {
+        inflator = (tinfl_decompressor*)malloc(sizeof(tinfl_decompressor));
+        dictionary = (uint8_t*)malloc(TINFL_LZ_DICT_SIZE);
+        if (!inflator || !dictionary) {
+            fail("Bellek yetersiz (gzip)");
+            return;
+        }
+        tinfl_init(inflator);
+    }
+    if (compression == OTA_COMPRESSION_HEATSHRINK && !window) {
+        window = (uint8_t*)calloc(1, (size_t)1 << windowBits);
+        if (!window) {
+            fail("Bellek yetersiz (heatshrink)");
+            return;
+        }
+    }
+
+    switch (compression) {
+        case OTA_COMPRESSION_GZIP:
+            decodeGzip(data, len);
+            break;
+        case OTA_COMPRESSION_HEATSHRINK:
+            decodeHeatshrink(data, len);
+            break;
+        default:
+            emit(data, len);
+            break;
+    }
+
+    stats.decodeTimeUs += (micros() - start) - (stats.flashTimeUs - flashBefore);
+    publishStatus(false);
+}
+
+void OtaUpdater::runEnd() {
+    if (state == OTA_RECEIVING) {
+        state = OTA_VERIFYING;
+        publishStatus(true);
+
+        if (compression == OTA_COMPRESSION_GZIP && gzipState != GZIP_DONE) {
+            fail("gzip akışı eksik");
+        } else if (flushBlock()) {
+            uint8_t digest[32];
+            mbedtls_sha256_finish_ret(&hash, digest);
+            if (stats.written == 0) {
+                fail("Boş imaj");
+            } else if (memcmp(digest, expectedHash, sizeof(digest)) != 0) {
+                fail("SHA-256 uyuşmuyor");
+            } else if (!Update.end(true)) {
+                fail(Update.errorString());
+            } else {
+                stats.elapsedMs = millis() - startMs;
+                Serial.printf("✅ OTA Update Success: %u bytes, %u ms\n", (unsigned)stats.written,
+                    (unsigned)stats.elapsedMs);
+                lock();
+                state = OTA_SUCCESS;
+                restartAt = millis() + OTA_RESTART_DELAY_MS;
+                restartPending = true;
+                unlock();
+            }
+        }
+    }
+    stats.elapsedMs = millis() - startMs;
+    release();
+    publishStatus(true);
+}
+
+void OtaUpdater::runAbort() {
+    fail(error ? error : "Bağlantı koptu");
+    release();
+}
+
+bool OtaUpdater::emit(const uint8_t* data, size_t len) {
+    mbedtls_sha256_update_ret(&hash, data, len);
+    while (len > 0) {
+        size_t count = min(len, (size_t)(OTA_BUFFER_SIZE - blockFill));
+        memcpy(block + blockFill, data, count);
+        blockFill += count;
+        data += count;
+        len -= count;
+        if (blockFill == OTA_BUFFER_SIZE && !flushBlock()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Update.write sektör silme + programlama yapar (onlarca ms); bu yüzden
+// async_tcp'de değil burada
+bool OtaUpdater::flushBlock() {
+    if (blockFill == 0) {
+        return true;
+    }
+    if (stats.written == 0 && block[0] != ESP_IMAGE_MAGIC) {
+        fail("Geçersiz imaj (sıkıştırma türü yanlış olabilir)");
+        return false;
+    }
+    uint32_t start = micros();
+    size_t written = Update.write(block, blockFill);
+    uint32_t elapsed = micros() - start;
+    stats.flashWrites++;
+    stats.flashTimeUs += elapsed;
+    if (elapsed > stats.maxFlashUs) stats.maxFlashUs = elapsed;
+    if (written != blockFill) {
+        fail(Update.errorString());
+        return false;
+    }
+    stats.written += blockFill;
+    blockFill = 0;
+    return true;
+}
+
+// Sıradaki isteğe bağlı başlık alanına geçer
+void OtaUpdater::nextGzipField() {
+    if (gzipFlags & GZIP_FLAG_EXTRA) {
+        gzipFlags &= ~GZIP_FLAG_EXTRA;
+        gzipState = GZIP_EXTRA_LENGTH;
+        gzipNeeded = 2;
+        gzipLength = 0;
+    } else if (gzipFlags & GZIP_FLAG_NAME) {
+        gzipFlags &= ~GZIP_FLAG_NAME;
+        gzipState = GZIP_NAME;
+    } else if (gzipFlags & GZIP_FLAG_COMMENT) {
+        gzipFlags &= ~GZIP_FLAG_COMMENT;
+        gzipState = GZIP_COMMENT;
+    } else if (gzipFlags & GZIP_FLAG_HCRC) {
+        gzipFlags &= ~GZIP_FLAG_HCRC;
+        gzipState = GZIP_HEADER_CRC;
+        gzipNeeded = 2;
+    } else {
+        gzipState = GZIP_DEFLATE;
+    }
+}
+
+bool OtaUpdater::decodeGzip(const uint8_t* data, size_t len) {
+    while (len > 0 && gzipState != GZIP_DEFLATE) {
+        uint8_t c = *data++;
+        len--;
+        switch (gzipState) {
+            case GZIP_HEADER: {
+                uint8_t pos = 10 - gzipNeeded;
+                if ((pos == 0 && c != 0x1f) || (pos == 1 && c != 0x8b) || (pos == 2 && c != 8)) {
+                    fail("Geçersiz gzip başlığı");
+                    return false;
+                }
+                if (pos == 3) gzipFlags = c;
+                if (--gzipNeeded == 0) nextGzipField();
+                break;
+            }
+            case GZIP_EXTRA_LENGTH:
+                gzipLength |= (uint16_t)c << ((2 - gzipNeeded) * 8);
+                if (--gzipNeeded == 0) {
+                    gzipNeeded = gzipLength;
+                    gzipState = GZIP_EXTRA;
+                    if (gzipNeeded == 0) nextGzipField();
+                }
+                break;
+            case GZIP_EXTRA:
+            case GZIP_HEADER_CRC:
+                if (--gzipNeeded == 0) nextGzipField();
+                break;
+            case GZIP_NAME:
+            case GZIP_COMMENT:
+                if (c == 0) nextGzipField();
+                break;
+            case GZIP_DONE:
+                // CRC32 + ISIZE; bütünlük SHA-256 ile doğrulanır
+                return true;
+        }
+    }
+    if (gzipState == GZIP_DEFLATE && len > 0) {
+        return inflate(data, len);
+    }
+    return true;
+}
+
+bool OtaUpdater::inflate(const uint8_t* data, size_t len) {
+    while (true) {
+        size_t inBytes = len;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - dictionaryPos;
+        tinfl_status status = tinfl_decompress(inflator, data, &inBytes, dictionary,
+            dictionary + dictionaryPos, &outBytes, TINFL_FLAG_HAS_MORE_INPUT);
+        data += inBytes;
+        len -= inBytes;
+
+        if (outBytes > 0) {
+            if (!emit(dictionary + dictionaryPos, outBytes)) {
+                return false;
+            }
+            dictionaryPos = (dictionaryPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+        if (status == TINFL_STATUS_DONE) {
+            gzipState = GZIP_DONE;
+            return true;
+        }
+        if (status < 0) {
+            fail("gzip verisi bozuk");
+            return false;
+        }
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && len == 0) {
+            return true;
+        }
+    }
+}
+
+// count bit toplanınca true; değer hsValue'da. Girdi biterse toplanan
+// bitler saklanır, sonraki tamponla devam edilir
+bool OtaUpdater::readBits(const uint8_t*& data, const uint8_t* end, uint8_t count) {
+    if (hsBitCount == 0) {
+        hsValue = 0;
+    }
+    while (hsBitCount < count) {
+        if (hsMask == 0) {
+            if (data == end) {
+                return false;
+            }
+            hsByte = *data++;
+            hsMask = 0x80;
+        }
+        hsValue = (hsValue << 1) | ((hsByte & hsMask) ? 1 : 0);
+        hsMask >>= 1;
+        hsBitCount++;
+    }
+    hsBitCount = 0;
+    return true;
+}
+
+// heatshrink (LZSS): 1 bitlik etiket; 1 -> 8 bit literal, 0 -> pencere
+// içi geri referans (windowBits bit uzaklık-1, lookaheadBits bit uzunluk-1)
+bool OtaUpdater::decodeHeatshrink(const uint8_t* data, size_t len) {
+    const uint8_t* end = data + len;
+    const uint16_t mask = (1 << windowBits) - 1;
+    uint8_t out[256];
+    size_t outLength = 0;
+
+    while (true) {
+        bool complete = false;
+        switch (hsState) {
+            case HS_TAG:
+                if ((complete = readBits(data, end, 1))) {
+                    hsState = hsValue ? HS_LITERAL : HS_INDEX;
+                }
+                break;
+            case HS_LITERAL:
+                if ((complete = readBits(data, end, 8))) {
+                    if (outLength == sizeof(out)) {
+                        if (!emit(out, outLength)) return false;
+                        outLength = 0;
+                    }
+                    window[windowHead] = (uint8_t)hsValue;
+                    windowHead = (windowHead + 1) & mask;
+                    out[outLength++] = (uint8_t)hsValue;
+                    hsState = HS_TAG;
+                }
+                break;
+            case HS_INDEX:
+                if ((complete = readBits(data, end, windowBits))) {
+                    hsIndex = hsValue + 1;
+                    hsState = HS_COUNT;
+                }
+                break;
+            case HS_COUNT:
+                if ((complete = readBits(data, end, lookaheadBits))) {
+                    // Uzunluk 2^lookaheadBits'e kadar çıkabilir; tampon dolunca boşaltılır
+                    for (uint16_t i = 0; i <= hsValue; i++) {
+                        if (outLength == sizeof(out)) {
+                            if (!emit(out, outLength)) return false;
+                            outLength = 0;
+                        }
+                        uint8_t c = window[(windowHead - hsIndex) & mask];
+                        window[windowHead] = c;
+                        windowHead = (windowHead + 1) & mask;
+                        out[outLength++] = c;
+                    }
+                    hsState = HS_TAG;
+                }
+                break;
+        }
+        if (!complete) {
+            break;
+        }
+    }
+    return outLength == 0 || emit(out, outLength);
+}
+
+void OtaUpdater::loop() {
+    if (restartPending && (int32_t)(millis() - restartAt) >= 0) {
+        restartPending = false;
+        Serial.println("OTA: yeniden başlatılıyor");
+        ESP.restart();
+    }
+}
@@ -0,0 +1,205 @@
+#ifndef OTA_UPDATER_H
+#define OTA_UPDATER_H
+
+#include <Arduino.h>
+#include <Update.h>
+#include <mbedtls/sha256.h>
+#include <rom/miniz.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "UploadWriter.h"
+
+// Akış halinde OTA güncellemesi.
+//
+// async_tcp callback'i gelen (sıkıştırılmış olabilen) veriyi sadece
+// havuzdaki bir tampona kopyalar. OTA task'ı tamponları sırayla açar
+// (gzip: ROM'daki tinfl, heatshrink: yerleşik çözücü), imajın SHA-256'sını
+// hesaplar ve flash'a sektör sektör yazar. Özet istemcinin verdiğiyle
+// uyuşmazsa slot boot edilebilir işaretlenmez (Update.abort). İlerleme
+// ve hız durum kanalına (STATUS_OTA) yazılır.
+
+#define OTA_BUFFER_SIZE         4096    // flash sektörü
+#define OTA_BUFFER_COUNT        4
+#define OTA_TASK_STACK          4096    // çözücü durumu heap'te
+#define OTA_TASK_PRIORITY       3
+#define OTA_TASK_CORE           0       // ses çekirdeğinden (1) uzak
+#define OTA_JOB_CAPACITY        (OTA_BUFFER_COUNT + 2)
+// /update yanıtı doğrulamayı en fazla bu kadar bekler, sonra 202 döner
+#define OTA_FINISH_TIMEOUT_MS   3000
+#define OTA_STATUS_INTERVAL_MS  250
+#define OTA_RESTART_DELAY_MS    1000    // yanıtın gitmesi için
+
+#define OTA_HEATSHRINK_WINDOW   11      // heatshrink -w varsayılanı
+#define OTA_HEATSHRINK_LOOKAHEAD 4      // heatshrink -l varsayılanı
+
+enum OtaCompression : uint8_t {
+    OTA_COMPRESSION_AUTO = 0,   // gzip sihirli sayısı varsa gzip, yoksa ham
+    OTA_COMPRESSION_NONE,
+    OTA_COMPRESSION_GZIP,
+    OTA_COMPRESSION_HEATSHRINK
+};
+
+enum OtaState : uint8_t {
+    OTA_IDLE = 0,
+    OTA_RECEIVING,
+    OTA_VERIFYING,
+    OTA_SUCCESS,
+    OTA_FAILED
+};
+
+struct OtaStats {
+    uint32_t received;          // ağdan gelen byte
+    uint32_t written;           // flash'a yazılan imaj byte'ı
+    uint32_t flashWrites;
+    uint32_t flashTimeUs;
+    uint32_t maxFlashUs;
+    uint32_t decodeTimeUs;
+    uint32_t backpressureHolds;
+    uint32_t elapsedMs;
+};
+
+class OtaUpdater {
+private:
+    enum JobType : uint8_t {
+        JOB_DATA,
+        JOB_END,
+        JOB_ABORT
+    };
+
+    struct Job {
+        uint8_t type;
+        int8_t buffer;
+        uint16_t length;
+    };
+
+    // gzip başlığı akış halinde ayrıştırılır (RFC 1952)
+    enum GzipState : uint8_t {
+        GZIP_HEADER,
+        GZIP_EXTRA_LENGTH,
+        GZIP_EXTRA,
+        GZIP_NAME,
+        GZIP_COMMENT,
+        GZIP_HEADER_CRC,
+        GZIP_DEFLATE,
+        GZIP_DONE
+    };
+
+    enum HeatshrinkState : uint8_t {
+        HS_TAG,
+        HS_LITERAL,
+        HS_INDEX,
+        HS_COUNT
+    };
+
+    // Havuz ve iş kuyruğu (UploadWriter ile aynı düzen)
+    uint8_t* pool;
+    int8_t freeList[OTA_BUFFER_COUNT];
+    uint8_t freeCount;
+    int8_t current;
+    uint16_t fill;
+    Job jobs[OTA_JOB_CAPACITY];
+    uint8_t jobHead;
+    uint8_t jobCount;
+    bool ending;
+    bool held;
+    UploadFlowControl* flow;
+
+    // Oturum
+    volatile OtaState state;
+    const char* error;
+    OtaCompression compression;
+    uint8_t expectedHash[32];
+    uint32_t total;
+    uint32_t startMs;
+    uint32_t lastStatusMs;
+    uint32_t restartAt;
+    bool restartPending;
+    OtaStats stats;
+
+    // Çözücüler (OTA task'ı)
+    mbedtls_sha256_context hash;
+    uint8_t* block;             // flash'a yazılacak sektör
+    uint16_t blockFill;
+    tinfl_decompressor* inflator;
+    uint8_t* dictionary;        // TINFL_LZ_DICT_SIZE, sarmal
+    size_t dictionaryPos;
+    uint8_t gzipState;
+    uint16_t gzipNeeded;        // bulunulan alanda kalan byte
+    uint16_t gzipLength;        // FEXTRA uzunluğu
+    uint8_t gzipFlags;
+    uint8_t* window;            // heatshrink penceresi
+    uint16_t windowHead;
+    uint8_t windowBits;
+    uint8_t lookaheadBits;
+    uint8_t hsState;
+    uint8_t hsBitCount;
+    uint16_t hsValue;
+    uint16_t hsIndex;
+    uint8_t hsByte;
+    uint8_t hsMask;
+
+    SemaphoreHandle_t mutex;
+    TaskHandle_t task;
+
+    static void taskEntry(void* arg);
+
+    void lock();
+    void unlock();
+    bool allocate();
+    void release();
+    bool pushJob(uint8_t type, int8_t buffer, uint16_t length);
+    void fail(const char* message);
+    void publishStatus(bool force);
+
+    void runData(const uint8_t* data, size_t len);
+    void runEnd();
+    void runAbort();
+
+    bool emit(const uint8_t* data, size_t len);
+    bool flushBlock();
+    void nextGzipField();
+    bool decodeGzip(const uint8_t* data, size_t len);
+    bool inflate(const uint8_t* data, size_t len);
+    bool decodeHeatshrink(const uint8_t* data, size_t len);
+    bool readBits(const uint8_t*& data, const uint8_t* end, uint8_t count);
+
+public:
+    OtaUpdater();
+
+    bool begin();
+
+    // Yeni güncelleme; sha256Hex açılmış imajın özeti (64 hex). total
+    // istek boyutudur (ilerleme için), bilinmiyorsa 0. flow'un sahipliği geçer.
+    bool start(const String& sha256Hex, OtaCompression compression, uint32_t total, UploadFlowControl* flow,
+        uint8_t windowBits = OTA_HEATSHRINK_WINDOW, uint8_t lookaheadBits = OTA_HEATSHRINK_LOOKAHEAD);
+
+    // async_tcp callback'inden; sadece kopyalar. Güncelleme başarısız
+    // olduysa false (kalan veri atılabilir)
+    bool write(const uint8_t* data, size_t len);
+
+    // Kalanı ve bitişi (doğrulama, Update.end) kuyruğa alır; beklemez.
+    // Sonuç getState()/durum kanalından izlenir.
+    void finish();
+
+    // Bağlantı koptuğunda
+    void abort();
+
+    // Kuyruktaki bir işi yürütür; iş yoksa false (host'ta elle çağrılır)
+    bool process();
+
+    // Başarılı güncellemeden sonra yeniden başlatmayı zamanlar (loop task'ı)
+    void loop();
+
+    OtaState getState() const { return state; }
+    const char* getError() const { return error; }
+    const OtaStats& getStats() const { return stats; }
+    bool isBusy() const { return state == OTA_RECEIVING || state == OTA_VERIFYING; }
+
+    static const char* stateName(OtaState state);
+    static OtaCompression compressionFromName(const String& name);
+};
+
+extern OtaUpdater otaUpdater;
+
+#endif // OTA_UPDATER_H
@@ -0,0 +1,138 @@
+#include "PlaylistStream.h"
+
+PlaylistStream::PlaylistStream(const LibraryIndex& library, size_t offset, size_t limit, bool _withMeta) :
+    index(library),
+    next(offset),
+    end(0),
+    opened(false),
+    closed(false),
+    firstItem(true),
+    withMeta(_withMeta),
+    pendingLength(0),
+    pendingPos(0) {
+    size_t total = library.size();
+    if (next > total) next = total;
+    end = (limit == 0 || limit > total - next) ? total : next + limit;
+}
+
+void PlaylistStream::loadNext() {
+    pendingLength = 0;
+    pendingPos = 0;
+
+    if (!opened) {
+        pending[pendingLength++] = '[';
+        opened = true;
+    }
+
+    if (next < end && withMeta) {
+        LibraryTrack track;
+        if (!index.getTrack(next++, track)) {
+            next = end;     // kütüphane bu arada küçüldü
+            return;
+        }
+        if (!firstItem) {
+            pending[pendingLength++] = ',';
+        }
+        firstItem = false;
+        pending[pendingLength++] = '{';
+        appendString("path", track.path);
+        pending[pendingLength++] = ',';
+        appendString("title", track.title);
+        pending[pendingLength++] = ',';
+        appendString("artist", track.artist);
+        pending[pendingLength++] = ',';
+        appendString("album", track.album);
+        pendingLength += snprintf(pending + pendingLength, sizeof(pending) - pendingLength,
+            ",\"duration\":%lu,\"format\":\"%s\"}",
+            (unsigned long)((track.durationMs + 500) / 1000), LibraryIndex::formatName(track.format));
+        return;
+    }
+
+    if (next < end) {
+        LibraryPath path;
+        if (!index.getPath(next++, path)) {
+            next = end;
+            return;
+        }
+        if (!firstItem) {
+            pending[pendingLength++] = ',';
+        }
+        firstItem = false;
+        pending[pendingLength++] = '"';
+        pendingLength += escapeJson(path.c_str() + 1, pending + pendingLength,
+            sizeof(pending) - pendingLength - 1);
+        pending[pendingLength++] = '"';
+        return;
+    }
+
+    if (!closed) {
+        pending[pendingLength++] = ']';
+        closed = true;
+    }
+}
+
+void PlaylistStream::appendString(const char* key, const char* value) {
+    pendingLength += snprintf(pending + pendingLength, sizeof(pending) - pendingLength, "\"%s\":\"", key);
+    pendingLength += escapeJson(value, pending + pendingLength, sizeof(pending) - pendingLength - 1);
+    pending[pendingLength++] = '"';
+}
+
+size_t PlaylistStream::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+
+    while (written < maxLen) {
+        if (pendingPos == pendingLength) {
+            if (closed) break;
+            loadNext();
+        }
+
+        size_t chunk = pendingLength - pendingPos;
+        if (chunk > maxLen - written) chunk = maxLen - written;
+        memcpy(buffer + written, pending + pendingPos, chunk);
+        pendingPos += chunk;
+        written += chunk;
+    }
+    return written;
+}
+
+size_t PlaylistStream::escapeJson(const char* in, char* out, size_t outSize) {
+    static const char hex[] = "0123456789abcdef";
+    size_t n = 0;
+
+    for (; *in; in++) {
+        unsigned char c = (unsigned char)*in;
+        const char* esc = nullptr;
+        switch (c) {
+            case '"': esc = "\\\""; break;
+            case '\\': esc = "\\\\"; break;
+            case '\n': esc = "\\n"; break;
+            case '\r': esc = "\\r"; break;
+            case '\t': esc = "\\t"; break;
+        }
+
+        if (esc) {
+            if (n + 2 > outSize) break;
+            out[n++] = esc[0];
+            out[n++] = esc[1];
+        } else if (c < 0x20) {
+            if (n + 6 > outSize) break;
+            out[n++] = '\\';
+            out[n++] = 'u';
+            out[n++] = '0';
+            out[n++] = '0';
+            out[n++] = hex[c >> 4];
+            out[n++] = hex[c & 0x0F];
+        } else {
+            if (n + 1 > outSize) break;
+            out[n++] = (char)c;
+        }
+    }
+    return n;
+}
+
+String PlaylistStream::makeEtag(uint32_t cardId, uint32_t generation, size_t offset, size_t limit, bool withMeta) {
+    char etag[56];
+    snprintf(etag, sizeof(etag), "\"pl-%08lx-%lu-%u-%u%s\"", (unsigned long)cardId,
+        (unsigned long)generation, (unsigned)offset, (unsigned)limit, withMeta ? "-m" : "");
+    return String(etag);
+}
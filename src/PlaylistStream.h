@@ -0,0 +1,54 @@
+#ifndef PLAYLIST_STREAM_H
+#define PLAYLIST_STREAM_H
+
+#include <Arduino.h>
+#include "LibraryIndex.h"
+
+// /api/playlist için akış halinde JSON üretici.
+//
+// Kütüphanenin [offset, offset+limit) aralığını ["a.mp3","b.wav",...]
+// biçiminde, chunked response'un verdiği tampona parça parça yazar; tüm
+// dokümanı bellekte kurmaz. Aynı anda sadece bir kaydın kaçışlanmış hali
+// tutulur.
+//
+// withMeta ile her kayıt {"path","title","artist","album","duration","format"}
+// nesnesidir (süre saniye); etiketler indeksten gelir, dosya açılmaz.
+
+#define PLAYLIST_DEFAULT_LIMIT  0       // 0: sınırsız (eski istemciler)
+#define PLAYLIST_MAX_LIMIT      500
+
+class PlaylistStream {
+private:
+    const LibraryIndex& index;
+    size_t next;
+    size_t end;
+    bool opened;
+    bool closed;
+    bool firstItem;
+    bool withMeta;
+
+    // Kaçışlanmış kayıt: en kötü durumda her byte \u00XX (6 byte) + ayraçlar
+    // ve alan adları
+    char pending[(LIBRARY_MAX_PATH + 3 * TRACK_TAG_MAX) * 6 + 96];
+    size_t pendingLength;
+    size_t pendingPos;
+
+    void loadNext();
+    void appendString(const char* key, const char* value);
+
+public:
+    PlaylistStream(const LibraryIndex& library, size_t offset, size_t limit, bool withMeta = false);
+
+    // Tampona en fazla maxLen byte yazar; 0 dönünce akış bitmiştir
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+    size_t getTotal() const { return index.size(); }
+
+    static size_t escapeJson(const char* in, char* out, size_t outSize);
+
+    // Kart kimliği + kütüphane nesli + sayfa; içerik değişmedikçe aynı
+    // kalır. Nesil kart başınadır, kart değişince kimlik ayırt eder.
+    static String makeEtag(uint32_t cardId, uint32_t generation, size_t offset, size_t limit, bool withMeta = false);
+};
+
+#endif // PLAYLIST_STREAM_H
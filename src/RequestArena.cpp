@@ -0,0 +1,51 @@
+#include "RequestArena.h"
+
+alignas(REQUEST_ARENA_ALIGN) static uint8_t requestArenaBuffer[REQUEST_ARENA_SIZE];
+RequestArena requestArena(requestArenaBuffer, sizeof(requestArenaBuffer));
+
+RequestArena::RequestArena(uint8_t* buffer, size_t size) :
+    base(buffer),
+    capacity(size),
+    used(0),
+    lastOffset(SIZE_MAX),
+    peak(0),
+    failures(0) {
+}
+
+void* RequestArena::allocate(size_t size) {
+    size_t offset = (used + REQUEST_ARENA_ALIGN - 1) & ~(size_t)(REQUEST_ARENA_ALIGN - 1);
+    if (size > capacity || offset > capacity - size) {
+        failures++;
+        return nullptr;
+    }
+    used = offset + size;
+    lastOffset = offset;
+    if (used > peak) peak = used;
+    return base + offset;
+}
+
+void* RequestArena::reallocate(void* ptr, size_t size) {
+    if (!ptr) return allocate(size);
+
+    size_t offset = (uint8_t*)ptr - base;
+    if (offset == lastOffset) {
+        if (size > capacity - offset) {
+            failures++;
+            return nullptr;
+        }
+        used = offset + size;
+        if (used > peak) peak = used;
+        return ptr;
+    }
+    // Eski boyut bilinmez; ArduinoJson araya blok girmiş dokümanı sadece
+    // küçültür (shrinkToFit), yer yerinde kalır
+    return ptr;
+}
+
+void RequestArena::rewind(size_t mark) {
+    if (mark >= used) return;
+    used = mark;
+    if (lastOffset != SIZE_MAX && lastOffset >= mark) {
+        lastOffset = SIZE_MAX;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// HTTP/WebSocket handler'larının geçici belleği. Tampon açılışta bir kez
+// (statik) ayrılır; handler içindeki JSON dokümanları ve geçici metinler
+// buradan sırayla kesilir, handler dönünce Scope hepsini tek seferde geri
+// alır. Heap'e istek başına farklı boyutlu blok ayrılıp bırakılmadığından
+// haftalar süren çalışmada en büyük boş blok küçülmez.
+//
+// Sadece async_tcp task'ından kullanılır (tüm route ve WebSocket
+// callback'leri orada çalışır); kilit yoktur.
+
+#define REQUEST_ARENA_SIZE      8192
+#define REQUEST_ARENA_ALIGN     8
+
+class RequestArena {
+private:
+    uint8_t* base;
+    size_t capacity;
+    size_t used;
+    size_t lastOffset;          // son ayrılan blok; yerinde büyüyebilir
+    size_t peak;
+    uint32_t failures;
+
+public:
+    RequestArena(uint8_t* buffer, size_t size);
+
+    // Yer yoksa nullptr (ArduinoJson bunu taşma olarak işler)
+    void* allocate(size_t size);
+
+    // Son blok yerinde büyür/küçülür; diğerleri sadece küçültülebilir
+    void* reallocate(void* ptr, size_t size);
+
+    size_t mark() const { return used; }
+    void rewind(size_t mark);
+
+    size_t getUsed() const { return used; }
+    size_t getPeak() const { return peak; }
+    size_t getCapacity() const { return capacity; }
+    uint32_t getFailures() const { return failures; }
+
+    // Kapsam boyunca ayrılanları sonunda geri alır; iç içe kullanılabilir
+    class Scope {
+    private:
+        RequestArena& arena;
+        size_t start;
+
+    public:
+        explicit Scope(RequestArena& _arena) :
+            arena(_arena),
+            start(_arena.mark()) {}
+        ~Scope() { arena.rewind(start); }
+    };
+};
+
+extern RequestArena requestArena;
+
+// ArduinoJson'ın ayırıcısı: doküman arenadan kesilir, serbest bırakma
+// Scope'a kalır. Doküman, onu kuran handler'ın Scope'undan uzun yaşamamalı.
+struct ArenaJsonAllocator {
+    RequestArena* arena;
+
+    ArenaJsonAllocator() : arena(&requestArena) {}
+    explicit ArenaJsonAllocator(RequestArena& _arena) : arena(&_arena) {}
+
+    void* allocate(size_t size) { return arena->allocate(size); }
+    void deallocate(void*) {}
+    void* reallocate(void* ptr, size_t size) { return arena->reallocate(ptr, size); }
+};
+
+typedef BasicJsonDocument<ArenaJsonAllocator> ArenaJsonDocument;
+
+#endif // REQUEST_ARENA_H
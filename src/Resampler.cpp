@@ -0,0 +1,188 @@
+#include "Resampler.h"
+#include <math.h>
+#include <string.h>
+
+static const ResamplerProfile profiles[RESAMPLER_QUALITY_COUNT] = {
+    { "fast",     8,  32,  0.80f, 5.0f, false },
+    { "balanced", 16, 64,  0.80f, 6.0f, true },
+    { "high",     32, 128, 0.90f, 9.0f, true },
+};
+
+static_assert(RESAMPLER_MAX_TAPS % 2 == 0, "tap sayısı çift olmalı");
+
+// Birinci tür sıfırıncı derece değiştirilmiş Bessel (Kaiser penceresi için)
+static float besselI0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float q = x * x / 4.0f;
+    for (int k = 1; k < 40; k++) {
+        term *= q / (float)(k * k);
+        sum += term;
+        if (term < sum * 1e-8f) break;
+    }
+    return sum;
+}
+
+Resampler::Resampler() :
+    historyPos(0),
+    inputRate(0),
+    outputRate(0),
+    quality(RESAMPLER_BALANCED),
+    profile(&profiles[RESAMPLER_BALANCED]),
+    bypass(true),
+    step(1ULL << 32),
+    phase(0),
+    pending(1) {
+    memset(history, 0, sizeof(history));
+}
+
+const ResamplerProfile& Resampler::getProfile(ResamplerQuality quality) {
+    return profiles[quality < RESAMPLER_QUALITY_COUNT ? quality : RESAMPLER_BALANCED];
+}
+
+uint32_t Resampler::macsPerSample(ResamplerQuality quality) {
+    const ResamplerProfile& p = getProfile(quality);
+    return p.interpolate ? 2 * p.taps : p.taps;
+}
+
+ResamplerQuality Resampler::qualityForBudget(uint32_t macsPerSecond, uint32_t outputRate) {
+    for (int q = RESAMPLER_QUALITY_COUNT - 1; q > RESAMPLER_FAST; q--) {
+        if ((uint64_t)macsPerSample((ResamplerQuality)q) * outputRate <= macsPerSecond) {
+            return (ResamplerQuality)q;
+        }
+    }
+    return RESAMPLER_FAST;
+}
+
+void Resampler::configure(uint32_t _inputRate, uint32_t _outputRate, ResamplerQuality _quality) {
+    if (_inputRate == 0 || _outputRate == 0) return;
+    if (_quality >= RESAMPLER_QUALITY_COUNT) _quality = RESAMPLER_BALANCED;
+    if (_inputRate == inputRate && _outputRate == outputRate && _quality == quality) return;
+
+    if (_quality != quality) {
+        // Tap sayısı değişince eski pencere anlamını yitirir
+        memset(history, 0, sizeof(history));
+        historyPos = 0;
+    }
+    inputRate = _inputRate;
+    outputRate = _outputRate;
+    quality = _quality;
+    profile = &profiles[quality];
+    bypass = inputRate == outputRate;
+    step = ((uint64_t)inputRate << 32) / outputRate;
+    if (!bypass) {
+        design();
+    }
+}
+
+void Resampler::reset() {
+    memset(history, 0, sizeof(history));
+    historyPos = 0;
+    phase = 0;
+    pending = 1;
+}
+
+void Resampler::design() {
+    const size_t taps = profile->taps;
+    const size_t phases = profile->phases;
+    const float half = taps / 2.0f;
+    const float ratio = outputRate < inputRate ? (float)outputRate / inputRate : 1.0f;
+    const float cutoff = 0.5f * ratio * profile->rolloff;  // giriş örneği başına devir
+    const float i0Beta = besselI0(profile->beta);
+    float row[RESAMPLER_MAX_TAPS];
+
+    for (size_t p = 0; p <= phases; p++) {
+        // Çıkış anı, pencerenin (half - 1) ve half. örnekleri arasında f kadar ileride
+        float f = (float)p / phases;
+        float sum = 0.0f;
+        for (size_t k = 0; k < taps; k++) {
+            float x = (float)k - (half - 1.0f) - f;
+            float t = x / half;
+            float window = t * t < 1.0f ? besselI0(profile->beta * sqrtf(1.0f - t * t)) / i0Beta : 0.0f;
+            float sinc = fabsf(x) < 1e-6f ? 2.0f * cutoff : sinf(2.0f * (float)M_PI * cutoff * x) / ((float)M_PI * x);
+            row[k] = sinc * window;
+            sum += row[k];
+        }
+
+        // Q15'e yuvarlama artığı merkez tap'e; satır toplamı tam 32768
+        int16_t* out = coeffs + p * taps;
+        int32_t total = 0;
+        for (size_t k = 0; k < taps; k++) {
+            int32_t q = (int32_t)lroundf(row[k] / sum * 32768.0f);
+            if (q > 32767) q = 32767;
+            if (q < -32768) q = -32768;
+            out[k] = (int16_t)q;
+            total += q;
+        }
+        size_t center = (size_t)(half - 1.0f) + (f >= 0.5f ? 1 : 0);
+        int32_t adjusted = out[center] + (32768 - total);
+        out[center] = (int16_t)(adjusted > 32767 ? 32767 : adjusted);
+    }
+}
+
+template <bool Interpolate>
+size_t Resampler::run(const int16_t* in, size_t frames, int16_t* out, size_t maxOut, size_t& consumed) {
+    const size_t taps = profile->taps;
+    const uint32_t phases = profile->phases;
+    size_t used = 0;
+    size_t produced = 0;
+
+    while (produced < maxOut) {
+        while (pending > 0) {
+            if (used == frames) {
+                consumed = used;
+                return produced;
+            }
+            push((int16_t)(((int32_t)in[2 * used] + in[2 * used + 1]) >> 1));
+            used++;
+            pending--;
+        }
+
+        int32_t acc;
+        uint64_t position = (uint64_t)phase * phases;
+        if (Interpolate) {
+            const int16_t* row = coeffs + (size_t)(position >> 32) * taps;
+            int32_t a = dot(row);
+            int32_t b = dot(row + taps);
+            int32_t weight = (int32_t)((position >> 16) & 0xFFFF);
+            acc = a + (int32_t)((((int64_t)b - a) * weight) >> 16);
+        } else {
+            size_t p = (size_t)((position + (1ULL << 31)) >> 32);
+            acc = dot(coeffs + p * taps);
+        }
+
+        int32_t y = (acc + (1 << 14)) >> 15;
+        if (y > 32767) y = 32767;
+        if (y < -32768) y = -32768;
+        out[2 * produced] = (int16_t)y;
+        out[2 * produced + 1] = (int16_t)y;
+        produced++;
+
+        uint64_t next = (uint64_t)phase + step;
+        phase = (uint32_t)next;
+        pending = (uint32_t)(next >> 32);
+    }
+    consumed = used;
+    return produced;
+}
+
+size_t Resampler::process(const int16_t* in, size_t frames, int16_t* out, size_t maxOut, size_t& consumed) {
+    if (bypass) {
+        // Aynı hız: örnekler olduğu gibi geçer, geçmiş yine güncellenir ki
+        // sonraki parçada dönüştürmeye geçişte pencere dolu olsun
+        size_t n = frames < maxOut ? frames : maxOut;
+        for (size_t i = 0; i < n; i++) {
+            out[2 * i] = in[2 * i];
+            out[2 * i + 1] = in[2 * i + 1];
+            push((int16_t)(((int32_t)in[2 * i] + in[2 * i + 1]) >> 1));
+        }
+        phase = 0;
+        pending = 1;
+        consumed = n;
+        return n;
+    }
+    if (profile->interpolate) {
+        return run<true>(in, frames, out, maxOut, consumed);
+    }
+    return run<false>(in, frames, out, maxOut, consumed);
+}
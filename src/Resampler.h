@@ -0,0 +1,114 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Decoder hızından (8-48 kHz) DAC'ın sabit çıkış hızına akan, sabit noktalı
+// polyphase örnekleme hızı dönüştürücü.
+//
+// Filtre Kaiser pencereli sinc'tir: kesim frekansı giriş ve çıkışın küçük
+// Nyquist'ine göre ayarlanır (aşağı örneklemede katlanmayı da bastırır),
+// P faz x T tap'lik Q15 tabloda tutulur. Her çıkış örneği için giriş
+// üzerindeki kesirli konum Q32 fazdır; kalite profiline göre en yakın faz
+// satırı kullanılır ya da komşu iki satırın sonucu doğrusal karıştırılır.
+// Her faz satırının toplamı tam 32768'dir (DC kazancı 1).
+//
+// DAC mono olduğundan kanallar girişte toplanır ((L+R)/2) ve filtre tek
+// kanal çalışır; çıkış SampleKernel'e verilmek üzere L=R interleaved'dır.
+// Tablo configure() ile hız değişince bir kez hesaplanır (float); örnek
+// başına yol sadece tamsayıdır.
+
+enum ResamplerQuality {
+    RESAMPLER_FAST = 0,     // 8 tap, en yakın faz
+    RESAMPLER_BALANCED,     // 16 tap, faz arası doğrusal
+    RESAMPLER_HIGH,         // 32 tap, faz arası doğrusal
+    RESAMPLER_QUALITY_COUNT
+};
+
+#define RESAMPLER_MAX_TAPS      32
+#define RESAMPLER_MAX_PHASES    128
+
+struct ResamplerProfile {
+    const char* name;
+    uint8_t taps;
+    uint16_t phases;
+    float rolloff;          // kesim / küçük Nyquist
+    float beta;             // Kaiser
+    bool interpolate;
+};
+
+class Resampler {
+private:
+    // Faz p'nin katsayıları coeffs[p * taps ..]; P+1. satır bir örnek kaymış
+    // sıfırıncı fazdır, doğrusal karıştırma sınırda ona bakar
+    int16_t coeffs[(RESAMPLER_MAX_PHASES + 1) * RESAMPLER_MAX_TAPS];
+    // Son T giriş örneği iki kez yazılır; pencere her zaman ardışık okunur
+    int16_t history[2 * RESAMPLER_MAX_TAPS];
+    size_t historyPos;
+
+    uint32_t inputRate;
+    uint32_t outputRate;
+    ResamplerQuality quality;
+    const ResamplerProfile* profile;
+    bool bypass;
+
+    uint64_t step;          // çıkış örneği başına giriş, Q32.32
+    uint32_t phase;         // sıradaki çıkışın kesirli konumu, Q32
+    uint32_t pending;       // sıradaki çıkıştan önce alınacak giriş örneği
+
+    void design();
+
+    inline void push(int16_t sample) {
+        size_t taps = profile->taps;
+        history[historyPos] = sample;
+        history[historyPos + taps] = sample;
+        historyPos = historyPos + 1 == taps ? 0 : historyPos + 1;
+    }
+
+    inline int32_t dot(const int16_t* row) const {
+        const int16_t* h = history + historyPos;
+        int32_t acc = 0;
+        // Satırın mutlak toplamı < 2 (pencereli sinc); int32 taşmaz
+        for (size_t k = 0; k < profile->taps; k++) {
+            acc += (int32_t)h[k] * row[k];
+        }
+        return acc;
+    }
+
+    template <bool Interpolate>
+    size_t run(const int16_t* in, size_t frames, int16_t* out, size_t maxOut, size_t& consumed);
+
+public:
+    Resampler();
+
+    static const ResamplerProfile& getProfile(ResamplerQuality quality);
+
+    // Çıkış örneği başına çarp-topla sayısı
+    static uint32_t macsPerSample(ResamplerQuality quality);
+
+    // Saniyedeki çarp-topla bütçesine sığan en iyi kalite
+    static ResamplerQuality qualityForBudget(uint32_t macsPerSecond, uint32_t outputRate);
+
+    // Hızlar veya kalite değiştiyse tabloyu yeniden hesaplar. Geçmiş korunur;
+    // parça geçişinde hız değişse de ses kesilmez.
+    void configure(uint32_t inputRate, uint32_t outputRate, ResamplerQuality quality);
+
+    void reset();
+
+    // interleaved stereo girişten en fazla maxOut çıkış frame'i üretir;
+    // consumed alınan giriş frame'i. Çıkış yeri bitince giriş alınmaz.
+    size_t process(const int16_t* in, size_t frames, int16_t* out, size_t maxOut, size_t& consumed);
+
+    // Bir giriş frame'inin üretebileceği en fazla çıkış (yukarı örneklemede > 1)
+    size_t maxOutputPerInput() const {
+        return (size_t)((outputRate + inputRate - 1) / inputRate) + 1;
+    }
+
+    bool isBypass() const { return bypass; }
+    uint32_t getInputRate() const { return inputRate; }
+    uint32_t getOutputRate() const { return outputRate; }
+    ResamplerQuality getQuality() const { return quality; }
+};
+
+#endif // RESAMPLER_H
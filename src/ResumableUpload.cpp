@@ -0,0 +1,630 @@
+#include "ResumableUpload.h"
+#include "LibraryIndex.h"
+#include "PlaylistStream.h"
+#include <esp_system.h>
+
+ResumableUploads resumableUploads;
+
+ResumableUploads::ResumableUploads() :
+    useCounter(0) {
+    for (uint8_t i = 0; i < UPLOAD_SESSION_SLOTS; i++) {
+        sessions[i].active = false;
+        sessions[i].chunkKey = nullptr;
+        sessions[i].verifying = false;
+        mbedtls_sha256_init(&sessions[i].hash);
+        mbedtls_sha256_init(&sessions[i].chunkHash);
+    }
+}
+
+bool ResumableUploads::begin() {
+    if (!SD.exists(UPLOAD_SESSION_DIR) && !SD.mkdir(UPLOAD_SESSION_DIR)) {
+        Serial.println("❌ Upload session directory could not be created");
+        return false;
+    }
+    return true;
+}
+
+String ResumableUploads::partPath(uint32_t id) {
+    char path[32];
+    snprintf(path, sizeof(path), UPLOAD_SESSION_DIR "/%08x.part", (unsigned)id);
+    return String(path);
+}
+
+String ResumableUploads::metaPath(uint32_t id) {
+    char path[32];
+    snprintf(path, sizeof(path), UPLOAD_SESSION_DIR "/%08x.meta", (unsigned)id);
+    return String(path);
+}
+
+bool ResumableUploads::parseId(const String& text, uint32_t& id) {
+    if (text.length() != 8) {
+        return false;
+    }
+    char* end = nullptr;
+    id = strtoul(text.c_str(), &end, 16);
+    return end && *end == '\0' && id != 0;
+}
+
+ResumableUploads::Session* ResumableUploads::find(uint32_t id) {
+    for (uint8_t i = 0; i < UPLOAD_SESSION_SLOTS; i++) {
+        if (sessions[i].active && sessions[i].id == id) {
+            sessions[i].lastUsed = ++useCounter;
+            return &sessions[i];
+        }
+    }
+    return nullptr;
+}
+
+ResumableUploads::Session* ResumableUploads::findByKey(const void* key) {
+    for (uint8_t i = 0; i < UPLOAD_SESSION_SLOTS; i++) {
+        if (sessions[i].active && sessions[i].chunkKey == key) {
+            return &sessions[i];
+        }
+    }
+    return nullptr;
+}
+
+// Boş slot, yoksa parça yazmayan en eski oturum (durumu SD'de, tekrar yüklenebilir)
+ResumableUploads::Session* ResumableUploads::allocate() {
+    Session* victim = nullptr;
+    for (uint8_t i = 0; i < UPLOAD_SESSION_SLOTS; i++) {
+        Session& session = sessions[i];
+        if (!session.active) {
+            return &session;
+        }
+        if (!session.chunkKey && (!victim || session.lastUsed < victim->lastUsed)) {
+            victim = &session;
+        }
+    }
+    if (victim) {
+        resetSession(*victim);
+    }
+    return victim;
+}
+
+void ResumableUploads::resetSession(Session& session) {
+    if (session.verifying) {
+        // Writer okumayı yarıda bırakıp kendi oturumunu serbest bırakır
+        uploadWriter.abort(&session);
+        session.verifying = false;
+    }
+    mbedtls_sha256_free(&session.hash);
+    mbedtls_sha256_free(&session.chunkHash);
+    session.active = false;
+    session.chunkKey = nullptr;
+    session.name = String();
+    session.bitmap.clear();
+    session.bitmap.shrink_to_fit();
+}
+
+bool ResumableUploads::readMeta(uint32_t id, ResumableMetaHeader& header, String& name,
+    std::vector<uint8_t>* bitmap, mbedtls_sha256_context* hash) {
+    File file = SD.open(metaPath(id), FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == UPLOAD_SESSION_MAGIC &&
+              header.version == UPLOAD_SESSION_VERSION &&
+              header.id == id &&
+              header.nameLength > 0 && header.nameLength <= LIBRARY_MAX_PATH &&
+              header.size > 0 && header.size <= UPLOAD_SESSION_MAX_SIZE &&
+              header.chunkSize > 0 &&
+              header.hashedBytes <= header.size &&
+              header.hashStateSize == sizeof(mbedtls_sha256_context);
+    if (ok) {
+        char buffer[LIBRARY_MAX_PATH + 1];
+        ok = file.read((uint8_t*)buffer, header.nameLength) == header.nameLength;
+        buffer[ok ? header.nameLength : 0] = '\0';
+        name = buffer;
+    }
+    if (ok && bitmap) {
+        uint32_t chunkCount = (header.size + header.chunkSize - 1) / header.chunkSize;
+        bitmap->assign((chunkCount + 7) / 8, 0);
+        ok = file.read(bitmap->data(), bitmap->size()) == bitmap->size();
+    }
+    if (ok && hash) {
+        // saveMeta'nın yazdığı yazılım durumu; aynı firmware'de geçerli
+        mbedtls_sha256_init(hash);
+        ok = file.read((uint8_t*)hash, sizeof(*hash)) == sizeof(*hash);
+    }
+    file.close();
+    return ok;
+}
+
+bool ResumableUploads::saveMeta(const Session& session) {
+    ResumableMetaHeader header;
+    header.magic = UPLOAD_SESSION_MAGIC;
+    header.version = UPLOAD_SESSION_VERSION;
+    header.nameLength = session.name.length();
+    header.id = session.id;
+    header.size = session.size;
+    header.chunkSize = session.chunkSize;
+    header.hashedBytes = session.hashedBytes;
+    header.hashStateSize = sizeof(mbedtls_sha256_context);
+
+    // clone donanım SHA'sının ara durumunu yazılım bağlamına çıkarır;
+    // bayt bayt saklanabilir, yeniden açılışta özet kaldığı yerden sürer
+    mbedtls_sha256_context hash;
+    mbedtls_sha256_init(&hash);
+    mbedtls_sha256_clone(&hash, &session.hash);
+
+    // Tek küçük dosya; yarım yazılırsa okumada reddedilir ve oturum kaybolur,
+    // .part dosyası pruneStored ile temizlenir
+    File file = SD.open(metaPath(session.id), FILE_WRITE);
+    bool ok = file &&
+              file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)session.name.c_str(), header.nameLength) == header.nameLength &&
+              file.write(session.bitmap.data(), session.bitmap.size()) == session.bitmap.size() &&
+              file.write((const uint8_t*)&hash, sizeof(hash)) == sizeof(hash);
+    if (file) {
+        file.close();
+    }
+    mbedtls_sha256_free(&hash);
+    return ok;
+}
+
+ResumableUploads::Session* ResumableUploads::load(uint32_t id) {
+    Session* session = find(id);
+    if (session) {
+        return session;
+    }
+
+    ResumableMetaHeader header;
+    String name;
+    std::vector<uint8_t> bitmap;
+    mbedtls_sha256_context hash;
+    if (!readMeta(id, header, name, &bitmap, &hash)) {
+        return nullptr;
+    }
+    session = allocate();
+    if (!session) {
+        return nullptr;
+    }
+
+    session->active = true;
+    session->id = id;
+    session->name = name;
+    session->size = header.size;
+    session->chunkSize = header.chunkSize;
+    session->chunkCount = (header.size + header.chunkSize - 1) / header.chunkSize;
+    session->bitmap.swap(bitmap);
+    session->receivedCount = 0;
+    for (uint32_t i = 0; i < session->chunkCount; i++) {
+        if (hasChunk(*session, i)) session->receivedCount++;
+    }
+    session->lastUsed = ++useCounter;
+
+    // Baştan kesintisiz özetlenmiş kısım meta'dan; finalize sadece kalanı okur
+    mbedtls_sha256_init(&session->hash);
+    mbedtls_sha256_clone(&session->hash, &hash);
+    mbedtls_sha256_free(&hash);
+    session->hashedBytes = header.hashedBytes;
+    session->verifying = false;
+    session->chunkKey = nullptr;
+    session->chunkIndex = -1;
+    session->chunkHashing = false;
+    return session;
+}
+
+void ResumableUploads::removeFiles(uint32_t id) {
+    SD.remove(partPath(id));
+    SD.remove(metaPath(id));
+}
+
+static const char* baseName(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// SD'de en fazla UPLOAD_SESSION_MAX_STORED yarım upload kalır; fazlası
+// (en eski değişiklik tarihli) silinir. Meta'sı olmayan .part'lar da gider.
+void ResumableUploads::pruneStored() {
+    File dir = SD.open(UPLOAD_SESSION_DIR);
+    if (!dir || !dir.isDirectory()) {
+        return;
+    }
+
+    std::vector<uint32_t> ids;
+    std::vector<time_t> times;
+    std::vector<uint32_t> orphans;
+    File file = dir.openNextFile();
+    while (file) {
+        const char* name = baseName(file.name());
+        uint32_t id;
+        if (strlen(name) == 13 && parseId(String(name).substring(0, 8), id)) {
+            if (strcmp(name + 8, ".meta") == 0) {
+                ids.push_back(id);
+                times.push_back(file.getLastWrite());
+            } else if (strcmp(name + 8, ".part") == 0 && !SD.exists(metaPath(id))) {
+                orphans.push_back(id);
+            }
+        }
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+
+    for (uint32_t id : orphans) {
+        SD.remove(partPath(id));
+    }
+    while (ids.size() >= UPLOAD_SESSION_MAX_STORED) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < ids.size(); i++) {
+            if (times[i] < times[oldest]) oldest = i;
+        }
+        Session* session = find(ids[oldest]);
+        if (session && (session->chunkKey || session->verifying)) {
+            // Parça yazılıyor ya da özet doğrulanıyor; bu oturum kalır
+        } else {
+            Serial.printf("🗑️ Dropping stale upload session %08x\n", (unsigned)ids[oldest]);
+            if (session) resetSession(*session);
+            removeFiles(ids[oldest]);
+        }
+        ids.erase(ids.begin() + oldest);
+        times.erase(times.begin() + oldest);
+    }
+}
+
+ResumableStatus ResumableUploads::create(const String& name, uint32_t size, String& id) {
+    if (name.length() == 0 || name.length() > LIBRARY_MAX_PATH ||
+        size == 0 || size > UPLOAD_SESSION_MAX_SIZE) {
+        return RESUMABLE_BAD_REQUEST;
+    }
+
+    // Aynı dosya için yarım kalmış oturum: bellekte, sonra SD'de
+    for (uint8_t i = 0; i < UPLOAD_SESSION_SLOTS; i++) {
+        Session& session = sessions[i];
+        if (session.active && session.size == size && session.name == name) {
+            session.lastUsed = ++useCounter;
+            char text[9];
+            snprintf(text, sizeof(text), "%08x", (unsigned)session.id);
+            id = text;
+            return RESUMABLE_OK;
+        }
+    }
+    File dir = SD.open(UPLOAD_SESSION_DIR);
+    if (dir && dir.isDirectory()) {
+        File file = dir.openNextFile();
+        while (file) {
+            const char* entry = baseName(file.name());
+            uint32_t storedId;
+            if (strlen(entry) == 13 && strcmp(entry + 8, ".meta") == 0 &&
+                parseId(String(entry).substring(0, 8), storedId)) {
+                ResumableMetaHeader header;
+                String storedName;
+                if (readMeta(storedId, header, storedName, nullptr) &&
+                    header.size == size && storedName == name && load(storedId)) {
+                    file.close();
+                    dir.close();
+                    id = String(entry).substring(0, 8);
+                    return RESUMABLE_OK;
+                }
+            }
+            file.close();
+            file = dir.openNextFile();
+        }
+        dir.close();
+    }
+
+    pruneStored();
+    Session* session = allocate();
+    if (!session) {
+        return RESUMABLE_BUSY;
+    }
+
+    uint32_t newId;
+    do {
+        newId = esp_random();
+    } while (newId == 0 || SD.exists(metaPath(newId)));
+
+    session->active = true;
+    session->id = newId;
+    session->name = name;
+    session->size = size;
+    session->chunkSize = UPLOAD_CHUNK_SIZE;
+    session->chunkCount = (size + UPLOAD_CHUNK_SIZE - 1) / UPLOAD_CHUNK_SIZE;
+    session->bitmap.assign((session->chunkCount + 7) / 8, 0);
+    session->receivedCount = 0;
+    session->lastUsed = ++useCounter;
+    mbedtls_sha256_init(&session->hash);
+    mbedtls_sha256_starts_ret(&session->hash, 0);
+    session->hashedBytes = 0;
+    session->verifying = false;
+    session->chunkKey = nullptr;
+    session->chunkIndex = -1;
+    session->chunkHashing = false;
+
+    File part = SD.open(partPath(newId), FILE_WRITE);
+    bool ok = (bool)part;
+    part.close();
+    if (!ok || !saveMeta(*session)) {
+        removeFiles(newId);
+        resetSession(*session);
+        return RESUMABLE_IO_ERROR;
+    }
+
+    char text[9];
+    snprintf(text, sizeof(text), "%08x", (unsigned)newId);
+    id = text;
+    Serial.printf("📝 Upload session %s: %s, %u bytes, %u chunks\n", text, name.c_str(),
+        (unsigned)size, (unsigned)session->chunkCount);
+    return RESUMABLE_OK;
+}
+
+ResumableStatus ResumableUploads::writeStatus(const String& idText, Print& out) {
+    uint32_t id;
+    Session* session = parseId(idText, id) ? load(id) : nullptr;
+    if (!session) {
+        return RESUMABLE_NOT_FOUND;
+    }
+
+    char name[LIBRARY_MAX_PATH * 6 + 1];
+    name[PlaylistStream::escapeJson(session->name.c_str(), name, sizeof(name) - 1)] = '\0';
+    out.printf("{\"id\":\"%08x\",\"name\":\"%s\",\"size\":%u,\"chunkSize\":%u,\"chunks\":%u,"
+        "\"receivedChunks\":%u,\"received\":[", (unsigned)session->id, name, (unsigned)session->size,
+        (unsigned)session->chunkSize, (unsigned)session->chunkCount, (unsigned)session->receivedCount);
+
+    // Alınmış parçalar bayt aralıkları olarak: [başlangıç, bitiş)
+    uint32_t ranges = 0;
+    uint32_t i = 0;
+    bool truncated = false;
+    while (i < session->chunkCount) {
+        if (!hasChunk(*session, i)) {
+            i++;
+            continue;
+        }
+        uint32_t start = i;
+        while (i < session->chunkCount && hasChunk(*session, i)) i++;
+        if (ranges == UPLOAD_SESSION_MAX_RANGES) {
+            truncated = true;
+            break;
+        }
+        uint32_t end = min((uint32_t)((uint64_t)i * session->chunkSize), session->size);
+        out.printf("%s[%u,%u]", ranges ? "," : "", (unsigned)(start * session->chunkSize), (unsigned)end);
+        ranges++;
+    }
+    out.printf("],\"truncated\":%s,\"complete\":%s}", truncated ? "true" : "false",
+        session->receivedCount == session->chunkCount ? "true" : "false");
+    return RESUMABLE_OK;
+}
+
+ResumableStatus ResumableUploads::beginChunk(const String& idText, uint32_t index, size_t length,
+    const void* key, UploadFlowControl* flow) {
+    uint32_t id;
+    Session* session = parseId(idText, id) ? load(id) : nullptr;
+    ResumableStatus status = RESUMABLE_OK;
+    uint32_t offset = 0;
+    uint32_t expected = 0;
+
+    if (!session) {
+        status = RESUMABLE_NOT_FOUND;
+    } else if (session->chunkKey) {
+        status = RESUMABLE_BUSY;
+    } else if (index >= session->chunkCount) {
+        status = RESUMABLE_BAD_REQUEST;
+    } else {
+        offset = index * session->chunkSize;
+        expected = min(session->chunkSize, session->size - offset);
+        if (length != expected) {
+            status = RESUMABLE_BAD_REQUEST;
+        } else if (hasChunk(*session, index)) {
+            // Yanıtı kaybolan parça tekrar geldi
+            status = RESUMABLE_DUPLICATE;
+        }
+    }
+    if (status != RESUMABLE_OK) {
+        delete flow;
+        return status;
+    }
+
+    if (!uploadWriter.openRange(key, partPath(session->id), offset, expected, session->size, flow)) {
+        return RESUMABLE_BUSY;
+    }
+    session->chunkKey = key;
+    session->chunkIndex = index;
+    session->chunkLength = expected;
+    session->chunkHashing = offset == session->hashedBytes;
+    if (session->chunkHashing) {
+        mbedtls_sha256_init(&session->chunkHash);
+        mbedtls_sha256_clone(&session->chunkHash, &session->hash);
+    }
+    return RESUMABLE_OK;
+}
+
+ResumableStatus ResumableUploads::writeChunk(const void* key, const uint8_t* data, size_t len) {
+    Session* session = findByKey(key);
+    if (!session) {
+        return RESUMABLE_NOT_FOUND;
+    }
+    if (session->chunkHashing) {
+        mbedtls_sha256_update_ret(&session->chunkHash, data, len);
+    }
+    return uploadWriter.write(key, data, len) ? RESUMABLE_OK : RESUMABLE_IO_ERROR;
+}
+
+ResumableStatus ResumableUploads::endChunk(const void* key) {
+    Session* session = findByKey(key);
+    if (!session) {
+        return RESUMABLE_NOT_FOUND;
+    }
+
+    // close() writer kapanışı zaten kuyruğa aldıysa false döner; sonuç her durumda pollChunk'tan
+    uploadWriter.close(key);
+    return RESUMABLE_PENDING;
+}
+
+ResumableStatus ResumableUploads::pollChunk(const void* key, bool giveUp) {
+    Session* session = findByKey(key);
+    if (!session) {
+        return RESUMABLE_NOT_FOUND;
+    }
+
+    UploadResult result = giveUp ? uploadWriter.wait(key, 0) : uploadWriter.poll(key);
+    if (result == UPLOAD_PENDING) {
+        return RESUMABLE_PENDING;
+    }
+
+    bool hashed = session->chunkHashing;
+    session->chunkKey = nullptr;
+    session->chunkHashing = false;
+    if (result != UPLOAD_OK) {
+        mbedtls_sha256_free(&session->chunkHash);
+        Serial.printf("❌ Upload chunk %d failed (%d)\n", (int)session->chunkIndex, (int)result);
+        session->chunkIndex = -1;
+        return RESUMABLE_IO_ERROR;
+    }
+
+    if (hashed) {
+        mbedtls_sha256_clone(&session->hash, &session->chunkHash);
+        mbedtls_sha256_free(&session->chunkHash);
+        session->hashedBytes += session->chunkLength;
+    }
+    session->bitmap[session->chunkIndex >> 3] |= 1 << (session->chunkIndex & 7);
+    session->receivedCount++;
+    session->chunkIndex = -1;
+
+    if (!saveMeta(*session)) {
+        // Veri yerinde; sadece yeniden başlatmada bu parça tekrar istenir
+        Serial.printf("❌ Upload session %08x metadata could not be saved\n", (unsigned)session->id);
+    }
+    return RESUMABLE_OK;
+}
+
+void ResumableUploads::abortChunk(const void* key) {
+    Session* session = findByKey(key);
+    if (!session) {
+        return;
+    }
+    uploadWriter.abort(key);
+    if (session->chunkHashing) {
+        mbedtls_sha256_free(&session->chunkHash);
+    }
+    session->chunkKey = nullptr;
+    session->chunkIndex = -1;
+    session->chunkHashing = false;
+}
+
+ResumableStatus ResumableUploads::finalize(const String& idText, const String& sha256Hex, String& path) {
+    uint32_t id;
+    Session* session = parseId(idText, id) ? load(id) : nullptr;
+    if (!session) {
+        return RESUMABLE_NOT_FOUND;
+    }
+    if (session->chunkKey) {
+        return RESUMABLE_BUSY;
+    }
+    if (session->receivedCount < session->chunkCount) {
+        return RESUMABLE_INCOMPLETE;
+    }
+    if (sha256Hex.length() != 64) {
+        return RESUMABLE_BAD_REQUEST;
+    }
+
+    if (session->verifying) {
+        UploadResult result = uploadWriter.pollHash(session, &session->hash);
+        if (result == UPLOAD_PENDING) {
+            return RESUMABLE_PENDING;
+        }
+        session->verifying = false;
+        if (result != UPLOAD_OK) {
+            Serial.printf("❌ Upload %08x could not be read for hashing (%d)\n", (unsigned)session->id, (int)result);
+            return RESUMABLE_IO_ERROR;
+        }
+        session->hashedBytes = session->size;
+    } else if (session->hashedBytes < session->size) {
+        // Sırasız gelen ya da yeniden başlatmadan önce özetlenmemiş kısım;
+        // 512 MB'a kadar okuma async_tcp'de yapılamaz
+        if (!uploadWriter.hash(session, partPath(session->id), session->hashedBytes,
+                session->size - session->hashedBytes, &session->hash)) {
+            return RESUMABLE_BUSY;
+        }
+        session->verifying = true;
+        return RESUMABLE_PENDING;
+    }
+    return complete(*session, sha256Hex, path);
+}
+
+// Özet tamam: doğrula ve taşı
+ResumableStatus ResumableUploads::complete(Session& session, const String& sha256Hex, String& path) {
+    String part = partPath(session.id);
+    File file = SD.open(part, FILE_READ);
+    bool sized = file && file.size() == session.size;
+    if (file) {
+        file.close();
+    }
+    if (!sized) {
+        return RESUMABLE_IO_ERROR;
+    }
+
+    // finish bağlamı tüketir; doğrulama başarısızsa oturum zaten silinir
+    uint8_t digest[32];
+    mbedtls_sha256_context hash;
+    mbedtls_sha256_init(&hash);
+    mbedtls_sha256_clone(&hash, &session.hash);
+    mbedtls_sha256_finish_ret(&hash, digest);
+    mbedtls_sha256_free(&hash);
+
+    char hex[65];
+    for (int i = 0; i < 32; i++) {
+        snprintf(hex + i * 2, 3, "%02x", digest[i]);
+    }
+    if (!sha256Hex.equalsIgnoreCase(hex)) {
+        // Hangi parçanın bozuk olduğu bilinemez; oturum baştan alınır
+        Serial.printf("❌ Upload %08x hash mismatch: %s\n", (unsigned)session.id, session.name.c_str());
+        removeFiles(session.id);
+        resetSession(session);
+        return RESUMABLE_HASH_MISMATCH;
+    }
+
+    // FAT rename hedef varken başarısız olur; eski dosya önce silinir
+    String target = "/" + session.name;
+    if (SD.exists(target)) {
+        SD.remove(target);
+    }
+    if (!SD.rename(part, target)) {
+        return RESUMABLE_IO_ERROR;
+    }
+    SD.remove(metaPath(session.id));
+    Serial.printf("✅ Upload %08x complete: %s, %u bytes\n", (unsigned)session.id, target.c_str(),
+        (unsigned)session.size);
+    resetSession(session);
+
+    libraryIndex.queueAdd(target.c_str());
+    path = target;
+    return RESUMABLE_OK;
+}
+
+bool ResumableUploads::remove(const String& idText) {
+    uint32_t id;
+    if (!parseId(idText, id)) {
+        return false;
+    }
+    if (Session* session = find(id)) {
+        if (session->chunkKey) {
+            abortChunk(session->chunkKey);
+        }
+        resetSession(*session);
+    }
+    if (!SD.exists(metaPath(id))) {
+        return false;
+    }
+    removeFiles(id);
+    return true;
+}
+
+const char* ResumableUploads::statusText(ResumableStatus status) {
+    switch (status) {
+        case RESUMABLE_OK:            return "OK";
+        case RESUMABLE_DUPLICATE:     return "Parça zaten alınmış";
+        case RESUMABLE_NOT_FOUND:     return "Upload oturumu bulunamadı";
+        case RESUMABLE_BAD_REQUEST:   return "Geçersiz parça veya parametre";
+        case RESUMABLE_BUSY:          return "Upload meşgul, tekrar deneyin";
+        case RESUMABLE_INCOMPLETE:    return "Eksik parçalar var";
+        case RESUMABLE_HASH_MISMATCH: return "SHA-256 uyuşmuyor";
+        case RESUMABLE_IO_ERROR:      return "SD kart hatası";
+        case RESUMABLE_PENDING:       return "Parça yazılıyor";
+    }
+    return "Bilinmeyen hata";
+}
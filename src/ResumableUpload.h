@@ -0,0 +1,139 @@
+#ifndef RESUMABLE_UPLOAD_H
+#define RESUMABLE_UPLOAD_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <mbedtls/sha256.h>
+#include <vector>
+#include "UploadWriter.h"
+
+// Parçalı, kaldığı yerden devam ettirilebilir upload'lar.
+//
+// İstemci önce oturum açar (ad + boyut), sonra numaralı parçaları PUT ile
+// gönderir. Parçalar SD'de geçici dosyaya (UPLOAD_SESSION_DIR/<id>.part)
+// kendi konumlarına yazılır, alınanlar bitmap'te tutulur ve her parçadan
+// sonra <id>.meta'ya kaydedilir; bağlantı ya da cihaz yeniden başlasa da
+// eksik aralıklar sorgulanıp sadece onlar yeniden gönderilir. Sırayla gelen
+// kısmın SHA-256 durumu da meta'da saklanır; finalize sadece özetlenmemiş
+// kısmı writer task'ında okur, doğrular ve dosyayı tek rename ile taşır.
+//
+// Sadece web handler'larından (async_tcp task'ı) çağrılır, kilit yoktur;
+// SD okuma/yazması uzun sürebilecek işler uploadWriter'a verilir.
+
+#define UPLOAD_SESSION_DIR          "/.uploads"
+#define UPLOAD_SESSION_MAGIC        0x5055424D  // "MBUP"
+#define UPLOAD_SESSION_VERSION      2
+#define UPLOAD_CHUNK_SIZE           (8 * UPLOAD_BUFFER_SIZE)   // 64 KB
+#define UPLOAD_SESSION_MAX_SIZE     (512UL * 1024 * 1024)      // bitmap <= 1 KB
+#define UPLOAD_SESSION_SLOTS        2       // bellekteki oturumlar
+#define UPLOAD_SESSION_MAX_STORED   8       // SD'de bekleyen yarım upload'lar
+#define UPLOAD_SESSION_MAX_RANGES   64      // durum yanıtındaki aralık sayısı
+
+enum ResumableStatus {
+    RESUMABLE_OK = 0,
+    RESUMABLE_DUPLICATE,        // parça zaten alınmış, gövde yok sayılır
+    RESUMABLE_NOT_FOUND,
+    RESUMABLE_BAD_REQUEST,
+    RESUMABLE_BUSY,             // oturumda başka parça yazılıyor / writer dolu
+    RESUMABLE_INCOMPLETE,
+    RESUMABLE_HASH_MISMATCH,
+    RESUMABLE_IO_ERROR,
+    RESUMABLE_PENDING           // parça kapanışı / özet doğrulaması writer'da sürüyor
+};
+
+struct ResumableMetaHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t nameLength;
+    uint32_t id;
+    uint32_t size;
+    uint32_t chunkSize;
+    uint32_t hashedBytes;
+    uint32_t hashStateSize;     // sizeof(mbedtls_sha256_context), bitmap'ten sonra
+};
+
+class ResumableUploads {
+private:
+    struct Session {
+        bool active;
+        uint32_t id;
+        String name;                // hedef dosya adı ('/' olmadan)
+        uint32_t size;
+        uint32_t chunkSize;
+        uint32_t chunkCount;
+        uint32_t receivedCount;
+        std::vector<uint8_t> bitmap;
+        uint32_t lastUsed;
+
+        // Baştan kesintisiz alınmış kısmın özeti; sırayla gelen parçalar
+        // geldikçe özetlenir, finalize sadece geri kalanı SD'den okur
+        mbedtls_sha256_context hash;
+        uint32_t hashedBytes;
+        bool verifying;             // kalan kısım writer'da özetleniyor (key: oturum)
+
+        // Yazılmakta olan parça (aynı dosyaya tek yazıcı)
+        const void* chunkKey;
+        int32_t chunkIndex;
+        uint32_t chunkLength;
+        bool chunkHashing;
+        mbedtls_sha256_context chunkHash;
+    };
+
+    Session sessions[UPLOAD_SESSION_SLOTS];
+    uint32_t useCounter;
+
+    static String partPath(uint32_t id);
+    static String metaPath(uint32_t id);
+    static bool parseId(const String& text, uint32_t& id);
+
+    Session* find(uint32_t id);
+    Session* load(uint32_t id);
+    Session* findByKey(const void* key);
+    Session* allocate();
+    bool readMeta(uint32_t id, ResumableMetaHeader& header, String& name, std::vector<uint8_t>* bitmap,
+        mbedtls_sha256_context* hash = nullptr);
+    bool saveMeta(const Session& session);
+    void resetSession(Session& session);
+    void removeFiles(uint32_t id);
+    void pruneStored();
+    ResumableStatus complete(Session& session, const String& sha256Hex, String& path);
+    bool hasChunk(const Session& session, uint32_t index) const {
+        return session.bitmap[index >> 3] & (1 << (index & 7));
+    }
+
+public:
+    ResumableUploads();
+
+    bool begin();
+
+    // Aynı ad ve boyutta yarım kalmış oturum varsa onu döndürür (sayfa
+    // yenilense de devam edilebilir). name önceden doğrulanmış olmalı.
+    ResumableStatus create(const String& name, uint32_t size, String& id);
+
+    // {"id","name","size","chunkSize","chunks","received":[[başlangıç,bitiş),...],"complete"}
+    ResumableStatus writeStatus(const String& id, Print& out);
+
+    // PUT gövdesi: beginChunk -> writeChunk* -> endChunk; koparsa abortChunk.
+    // endChunk kapanışı kuyruğa alıp RESUMABLE_PENDING döner; sonuç
+    // pollChunk'tan alınır (beklemez). giveUp ile sonuç gelmediyse parça
+    // writer'a bırakılır ve RESUMABLE_IO_ERROR döner.
+    ResumableStatus beginChunk(const String& id, uint32_t index, size_t length, const void* key,
+        UploadFlowControl* flow);
+    ResumableStatus writeChunk(const void* key, const uint8_t* data, size_t len);
+    ResumableStatus endChunk(const void* key);
+    ResumableStatus pollChunk(const void* key, bool giveUp = false);
+    void abortChunk(const void* key);
+
+    // Tüm parçalar alındıysa özeti doğrular ve dosyayı "/" + ad'a taşır.
+    // Özetlenmemiş kısım varsa writer'a okutur ve RESUMABLE_PENDING döner
+    // (beklemez); aynı çağrı tekrarlanınca sonuç alınır.
+    ResumableStatus finalize(const String& id, const String& sha256Hex, String& path);
+
+    bool remove(const String& id);
+
+    static const char* statusText(ResumableStatus status);
+};
+
+extern ResumableUploads resumableUploads;
+
+#endif // RESUMABLE_UPLOAD_H
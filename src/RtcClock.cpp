@@ -0,0 +1,117 @@
+#include "RtcClock.h"
+
+RtcClock rtcClock;
+
+RtcClock::RtcClock() :
+    rtc(nullptr),
+    arbiter(nullptr),
+    budgetUs(0),
+    baseMs(0),
+    baseMillis(0),
+    lastSyncMillis(0),
+    lastServed(0),
+    temperature(0),
+    valid(false),
+    resyncRequested(false),
+    mutex(xSemaphoreCreateMutex()) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void RtcClock::lock() const {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void RtcClock::unlock() const {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+void RtcClock::begin(RTC_DS3231* _rtc, I2cArbiter* _arbiter) {
+    rtc = _rtc;
+    arbiter = _arbiter;
+    // Saat: register adresi yaz + 7 byte oku; sıcaklık: adres yaz + 2 byte oku
+    budgetUs = arbiter->transactionUs(2) + arbiter->transactionUs(8) +
+               arbiter->transactionUs(2) + arbiter->transactionUs(3);
+
+    arbiter->acquire(I2C_DEVICE_RTC, budgetUs);
+    readRtc();
+    Serial.printf("✅ RTC saati: %lu (sıcaklık %.2f°C)\n", (unsigned long)unixtime(), temperature);
+}
+
+void RtcClock::loop() {
+    if (!rtc) return;
+
+    bool resync = resyncRequested.load();
+    if (!resync && valid && millis() - lastSyncMillis < RTC_CLOCK_SYNC_MS) return;
+
+    if (!arbiter->tryAcquire(I2C_DEVICE_RTC, budgetUs)) return;
+    readRtc();
+}
+
+// Bus alınmış olarak çağrılır, bırakır
+void RtcClock::readRtc() {
+    bool resync = resyncRequested.exchange(false);
+    uint32_t seconds = rtc->now().unixtime();
+    float celsius = rtc->getTemperature();
+    unsigned long at = millis();
+    arbiter->release(I2C_DEVICE_RTC);
+
+    if (resync) {
+        // RTC ileri/geri ayarlandı; eski taban ve monoton sınır geçersiz
+        lock();
+        valid = false;
+        lastServed = 0;
+        unlock();
+    }
+    discipline(seconds, celsius, at);
+}
+
+void RtcClock::discipline(uint32_t rtcUnix, float celsius, unsigned long atMillis) {
+    uint64_t low = (uint64_t)rtcUnix * 1000;
+    uint64_t high = low + 999;
+
+    lock();
+    int32_t error = 0;
+    if (!valid) {
+        baseMs = low;
+        valid = true;
+    } else {
+        uint64_t estimate = baseMs + (atMillis - baseMillis);
+        if (estimate < low) {
+            error = (int32_t)(low - estimate);
+            estimate = low;
+        } else if (estimate > high) {
+            error = -(int32_t)(estimate - high);
+            estimate = high;
+        }
+        baseMs = estimate;
+        if (error != 0) {
+            stats.corrections++;
+            uint32_t magnitude = (uint32_t)abs(error);
+            if (magnitude > stats.maxErrorMs) stats.maxErrorMs = magnitude;
+        }
+    }
+    baseMillis = atMillis;
+    lastSyncMillis = atMillis;
+    temperature = celsius;
+    stats.lastErrorMs = error;
+    stats.syncs++;
+    unlock();
+}
+
+uint32_t RtcClock::unixtime() {
+    lock();
+    uint32_t seconds = (uint32_t)((baseMs + (millis() - baseMillis)) / 1000);
+    if (seconds < lastServed) {
+        seconds = lastServed;
+    }
+    lastServed = seconds;
+    unlock();
+    return seconds;
+}
+
+float RtcClock::getTemperature() const {
+    lock();
+    float celsius = temperature;
+    unlock();
+    return celsius;
+}
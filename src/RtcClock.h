@@ -0,0 +1,76 @@
+#ifndef RTC_CLOCK_H
+#define RTC_CLOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <RTClib.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "I2cArbiter.h"
+
+// Duvar saati. Zaman millis()'ten hesaplanır; DS3231 dakikada bir,
+// sıcaklıkla birlikte tek slotta okunur ve saat ona göre düzeltilir.
+// Durum, web ve MQTT istekleri I2C'ye dokunmadan now()/getTemperature()
+// kullanır.
+//
+// RTC saniye çözünürlüklü: okuma R ise gerçek zaman [R, R+1) içindedir.
+// Tahmin bu aralıktaysa dokunulmaz (saniye altı faz korunur), dışındaysa
+// en yakın sınıra çekilir. Geri çekilmede verilen saniye geri gitmez.
+
+#define RTC_CLOCK_SYNC_MS       60000
+
+struct RtcClockStats {
+    uint32_t syncs;
+    uint32_t corrections;       // tahmin RTC saniyesinin dışındaydı
+    int32_t lastErrorMs;        // RTC - tahmin (düzeltilen kısım)
+    uint32_t maxErrorMs;
+};
+
+class RtcClock {
+private:
+    RTC_DS3231* rtc;
+    I2cArbiter* arbiter;
+    uint32_t budgetUs;
+
+    uint64_t baseMs;            // son düzeltmedeki unix zamanı (ms)
+    unsigned long baseMillis;
+    unsigned long lastSyncMillis;
+    uint32_t lastServed;
+    float temperature;
+    bool valid;
+    std::atomic<bool> resyncRequested;
+
+    RtcClockStats stats;
+    SemaphoreHandle_t mutex;
+
+    void lock() const;
+    void unlock() const;
+    void readRtc();
+
+public:
+    RtcClock();
+
+    // rtc.begin() çağrılmış olmalı; ilk okuma slot beklenerek yapılır
+    void begin(RTC_DS3231* rtc, I2cArbiter* arbiter);
+
+    // Senkron zamanı geldiyse ve bus'ta slot varsa RTC'yi okur; bloklamaz
+    void loop();
+
+    // RTC ayarlandı (NTP, elle ayar); sonraki loop()'ta yeniden kurulur
+    void requestSync() { resyncRequested = true; }
+
+    // Tüm task'lardan, I2C'siz
+    uint32_t unixtime();
+    DateTime now() { return DateTime(unixtime()); }
+    float getTemperature() const;
+    bool isValid() const { return valid; }
+
+    // Senkron sonrası düzeltme (host testleri de doğrudan çağırır)
+    void discipline(uint32_t rtcUnix, float temperature, unsigned long atMillis);
+
+    const RtcClockStats& getStats() const { return stats; }
+};
+
+extern RtcClock rtcClock;
+
+#endif // RTC_CLOCK_H
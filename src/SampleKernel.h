@@ -0,0 +1,171 @@
+#ifndef SAMPLE_KERNEL_H
+#define SAMPLE_KERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+
+// 16-bit stereo -> 12-bit mono DAC kodu dönüşümü (sabit noktalı, dalsız).
+//
+//   mono2 = L + R                  ((L+R)/2 * 2 ile aynı, eski 2x kazanç)
+//   y     = (mono2 * gainQ15) >> 15
+//   y     = sat16(y + dither)
+//   kod   = (y + 32768) >> 4
+//
+// Ses seviyesi işaretli örneğe uygulanır, böylece kısık seste sinyal
+// midscale (2048) etrafında kalır. Seviye değişince kazanç tek adımda
+// atlamaz, SAMPLE_KERNEL_RAMP_FRAMES boyunca doğrusal kayar (zipper
+// gürültüsü olmaz); rampa bitince blok yolu eskisi gibi sabit kazançla döner.
+
+enum DitherMode {
+    DITHER_NONE = 0,
+    DITHER_TPDF,        // ±1 LSB üçgen dağılımlı dither
+    DITHER_SHAPED       // TPDF + birinci derece hata geri beslemesi
+};
+
+#define SAMPLE_KERNEL_UNITY_Q15 32768
+#define SAMPLE_KERNEL_LSB_SHIFT 4       // 16 bit -> 12 bit
+#define SAMPLE_KERNEL_RAMP_FRAMES 256   // 22.05 kHz'de ~12 ms
+
+class SampleKernel {
+private:
+    int32_t gainQ15;
+    int32_t targetGainQ15;
+    int32_t rampStep;
+    uint32_t rngState;
+    int32_t shapingError;
+    DitherMode ditherMode;
+
+    static inline int32_t saturate16(int32_t v) {
+        return std::min(std::max(v, (int32_t)-32768), (int32_t)32767);
+    }
+
+    static inline uint16_t toCode(int32_t v) {
+        return (uint16_t)((v + 32768) >> SAMPLE_KERNEL_LSB_SHIFT);
+    }
+
+    // xorshift32; tek çekilişten iki adet 4-bit uniform değer
+    inline int32_t nextTpdf() {
+        uint32_t x = rngState;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        rngState = x;
+        return (int32_t)(x & 0x0F) - (int32_t)((x >> 4) & 0x0F);
+    }
+
+    inline int32_t scale(int16_t l, int16_t r) const {
+        // |L+R| <= 65536 ve gain <= 32768 olduğundan int32'ye sığar
+        return (((int32_t)l + (int32_t)r) * gainQ15) >> 15;
+    }
+
+    template <DitherMode Mode>
+    void convertBlock(const int16_t* in, uint16_t* out, size_t frames) {
+        for (size_t i = 0; i < frames; i++) {
+            int32_t y = scale(in[2 * i], in[2 * i + 1]);
+            if (Mode == DITHER_NONE) {
+                out[i] = toCode(saturate16(y));
+            } else if (Mode == DITHER_TPDF) {
+                out[i] = toCode(saturate16(y + nextTpdf()));
+            } else {
+                int32_t v = y - shapingError;
+                uint16_t code = toCode(saturate16(v + nextTpdf()));
+                int32_t e = ((int32_t)code << SAMPLE_KERNEL_LSB_SHIFT) - 32768 - v;
+                // Clipping sonrası büyük hatanın geri beslenmesini sınırla
+                shapingError = std::min(std::max(e, (int32_t)-32), (int32_t)32);
+                out[i] = code;
+            }
+        }
+    }
+
+    void convertFlat(const int16_t* in, uint16_t* out, size_t frames) {
+        switch (ditherMode) {
+            case DITHER_TPDF:
+                convertBlock<DITHER_TPDF>(in, out, frames);
+                break;
+            case DITHER_SHAPED:
+                convertBlock<DITHER_SHAPED>(in, out, frames);
+                break;
+            default:
+                convertBlock<DITHER_NONE>(in, out, frames);
+                break;
+        }
+    }
+
+    // Rampa sürerken kazanç her frame'de bir adım hedefe yaklaşır;
+    // işlenen frame sayısını döndürür
+    size_t convertRamp(const int16_t* in, uint16_t* out, size_t frames) {
+        size_t done = 0;
+        while (done < frames && gainQ15 != targetGainQ15) {
+            if (gainQ15 < targetGainQ15) {
+                gainQ15 = std::min(gainQ15 + rampStep, targetGainQ15);
+            } else {
+                gainQ15 = std::max(gainQ15 - rampStep, targetGainQ15);
+            }
+            convertFlat(in + 2 * done, out + done, 1);
+            done++;
+        }
+        return done;
+    }
+
+public:
+    SampleKernel() :
+        gainQ15(SAMPLE_KERNEL_UNITY_Q15),
+        targetGainQ15(SAMPLE_KERNEL_UNITY_Q15),
+        rampStep(1),
+        rngState(0x12345678),
+        shapingError(0),
+        ditherMode(DITHER_NONE) {
+    }
+
+    // 0-100 arası ses seviyesi, Q15 kazanca bir kez çevrilir; yeni
+    // kazanca rampayla geçilir. Rampa sürerken gelen değer kalan yolu
+    // baştan böler.
+    void setVolume(int volume) {
+        volume = std::min(std::max(volume, 0), 100);
+        rampToGainQ15((volume * SAMPLE_KERNEL_UNITY_Q15) / 100);
+    }
+
+    void rampToGainQ15(int32_t gain) {
+        targetGainQ15 = std::min(std::max(gain, (int32_t)0), (int32_t)SAMPLE_KERNEL_UNITY_Q15);
+        int32_t distance = targetGainQ15 > gainQ15 ? targetGainQ15 - gainQ15 : gainQ15 - targetGainQ15;
+        rampStep = std::max(distance / SAMPLE_KERNEL_RAMP_FRAMES, (int32_t)1);
+    }
+
+    // Rampasız; çalma başlamadan önce (ör. sessizden) kullanılır
+    void setGainQ15(int32_t gain) {
+        gainQ15 = std::min(std::max(gain, (int32_t)0), (int32_t)SAMPLE_KERNEL_UNITY_Q15);
+        targetGainQ15 = gainQ15;
+    }
+
+    int32_t getGainQ15() const { return gainQ15; }
+    int32_t getTargetGainQ15() const { return targetGainQ15; }
+    bool isRamping() const { return gainQ15 != targetGainQ15; }
+
+    void setDither(DitherMode mode) {
+        ditherMode = mode;
+        shapingError = 0;
+    }
+
+    DitherMode getDither() const { return ditherMode; }
+
+    uint16_t convertFrame(int16_t l, int16_t r) {
+        uint16_t code;
+        int16_t frame[2] = { l, r };
+        convert(frame, &code, 1);
+        return code;
+    }
+
+    // interleaved: L,R,L,R,... ; out: frames adet 12-bit kod
+    void convert(const int16_t* interleaved, uint16_t* out, size_t frames) {
+        size_t done = 0;
+        if (gainQ15 != targetGainQ15) {
+            done = convertRamp(interleaved, out, frames);
+        }
+        if (done < frames) {
+            convertFlat(interleaved + 2 * done, out + done, frames - done);
+        }
+    }
+};
+
+#endif // SAMPLE_KERNEL_H
@@ -0,0 +1,75 @@
+#include "StaticAssets.h"
+#include "StaticAssetsData.h"
+
+StaticAssetHandler staticAssets;
+
+const StaticAsset* StaticAssetHandler::find(const String& url, bool& immutable) {
+    const char* path = url == "/" ? "/index.html" : url.c_str();
+
+    for (size_t i = 0; i < STATIC_ASSET_COUNT; i++) {
+        const StaticAsset& asset = STATIC_ASSETS[i];
+        if (strcmp(path, asset.path) == 0) {
+            immutable = false;
+            return &asset;
+        }
+        if (strcmp(path, asset.fingerprintPath) == 0) {
+            immutable = true;
+            return &asset;
+        }
+    }
+    return nullptr;
+}
+
+bool StaticAssetHandler::canHandle(AsyncWebServerRequest* request) {
+    if (request->method() != HTTP_GET && request->method() != HTTP_HEAD) {
+        return false;
+    }
+    bool immutable;
+    return find(request->url(), immutable) != nullptr;
+}
+
+void StaticAssetHandler::handleRequest(AsyncWebServerRequest* request) {
+    bool immutable = false;
+    const StaticAsset* asset = find(request->url(), immutable);
+    if (!asset) {
+        request->send(404);
+        return;
+    }
+
+    const char* cacheControl = immutable ? STATIC_ASSET_IMMUTABLE_CACHE : STATIC_ASSET_REVALIDATE_CACHE;
+
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match") == asset->etag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", asset->etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        return;
+    }
+
+    AsyncWebServerResponse* response;
+    if (asset->data) {
+        response = request->beginResponse_P(200, asset->contentType, asset->data, asset->length);
+        response->addHeader("Content-Encoding", "gzip");
+    } else {
+        File file = SPIFFS.open(asset->storagePath, "r");
+        if (!file) {
+            Serial.printf("❌ Static asset missing: %s\n", asset->storagePath);
+            request->send(404, "text/plain", "File not found!");
+            return;
+        }
+        // Dosya adı .gz ile bittiği için Content-Encoding: gzip eklenir
+        response = request->beginResponse(file, asset->path, asset->contentType);
+    }
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+}
+
+size_t StaticAssetHandler::count() {
+    return STATIC_ASSET_COUNT;
+}
+
+bool StaticAssetHandler::isEmbedded() {
+    return STATIC_ASSETS_EMBEDDED;
+}
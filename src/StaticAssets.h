@@ -0,0 +1,45 @@
+#ifndef STATIC_ASSETS_H
+#define STATIC_ASSETS_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <SPIFFS.h>
+
+// data/ altındaki web dosyalarının gzip'li, önbelleklenebilir servisi.
+//
+// Tablo build sırasında assets_script.py ile üretilir. Her dosya iki
+// adresten verilir: parmak izli ad (app.<hash>.js) bir yıl immutable
+// önbelleklenir, asıl ad (ve "/") no-cache + güçlü ETag ile doğrulanır.
+// İçerik ya firmware'e gömülü diziden ya da SPIFFS'teki .gz dosyasından
+// gelir; istek başına exists() çağrısı yapılmaz.
+
+#define STATIC_ASSET_IMMUTABLE_CACHE "public, max-age=31536000, immutable"
+#define STATIC_ASSET_REVALIDATE_CACHE "no-cache"
+
+struct StaticAsset {
+    const char* path;               // "/js/app.js"
+    const char* fingerprintPath;    // "/js/app.3f2a9c1d.js" (HTML'de path ile aynı)
+    const char* contentType;
+    const char* etag;               // tırnaklı, içerik hash'i
+    const char* storagePath;        // SPIFFS'teki gzip dosyası
+    const uint8_t* data;            // gömülü gzip içerik (SPIFFS modunda nullptr)
+    uint32_t length;                // gzip boyutu
+};
+
+class StaticAssetHandler : public AsyncWebHandler {
+private:
+    // immutable: parmak izli adla istendi
+    static const StaticAsset* find(const String& url, bool& immutable);
+
+public:
+    virtual bool canHandle(AsyncWebServerRequest* request) override;
+    virtual void handleRequest(AsyncWebServerRequest* request) override;
+    virtual bool isRequestHandlerTrivial() override { return true; }
+
+    static size_t count();
+    static bool isEmbedded();
+};
+
+extern StaticAssetHandler staticAssets;
+
+#endif // STATIC_ASSETS_H
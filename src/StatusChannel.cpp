@@ -0,0 +1,77 @@
+#include "StatusChannel.h"
+
+StatusChannel statusChannel(statusSnapshot);
+
+StatusChannel::StatusChannel(StatusSnapshot& _snapshot) :
+    ws(nullptr),
+    snapshot(_snapshot),
+    sentVersion(0),
+    lastDelta(0),
+    pendingCount(0),
+    mutex(nullptr) {
+}
+
+void StatusChannel::attach(AsyncWebSocket& socket) {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+    }
+    ws = &socket;
+}
+
+void StatusChannel::requestSnapshot(uint32_t clientId) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (pendingCount < STATUS_MAX_PENDING) {
+        pending[pendingCount++] = clientId;
+    }
+    xSemaphoreGive(mutex);
+}
+
+void StatusChannel::loop() {
+    if (!ws) {
+        return;
+    }
+
+    if (pendingCount > 0) {
+        uint32_t ids[STATUS_MAX_PENDING];
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        uint8_t count = pendingCount;
+        memcpy(ids, pending, count * sizeof(uint32_t));
+        pendingCount = 0;
+        xSemaphoreGive(mutex);
+
+        // MQTT/BLE ile aynı tampon, sürüm değişmediyse yeniden serialize edilmez
+        StatusFrame frame = snapshot.serialize();
+        for (uint8_t i = 0; i < count; i++) {
+            AsyncWebSocketClient* client = ws->client(ids[i]);
+            if (client && client->status() == WS_CONNECTED) {
+                client->text(frame.data, frame.length);
+            }
+        }
+    }
+
+    if (snapshot.getVersion() == sentVersion) {
+        return;
+    }
+
+    // Kimse dinlemiyorsa değişiklikleri atla; bağlanan snapshot alır
+    if (ws->count() == 0) {
+        sentVersion = snapshot.getVersion();
+        return;
+    }
+
+    unsigned long now = millis();
+    bool immediate = snapshot.changedSince(sentVersion) & STATUS_IMMEDIATE_FIELDS;
+    if (!immediate && now - lastDelta < STATUS_DELTA_INTERVAL_MS) {
+        return;
+    }
+
+    // Yavaş bir istemcinin kuyruğu doluysa bekle, değişiklikler birikir
+    if (!ws->availableForWriteAll()) {
+        return;
+    }
+
+    char frame[STATUS_FRAME_SIZE];
+    size_t len = snapshot.serializeChanges(sentVersion, frame, sizeof(frame), sentVersion);
+    ws->textAll(frame, len);
+    lastDelta = now;
+}
@@ -0,0 +1,46 @@
+#ifndef STATUS_CHANNEL_H
+#define STATUS_CHANNEL_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/semphr.h>
+#include "StatusSnapshot.h"
+
+// WebSocket üzerinden olay tabanlı durum kanalı (StatusSnapshot tüketicisi).
+//
+// loop() son gönderilen sürümden beri değişen alanları tek bir delta
+// frame'de birleştirir: çalma/durdurma, parça ve ses seviyesi hemen, konum,
+// saat gibi sık değişen alanlar en fazla STATUS_DELTA_INTERVAL_MS'de bir
+// gider. Yeni bağlanan istemci önce paylaşılan tam snapshot'ı alır.
+
+#define STATUS_IMMEDIATE_FIELDS (STATUS_PLAYING | STATUS_VOLUME | STATUS_TRACK | STATUS_DURATION | STATUS_LOOPING)
+#define STATUS_DELTA_INTERVAL_MS        100     // sık değişen alanlar için 10 Hz
+#define STATUS_MAX_PENDING              8
+
+class StatusChannel {
+private:
+    AsyncWebSocket* ws;
+    StatusSnapshot& snapshot;
+    uint32_t sentVersion;
+    unsigned long lastDelta;
+    uint32_t pending[STATUS_MAX_PENDING];   // snapshot bekleyen client id'leri
+    uint8_t pendingCount;
+    SemaphoreHandle_t mutex;
+
+public:
+    StatusChannel(StatusSnapshot& _snapshot);
+
+    void attach(AsyncWebSocket& socket);
+
+    // WS_EVT_CONNECT'ten çağrılır; snapshot loop() içinde, alanlar
+    // tazelendikten sonra gönderilir
+    void requestSnapshot(uint32_t clientId);
+    bool hasPendingSnapshots() const { return pendingCount > 0; }
+
+    // Bekleyen snapshot'ları ve değişiklikleri hız sınırına uyarak yayınlar
+    void loop();
+};
+
+extern StatusChannel statusChannel;
+
+#endif // STATUS_CHANNEL_H
@@ -0,0 +1,290 @@
+#include "StatusSnapshot.h"
+#include "Trace.h"
+
+StatusSnapshot statusSnapshot;
+
+StatusSnapshot::StatusSnapshot() :
+    version(0),
+    frameLength(0),
+    frameVersion(UINT32_MAX),
+    serializations(0),
+    mutex(xSemaphoreCreateMutex()) {
+    state.playing = false;
+    state.volume = 0;
+    state.position = 0;
+    state.duration = 0;
+    state.looping = false;
+    state.temperature = 0;
+    state.wifi = false;
+    state.mqtt = false;
+    state.otaState = "idle";
+    state.otaError = nullptr;
+    state.otaReceived = 0;
+    state.otaTotal = 0;
+    state.otaWritten = 0;
+    state.otaRate = 0;
+    memset(fieldVersion, 0, sizeof(fieldVersion));
+}
+
+void StatusSnapshot::lock() const {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void StatusSnapshot::unlock() const {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+void StatusSnapshot::touch(uint32_t field) {
+    version++;
+    fieldVersion[__builtin_ctz(field)] = version;
+}
+
+void StatusSnapshot::setPlaying(bool playing) {
+    lock();
+    if (state.playing != playing) {
+        state.playing = playing;
+        touch(STATUS_PLAYING);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setVolume(int volume) {
+    lock();
+    if (state.volume != volume) {
+        state.volume = volume;
+        touch(STATUS_VOLUME);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setTrack(const String& track) {
+    lock();
+    if (state.track != track.c_str()) {
+        state.track = track.c_str();
+        touch(STATUS_TRACK);
+    }
+    unlock();
+}
+
+// Etiketler parça alanının parçasıdır; aynı delta'da gider
+void StatusSnapshot::setTrackTags(const char* title, const char* artist, const char* album) {
+    lock();
+    if (state.title != title || state.artist != artist || state.album != album) {
+        state.title = title;
+        state.artist = artist;
+        state.album = album;
+        touch(STATUS_TRACK);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setPosition(uint32_t position) {
+    lock();
+    if (state.position != position) {
+        state.position = position;
+        touch(STATUS_POSITION);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setDuration(uint32_t duration) {
+    lock();
+    if (state.duration != duration) {
+        state.duration = duration;
+        touch(STATUS_DURATION);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setLooping(bool looping) {
+    lock();
+    if (state.looping != looping) {
+        state.looping = looping;
+        touch(STATUS_LOOPING);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setTime(const DateTime& time) {
+    lock();
+    if (state.time != time) {
+        state.time = time;
+        touch(STATUS_TIME);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setTemperature(float temperature) {
+    lock();
+    // DS3231 çözünürlüğü 0.25 °C
+    if (fabsf(state.temperature - temperature) >= 0.25f) {
+        state.temperature = temperature;
+        touch(STATUS_TEMPERATURE);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setWifi(bool connected) {
+    lock();
+    if (state.wifi != connected) {
+        state.wifi = connected;
+        touch(STATUS_WIFI);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setMqtt(bool connected) {
+    lock();
+    if (state.mqtt != connected) {
+        state.mqtt = connected;
+        touch(STATUS_MQTT);
+    }
+    unlock();
+}
+
+void StatusSnapshot::setOta(const char* otaState, uint32_t received, uint32_t total, uint32_t written,
+    uint32_t rateKBps, const char* error) {
+    lock();
+    if (state.otaState != otaState || state.otaError != error || state.otaReceived != received ||
+        state.otaTotal != total || state.otaWritten != written || state.otaRate != rateKBps) {
+        state.otaState = otaState;
+        state.otaError = error;
+        state.otaReceived = received;
+        state.otaTotal = total;
+        state.otaWritten = written;
+        state.otaRate = rateKBps;
+        touch(STATUS_OTA);
+    }
+    unlock();
+}
+
+uint32_t StatusSnapshot::changedSince(uint32_t since) const {
+    lock();
+    uint32_t fields = changedLocked(since);
+    unlock();
+    return fields;
+}
+
+StatusState StatusSnapshot::getState() const {
+    lock();
+    StatusState copy = state;
+    unlock();
+    return copy;
+}
+
+uint32_t StatusSnapshot::changedLocked(uint32_t since) const {
+    uint32_t fields = 0;
+    for (uint8_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        if (fieldVersion[i] > since) {
+            fields |= 1UL << i;
+        }
+    }
+    return fields;
+}
+
+// Alan adları /api/status ile aynı, istemciler aynı render kodunu kullanır
+size_t StatusSnapshot::write(uint32_t fields, const char* type, char* out, size_t size) const {
+    StaticJsonDocument<STATUS_FRAME_SIZE> doc;
+
+    doc["type"] = type;
+    doc["v"] = version;
+    addFields(fields, doc);
+    return serializeJson(doc, out, size);
+}
+
+void StatusSnapshot::addFields(uint32_t fields, JsonDocument& doc) const {
+    if (fields & STATUS_PLAYING) doc["playing"] = state.playing;
+    if (fields & STATUS_VOLUME) doc["volume"] = state.volume;
+    if (fields & STATUS_TRACK) {
+        doc["track"] = state.track.c_str();
+        doc["title"] = state.title.c_str();
+        doc["artist"] = state.artist.c_str();
+        doc["album"] = state.album.c_str();
+    }
+    if (fields & STATUS_POSITION) doc["track_position"] = state.position;
+    if (fields & STATUS_DURATION) doc["track_duration"] = state.duration;
+    if (fields & STATUS_LOOPING) doc["looping"] = state.looping;
+    if (fields & STATUS_TEMPERATURE) doc["temperature"] = state.temperature;
+    if (fields & STATUS_WIFI) doc["wifi"] = state.wifi ? "Connected" : "Disconnected";
+    if (fields & STATUS_MQTT) doc["mqtt"] = state.mqtt ? "Connected" : "Disconnected";
+    if (fields & STATUS_OTA) {
+        doc["ota"]["state"] = state.otaState;
+        doc["ota"]["received"] = state.otaReceived;
+        doc["ota"]["total"] = state.otaTotal;
+        doc["ota"]["written"] = state.otaWritten;
+        doc["ota"]["rate"] = state.otaRate;
+        if (state.otaError) doc["ota"]["error"] = state.otaError;
+    }
+    if (fields & STATUS_TIME) {
+        doc["time"]["hour"] = state.time.hour();
+        doc["time"]["minute"] = state.time.minute();
+        doc["time"]["second"] = state.time.second();
+        doc["time"]["date"]["day"] = state.time.day();
+        doc["time"]["date"]["month"] = state.time.month();
+        doc["time"]["date"]["year"] = state.time.year();
+    }
+}
+
+static const char* const fieldNames[STATUS_FIELD_COUNT] = {
+    "playing", "volume", "track", "position", "duration", "looping",
+    "time", "temperature", "wifi", "mqtt", "ota"
+};
+
+const char* StatusSnapshot::fieldName(uint32_t field) {
+    for (uint8_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        if (field == (1UL << i)) return fieldNames[i];
+    }
+    return nullptr;
+}
+
+size_t StatusSnapshot::serializeField(uint32_t field, char* out, size_t size) const {
+    StaticJsonDocument<STATUS_FRAME_SIZE> doc;
+    int len = 0;
+    lock();
+    switch (field) {
+        case STATUS_PLAYING: len = snprintf(out, size, "%s", state.playing ? "true" : "false"); break;
+        case STATUS_VOLUME: len = snprintf(out, size, "%d", state.volume); break;
+        case STATUS_POSITION: len = snprintf(out, size, "%lu", (unsigned long)state.position); break;
+        case STATUS_DURATION: len = snprintf(out, size, "%lu", (unsigned long)state.duration); break;
+        case STATUS_LOOPING: len = snprintf(out, size, "%s", state.looping ? "true" : "false"); break;
+        case STATUS_TEMPERATURE: len = snprintf(out, size, "%.2f", state.temperature); break;
+        case STATUS_WIFI: len = snprintf(out, size, "%s", state.wifi ? "Connected" : "Disconnected"); break;
+        case STATUS_MQTT: len = snprintf(out, size, "%s", state.mqtt ? "Connected" : "Disconnected"); break;
+        case STATUS_TRACK:
+            addFields(field, doc);
+            len = serializeJson(doc, out, size);
+            break;
+        case STATUS_TIME:
+        case STATUS_OTA:
+            // Tek anahtarın altındaki nesne
+            addFields(field, doc);
+            len = serializeJson(doc[fieldName(field)], out, size);
+            break;
+        default:
+            break;
+    }
+    unlock();
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+StatusFrame StatusSnapshot::serialize() {
+    TRACE_SCOPE("status.serialize");
+    lock();
+    if (frameVersion != version) {
+        frameLength = write(STATUS_ALL, "snapshot", frame, sizeof(frame));
+        frameVersion = version;
+        serializations++;
+    }
+    StatusFrame result = { frame, frameLength, frameVersion };
+    unlock();
+    return result;
+}
+
+size_t StatusSnapshot::serializeChanges(uint32_t since, char* out, size_t size, uint32_t& versionOut) const {
+    TRACE_SCOPE("status.delta");
+    lock();
+    size_t len = write(changedLocked(since), "delta", out, size);
+    versionOut = version;
+    unlock();
+    return len;
+}
@@ -0,0 +1,136 @@
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <RTClib.h>
+#include <freertos/semphr.h>
+#include "LibraryIndex.h"
+
+// Web, MQTT ve BLE'nin paylaştığı tek durum kaydı.
+//
+// Alan sahipleri setter'larla günceller; değişen her alan global sürümü
+// artırır ve alanın sürümünü kaydeder. Tam JSON sürüm başına en fazla bir
+// kez, önceden ayrılmış tampona serialize edilir ve tüm taşıyıcılara
+// referansla verilir. Delta isteyen taşıyıcı changedSince() ile kendi son
+// gönderdiği sürümden beri değişen alanları sorar.
+
+enum StatusField : uint32_t {
+    STATUS_PLAYING      = 1 << 0,
+    STATUS_VOLUME       = 1 << 1,
+    STATUS_TRACK        = 1 << 2,
+    STATUS_POSITION     = 1 << 3,
+    STATUS_DURATION     = 1 << 4,
+    STATUS_LOOPING      = 1 << 5,
+    STATUS_TIME         = 1 << 6,
+    STATUS_TEMPERATURE  = 1 << 7,
+    STATUS_WIFI         = 1 << 8,
+    STATUS_MQTT         = 1 << 9,
+    STATUS_OTA          = 1 << 10,
+    STATUS_ALL          = (1 << 11) - 1
+};
+
+#define STATUS_FIELD_COUNT              11
+#define STATUS_FRAME_SIZE               1024    // uzun parça adı + etiketler + OTA alanları
+#define STATUS_CLOCK_INTERVAL_MS        1000
+#define STATUS_TEMPERATURE_INTERVAL_MS  60000   // DS3231 sıcaklığı 64 sn'de bir ölçer
+
+struct StatusState {
+    bool playing;
+    int volume;
+    LibraryPath track;          // kopyası heap'e gitmez (getState)
+    FixedString<TRACK_TAG_MAX> title;   // etiketler LibraryIndex'ten; yoksa boş
+    FixedString<TRACK_TAG_MAX> artist;
+    FixedString<TRACK_TAG_MAX> album;
+    uint32_t position;
+    uint32_t duration;
+    bool looping;
+    DateTime time;
+    float temperature;
+    bool wifi;
+    bool mqtt;
+
+    // OTA ilerlemesi; metinler statik (OtaUpdater)
+    const char* otaState;
+    const char* otaError;
+    uint32_t otaReceived;       // alınan (sıkıştırılmış) byte
+    uint32_t otaTotal;          // istek boyutu, bilinmiyorsa 0
+    uint32_t otaWritten;        // flash'a yazılan imaj byte'ı
+    uint32_t otaRate;           // KB/s
+};
+
+// serialize() sonucu; data bir sonraki sürüm serialize edilene kadar geçerli
+struct StatusFrame {
+    const char* data;
+    size_t length;
+    uint32_t version;
+};
+
+class StatusSnapshot {
+private:
+    StatusState state;
+    uint32_t version;
+    uint32_t fieldVersion[STATUS_FIELD_COUNT];
+    char frame[STATUS_FRAME_SIZE];
+    size_t frameLength;
+    uint32_t frameVersion;
+    uint32_t serializations;
+    SemaphoreHandle_t mutex;
+
+    void lock() const;
+    void unlock() const;
+    void touch(uint32_t field);
+    uint32_t changedLocked(uint32_t since) const;
+    size_t write(uint32_t fields, const char* type, char* out, size_t size) const;
+    void addFields(uint32_t fields, JsonDocument& doc) const;
+
+public:
+    StatusSnapshot();
+
+    // Alan sahipleri çağırır; değer değişmediyse sürüm artmaz
+    void setPlaying(bool playing);
+    void setVolume(int volume);
+    void setTrack(const String& track);
+    void setTrackTags(const char* title, const char* artist, const char* album);
+    void setPosition(uint32_t position);
+    void setDuration(uint32_t duration);
+    void setLooping(bool looping);
+    void setTime(const DateTime& time);
+    void setTemperature(float temperature);
+    void setWifi(bool connected);
+    void setMqtt(bool connected);
+    void setOta(const char* state, uint32_t received, uint32_t total, uint32_t written,
+        uint32_t rateKBps, const char* error);
+
+    uint32_t getVersion() const { return version; }
+
+    // since sürümünden sonra değişen alanların maskesi
+    uint32_t changedSince(uint32_t since) const;
+
+    // Durumun tutarlı bir kopyası (alan sahibi olmayan okuyucular için)
+    StatusState getState() const;
+
+    // Tam durum JSON'u. Sadece loop task'ından çağrılır: tampon tek,
+    // taşıyıcılar gönderimi bitirmeden yeni sürüm serialize edilmez
+    StatusFrame serialize();
+
+    // since'ten beri değişen alanları "delta" olarak out'a yazar
+    // (WebSocket). Maske ve sürüm aynı kilit altında alınır; yazılan
+    // durumun sürümü versionOut'a konur
+    size_t serializeChanges(uint32_t since, char* out, size_t size, uint32_t& versionOut) const;
+
+    // Tek alanın değeri (MQTT'de alan başına retained konu). Tek anahtarlı
+    // alanlar çıplak değerdir ("42", "true", metin tırnaksız); parça
+    // {track,title,artist,album}, saat ve OTA kendi nesneleridir. Sığmazsa 0
+    size_t serializeField(uint32_t field, char* out, size_t size) const;
+
+    // Konu son eki ("volume"); field tek bit değilse nullptr
+    static const char* fieldName(uint32_t field);
+
+    // Kaç kez gerçekten serialize edildiği (paylaşımın ölçüsü)
+    uint32_t getSerializationCount() const { return serializations; }
+};
+
+extern StatusSnapshot statusSnapshot;
+
+#endif // STATUS_SNAPSHOT_H
@@ -0,0 +1,477 @@
+#include "TimerScheduler.h"
+#include <Preferences.h>
+
+TimerScheduler timerScheduler;
+
+TimerScheduler::TimerScheduler(size_t _capacity) :
+    slots(new Slot[_capacity]),
+    heap(new uint16_t[_capacity]),
+    capacity(_capacity),
+    heapSize(0),
+    nextId(1),
+    alarm(nullptr),
+    handler(nullptr),
+    handlerContext(nullptr),
+    programmed(0),
+    dirty(false),
+    clockChanged(false),
+    baseNow(0),
+    baseMillis(0),
+    persist(false),
+    mutex(xSemaphoreCreateMutex()) {
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].used = false;
+        slots[i].heapIndex = -1;
+        slots[i].nextFire = 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+TimerScheduler::~TimerScheduler() {
+    delete[] slots;
+    delete[] heap;
+}
+
+void TimerScheduler::lock() const {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void TimerScheduler::unlock() const {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+// --- min-heap ---
+
+bool TimerScheduler::before(size_t a, size_t b) const {
+    return slots[heap[a]].nextFire < slots[heap[b]].nextFire;
+}
+
+void TimerScheduler::swapHeap(size_t a, size_t b) {
+    uint16_t tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+    slots[heap[a]].heapIndex = (int16_t)a;
+    slots[heap[b]].heapIndex = (int16_t)b;
+}
+
+void TimerScheduler::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!before(index, parent)) break;
+        swapHeap(index, parent);
+        index = parent;
+    }
+}
+
+void TimerScheduler::siftDown(size_t index) {
+    while (true) {
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        size_t smallest = index;
+        if (left < heapSize && before(left, smallest)) smallest = left;
+        if (right < heapSize && before(right, smallest)) smallest = right;
+        if (smallest == index) break;
+        swapHeap(index, smallest);
+        index = smallest;
+    }
+}
+
+void TimerScheduler::heapInsert(uint16_t slot) {
+    heap[heapSize] = slot;
+    slots[slot].heapIndex = (int16_t)heapSize;
+    heapSize++;
+    siftUp(heapSize - 1);
+}
+
+void TimerScheduler::heapRemove(uint16_t slot) {
+    int16_t index = slots[slot].heapIndex;
+    if (index < 0) return;
+    slots[slot].heapIndex = -1;
+    heapSize--;
+    if ((size_t)index == heapSize) return;
+
+    // Son eleman boşluğa taşınır; yukarı veya aşağı gitmesi gerekebilir
+    uint16_t moved = heap[heapSize];
+    heap[index] = moved;
+    slots[moved].heapIndex = index;
+    siftDown(index);
+    siftUp(slots[moved].heapIndex);
+}
+
+// --- kurallar ---
+
+uint32_t TimerScheduler::nextOccurrence(uint32_t after, uint8_t hour, uint8_t minute, uint8_t weekdays) {
+    uint32_t day = after / 86400;
+    uint32_t offset = (uint32_t)hour * 3600 + (uint32_t)minute * 60;
+    for (uint32_t d = 0; d <= 7; d++) {
+        uint32_t t = (day + d) * 86400 + offset;
+        if (t <= after) continue;
+        uint8_t dow = (uint8_t)((day + d + 4) % 7);     // 1 Ocak 1970 Perşembe
+        if (weekdays & (1 << dow)) return t;
+    }
+    return 0;
+}
+
+uint32_t TimerScheduler::estimateNow() const {
+    return baseNow + (uint32_t)((millis() - baseMillis) / 1000);
+}
+
+void TimerScheduler::noteNow(uint32_t now) {
+    baseNow = now;
+    baseMillis = millis();
+}
+
+int TimerScheduler::findLocked(uint16_t id) const {
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].used && slots[i].rule.id == id) return (int)i;
+    }
+    return -1;
+}
+
+void TimerScheduler::scheduleLocked(uint16_t slot, uint32_t after) {
+    Slot& s = slots[slot];
+    heapRemove(slot);
+
+    const TimerRule& rule = s.rule;
+    switch (rule.repeat) {
+        case TIMER_ONCE:
+            s.nextFire = rule.at;   // geçmişteyse hemen (kaçırılmış)
+            break;
+        case TIMER_DAILY:
+            s.nextFire = nextOccurrence(after, rule.hour, rule.minute, 0x7F);
+            break;
+        case TIMER_WEEKLY:
+            s.nextFire = nextOccurrence(after, rule.hour, rule.minute, rule.weekdays);
+            break;
+        case TIMER_SLEEP: {
+            uint32_t fadeStart = rule.at - rule.fadeSeconds;
+            uint32_t next = after < fadeStart ? fadeStart : after + TIMER_FADE_STEP_S;
+            s.nextFire = min(next, rule.at);
+            break;
+        }
+        default:
+            s.nextFire = 0;
+            break;
+    }
+
+    if (rule.enabled && s.nextFire != 0) {
+        heapInsert(slot);
+    }
+}
+
+void TimerScheduler::rebuildLocked(uint32_t now) {
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].heapIndex = -1;
+    }
+    heapSize = 0;
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].used) {
+            scheduleLocked((uint16_t)i, now);
+        }
+    }
+}
+
+void TimerScheduler::releaseLocked(uint16_t slot) {
+    heapRemove(slot);
+    slots[slot].used = false;
+    slots[slot].nextFire = 0;
+}
+
+void TimerScheduler::begin(TimerAlarm* _alarm, TimerHandler _handler, void* context, bool _persist) {
+    alarm = _alarm;
+    handler = _handler;
+    handlerContext = context;
+    persist = _persist;
+
+    if (persist) load();
+
+    uint32_t now = alarm ? alarm->now() : 0;
+    lock();
+    noteNow(now);
+    rebuildLocked(now);
+    unlock();
+
+    programmed = 0;
+    dirty = true;
+    Serial.printf("✅ Timer scheduler: %u kural\n", (unsigned)size());
+}
+
+int TimerScheduler::add(const TimerRule& rule) {
+    lock();
+    int free = -1;
+    for (size_t i = 0; i < capacity; i++) {
+        if (!slots[i].used) {
+            free = (int)i;
+            break;
+        }
+    }
+    if (free < 0) {
+        unlock();
+        Serial.println("❌ Timer tablosu dolu");
+        return -1;
+    }
+
+    Slot& s = slots[free];
+    s.rule = rule;
+    s.rule.id = nextId++;
+    if (nextId == 0) nextId = 1;
+    s.used = true;
+    s.heapIndex = -1;
+    scheduleLocked((uint16_t)free, estimateNow());
+    int id = s.rule.id;
+    unlock();
+
+    dirty = true;
+    if (rule.repeat != TIMER_SLEEP) save();
+    return id;
+}
+
+int TimerScheduler::addOnce(uint32_t at, uint8_t action) {
+    TimerRule rule = {};
+    rule.repeat = TIMER_ONCE;
+    rule.action = action;
+    rule.enabled = true;
+    rule.at = at;
+    return add(rule);
+}
+
+int TimerScheduler::addDaily(uint8_t hour, uint8_t minute, uint8_t action) {
+    TimerRule rule = {};
+    rule.repeat = TIMER_DAILY;
+    rule.action = action;
+    rule.hour = hour;
+    rule.minute = minute;
+    rule.enabled = true;
+    return add(rule);
+}
+
+int TimerScheduler::addWeekly(uint8_t weekdays, uint8_t hour, uint8_t minute, uint8_t action) {
+    TimerRule rule = {};
+    rule.repeat = TIMER_WEEKLY;
+    rule.action = action;
+    rule.weekdays = weekdays & 0x7F;
+    rule.hour = hour;
+    rule.minute = minute;
+    rule.enabled = true;
+    return add(rule);
+}
+
+int TimerScheduler::startSleep(uint32_t seconds, uint16_t fadeSeconds) {
+    // Tek uyku zamanlayıcısı; yenisi eskisinin yerine geçer
+    lock();
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].used && slots[i].rule.repeat == TIMER_SLEEP) {
+            releaseLocked((uint16_t)i);
+        }
+    }
+    uint32_t now = estimateNow();
+    unlock();
+    dirty = true;
+
+    if (seconds == 0) return 0;
+
+    TimerRule rule = {};
+    rule.repeat = TIMER_SLEEP;
+    rule.action = TIMER_ACTION_STOP;
+    rule.enabled = true;
+    rule.fadeSeconds = (uint16_t)min((uint32_t)fadeSeconds, seconds);
+    rule.at = now + seconds;
+    return add(rule);
+}
+
+bool TimerScheduler::remove(uint16_t id) {
+    lock();
+    int slot = findLocked(id);
+    if (slot < 0) {
+        unlock();
+        return false;
+    }
+    bool sleep = slots[slot].rule.repeat == TIMER_SLEEP;
+    releaseLocked((uint16_t)slot);
+    unlock();
+
+    dirty = true;
+    if (!sleep) save();
+    return true;
+}
+
+bool TimerScheduler::setEnabled(uint16_t id, bool enabled) {
+    lock();
+    int slot = findLocked(id);
+    if (slot < 0) {
+        unlock();
+        return false;
+    }
+    slots[slot].rule.enabled = enabled;
+    scheduleLocked((uint16_t)slot, estimateNow());
+    unlock();
+
+    dirty = true;
+    save();
+    return true;
+}
+
+uint32_t TimerScheduler::getNextDeadline() const {
+    lock();
+    uint32_t deadline = heapSize ? slots[heap[0]].nextFire : 0;
+    unlock();
+    return deadline;
+}
+
+size_t TimerScheduler::size() const {
+    lock();
+    size_t count = 0;
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].used) count++;
+    }
+    unlock();
+    return count;
+}
+
+// --- tetikleme ---
+
+uint32_t TimerScheduler::runDue(uint32_t now) {
+    uint32_t count = 0;
+    while (true) {
+        lock();
+        if (heapSize == 0 || slots[heap[0]].nextFire > now) {
+            unlock();
+            break;
+        }
+
+        uint16_t slot = heap[0];
+        Slot& s = slots[slot];
+        TimerEvent event;
+        event.id = s.rule.id;
+        event.action = s.rule.action;
+        event.level = 100;
+        event.at = s.nextFire;
+        bool removed = false;
+
+        switch (s.rule.repeat) {
+            case TIMER_DAILY:
+            case TIMER_WEEKLY:
+                // Uzun bir kesintiden sonra kaçırılanlar tek olayda birleşir
+                scheduleLocked(slot, max(event.at, now));
+                break;
+            case TIMER_SLEEP:
+                if (event.at >= s.rule.at) {
+                    event.action = TIMER_ACTION_STOP;
+                    event.level = 0;
+                    releaseLocked(slot);
+                } else {
+                    event.action = TIMER_ACTION_FADE;
+                    uint32_t left = s.rule.at - event.at;
+                    event.level = (uint8_t)min((uint32_t)100, left * 100 / max((uint32_t)s.rule.fadeSeconds, (uint32_t)1));
+                    scheduleLocked(slot, max(event.at, now));
+                }
+                break;
+            default:
+                releaseLocked(slot);
+                removed = true;
+                break;
+        }
+        stats.fired++;
+        unlock();
+
+        if (removed) save();
+        if (handler) handler(event, handlerContext);
+        count++;
+    }
+    return count;
+}
+
+void TimerScheduler::loop() {
+    if (!alarm) return;
+
+    // Olay yokken tek maliyet bu kontrol; RTC okunmaz
+    bool wake = alarm->fired();
+    if (!wake && !dirty && !clockChanged) {
+        return;
+    }
+
+    uint32_t now = alarm->now();
+    if (wake) {
+        alarm->acknowledge();
+        stats.wakeups++;
+    }
+    dirty = false;
+
+    lock();
+    noteNow(now);
+    if (clockChanged) {
+        clockChanged = false;
+        rebuildLocked(now);
+    }
+    unlock();
+
+    uint32_t fired = runDue(now);
+    if (wake && fired == 0) stats.spurious++;
+
+    programAlarm();
+
+    // Alarm 1 saniye çözünürlüklü ve eşleşmeyle çalışır: çok yakın bir an
+    // yazılırken geçebilir, o durumda bir sonraki loop()'ta tekrar bakılır
+    uint32_t deadline = getNextDeadline();
+    if (deadline != 0 && deadline <= now + 1) {
+        dirty = true;
+    }
+}
+
+void TimerScheduler::programAlarm() {
+    uint32_t deadline = getNextDeadline();
+    if (deadline == programmed) return;
+    alarm->program(deadline);
+    programmed = deadline;
+    stats.programs++;
+}
+
+// --- kalıcılık (uyku zamanlayıcısı hariç) ---
+
+void TimerScheduler::save() {
+    if (!persist) return;
+
+    TimerRule* rules = (TimerRule*)malloc(capacity * sizeof(TimerRule));
+    if (!rules) return;
+    size_t count = 0;
+    lock();
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].used && slots[i].rule.repeat != TIMER_SLEEP) {
+            rules[count++] = slots[i].rule;
+        }
+    }
+    unlock();
+
+    Preferences prefs;
+    if (prefs.begin(TIMER_PREFS_NAMESPACE, false)) {
+        if (count) {
+            prefs.putBytes("rules", rules, count * sizeof(TimerRule));
+        } else {
+            prefs.remove("rules");
+        }
+        prefs.end();
+    }
+    free(rules);
+}
+
+void TimerScheduler::load() {
+    Preferences prefs;
+    if (!prefs.begin(TIMER_PREFS_NAMESPACE, true)) {
+        return;
+    }
+    size_t length = prefs.getBytesLength("rules");
+    size_t count = min(length / sizeof(TimerRule), capacity);
+    TimerRule* rules = count ? (TimerRule*)malloc(length) : nullptr;
+    if (rules && prefs.getBytes("rules", rules, length) == length) {
+        lock();
+        for (size_t i = 0; i < count; i++) {
+            slots[i].rule = rules[i];
+            slots[i].used = true;
+            slots[i].heapIndex = -1;
+            if (rules[i].id >= nextId) nextId = rules[i].id + 1;
+        }
+        unlock();
+    }
+    free(rules);
+    prefs.end();
+}
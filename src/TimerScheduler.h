@@ -0,0 +1,186 @@
+#ifndef TIMER_SCHEDULER_H
+#define TIMER_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Zamanlayıcılar (alarm, tekrar eden çalma/durdurma, uyku zamanlayıcısı).
+//
+// Kurallar bir sonraki tetiklenme anına göre min-heap'te tutulur; en
+// yakın an DS3231'in Alarm 1'ine yazılır ve INT/SQW kesmesi gelene kadar
+// loop() sadece bir bayrağa bakar. RTC sadece alarm geldiğinde bir kez
+// okunur, DAC ile paylaşılan I2C bus'ında periyodik trafik yoktur.
+// Tetiklenen tekrar eden kural yeniden hesaplanıp heap'e geri konur:
+// olay başına O(log n), olay yokken O(1).
+//
+// Zamanlar RTC'nin yerel saatiyle (DateTime::unixtime()) ifade edilir.
+
+#define TIMER_MAX_TIMERS        32
+#define TIMER_FADE_STEP_S       2       // uyku zamanlayıcısında ses adımı
+#define TIMER_PREFS_NAMESPACE   "timers"
+
+enum TimerRepeat : uint8_t {
+    TIMER_ONCE = 0,         // at
+    TIMER_DAILY,            // hour:minute
+    TIMER_WEEKLY,           // weekdays maskesi (bit 0 = Pazar) + hour:minute
+    TIMER_SLEEP             // at'te durdur, fadeSeconds önceden sesi kıs
+};
+
+enum TimerAction : uint8_t {
+    TIMER_ACTION_PLAY = 0,
+    TIMER_ACTION_STOP,
+    TIMER_ACTION_FADE       // sadece uyku zamanlayıcısı üretir
+};
+
+#define TIMER_WEEKDAYS  0x3E    // Pzt-Cum
+#define TIMER_WEEKENDS  0x41    // Cmt-Paz
+
+struct TimerRule {
+    uint16_t id;
+    uint8_t repeat;
+    uint8_t action;
+    uint8_t weekdays;
+    uint8_t hour;
+    uint8_t minute;
+    bool enabled;
+    uint16_t fadeSeconds;
+    uint32_t at;            // ONCE/SLEEP: mutlak zaman
+};
+
+struct TimerEvent {
+    uint16_t id;
+    uint8_t action;
+    uint8_t level;          // FADE: başlangıç sesinin yüzdesi
+    uint32_t at;
+};
+
+typedef void (*TimerHandler)(const TimerEvent& event, void* context);
+
+// Bir sonraki tetiklenme anını donanıma yazan saat. ESP32'de
+// Ds3231TimerAlarm, host'ta simüle saat.
+class TimerAlarm {
+public:
+    virtual ~TimerAlarm() {}
+
+    // Şimdiki yerel zaman (RTC okuması)
+    virtual uint32_t now() = 0;
+
+    // Alarmı deadline'a kurar; 0 alarmı kapatır
+    virtual void program(uint32_t deadline) = 0;
+
+    // Alarm kesmesi geldi mi; I2C'ye dokunmaz
+    virtual bool fired() = 0;
+
+    // Kesme bayrağını ve RTC'deki alarm bayrağını temizler
+    virtual void acknowledge() = 0;
+};
+
+struct TimerSchedulerStats {
+    uint32_t fired;
+    uint32_t wakeups;           // alarm kesmesiyle yapılan RTC okumaları
+    uint32_t spurious;          // uyanıldı ama vadesi gelen yoktu
+    uint32_t programs;          // alarm yazmaları
+};
+
+class TimerScheduler {
+private:
+    struct Slot {
+        TimerRule rule;
+        uint32_t nextFire;
+        int16_t heapIndex;      // -1: heap'te değil (kapalı)
+        bool used;
+    };
+
+    Slot* slots;
+    uint16_t* heap;             // slot indeksleri, nextFire'a göre min-heap
+    size_t capacity;
+    size_t heapSize;
+    uint16_t nextId;
+
+    TimerAlarm* alarm;
+    TimerHandler handler;
+    void* handlerContext;
+    uint32_t programmed;        // alarma yazılı son an
+    volatile bool dirty;        // kurallar değişti, alarm yeniden yazılmalı
+    volatile bool clockChanged;
+    uint32_t baseNow;           // son RTC okuması ve o anki millis()
+    unsigned long baseMillis;
+    bool persist;
+
+    TimerSchedulerStats stats;
+    SemaphoreHandle_t mutex;
+
+    void lock() const;
+    void unlock() const;
+
+    bool before(size_t a, size_t b) const;
+    void swapHeap(size_t a, size_t b);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void heapInsert(uint16_t slot);
+    void heapRemove(uint16_t slot);
+
+    uint32_t estimateNow() const;
+    void noteNow(uint32_t now);
+    int findLocked(uint16_t id) const;
+    void scheduleLocked(uint16_t slot, uint32_t after);
+    void rebuildLocked(uint32_t now);
+    void releaseLocked(uint16_t slot);
+    void programAlarm();
+    void save();
+    void load();
+
+public:
+    explicit TimerScheduler(size_t capacity = TIMER_MAX_TIMERS);
+    ~TimerScheduler();
+
+    // alarm null olabilir (sadece runDue() ile sürülür)
+    void begin(TimerAlarm* alarm, TimerHandler handler, void* context = nullptr, bool persist = true);
+
+    // Alarm kesmesi gelmediyse hemen döner
+    void loop();
+
+    // now'a kadar vadesi gelenleri tetikler; tetiklenen olay sayısı
+    uint32_t runDue(uint32_t now);
+
+    // NTP senkronu veya saat dilimi değişince; sonraki loop()'ta
+    // tüm anlar yeniden hesaplanır
+    void notifyClockChanged() { clockChanged = true; }
+
+    // Herhangi bir task'tan; kural id'si, yer yoksa -1
+    int add(const TimerRule& rule);
+    int addOnce(uint32_t at, uint8_t action);
+    int addDaily(uint8_t hour, uint8_t minute, uint8_t action);
+    int addWeekly(uint8_t weekdays, uint8_t hour, uint8_t minute, uint8_t action);
+
+    // Mevcut uyku zamanlayıcısını değiştirir; seconds == 0 iptal eder
+    int startSleep(uint32_t seconds, uint16_t fadeSeconds);
+
+    bool remove(uint16_t id);
+    bool setEnabled(uint16_t id, bool enabled);
+
+    // Kurallar kilit altında sırayla verilir (kopya vektör oluşmaz)
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        lock();
+        for (size_t i = 0; i < capacity; i++) {
+            if (slots[i].used) {
+                fn(slots[i].rule, slots[i].nextFire);
+            }
+        }
+        unlock();
+    }
+
+    // En yakın tetiklenme anı, yoksa 0
+    uint32_t getNextDeadline() const;
+    size_t size() const;
+    const TimerSchedulerStats& getStats() const { return stats; }
+
+    // Yerel zamandan sonraki ilk hour:minute (weekdays maskesine uyan)
+    static uint32_t nextOccurrence(uint32_t after, uint8_t hour, uint8_t minute, uint8_t weekdays);
+};
+
+extern TimerScheduler timerScheduler;
+
+#endif // TIMER_SCHEDULER_H
@@ -0,0 +1,201 @@
+#include "Trace.h"
+
+#if TRACE_ENABLED
+
+Tracer tracer;
+
+Tracer::Tracer() :
+    pauseDepth(0),
+    dropped(0) {
+    for (size_t c = 0; c < TRACE_CORES; c++) {
+        heads[c].store(0, std::memory_order_relaxed);
+        floors[c].store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < TRACE_RING_EVENTS; i++) {
+            rings[c][i].seq.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < TRACE_MAX_TASKS; i++) {
+        taskHandles[i].store(nullptr, std::memory_order_relaxed);
+        taskNamed[i].store(false, std::memory_order_relaxed);
+        taskNames[i][0] = '\0';
+    }
+}
+
+// Task'lar ilk olaylarında kendilerini kaydeder; adı kaydeden task kendisi
+// olduğundan pcTaskGetName() silinmiş bir handle'a bakmaz
+uint8_t Tracer::taskIndex() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (uint8_t i = 0; i < TRACE_MAX_TASKS - 1; i++) {
+        TaskHandle_t handle = taskHandles[i].load(std::memory_order_acquire);
+        if (handle == self) return i;
+        if (handle != nullptr) continue;
+
+        TaskHandle_t expected = nullptr;
+        if (taskHandles[i].compare_exchange_strong(expected, self, std::memory_order_acq_rel)) {
+            const char* name = pcTaskGetName(nullptr);
+            size_t n = 0;
+            // JSON'a kaçışsız yazılır
+            for (; name[n] && n < TRACE_TASK_NAME - 1; n++) {
+                char c = name[n];
+                taskNames[i][n] = (c == '"' || c == '\\' || c < ' ') ? '_' : c;
+            }
+            taskNames[i][n] = '\0';
+            taskNamed[i].store(true, std::memory_order_release);
+            return i;
+        }
+        if (expected == self) return i;
+    }
+    return TRACE_MAX_TASKS - 1;
+}
+
+void Tracer::clear() {
+    for (size_t c = 0; c < TRACE_CORES; c++) {
+        floors[c].store(heads[c].load(std::memory_order_acquire), std::memory_order_release);
+    }
+    dropped.store(0, std::memory_order_relaxed);
+}
+
+uint32_t Tracer::firstIndex(uint8_t core) const {
+    uint32_t end = heads[core].load(std::memory_order_acquire);
+    uint32_t floor = floors[core].load(std::memory_order_acquire);
+    uint32_t oldest = end > TRACE_RING_EVENTS ? end - TRACE_RING_EVENTS : 0;
+    return floor > oldest ? floor : oldest;
+}
+
+bool Tracer::read(uint8_t core, uint32_t index, TraceRecord& out) const {
+    const TraceEvent& event = rings[core][index & (TRACE_RING_EVENTS - 1)];
+    if (event.seq.load(std::memory_order_acquire) != index + 1) return false;
+    out.timestampUs = event.timestampUs;
+    out.name = event.name;
+    out.phase = event.phase;
+    out.task = event.task;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return event.seq.load(std::memory_order_relaxed) == index + 1;
+}
+
+const char* Tracer::taskName(uint8_t task) const {
+    if (task == TRACE_MAX_TASKS - 1) return "other";
+    if (task >= TRACE_MAX_TASKS || !taskNamed[task].load(std::memory_order_acquire)) return nullptr;
+    return taskNames[task];
+}
+
+// --- TraceStream ---
+
+enum TraceStreamStage : uint8_t {
+    TRACE_STAGE_HEADER,
+    TRACE_STAGE_TASKS,
+    TRACE_STAGE_EVENTS,
+    TRACE_STAGE_FOOTER,
+    TRACE_STAGE_DONE
+};
+
+TraceStream::TraceStream(Tracer& _tracer) :
+    tracer(_tracer),
+    stage(TRACE_STAGE_HEADER),
+    core(0),
+    index(0),
+    baseUs(0),
+    pendingLength(0),
+    pendingPos(0) {
+    tracer.pause();
+
+    // Taban: halkalardaki en eski olay
+    uint32_t now = micros();
+    uint32_t oldestAge = 0;
+    for (uint8_t c = 0; c < TRACE_CORES; c++) {
+        ends[c] = tracer.endIndex(c);
+        TraceRecord record;
+        for (uint32_t i = tracer.firstIndex(c); i < ends[c]; i++) {
+            if (tracer.read(c, i, record)) {
+                if (now - record.timestampUs > oldestAge) oldestAge = now - record.timestampUs;
+                break;
+            }
+        }
+    }
+    baseUs = now - oldestAge;
+}
+
+TraceStream::~TraceStream() {
+    tracer.resume();
+}
+
+bool TraceStream::nextLine() {
+    // Başlık process_name ile biter; sonraki her olay virgülle başlar
+    const char* sep = ",\n";
+    while (true) {
+        switch (stage) {
+            case TRACE_STAGE_HEADER:
+                pendingLength = snprintf(pending, sizeof(pending),
+                    "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"musicbox\"}}");
+                stage = TRACE_STAGE_TASKS;
+                index = 0;
+                return true;
+
+            case TRACE_STAGE_TASKS: {
+                if (index >= TRACE_MAX_TASKS) {
+                    stage = TRACE_STAGE_EVENTS;
+                    core = 0;
+                    index = tracer.firstIndex(0);
+                    continue;
+                }
+                uint8_t task = (uint8_t)index++;
+                const char* name = tracer.taskName(task);
+                if (!name) continue;
+                pendingLength = snprintf(pending, sizeof(pending),
+                    "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    sep, (unsigned)task + 1, name);
+                return true;
+            }
+
+            case TRACE_STAGE_EVENTS: {
+                if (core >= TRACE_CORES) {
+                    stage = TRACE_STAGE_FOOTER;
+                    continue;
+                }
+                if (index >= ends[core]) {
+                    core++;
+                    if (core < TRACE_CORES) index = tracer.firstIndex(core);
+                    continue;
+                }
+                TraceRecord record;
+                if (!tracer.read(core, index++, record)) continue;
+                // Anlık olay task şeridinde çizilir ("s":"t")
+                pendingLength = snprintf(pending, sizeof(pending),
+                    "%s{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%lu,\"pid\":1,\"tid\":%u,\"args\":{\"core\":%u}}",
+                    sep, record.name, (char)record.phase,
+                    record.phase == TRACE_PHASE_INSTANT ? "\"s\":\"t\"," : "",
+                    (unsigned long)(record.timestampUs - baseUs), (unsigned)record.task + 1, (unsigned)core);
+                return true;
+            }
+
+            case TRACE_STAGE_FOOTER:
+                pendingLength = snprintf(pending, sizeof(pending),
+                    "\n],\"otherData\":{\"dropped\":%lu,\"ring_events\":%u}}\n",
+                    (unsigned long)tracer.getDropped(), (unsigned)TRACE_RING_EVENTS);
+                stage = TRACE_STAGE_DONE;
+                return true;
+
+            default:
+                return false;
+        }
+    }
+}
+
+size_t TraceStream::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (pendingPos >= pendingLength) {
+            if (!nextLine()) break;
+            if (pendingLength >= sizeof(pending)) pendingLength = sizeof(pending) - 1;
+            pendingPos = 0;
+        }
+        size_t n = min(pendingLength - pendingPos, maxLen - written);
+        memcpy(buffer + written, pending + pendingPos, n);
+        pendingPos += n;
+        written += n;
+    }
+    return written;
+}
+
+#endif // TRACE_ENABLED
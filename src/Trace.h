@@ -0,0 +1,183 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Sıcak yol izleme: decode, SD okuması, DAC burst'ü, HTTP handler'ları
+// birbirine göre ne zaman çalıştı. TRACE_ENABLED=1 ile derlenir
+// (platformio.ini build_flags); kapalıyken makrolar hiçbir şey üretmez,
+// halka tamponları ve /api/trace gövdesi de derlenmez.
+//
+// Olaylar core başına bir halkaya yazılır. Yer fetch_add ile ayrılır, slot
+// sürüm numarasıyla işaretlenir; aynı core'daki task'lar birbirini kesse de
+// kilit yoktur, okuyucu yarım yazılmış slotu atlar. Halka dolunca en eski
+// olaylar ezilir: çalarken ses core'unda son ~100 ms elde olur.
+//
+// İsimler statik metin olmalıdır (literal, route uri'si); olay sadece
+// işaretçiyi saklar.
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+// Örnek başına izleme (ConsumeSample); halkayı ms'ler içinde doldurur,
+// sadece kısa bir glitch'e bakarken açılır
+#ifndef TRACE_VERBOSE
+#define TRACE_VERBOSE 0
+#endif
+
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS   1024    // core başına, 2'nin kuvveti; olay 16 byte
+#endif
+#define TRACE_CORES         2
+#define TRACE_MAX_TASKS     16      // son slot tanınmayan task'lar için
+#define TRACE_TASK_NAME     16
+#define TRACE_LINE_SIZE     160
+
+enum TracePhase : uint8_t {
+    TRACE_PHASE_BEGIN   = 'B',
+    TRACE_PHASE_END     = 'E',
+    TRACE_PHASE_INSTANT = 'i'
+};
+
+#if TRACE_ENABLED
+
+struct TraceEvent {
+    std::atomic<uint32_t> seq;  // yazım bitince index + 1; 0: boş/yazılıyor
+    uint32_t timestampUs;
+    const char* name;
+    uint8_t phase;
+    uint8_t task;
+};
+
+// Okuyucunun tutarlı kopyası
+struct TraceRecord {
+    uint32_t timestampUs;
+    const char* name;
+    uint8_t phase;
+    uint8_t task;
+};
+
+class Tracer {
+private:
+    TraceEvent rings[TRACE_CORES][TRACE_RING_EVENTS];
+    std::atomic<uint32_t> heads[TRACE_CORES];
+    std::atomic<uint32_t> floors[TRACE_CORES];     // clear() sonrası ilk geçerli index
+
+    std::atomic<TaskHandle_t> taskHandles[TRACE_MAX_TASKS];
+    std::atomic<bool> taskNamed[TRACE_MAX_TASKS];
+    char taskNames[TRACE_MAX_TASKS][TRACE_TASK_NAME];
+
+    std::atomic<uint8_t> pauseDepth;
+    std::atomic<uint32_t> dropped;
+
+    uint8_t taskIndex();
+
+public:
+    Tracer();
+
+    void record(const char* name, uint8_t phase) {
+        if (pauseDepth.load(std::memory_order_relaxed)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        uint8_t core = (uint8_t)xPortGetCoreID() % TRACE_CORES;
+        uint32_t index = heads[core].fetch_add(1, std::memory_order_relaxed);
+        TraceEvent& event = rings[core][index & (TRACE_RING_EVENTS - 1)];
+        event.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        event.timestampUs = micros();
+        event.name = name;
+        event.phase = phase;
+        event.task = taskIndex();
+        event.seq.store(index + 1, std::memory_order_release);
+    }
+
+    // Dışa aktarma sırasında yeni olaylar sayılıp atılır; halka
+    // okunurken ezilmez. İç içe çağrılabilir.
+    void pause() { pauseDepth.fetch_add(1, std::memory_order_acq_rel); }
+    void resume() { pauseDepth.fetch_sub(1, std::memory_order_acq_rel); }
+
+    // Mevcut olayları gizler; slotlara dokunmaz
+    void clear();
+
+    // Okuma aralığı [first, end); index'teki olay ezilmiş veya yazılıyorsa false
+    uint32_t firstIndex(uint8_t core) const;
+    uint32_t endIndex(uint8_t core) const { return heads[core].load(std::memory_order_acquire); }
+    bool read(uint8_t core, uint32_t index, TraceRecord& out) const;
+
+    // Kayıtlı task adı; boş slot için nullptr
+    const char* taskName(uint8_t task) const;
+
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+extern Tracer tracer;
+
+// Kapsam boyunca B/E çifti
+class TraceScope {
+private:
+    const char* name;
+
+public:
+    explicit TraceScope(const char* _name) :
+        name(_name) {
+        tracer.record(name, TRACE_PHASE_BEGIN);
+    }
+    ~TraceScope() {
+        tracer.record(name, TRACE_PHASE_END);
+    }
+};
+
+// /api/trace gövdesi: Chrome trace_event JSON'u (chrome://tracing,
+// ui.perfetto.dev). Akış boyunca kayıt durur; zaman damgaları en eski
+// olaya göre, böylece micros() taşması araya girmez.
+class TraceStream {
+private:
+    Tracer& tracer;
+    uint8_t stage;
+    uint8_t core;
+    uint32_t index;
+    uint32_t ends[TRACE_CORES];
+    uint32_t baseUs;
+
+    char pending[TRACE_LINE_SIZE];
+    size_t pendingLength;
+    size_t pendingPos;
+
+    bool nextLine();
+
+public:
+    explicit TraceStream(Tracer& tracer);
+    ~TraceStream();
+
+    // Tampona en fazla maxLen byte yazar; 0 dönünce akış bitmiştir
+    size_t fill(uint8_t* buffer, size_t maxLen);
+};
+
+#define TRACE_CONCAT_(a, b)     a##b
+#define TRACE_CONCAT(a, b)      TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name)       TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_BEGIN(name)       tracer.record((name), TRACE_PHASE_BEGIN)
+#define TRACE_END(name)         tracer.record((name), TRACE_PHASE_END)
+#define TRACE_INSTANT(name)     tracer.record((name), TRACE_PHASE_INSTANT)
+
+#else
+
+#define TRACE_SCOPE(name)       ((void)0)
+#define TRACE_BEGIN(name)       ((void)0)
+#define TRACE_END(name)         ((void)0)
+#define TRACE_INSTANT(name)     ((void)0)
+
+#endif // TRACE_ENABLED
+
+#if TRACE_ENABLED && TRACE_VERBOSE
+#define TRACE_SCOPE_VERBOSE(name)   TRACE_SCOPE(name)
+#else
+#define TRACE_SCOPE_VERBOSE(name)   ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,564 @@
+#include "TrackMetadata.h"
+#include "LibraryIndex.h"
+
+static uint16_t be16(const uint8_t* p) { return ((uint16_t)p[0] << 8) | p[1]; }
+static uint32_t be24(const uint8_t* p) { return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2]; }
+static uint32_t be32(const uint8_t* p) { return ((uint32_t)p[0] << 24) | be24(p + 1); }
+static uint64_t be64(const uint8_t* p) { return ((uint64_t)be32(p) << 32) | be32(p + 4); }
+static uint16_t le16(const uint8_t* p) { return p[0] | ((uint16_t)p[1] << 8); }
+static uint32_t le32(const uint8_t* p) { return le16(p) | ((uint32_t)le16(p + 2) << 16); }
+
+// ID3v2 boyutları 7-bit'lik byte'larla yazılır
+static uint32_t syncsafe(const uint8_t* p) {
+    return ((uint32_t)(p[0] & 0x7F) << 21) | ((uint32_t)(p[1] & 0x7F) << 14) |
+           ((uint32_t)(p[2] & 0x7F) << 7) | (p[3] & 0x7F);
+}
+
+static size_t readAt(File& file, uint32_t pos, uint8_t* data, size_t length) {
+    if (!file.seek(pos)) return 0;
+    return file.read(data, length);
+}
+
+// Windows-1254'ün ISO-8859-1'den ayrıldığı Türkçe harfler
+static uint32_t legacyCodepoint(uint8_t b) {
+#if TRACK_LEGACY_CODEPAGE == 1254
+    switch (b) {
+        case 0xD0: return 0x011E;   // Ğ
+        case 0xDD: return 0x0130;   // İ
+        case 0xDE: return 0x015E;   // Ş
+        case 0xF0: return 0x011F;   // ğ
+        case 0xFD: return 0x0131;   // ı
+        case 0xFE: return 0x015F;   // ş
+    }
+#endif
+    return b;
+}
+
+// Sığmayan kod noktası yazılmaz; false dönünce çıktı doludur
+static bool putCodepoint(char* out, size_t& n, uint32_t cp) {
+    if (cp < 0x20) cp = ' ';
+    uint8_t bytes[4];
+    size_t count;
+    if (cp < 0x80) {
+        bytes[0] = (uint8_t)cp;
+        count = 1;
+    } else if (cp < 0x800) {
+        bytes[0] = 0xC0 | (cp >> 6);
+        bytes[1] = 0x80 | (cp & 0x3F);
+        count = 2;
+    } else if (cp < 0x10000) {
+        bytes[0] = 0xE0 | (cp >> 12);
+        bytes[1] = 0x80 | ((cp >> 6) & 0x3F);
+        bytes[2] = 0x80 | (cp & 0x3F);
+        count = 3;
+    } else {
+        bytes[0] = 0xF0 | (cp >> 18);
+        bytes[1] = 0x80 | ((cp >> 12) & 0x3F);
+        bytes[2] = 0x80 | ((cp >> 6) & 0x3F);
+        bytes[3] = 0x80 | (cp & 0x3F);
+        count = 4;
+    }
+    if (n + count > TRACK_TAG_MAX) return false;
+    memcpy(out + n, bytes, count);
+    n += count;
+    return true;
+}
+
+// Geçerli UTF-8 dizisinin uzunluğu; geçersizse 0
+static size_t utf8Sequence(const uint8_t* p, size_t length, uint32_t& cp) {
+    uint8_t c = p[0];
+    size_t count = c >= 0xF0 && c < 0xF5 ? 4 : c >= 0xE0 ? 3 : c >= 0xC2 && c < 0xE0 ? 2 : 0;
+    if (count == 0 || count > length) return 0;
+    cp = c & (0xFF >> (count + 1));
+    for (size_t i = 1; i < count; i++) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    return count;
+}
+
+void TrackMetadata::decodeText(uint8_t encoding, const uint8_t* data, size_t length, char* out) {
+    size_t n = 0;
+
+    if (encoding == 1 || encoding == 2) {
+        bool bigEndian = encoding == 2;
+        size_t i = 0;
+        if (length >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+            bigEndian = false;
+            i = 2;
+        } else if (length >= 2 && data[0] == 0xFE && data[1] == 0xFF) {
+            bigEndian = true;
+            i = 2;
+        }
+        for (; i + 1 < length; i += 2) {
+            uint32_t unit = bigEndian ? be16(data + i) : le16(data + i);
+            if (unit == 0) break;
+            uint32_t cp = unit;
+            if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < length) {
+                uint32_t low = bigEndian ? be16(data + i + 2) : le16(data + i + 2);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                    i += 2;
+                } else {
+                    cp = 0xFFFD;
+                }
+            } else if (unit >= 0xD800 && unit < 0xE000) {
+                cp = 0xFFFD;
+            }
+            if (!putCodepoint(out, n, cp)) break;
+        }
+    } else {
+        // UTF-8; geçersiz byte'lar (ID3v1, RIFF INFO'daki eski kodlamalar)
+        // TRACK_LEGACY_CODEPAGE sayılır
+        for (size_t i = 0; i < length && data[i]; ) {
+            uint32_t cp = legacyCodepoint(data[i]);
+            size_t count = 1;
+            if (encoding == 3 && data[i] >= 0x80) {
+                uint32_t utf8;
+                size_t sequence = utf8Sequence(data + i, length - i, utf8);
+                if (sequence) {
+                    cp = utf8;
+                    count = sequence;
+                }
+            }
+            if (!putCodepoint(out, n, cp)) break;
+            i += count;
+        }
+    }
+
+    while (n > 0 && out[n - 1] == ' ') n--;
+    out[n] = '\0';
+}
+
+void TrackMetadata::clear(TrackTags& out) {
+    out.durationMs = 0;
+    out.bitrateKbps = 0;
+    out.title[0] = '\0';
+    out.artist[0] = '\0';
+    out.album[0] = '\0';
+}
+
+bool TrackMetadata::read(File& file, uint8_t format, TrackTags& out) {
+    clear(out);
+    switch (format) {
+        case LIBRARY_FORMAT_MP3: return readMp3(file, out);
+        case LIBRARY_FORMAT_WAV: return readWav(file, out);
+        case LIBRARY_FORMAT_M4A: return readM4a(file, out);
+        // .aac çoğunlukla ADTS, bazen uzantısı değişmiş bir MP4
+        case LIBRARY_FORMAT_AAC: return readAdts(file, out) || readM4a(file, out);
+        default: return false;
+    }
+}
+
+// --- ID3 ---
+
+// Unsynchronisation: 0xFF'ten sonra eklenen 0x00'ları çıkarır
+static size_t undoUnsync(uint8_t* data, size_t length) {
+    size_t out = 0;
+    for (size_t i = 0; i < length; i++) {
+        data[out++] = data[i];
+        if (data[i] == 0xFF && i + 1 < length && data[i + 1] == 0x00) i++;
+    }
+    return out;
+}
+
+// Etiketi okur, ses verisinin başladığı konumu döndürür (etiket yoksa 0)
+uint32_t TrackMetadata::readId3v2(File& file, TrackTags& out) {
+    uint8_t header[10];
+    if (readAt(file, 0, header, sizeof(header)) != sizeof(header) || memcmp(header, "ID3", 3) != 0) {
+        return 0;
+    }
+    uint8_t version = header[3];
+    uint8_t flags = header[5];
+    if (version < 2 || version > 4 || ((header[6] | header[7] | header[8] | header[9]) & 0x80)) {
+        return 0;
+    }
+    uint32_t tagEnd = 10 + syncsafe(header + 6);
+    uint32_t audioStart = tagEnd + ((version == 4 && (flags & 0x10)) ? 10 : 0);
+    bool tagUnsync = flags & 0x80;
+
+    // v2.2'de bu bit sıkıştırma demektir; etiket okunamaz
+    if (version == 2 && (flags & 0x40)) {
+        return audioStart;
+    }
+
+    uint32_t pos = 10;
+    if (version >= 3 && (flags & 0x40)) {
+        uint8_t ext[4];
+        if (readAt(file, pos, ext, sizeof(ext)) != sizeof(ext)) return audioStart;
+        pos += version == 4 ? syncsafe(ext) : be32(ext) + 4;
+    }
+
+    static const char* const ids22[3] = { "TT2", "TP1", "TAL" };
+    static const char* const ids23[3] = { "TIT2", "TPE1", "TALB" };
+    char* targets[3] = { out.title, out.artist, out.album };
+    size_t headerSize = version == 2 ? 6 : 10;
+    size_t found = 0;
+
+    while (pos + headerSize <= tagEnd && found < 3) {
+        uint8_t frame[10];
+        if (readAt(file, pos, frame, headerSize) != headerSize || frame[0] == 0) {
+            break;      // padding
+        }
+
+        uint32_t frameSize;
+        int target = -1;
+        bool readable = true;
+        bool frameUnsync = tagUnsync;
+        uint32_t skip = 0;
+
+        if (version == 2) {
+            frameSize = be24(frame + 3);
+            for (int i = 0; i < 3; i++) {
+                if (memcmp(frame, ids22[i], 3) == 0) target = i;
+            }
+        } else {
+            frameSize = version == 4 ? syncsafe(frame + 4) : be32(frame + 4);
+            for (int i = 0; i < 3; i++) {
+                if (memcmp(frame, ids23[i], 4) == 0) target = i;
+            }
+            uint8_t format = frame[9];
+            if (version == 3) {
+                readable = (format & 0xC0) == 0;            // sıkıştırma, şifreleme
+            } else {
+                readable = (format & 0x0C) == 0;
+                frameUnsync = tagUnsync || (format & 0x02);
+                if (format & 0x01) skip = 4;                // veri uzunluğu göstergesi
+            }
+        }
+
+        uint32_t dataPos = pos + headerSize;
+        if (frameSize > tagEnd - dataPos) break;
+
+        if (target >= 0 && readable && targets[target][0] == '\0' && frameSize > skip + 1) {
+            uint8_t data[TRACK_TEXT_READ];
+            size_t length = min((size_t)(frameSize - skip), sizeof(data));
+            length = readAt(file, dataPos + skip, data, length);
+            if (frameUnsync) length = undoUnsync(data, length);
+            if (length > 1) {
+                decodeText(data[0], data + 1, length - 1, targets[target]);
+                if (targets[target][0]) found++;
+            }
+        }
+        pos = dataPos + frameSize;
+    }
+    return audioStart;
+}
+
+bool TrackMetadata::readId3v1(File& file, TrackTags& out) {
+    uint32_t size = file.size();
+    if (size < 128) return false;
+    uint8_t tag[128];
+    if (readAt(file, size - 128, tag, sizeof(tag)) != sizeof(tag) || memcmp(tag, "TAG", 3) != 0) {
+        return false;
+    }
+    // Sadece ID3v2'de olmayan alanlar; v1 30 byte ile sınırlı
+    if (!out.title[0]) decodeText(3, tag + 3, 30, out.title);
+    if (!out.artist[0]) decodeText(3, tag + 33, 30, out.artist);
+    if (!out.album[0]) decodeText(3, tag + 63, 30, out.album);
+    return true;
+}
+
+// --- MP3 ---
+
+bool TrackMetadata::parseMp3Header(const uint8_t* data, Mp3FrameHeader& out) {
+    static const uint16_t mpeg1Rates[15] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+    static const uint16_t mpeg2Rates[15] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 };
+    static const uint32_t sampleRates[3] = { 44100, 48000, 32000 };
+
+    if (data[0] != 0xFF || (data[1] & 0xE0) != 0xE0) return false;
+    uint8_t version = (data[1] >> 3) & 3;       // 0: 2.5, 2: 2, 3: 1
+    uint8_t layer = (data[1] >> 1) & 3;         // 1: Layer III
+    uint8_t bitrateIndex = data[2] >> 4;
+    uint8_t rateIndex = (data[2] >> 2) & 3;
+    if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) {
+        return false;
+    }
+
+    bool mpeg1 = version == 3;
+    out.sampleRate = sampleRates[rateIndex] >> (mpeg1 ? 0 : version == 2 ? 1 : 2);
+    out.bitrateKbps = mpeg1 ? mpeg1Rates[bitrateIndex] : mpeg2Rates[bitrateIndex];
+    out.samplesPerFrame = mpeg1 ? 1152 : 576;
+    out.frameLength = (uint16_t)((uint32_t)out.samplesPerFrame / 8 * out.bitrateKbps * 1000 / out.sampleRate +
+                                 ((data[2] >> 1) & 1));
+    out.mono = (data[3] >> 6) == 3;
+    out.sideInfoSize = mpeg1 ? (out.mono ? 17 : 32) : (out.mono ? 9 : 17);
+    return true;
+}
+
+// İlk geçerli frame: başlık ve hemen ardından gelen frame'in başlığı
+// tutmalı (etiket artığındaki rastgele 0xFF'ler senkron sanılmasın)
+bool TrackMetadata::findMp3Frame(File& file, uint32_t start, uint32_t& offset, Mp3FrameHeader& header) {
+    uint32_t size = file.size();
+    uint32_t limit = start + TRACK_SYNC_SCAN_BYTES;
+    uint8_t buffer[512];
+    uint32_t pos = start;
+
+    while (pos < limit && pos + 4 <= size) {
+        size_t got = readAt(file, pos, buffer, sizeof(buffer));
+        if (got < 4) break;
+        for (size_t i = 0; i + 4 <= got; i++) {
+            if (buffer[i] != 0xFF || !parseMp3Header(buffer + i, header)) continue;
+            uint32_t candidate = pos + i;
+            uint32_t next = candidate + header.frameLength;
+            if (next + 4 <= size) {
+                uint8_t nextHeader[4];
+                Mp3FrameHeader following;
+                if (readAt(file, next, nextHeader, sizeof(nextHeader)) != sizeof(nextHeader) ||
+                    !parseMp3Header(nextHeader, following) || following.sampleRate != header.sampleRate) {
+                    continue;
+                }
+            }
+            offset = candidate;
+            return true;
+        }
+        pos += got - 3;     // sınırdaki başlık bir sonraki okumada
+    }
+    return false;
+}
+
+bool TrackMetadata::readMp3(File& file, TrackTags& out) {
+    uint32_t start = readId3v2(file, out);
+    bool hasId3v1 = readId3v1(file, out);
+
+    uint32_t offset;
+    Mp3FrameHeader header;
+    if (!findMp3Frame(file, start, offset, header)) {
+        return out.title[0] || out.artist[0] || out.album[0];
+    }
+
+    // Xing/Info: frame başlığı + side info'dan sonra; VBRI: sabit 32 byte sonra
+    uint8_t frame[64];
+    memset(frame, 0, sizeof(frame));
+    readAt(file, offset, frame, sizeof(frame));
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    const uint8_t* xing = frame + 4 + header.sideInfoSize;
+    if (memcmp(xing, "Xing", 4) == 0 || memcmp(xing, "Info", 4) == 0) {
+        uint32_t flags = be32(xing + 4);
+        const uint8_t* p = xing + 8;
+        if (flags & 1) {
+            frames = be32(p);
+            p += 4;
+        }
+        if (flags & 2) bytes = be32(p);
+    } else if (memcmp(frame + 36, "VBRI", 4) == 0) {
+        bytes = be32(frame + 36 + 10);
+        frames = be32(frame + 36 + 14);
+    }
+
+    uint32_t audioEnd = file.size() - (hasId3v1 ? 128 : 0);
+    uint32_t audioBytes = audioEnd > offset ? audioEnd - offset : 0;
+    if (frames) {
+        out.durationMs = (uint32_t)((uint64_t)frames * header.samplesPerFrame * 1000 / header.sampleRate);
+        if (!bytes) bytes = audioBytes;
+        out.bitrateKbps = out.durationMs ? (uint16_t)((uint64_t)bytes * 8 / out.durationMs) : header.bitrateKbps;
+    } else {
+        // CBR: bit hızı ilk frame'inki (kbps == bit/ms)
+        out.durationMs = (uint32_t)((uint64_t)audioBytes * 8 / header.bitrateKbps);
+        out.bitrateKbps = header.bitrateKbps;
+    }
+    return true;
+}
+
+// --- WAV ---
+
+bool TrackMetadata::readWav(File& file, TrackTags& out) {
+    uint8_t header[12];
+    if (readAt(file, 0, header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    uint32_t size = file.size();
+    uint32_t byteRate = 0;
+    uint32_t dataSize = 0;
+    uint32_t pos = 12;
+    while (pos + 8 <= size) {
+        uint8_t chunk[8];
+        if (readAt(file, pos, chunk, sizeof(chunk)) != sizeof(chunk)) break;
+        uint32_t length = le32(chunk + 4);
+        uint32_t body = pos + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && length >= 16) {
+            uint8_t format[16];
+            if (readAt(file, body, format, sizeof(format)) == sizeof(format)) {
+                byteRate = le32(format + 8);
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            // Akış olarak yazılmış dosyalarda boyut 0 veya 0xFFFFFFFF olabilir
+            dataSize = (length == 0 || length > size - body) ? size - body : length;
+        } else if (memcmp(chunk, "LIST", 4) == 0 && length >= 4) {
+            uint8_t type[4];
+            uint32_t listEnd = body + min(length, size - body);
+            if (readAt(file, body, type, sizeof(type)) == sizeof(type) && memcmp(type, "INFO", 4) == 0) {
+                uint32_t sub = body + 4;
+                while (sub + 8 <= listEnd) {
+                    uint8_t item[8];
+                    if (readAt(file, sub, item, sizeof(item)) != sizeof(item)) break;
+                    uint32_t itemLength = le32(item + 4);
+                    char* target = memcmp(item, "INAM", 4) == 0 ? out.title :
+                                   memcmp(item, "IART", 4) == 0 ? out.artist :
+                                   memcmp(item, "IPRD", 4) == 0 ? out.album : nullptr;
+                    if (target && itemLength > 0) {
+                        uint8_t text[TRACK_TEXT_READ];
+                        size_t got = readAt(file, sub + 8, text, min((size_t)itemLength, sizeof(text)));
+                        decodeText(3, text, got, target);
+                    }
+                    sub += 8 + itemLength + (itemLength & 1);
+                }
+            }
+        }
+
+        if (length > size - body) break;
+        pos = body + length + (length & 1);
+    }
+
+    if (byteRate == 0) return false;
+    out.durationMs = (uint32_t)((uint64_t)dataSize * 1000 / byteRate);
+    out.bitrateKbps = (uint16_t)min((uint32_t)UINT16_MAX, byteRate * 8 / 1000);
+    return true;
+}
+
+// --- M4A ---
+
+struct M4aState {
+    uint32_t timescale;
+    uint64_t duration;
+};
+
+static void readIlst(File& file, uint32_t pos, uint32_t end, TrackTags& out) {
+    while (pos + 8 <= end) {
+        uint8_t item[24];
+        if (readAt(file, pos, item, sizeof(item)) < 8) break;
+        uint32_t itemSize = be32(item);
+        if (itemSize < 8 || itemSize > end - pos) break;
+
+        char* target = nullptr;
+        if (item[4] == 0xA9 && memcmp(item + 5, "nam", 3) == 0) target = out.title;
+        if (item[4] == 0xA9 && memcmp(item + 5, "ART", 3) == 0) target = out.artist;
+        if (item[4] == 0xA9 && memcmp(item + 5, "alb", 3) == 0) target = out.album;
+
+        // Öğe > data atomu: boyut, "data", tür (1 = UTF-8), yerel ayar, metin
+        uint32_t dataSize = be32(item + 8);
+        if (target && itemSize >= 24 && memcmp(item + 12, "data", 4) == 0 &&
+            dataSize >= 16 && dataSize <= itemSize - 8) {
+            uint8_t text[TRACK_TEXT_READ];
+            size_t got = readAt(file, pos + 24, text, min((size_t)(dataSize - 16), sizeof(text)));
+            TrackMetadata::decodeText(3, text, got, target);
+        }
+        pos += itemSize;
+    }
+}
+
+static void walkAtoms(File& file, uint32_t pos, uint32_t end, uint8_t depth, M4aState& state, TrackTags& out) {
+    while (pos + 8 <= end && depth < 5) {
+        uint8_t atom[16];
+        if (readAt(file, pos, atom, 8) != 8) break;
+        uint64_t atomSize = be32(atom);
+        uint32_t headerSize = 8;
+        if (atomSize == 1) {
+            if (readAt(file, pos + 8, atom + 8, 8) != 8) break;
+            atomSize = be64(atom + 8);
+            headerSize = 16;
+        } else if (atomSize == 0) {
+            atomSize = end - pos;
+        }
+        if (atomSize < headerSize || atomSize > end - pos) break;
+
+        uint32_t body = pos + headerSize;
+        uint32_t atomEnd = pos + (uint32_t)atomSize;
+        const uint8_t* type = atom + 4;
+
+        if (memcmp(type, "moov", 4) == 0 || memcmp(type, "udta", 4) == 0) {
+            walkAtoms(file, body, atomEnd, depth + 1, state, out);
+        } else if (memcmp(type, "meta", 4) == 0) {
+            // ISO: sürüm/bayrak alanı var; QuickTime: yok, doğrudan hdlr gelir
+            uint8_t peek[8];
+            bool quickTime = readAt(file, body, peek, sizeof(peek)) == sizeof(peek) && memcmp(peek + 4, "hdlr", 4) == 0;
+            walkAtoms(file, quickTime ? body : body + 4, atomEnd, depth + 1, state, out);
+        } else if (memcmp(type, "ilst", 4) == 0) {
+            readIlst(file, body, atomEnd, out);
+        } else if (memcmp(type, "mvhd", 4) == 0) {
+            uint8_t mvhd[32];
+            if (readAt(file, body, mvhd, sizeof(mvhd)) == sizeof(mvhd)) {
+                if (mvhd[0] == 1) {
+                    state.timescale = be32(mvhd + 20);
+                    state.duration = be64(mvhd + 24);
+                } else {
+                    state.timescale = be32(mvhd + 12);
+                    state.duration = be32(mvhd + 16);
+                }
+            }
+        }
+        pos = atomEnd;
+    }
+}
+
+bool TrackMetadata::readM4a(File& file, TrackTags& out) {
+    uint8_t ftyp[8];
+    if (readAt(file, 0, ftyp, sizeof(ftyp)) != sizeof(ftyp) || memcmp(ftyp + 4, "ftyp", 4) != 0) {
+        return false;
+    }
+    // moov dosyanın sonunda olabilir; mdat okunmadan atlanır
+    M4aState state = { 0, 0 };
+    walkAtoms(file, 0, file.size(), 0, state, out);
+    if (state.timescale == 0) {
+        return out.title[0] || out.artist[0] || out.album[0];
+    }
+    out.durationMs = (uint32_t)(state.duration * 1000 / state.timescale);
+    out.bitrateKbps = out.durationMs ? (uint16_t)min((uint64_t)UINT16_MAX, (uint64_t)file.size() * 8 / out.durationMs) : 0;
+    return true;
+}
+
+// --- AAC (ADTS) ---
+
+bool TrackMetadata::readAdts(File& file, TrackTags& out) {
+    static const uint32_t sampleRates[13] = {
+        96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350
+    };
+
+    uint32_t start = readId3v2(file, out);
+    uint32_t size = file.size();
+    uint8_t buffer[512];
+    uint32_t bufferStart = 0;
+    size_t bufferLength = 0;
+    uint32_t pos = start;
+    uint32_t sampleRate = 0;
+    uint64_t samples = 0;
+    uint32_t frames = 0;
+
+    // Frame başlıkları sıralı okunur; başlıktaki uzunlukla bir sonrakine atlanır
+    while (pos + 7 <= size && pos - start < TRACK_ADTS_SCAN_BYTES) {
+        if (pos < bufferStart || pos + 7 > bufferStart + bufferLength) {
+            bufferStart = pos;
+            bufferLength = readAt(file, pos, buffer, sizeof(buffer));
+            if (bufferLength < 7) break;
+        }
+        const uint8_t* p = buffer + (pos - bufferStart);
+        if (p[0] != 0xFF || (p[1] & 0xF6) != 0xF0) {
+            if (frames > 0) break;
+            pos++;      // ilk senkrona kadar
+            continue;
+        }
+        uint8_t rateIndex = (p[2] >> 2) & 0x0F;
+        uint32_t frameLength = ((uint32_t)(p[3] & 0x03) << 11) | ((uint32_t)p[4] << 3) | (p[5] >> 5);
+        if (rateIndex >= 13 || frameLength < 7) break;
+        if (frames == 0) start = pos;
+        sampleRate = sampleRates[rateIndex];
+        samples += 1024 * ((p[6] & 0x03) + 1);
+        frames++;
+        pos += frameLength;
+    }
+    if (frames == 0 || sampleRate == 0) return false;
+
+    uint32_t walked = min(pos, size) - start;
+    uint64_t walkedMs = samples * 1000 / sampleRate;
+    if (pos >= size || walked == 0) {
+        out.durationMs = (uint32_t)walkedMs;
+    } else {
+        out.durationMs = (uint32_t)(walkedMs * (size - start) / walked);
+    }
+    out.bitrateKbps = walkedMs ? (uint16_t)min((uint64_t)UINT16_MAX, (uint64_t)walked * 8 / walkedMs) : 0;
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef TRACK_METADATA_H
+#define TRACK_METADATA_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Parça süresi ve etiketleri; dosya indekslenirken (tarama, upload) bir kez
+// okunur ve LibraryIndex'te saklanır, çalma sırasında dosya açılmaz.
+//
+//   MP3: ID3v2.2/2.3/2.4 (TIT2/TPE1/TALB), eksikler için ID3v1; süre
+//        Xing/Info veya VBRI başlığının frame sayısından, yoksa (CBR) ilk
+//        frame'in bit hızından
+//   WAV: fmt + data chunk'ı, LIST/INFO (INAM/IART/IPRD)
+//   M4A: moov/mvhd süresi, udta/meta/ilst (©nam/©ART/©alb)
+//   AAC: ADTS frame'leri dosyanın başından TRACK_ADTS_SCAN_BYTES boyunca
+//        sayılır; dosya daha uzunsa ortalamadan tahmin edilir
+//
+// Okumalar küçük ve sıralıdır; büyük etiket frame'leri (kapak resmi)
+// okunmadan atlanır.
+
+#define TRACK_TAG_MAX           63      // UTF-8 byte, kod noktası bölünmez
+#define TRACK_TEXT_READ         256     // etiket frame'inden okunan en fazla byte
+#define TRACK_SYNC_SCAN_BYTES   4096    // ID3v2'den sonra ilk MP3 frame'i arama sınırı
+#define TRACK_ADTS_SCAN_BYTES   16384
+
+// Tek byte'lık eski metinlerin (ID3v1, ID3v2 ISO-8859-1 çerçeveleri, RIFF
+// INFO) kod sayfası: 1254 Türkçe Windows, 28591 düz ISO-8859-1
+#ifndef TRACK_LEGACY_CODEPAGE
+#define TRACK_LEGACY_CODEPAGE   1254
+#endif
+
+struct TrackTags {
+    uint32_t durationMs;        // 0: bilinmiyor
+    uint16_t bitrateKbps;       // ortalama; 0: bilinmiyor
+    char title[TRACK_TAG_MAX + 1];
+    char artist[TRACK_TAG_MAX + 1];
+    char album[TRACK_TAG_MAX + 1];
+};
+
+// Bir MPEG audio frame başlığı (Layer III)
+struct Mp3FrameHeader {
+    uint32_t sampleRate;
+    uint16_t bitrateKbps;
+    uint16_t samplesPerFrame;
+    uint16_t frameLength;       // byte, padding dahil
+    uint8_t sideInfoSize;       // Xing başlığının konumu için
+    bool mono;
+};
+
+class TrackMetadata {
+private:
+    static uint32_t readId3v2(File& file, TrackTags& out);
+    static bool readId3v1(File& file, TrackTags& out);
+    static bool findMp3Frame(File& file, uint32_t start, uint32_t& offset, Mp3FrameHeader& header);
+
+public:
+    // format: LibraryFormat. Tanınan hiçbir şey yoksa false; etiketler boş,
+    // süre 0 kalır (dosya yine de indekslenir)
+    static bool read(File& file, uint8_t format, TrackTags& out);
+
+    static bool readMp3(File& file, TrackTags& out);
+    static bool readWav(File& file, TrackTags& out);
+    static bool readM4a(File& file, TrackTags& out);
+    static bool readAdts(File& file, TrackTags& out);
+
+    static bool parseMp3Header(const uint8_t* data, Mp3FrameHeader& out);
+
+    // ID3 metin kodlaması (0: ISO-8859-1, 1: BOM'lu UTF-16, 2: UTF-16BE,
+    // 3: UTF-8) -> UTF-8; out TRACK_TAG_MAX + 1 byte. Sondaki boşluklar atılır.
+    // 0 ve geçersiz UTF-8 byte'ları TRACK_LEGACY_CODEPAGE ile çözülür.
+    static void decodeText(uint8_t encoding, const uint8_t* data, size_t length, char* out);
+
+    static void clear(TrackTags& out);
+};
+
+#endif // TRACK_METADATA_H
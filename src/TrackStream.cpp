@@ -0,0 +1,220 @@
+#include "TrackStream.h"
+#include "AudioFileSourcePrefetch.h"
+#include "Trace.h"
+
+static StreamConnection connections[STREAM_MAX_CONNECTIONS];
+static StreamTotals totals;
+
+static uint32_t tokens = STREAM_PLAYING_BURST;
+static unsigned long lastRefillUs = 0;
+
+static StreamPlayback prefetchPlayback() {
+    StreamPlayback playback;
+    playback.active = audioPrefetch.isOpen();
+    playback.fill = audioPrefetch.getFill();
+    playback.capacity = audioPrefetch.getCapacity();
+    return playback;
+}
+
+static StreamPlaybackProbe playbackProbe = prefetchPlayback;
+
+TrackStream::TrackStream() :
+    slot(nullptr),
+    size(0),
+    position(0),
+    remaining(0) {
+}
+
+TrackStream::~TrackStream() {
+    if (file) {
+        file.close();
+    }
+    if (slot) {
+        if (remaining == 0) {
+            totals.completed++;
+        }
+        slot->active = false;
+    }
+}
+
+StreamOpenResult TrackStream::open(const char* path) {
+    StreamConnection* spare = nullptr;
+    for (size_t i = 0; i < STREAM_MAX_CONNECTIONS && !spare; i++) {
+        if (!connections[i].active) spare = &connections[i];
+    }
+    if (!spare) {
+        totals.rejected++;
+        return STREAM_OPEN_BUSY;
+    }
+
+    file = SD.open(path, FILE_READ);
+    if (!file) {
+        return STREAM_OPEN_NOT_FOUND;
+    }
+
+    slot = spare;
+    size = file.size();
+    position = 0;
+    remaining = size;
+
+    unsigned long now = millis();
+    slot->active = true;
+    slot->id = ++totals.opened;
+    slot->path.clear();
+    slot->path.append(path);
+    slot->rangeStart = 0;
+    slot->length = size;
+    slot->sent = 0;
+    slot->startedMs = now;
+    slot->lastMs = now;
+    slot->reads = 0;
+    slot->deferred = 0;
+    slot->maxReadUs = 0;
+    return STREAM_OPEN_OK;
+}
+
+bool TrackStream::setRange(uint32_t start, uint32_t end) {
+    if (!slot || start > end || end >= size) return false;
+    if (!file.seek(start)) return false;
+    position = start;
+    remaining = end - start + 1;
+    slot->rangeStart = start;
+    slot->length = remaining;
+    return true;
+}
+
+// Çalma sürerken okunabilecek byte; 0 ise ertelenir
+size_t TrackStream::admit(size_t want) {
+    StreamPlayback playback = playbackProbe();
+    unsigned long now = micros();
+    if (!playback.active) {
+        tokens = STREAM_PLAYING_BURST;
+        lastRefillUs = now;
+        return want;
+    }
+
+    // Tampon zaten azalıyorsa SD'yi önden okuma task'ına bırak
+    if (playback.capacity && playback.fill * 100 < playback.capacity * STREAM_PREFETCH_LOW_PCT) {
+        return 0;
+    }
+
+    uint64_t earned = (uint64_t)(now - lastRefillUs) * STREAM_PLAYING_RATE / 1000000;
+    if (earned > 0) {
+        tokens = (uint32_t)min((uint64_t)tokens + earned, (uint64_t)STREAM_PLAYING_BURST);
+        lastRefillUs = now;
+    }
+
+    size_t n = min(want, (size_t)tokens);
+    if (n < want && n < STREAM_SECTOR_SIZE) {
+        return 0;
+    }
+    if (n < want) {
+        n -= n % STREAM_SECTOR_SIZE;
+    }
+    tokens -= n;
+    return n;
+}
+
+size_t TrackStream::fill(uint8_t* buffer, size_t maxLen) {
+    if (!slot || remaining == 0) return 0;
+
+    size_t want = min(maxLen, min((size_t)remaining, (size_t)STREAM_READ_MAX));
+    // Dosya sonu değilse okuma sektör sınırında biter; sonraki okumalar hizalı
+    if (want < remaining && want > STREAM_SECTOR_SIZE) {
+        want = ((position + want) & ~(uint32_t)(STREAM_SECTOR_SIZE - 1)) - position;
+    }
+
+    size_t allowed = admit(want);
+    if (allowed == 0) {
+        slot->deferred++;
+        totals.deferred++;
+        return STREAM_TRY_AGAIN;
+    }
+
+    TRACE_SCOPE("stream.read");
+    unsigned long start = micros();
+    size_t got = file.read(buffer, allowed);
+    uint32_t elapsed = micros() - start;
+    if (got == 0) {
+        Serial.printf("❌ Akış okunamadı: %s @%lu\n", slot->path.c_str(), (unsigned long)position);
+        totals.readErrors++;
+        return 0;
+    }
+
+    position += got;
+    remaining -= got;
+    slot->sent += got;
+    slot->reads++;
+    slot->lastMs = millis();
+    if (elapsed > slot->maxReadUs) slot->maxReadUs = elapsed;
+    totals.bytes += got;
+    return got;
+}
+
+// Taşmaya karşı doymalı ondalık sayı; okunan karakter sayısı
+static size_t parseNumber(const char* p, uint64_t& value) {
+    size_t n = 0;
+    value = 0;
+    while (p[n] >= '0' && p[n] <= '9') {
+        if (value <= UINT32_MAX) value = value * 10 + (p[n] - '0');
+        n++;
+    }
+    return n;
+}
+
+StreamRangeResult TrackStream::parseRange(const char* header, uint32_t size, uint32_t& start, uint32_t& end) {
+    if (!header || strncasecmp(header, "bytes=", 6) != 0) return STREAM_RANGE_NONE;
+    const char* p = header + 6;
+    while (*p == ' ') p++;
+
+    uint64_t first = 0, last = 0;
+    size_t firstDigits = parseNumber(p, first);
+    p += firstDigits;
+    if (*p != '-') return STREAM_RANGE_NONE;
+    p++;
+    size_t lastDigits = parseNumber(p, last);
+    p += lastDigits;
+    while (*p == ' ') p++;
+    if (*p != '\0') return STREAM_RANGE_NONE;     // birden fazla aralık veya çöp
+
+    if (firstDigits == 0) {
+        // Sondan n byte
+        if (lastDigits == 0) return STREAM_RANGE_NONE;
+        if (last == 0 || size == 0) return STREAM_RANGE_UNSATISFIABLE;
+        start = size - (uint32_t)min(last, (uint64_t)size);
+        end = size - 1;
+        return STREAM_RANGE_OK;
+    }
+
+    if (lastDigits > 0 && last < first) return STREAM_RANGE_NONE;
+    if (first >= size) return STREAM_RANGE_UNSATISFIABLE;
+    start = (uint32_t)first;
+    end = (lastDigits == 0 || last >= size) ? size - 1 : (uint32_t)last;
+    return STREAM_RANGE_OK;
+}
+
+void TrackStream::setPlaybackProbe(StreamPlaybackProbe probe) {
+    playbackProbe = probe ? probe : prefetchPlayback;
+}
+
+const StreamConnection& TrackStream::connection(size_t index) {
+    return connections[index < STREAM_MAX_CONNECTIONS ? index : 0];
+}
+
+size_t TrackStream::activeCount() {
+    size_t count = 0;
+    for (size_t i = 0; i < STREAM_MAX_CONNECTIONS; i++) {
+        if (connections[i].active) count++;
+    }
+    return count;
+}
+
+const StreamTotals& TrackStream::getTotals() {
+    return totals;
+}
+
+uint32_t TrackStream::kbpsOf(const StreamConnection& connection) {
+    unsigned long elapsed = (connection.active ? millis() : connection.lastMs) - connection.startedMs;
+    if (elapsed == 0) return 0;
+    return (uint32_t)((uint64_t)connection.sent * 8 / elapsed);
+}
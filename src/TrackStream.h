@@ -0,0 +1,117 @@
+#ifndef TRACK_STREAM_H
+#define TRACK_STREAM_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "LibraryIndex.h"
+
+// /api/stream/<dosya> için SD'den HTTP'ye parça akışı.
+//
+// Dosya RAM'e alınmaz: async response'un fill callback'i her çağrıda
+// verilen tampona en fazla STREAM_READ_MAX byte'ı doğrudan SD'den okur.
+// Okumalar mümkünse 512 byte sektör sınırında biter.
+//
+// Yerel çalma önceliklidir. Bir parça açıkken tüm akışlar tek bir token
+// bucket'tan (STREAM_PLAYING_RATE) pay alır; önden okuma tamponu
+// STREAM_PREFETCH_LOW_PCT'nin altındaysa hiç okunmaz ve STREAM_TRY_AGAIN
+// döner, response bir sonraki ACK/poll'da yeniden dener. Bağlantı başına
+// gönderilen byte, süre ve erteleme sayılır.
+//
+// Tüm çağrılar async_tcp task'ından yapılır (open, fill, yıkıcı ve
+// istatistik okuma); kilit yoktur.
+
+#define STREAM_MAX_CONNECTIONS      3
+#define STREAM_READ_MAX             4096    // tek fill'de SD'den en fazla
+#define STREAM_SECTOR_SIZE          512
+#define STREAM_PLAYING_RATE         (128 * 1024)    // çalarken tüm akışlar, byte/s
+#define STREAM_PLAYING_BURST        (8 * 1024)      // token bucket derinliği
+#define STREAM_PREFETCH_LOW_PCT     50
+
+// ESPAsyncWebServer'ın RESPONSE_TRY_AGAIN değeri
+#define STREAM_TRY_AGAIN            ((size_t)0xFFFFFFFF)
+
+enum StreamRangeResult {
+    STREAM_RANGE_NONE,              // başlık yok veya geçersiz: tüm dosya (200)
+    STREAM_RANGE_OK,                // tek aralık (206)
+    STREAM_RANGE_UNSATISFIABLE      // dosya dışında (416)
+};
+
+enum StreamOpenResult {
+    STREAM_OPEN_OK,
+    STREAM_OPEN_NOT_FOUND,
+    STREAM_OPEN_BUSY                // tüm bağlantı yuvaları dolu
+};
+
+// Çalma durumu; akışın ne kadar okuyabileceğine karar verir
+struct StreamPlayback {
+    bool active;
+    size_t fill;
+    size_t capacity;
+};
+
+typedef StreamPlayback (*StreamPlaybackProbe)();
+
+struct StreamConnection {
+    bool active;
+    uint32_t id;
+    LibraryPath path;
+    uint32_t rangeStart;
+    uint32_t length;
+    uint32_t sent;
+    unsigned long startedMs;
+    unsigned long lastMs;
+    uint32_t reads;
+    uint32_t deferred;
+    uint32_t maxReadUs;
+};
+
+struct StreamTotals {
+    uint32_t opened;
+    uint32_t completed;
+    uint32_t rejected;              // yuva yokken gelen istekler
+    uint32_t readErrors;
+    uint32_t deferred;
+    uint64_t bytes;
+};
+
+class TrackStream {
+private:
+    File file;
+    StreamConnection* slot;
+    uint32_t size;
+    uint32_t position;
+    uint32_t remaining;
+
+    static size_t admit(size_t want);
+
+public:
+    TrackStream();
+    ~TrackStream();
+
+    StreamOpenResult open(const char* path);
+
+    // Kapsayıcı [start, end] aralığına konumlanır; open() sonrası bir kez
+    bool setRange(uint32_t start, uint32_t end);
+
+    // Tampona en fazla maxLen byte okur. 0: gövde bitti veya SD hatası
+    // (finished() ayırır); STREAM_TRY_AGAIN: çalma için ertelendi.
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+    uint32_t getSize() const { return size; }
+    bool finished() const { return remaining == 0; }
+
+    // "bytes=a-b", "bytes=a-", "bytes=-n"; birden fazla aralık NONE sayılır
+    static StreamRangeResult parseRange(const char* header, uint32_t size, uint32_t& start, uint32_t& end);
+
+    // Varsayılan: audioPrefetch'in açık olup olmadığı ve doluluğu
+    static void setPlaybackProbe(StreamPlaybackProbe probe);
+
+    static const StreamConnection& connection(size_t index);
+    static size_t activeCount();
+    static const StreamTotals& getTotals();
+
+    // Ortalama hız (kbit/s); bağlantı açıkken şimdiye kadarki
+    static uint32_t kbpsOf(const StreamConnection& connection);
+};
+
+#endif // TRACK_STREAM_H
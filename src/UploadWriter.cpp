@@ -0,0 +1,600 @@
+#include "UploadWriter.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+UploadWriter uploadWriter;
+
+UploadWriter::UploadWriter() :
+    pool(nullptr),
+    poolAllocation(nullptr),
+    freeCount(0),
+    jobHead(0),
+    jobCount(0),
+    mutex(nullptr),
+    writerTask(nullptr) {
+    for (uint8_t i = 0; i < UPLOAD_MAX_SESSIONS; i++) {
+        sessions[i].active = false;
+        sessions[i].current = -1;
+        sessions[i].flow = nullptr;
+        sessions[i].hashing = false;
+        mbedtls_sha256_init(&sessions[i].hash);
+    }
+    resetStats();
+}
+
+bool UploadWriter::begin() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+    }
+    if (!writerTask) {
+        if (xTaskCreatePinnedToCore(writerTaskEntry, "upload_writer", UPLOAD_WRITER_STACK, this,
+                UPLOAD_WRITER_PRIORITY, &writerTask, UPLOAD_WRITER_CORE) != pdPASS) {
+            Serial.println("❌ Upload writer task oluşturulamadı");
+            writerTask = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+void UploadWriter::writerTaskEntry(void* arg) {
+    UploadWriter* self = (UploadWriter*)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->process()) {
+        }
+    }
+}
+
+void UploadWriter::lock() {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void UploadWriter::unlock() {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+// Havuz ilk upload'da ayrılır, son oturum kapanınca geri verilir
+bool UploadWriter::allocatePool() {
+    poolAllocation = (uint8_t*)malloc(UPLOAD_BUFFER_COUNT * UPLOAD_BUFFER_SIZE + UPLOAD_SECTOR_SIZE - 1);
+    if (!poolAllocation) {
+        return false;
+    }
+    pool = (uint8_t*)(((uintptr_t)poolAllocation + UPLOAD_SECTOR_SIZE - 1) & ~(uintptr_t)(UPLOAD_SECTOR_SIZE - 1));
+    for (uint8_t i = 0; i < UPLOAD_BUFFER_COUNT; i++) {
+        freeList[i] = i;
+    }
+    freeCount = UPLOAD_BUFFER_COUNT;
+    return true;
+}
+
+void UploadWriter::releasePoolIfIdle() {
+    if (!poolAllocation || jobCount > 0 || activeSessionsLocked() > 0) {
+        return;
+    }
+    free(poolAllocation);
+    poolAllocation = nullptr;
+    pool = nullptr;
+    freeCount = 0;
+}
+
+int8_t UploadWriter::takeBuffer() {
+    if (freeCount == 0) {
+        return -1;
+    }
+    return freeList[--freeCount];
+}
+
+void UploadWriter::giveBuffer(int8_t buffer) {
+    if (buffer >= 0) {
+        freeList[freeCount++] = buffer;
+    }
+}
+
+bool UploadWriter::pushJob(uint8_t type, uint8_t session, int8_t buffer, uint16_t length) {
+    if (jobCount >= UPLOAD_JOB_CAPACITY) {
+        return false;
+    }
+    Job& job = jobs[(jobHead + jobCount) % UPLOAD_JOB_CAPACITY];
+    job.type = type;
+    job.session = session;
+    job.buffer = buffer;
+    job.length = length;
+    jobCount++;
+    return true;
+}
+
+int UploadWriter::findLocked(const void* key) const {
+    for (uint8_t i = 0; i < UPLOAD_MAX_SESSIONS; i++) {
+        // detached oturumun isteği yok olmuştur; adres yeni bir isteğe ait olabilir
+        if (sessions[i].active && !sessions[i].detached && sessions[i].key == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint8_t UploadWriter::activeSessionsLocked() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < UPLOAD_MAX_SESSIONS; i++) {
+        if (sessions[i].active) count++;
+    }
+    return count;
+}
+
+void UploadWriter::freeSessionLocked(Session& session) {
+    if (session.hashing) {
+        mbedtls_sha256_free(&session.hash);
+        session.hashing = false;
+    }
+    delete session.flow;
+    session.flow = nullptr;
+    session.active = false;
+    session.key = nullptr;
+    session.path = String();
+    releasePoolIfIdle();
+}
+
+void UploadWriter::releaseHeldLocked() {
+    for (uint8_t i = 0; i < UPLOAD_MAX_SESSIONS; i++) {
+        Session& session = sessions[i];
+        if (session.active && session.held) {
+            session.held = false;
+            if (session.flow) session.flow->release();
+        }
+    }
+}
+
+bool UploadWriter::open(const void* key, const String& path, size_t expectedSize, UploadFlowControl* flow) {
+    return openSession(key, path, 0, expectedSize, expectedSize, false, flow);
+}
+
+bool UploadWriter::openRange(const void* key, const String& path, size_t offset, size_t length, size_t fileSize,
+    UploadFlowControl* flow) {
+    return openSession(key, path, offset, length, fileSize, true, flow);
+}
+
+// Boş oturum yuvası; key zaten kullanılıyorsa ya da havuz ayrılamazsa -1
+int UploadWriter::claimSlotLocked(const void* key) {
+    int slot = -1;
+    for (uint8_t i = 0; i < UPLOAD_MAX_SESSIONS; i++) {
+        if (!sessions[i].active) {
+            slot = i;
+            break;
+        }
+    }
+    if (findLocked(key) >= 0 || slot < 0 || (!pool && !allocatePool())) {
+        return -1;
+    }
+    return slot;
+}
+
+bool UploadWriter::openSession(const void* key, const String& path, size_t offset, size_t expectedSize,
+    size_t fileSize, bool ranged, UploadFlowControl* flow) {
+    lock();
+    int slot = claimSlotLocked(key);
+    if (slot < 0) {
+        unlock();
+        delete flow;
+        return false;
+    }
+
+    Session& session = sessions[slot];
+    session.active = true;
+    session.key = key;
+    session.path = path;
+    session.expectedSize = expectedSize;
+    session.offset = offset;
+    session.fileSize = fileSize;
+    session.ranged = ranged;
+    session.bytesQueued = 0;
+    session.bytesWritten = 0;
+    session.current = -1;
+    session.fill = 0;
+    session.held = false;
+    session.closing = false;
+    session.aborted = false;
+    session.detached = false;
+    session.closed = false;
+    session.error = UPLOAD_OK;
+    session.result = UPLOAD_PENDING;
+    session.startMs = millis();
+    session.flow = flow;
+
+    // Dosya açma ve ön ayırma da writer'da: FAT zinciri ayırmak uzun sürebilir
+    pushJob(JOB_OPEN, slot, -1, 0);
+    unlock();
+
+    if (writerTask) xTaskNotifyGive(writerTask);
+    return true;
+}
+
+bool UploadWriter::hash(const void* key, const String& path, size_t offset, size_t length,
+    const mbedtls_sha256_context* start) {
+    lock();
+    int slot = claimSlotLocked(key);
+    int8_t buffer = slot >= 0 ? takeBuffer() : -1;
+    if (buffer < 0 || jobCount >= UPLOAD_JOB_CAPACITY) {
+        giveBuffer(buffer);
+        if (slot >= 0) releasePoolIfIdle();
+        unlock();
+        return false;
+    }
+
+    Session& session = sessions[slot];
+    session.active = true;
+    session.key = key;
+    session.path = path;
+    session.expectedSize = length;
+    session.offset = offset;
+    session.fileSize = 0;
+    session.ranged = true;
+    session.bytesQueued = 0;
+    session.bytesWritten = 0;
+    session.current = buffer;       // okuma tamponu
+    session.fill = 0;
+    session.held = false;
+    session.closing = true;         // write/close kabul edilmez
+    session.aborted = false;
+    session.detached = false;
+    session.closed = false;
+    session.error = UPLOAD_OK;
+    session.result = UPLOAD_PENDING;
+    session.startMs = millis();
+    session.flow = nullptr;
+    session.hashing = true;
+    mbedtls_sha256_init(&session.hash);
+    mbedtls_sha256_clone(&session.hash, start);
+
+    pushJob(JOB_HASH, slot, -1, 0);
+    unlock();
+
+    if (writerTask) xTaskNotifyGive(writerTask);
+    return true;
+}
+
+UploadResult UploadWriter::pollHash(const void* key, mbedtls_sha256_context* out) {
+    lock();
+    int id = findLocked(key);
+    if (id < 0 || !sessions[id].hashing) {
+        unlock();
+        return UPLOAD_ERROR_UNKNOWN;
+    }
+    Session& session = sessions[id];
+    if (!session.closed) {
+        unlock();
+        return UPLOAD_PENDING;
+    }
+    UploadResult result = (UploadResult)session.result;
+    if (result == UPLOAD_OK) {
+        mbedtls_sha256_clone(out, &session.hash);
+    }
+    freeSessionLocked(session);
+    unlock();
+    return result;
+}
+
+bool UploadWriter::write(const void* key, const uint8_t* data, size_t len) {
+    bool queued = false;
+
+    lock();
+    int id = findLocked(key);
+    if (id < 0) {
+        unlock();
+        return false;
+    }
+    Session& session = sessions[id];
+    if (session.error != UPLOAD_OK || session.closing) {
+        unlock();
+        return false;
+    }
+
+    while (len > 0) {
+        if (session.current < 0) {
+            session.current = takeBuffer();
+            if (session.current < 0) {
+                stats.poolOverflows++;
+                session.error = UPLOAD_ERROR_POOL;
+                unlock();
+                return false;
+            }
+            session.fill = 0;
+        }
+
+        size_t count = min(len, (size_t)(UPLOAD_BUFFER_SIZE - session.fill));
+        memcpy(bufferData(session.current) + session.fill, data, count);
+        session.fill += count;
+        session.bytesQueued += count;
+        data += count;
+        len -= count;
+
+        if (session.fill == UPLOAD_BUFFER_SIZE) {
+            pushJob(JOB_WRITE, id, session.current, session.fill);
+            session.current = -1;
+            session.fill = 0;
+            queued = true;
+        }
+    }
+
+    // Ack'lenmiş veri için her oturuma bir yedek tampon kalmalı: uçuştaki
+    // veri en fazla bir TCP penceresi (< UPLOAD_BUFFER_SIZE). Kuyrukta iş
+    // yoksa release() gelmeyeceğinden bekletilmez.
+    if (freeCount <= activeSessionsLocked() && jobCount > 0 && session.flow) {
+        session.flow->hold();
+        session.held = true;
+        stats.backpressureHolds++;
+    }
+    unlock();
+
+    if (queued && writerTask) xTaskNotifyGive(writerTask);
+    return true;
+}
+
+bool UploadWriter::close(const void* key) {
+    lock();
+    int id = findLocked(key);
+    if (id < 0 || sessions[id].closing) {
+        unlock();
+        return false;
+    }
+    Session& session = sessions[id];
+    if (session.current >= 0) {
+        pushJob(JOB_WRITE, id, session.current, session.fill);
+        session.current = -1;
+        session.fill = 0;
+    }
+    session.closing = true;
+    pushJob(JOB_CLOSE, id, -1, 0);
+    unlock();
+
+    if (writerTask) xTaskNotifyGive(writerTask);
+    return true;
+}
+
+UploadResult UploadWriter::poll(const void* key) {
+    lock();
+    int id = findLocked(key);
+    if (id < 0) {
+        unlock();
+        return UPLOAD_ERROR_UNKNOWN;
+    }
+    Session& session = sessions[id];
+    if (!session.closed) {
+        unlock();
+        return UPLOAD_PENDING;
+    }
+    UploadResult result = (UploadResult)session.result;
+    freeSessionLocked(session);
+    unlock();
+    return result;
+}
+
+UploadResult UploadWriter::wait(const void* key, uint32_t timeoutMs) {
+    uint32_t start = millis();
+    while (true) {
+        lock();
+        int id = findLocked(key);
+        if (id < 0) {
+            unlock();
+            return UPLOAD_ERROR_UNKNOWN;
+        }
+        Session& session = sessions[id];
+        if (session.closed) {
+            UploadResult result = (UploadResult)session.result;
+            freeSessionLocked(session);
+            unlock();
+            return result;
+        }
+        if (millis() - start >= timeoutMs) {
+            // Sonuç gelmedi; kapanışı writer tamamlayıp oturumu bırakır
+            session.detached = true;
+            unlock();
+            return UPLOAD_ERROR_TIMEOUT;
+        }
+        unlock();
+        vTaskDelay(1);
+    }
+}
+
+bool UploadWriter::has(const void* key) {
+    lock();
+    bool found = findLocked(key) >= 0;
+    unlock();
+    return found;
+}
+
+void UploadWriter::abort(const void* key) {
+    bool queued = false;
+
+    lock();
+    int id = findLocked(key);
+    if (id >= 0) {
+        Session& session = sessions[id];
+        session.aborted = true;
+        session.detached = true;
+        if (session.closed) {
+            freeSessionLocked(session);
+        } else if (!session.closing) {
+            giveBuffer(session.current);
+            session.current = -1;
+            session.closing = true;
+            pushJob(JOB_CLOSE, id, -1, 0);
+            queued = true;
+        }
+    }
+    unlock();
+
+    if (queued && writerTask) xTaskNotifyGive(writerTask);
+}
+
+bool UploadWriter::process() {
+    lock();
+    if (jobCount == 0) {
+        unlock();
+        return false;
+    }
+    Job job = jobs[jobHead];
+    jobHead = (jobHead + 1) % UPLOAD_JOB_CAPACITY;
+    jobCount--;
+    Session& session = sessions[job.session];
+    unlock();
+
+    // Dosya sadece writer'da kullanılır; kilit dışında yazılır
+    switch (job.type) {
+        case JOB_OPEN:
+            runOpen(session);
+            break;
+        case JOB_WRITE:
+            runWrite(session, job.buffer, job.length);
+            break;
+        case JOB_CLOSE:
+            runClose(session);
+            break;
+        case JOB_HASH:
+            runHash(session);
+            break;
+    }
+
+    // Her işten sonra: tampon boşaldı ya da kuyruk ilerledi, bekletilen
+    // ack'ler serbest bırakılır
+    lock();
+    releaseHeldLocked();
+    unlock();
+    return true;
+}
+
+void UploadWriter::runOpen(Session& session) {
+    File file;
+    if (session.ranged) {
+        // "r+" mevcut içeriği korur; offset dosya sonundan ötedeyse seek dosyayı genişletir
+        file = SD.open(session.path, SD.exists(session.path) ? "r+" : FILE_WRITE);
+        if (file && file.size() < session.fileSize) {
+            // İlk parçada dosya son boyutuna genişletilir, sonrakiler zinciri büyütmez
+            file.seek(session.fileSize);
+        }
+        if (file && !file.seek(session.offset)) {
+            file.close();
+            file = File();
+        }
+    } else {
+        file = SD.open(session.path, FILE_WRITE);
+    }
+    if (file && !session.ranged && session.expectedSize > 0) {
+        // Dosyayı son boyutuna genişlet: kümeler tek seferde ayrılır,
+        // sonraki yazmalar FAT zincirini büyütmez
+        file.seek(session.expectedSize);
+        file.seek(0);
+    }
+
+    lock();
+    session.file = file;
+    if (!file) {
+        session.error = UPLOAD_ERROR_OPEN;
+        Serial.printf("❌ Upload file could not be created: %s\n", session.path.c_str());
+    }
+    unlock();
+}
+
+void UploadWriter::runWrite(Session& session, int8_t buffer, uint16_t length) {
+    bool skip = session.aborted || session.error != UPLOAD_OK;
+
+    size_t written = 0;
+    uint32_t elapsed = 0;
+    if (!skip) {
+        uint32_t start = micros();
+        TRACE_BEGIN("sd.write");
+        written = session.file.write(bufferData(buffer), length);
+        TRACE_END("sd.write");
+        elapsed = micros() - start;
+    }
+
+    lock();
+    if (!skip) {
+        stats.writes++;
+        stats.bytesWritten += written;
+        stats.writeTimeUs += elapsed;
+        if (elapsed > stats.maxWriteUs) stats.maxWriteUs = elapsed;
+        metrics.sdWrite.record(elapsed);
+        if (elapsed > UPLOAD_SLOW_WRITE_US) stats.slowWrites++;
+        session.bytesWritten += written;
+        if (written != length) {
+            session.error = UPLOAD_ERROR_WRITE;
+        }
+    }
+    giveBuffer(buffer);
+    unlock();
+}
+
+void UploadWriter::runClose(Session& session) {
+    if (session.file) {
+        session.file.close();
+    }
+
+    bool sizeMismatch = session.expectedSize > 0 && session.bytesWritten != session.expectedSize;
+    bool failed = session.aborted || session.error != UPLOAD_OK || sizeMismatch;
+    if (failed && !session.ranged) {
+        SD.remove(session.path);
+    }
+
+    lock();
+    uint8_t result = session.error;
+    if (result == UPLOAD_OK && (session.aborted || sizeMismatch)) {
+        result = UPLOAD_ERROR_WRITE;
+    }
+    session.result = result;
+    session.file = File();
+
+    if (failed) {
+        stats.failed++;
+    } else {
+        stats.completed++;
+        uint32_t elapsedMs = millis() - session.startMs;
+        if (elapsedMs > 0) {
+            stats.lastUploadMBps = (float)session.bytesWritten / elapsedMs / 1000.0f;
+        }
+    }
+
+    session.closed = true;
+    if (session.detached) {
+        freeSessionLocked(session);
+    }
+    unlock();
+}
+
+// Büyük dosyada dakikalar sürebilir; her okumada iptal kontrol edilir
+void UploadWriter::runHash(Session& session) {
+    File file = SD.open(session.path, FILE_READ);
+    bool ok = file && file.seek(session.offset);
+    uint8_t* buffer = bufferData(session.current);
+    size_t remaining = session.expectedSize;
+    while (ok && remaining > 0 && !session.aborted) {
+        size_t count = file.read(buffer, min(remaining, (size_t)UPLOAD_BUFFER_SIZE));
+        ok = count > 0;
+        mbedtls_sha256_update_ret(&session.hash, buffer, count);
+        remaining -= count;
+    }
+    if (file) {
+        file.close();
+    }
+
+    lock();
+    giveBuffer(session.current);
+    session.current = -1;
+    session.result = ok && !session.aborted ? UPLOAD_OK : UPLOAD_ERROR_READ;
+    session.closed = true;
+    if (session.detached) {
+        freeSessionLocked(session);
+    }
+    unlock();
+}
+
+void UploadWriter::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+float UploadWriter::getWriteMBps() const {
+    if (stats.writeTimeUs == 0) {
+        return 0;
+    }
+    return (float)stats.bytesWritten / stats.writeTimeUs;
+}
@@ -0,0 +1,206 @@
+#ifndef UPLOAD_WRITER_H
+#define UPLOAD_WRITER_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <mbedtls/sha256.h>
+
+// Upload'lar için arka plan SD yazıcısı.
+//
+// async_tcp callback'i veriyi sadece havuzdaki bir tampona kopyalar; dolan
+// tampon kuyruğa girer ve writer task onu tek seferde SD'ye yazar. Her
+// upload'un kendi oturumu vardır, eşzamanlı upload'lar birbirini bozmaz.
+// Havuz tükenmek üzereyken TCP ack'i geciktirilir (UploadFlowControl),
+// böylece lwIP bekletilmeden istemcinin penceresi kapanır. Devam ettirilen
+// upload'ların SHA-256 doğrulaması için dosya okuma da burada yapılır.
+
+#define UPLOAD_SECTOR_SIZE      512
+#define UPLOAD_BUFFER_SIZE      (16 * UPLOAD_SECTOR_SIZE)  // 8 KB, FAT32 küme boyutunun katı/böleni
+#define UPLOAD_BUFFER_COUNT     4
+#define UPLOAD_MAX_SESSIONS     2
+#define UPLOAD_WRITER_STACK     4096
+#define UPLOAD_WRITER_PRIORITY  3
+#define UPLOAD_WRITER_CORE      0       // ses çekirdeğinden (1) uzak
+// Yanıtın kapanış sonucunu bekleyeceği üst sınır (bkz. OTA_FINISH_TIMEOUT_MS)
+#define UPLOAD_FINISH_TIMEOUT_MS 3000
+#define UPLOAD_SLOW_WRITE_US    50000   // bundan uzun süren yazma "stall" sayılır
+#define UPLOAD_JOB_CAPACITY     (UPLOAD_BUFFER_COUNT + 2 * UPLOAD_MAX_SESSIONS)
+
+// TCP akış kontrolü: hold() async_tcp içinden, release() writer task'ından
+// çağrılır. Oturum sahipliğini alır, kapanışta siler.
+class UploadFlowControl {
+public:
+    virtual ~UploadFlowControl() {}
+    virtual void hold() = 0;
+    virtual void release() = 0;
+};
+
+enum UploadResult {
+    UPLOAD_OK = 0,
+    UPLOAD_PENDING,
+    UPLOAD_ERROR_OPEN,
+    UPLOAD_ERROR_WRITE,
+    UPLOAD_ERROR_READ,      // hash(): dosya okunamadı
+    UPLOAD_ERROR_POOL,      // havuz taştı (akış kontrolü yetmedi)
+    UPLOAD_ERROR_TIMEOUT,
+    UPLOAD_ERROR_UNKNOWN
+};
+
+struct UploadStats {
+    uint64_t bytesWritten;
+    uint64_t writeTimeUs;       // SD yazma çağrılarında geçen toplam süre
+    uint32_t writes;
+    uint32_t maxWriteUs;
+    uint32_t slowWrites;        // UPLOAD_SLOW_WRITE_US'i aşan yazmalar
+    uint32_t backpressureHolds; // ack'in geciktirildiği chunk sayısı
+    uint32_t poolOverflows;
+    uint32_t completed;
+    uint32_t failed;
+    float lastUploadMBps;       // son upload'un baştan sona hızı
+};
+
+class UploadWriter {
+private:
+    enum JobType : uint8_t {
+        JOB_OPEN,
+        JOB_WRITE,
+        JOB_CLOSE,
+        JOB_HASH
+    };
+
+    struct Job {
+        uint8_t type;
+        uint8_t session;
+        int8_t buffer;
+        uint16_t length;
+    };
+
+    struct Session {
+        bool active;
+        const void* key;            // upload'u başlatan istek
+        String path;
+        File file;
+        size_t expectedSize;
+        size_t offset;              // ranged oturumda dosya içindeki başlangıç
+        size_t fileSize;            // ranged: dosya bundan kısaysa önce genişletilir
+        bool ranged;                // mevcut dosyaya yazar, hata olursa silmez
+        size_t bytesQueued;
+        size_t bytesWritten;
+        int8_t current;             // doldurulan tampon, yoksa -1
+        uint16_t fill;
+        bool held;                  // ack şu anda geciktiriliyor
+        bool closing;               // JOB_CLOSE kuyrukta
+        bool aborted;               // dosya kapanışta silinir
+        bool detached;              // sonucu bekleyen yok, writer serbest bırakır
+        bool hashing;               // yazmaz, [offset, offset + expectedSize) aralığını özetler
+        mbedtls_sha256_context hash;
+        volatile bool closed;
+        uint8_t error;              // ilk hata (UploadResult), yoksa UPLOAD_OK
+        uint8_t result;
+        uint32_t startMs;
+        UploadFlowControl* flow;
+    };
+
+    uint8_t* pool;                  // UPLOAD_BUFFER_COUNT * UPLOAD_BUFFER_SIZE, sektör hizalı
+    uint8_t* poolAllocation;
+    int8_t freeList[UPLOAD_BUFFER_COUNT];
+    uint8_t freeCount;
+
+    Job jobs[UPLOAD_JOB_CAPACITY];
+    uint8_t jobHead;
+    uint8_t jobCount;
+
+    Session sessions[UPLOAD_MAX_SESSIONS];
+    UploadStats stats;
+
+    SemaphoreHandle_t mutex;
+    TaskHandle_t writerTask;
+
+    static void writerTaskEntry(void* arg);
+
+    void lock();
+    void unlock();
+    bool allocatePool();
+    void releasePoolIfIdle();
+    int8_t takeBuffer();
+    void giveBuffer(int8_t buffer);
+    bool pushJob(uint8_t type, uint8_t session, int8_t buffer, uint16_t length);
+    int claimSlotLocked(const void* key);
+    bool openSession(const void* key, const String& path, size_t offset, size_t expectedSize,
+        size_t fileSize, bool ranged, UploadFlowControl* flow);
+    int findLocked(const void* key) const;
+    uint8_t activeSessionsLocked() const;
+    void freeSessionLocked(Session& session);
+    void releaseHeldLocked();
+    void runOpen(Session& session);
+    void runWrite(Session& session, int8_t buffer, uint16_t length);
+    void runClose(Session& session);
+    void runHash(Session& session);
+    uint8_t* bufferData(int8_t buffer) { return pool + (size_t)buffer * UPLOAD_BUFFER_SIZE; }
+
+public:
+    UploadWriter();
+
+    // Writer task'ı başlatır (host build'de task çalışmaz, process() elle çağrılır)
+    bool begin();
+
+    // Yeni oturum; expectedSize biliniyorsa dosya önceden o boyuta genişletilir.
+    // flow'un sahipliği oturuma geçer.
+    bool open(const void* key, const String& path, size_t expectedSize, UploadFlowControl* flow);
+
+    // Mevcut (yoksa yeni) dosyanın [offset, offset + length) aralığına yazan
+    // oturum; devam ettirilebilir upload parçaları için. Dosya fileSize'dan
+    // kısaysa açılışta bir kez o boyuta genişletilir. Hata veya iptalde
+    // dosya silinmez, sadece sonuç hatalı döner.
+    bool openRange(const void* key, const String& path, size_t offset, size_t length, size_t fileSize,
+        UploadFlowControl* flow);
+
+    // Dosyanın [offset, offset + length) aralığını start özetinin devamı
+    // olarak okur; sonuç pollHash'ten alınır. abort ile yarıda kesilir.
+    bool hash(const void* key, const String& path, size_t offset, size_t length,
+        const mbedtls_sha256_context* start);
+
+    // hash() bitmediyse UPLOAD_PENDING; bittiyse özet out'a kopyalanır ve
+    // oturum serbest kalır
+    UploadResult pollHash(const void* key, mbedtls_sha256_context* out);
+
+    // async_tcp callback'inden çağrılır, sadece kopyalar
+    bool write(const void* key, const uint8_t* data, size_t len);
+
+    // Yarım tamponu ve kapanışı kuyruğa alır
+    bool close(const void* key);
+
+    // Kapanış bitmediyse UPLOAD_PENDING, bittiyse sonucu döndürüp oturumu
+    // serbest bırakır; beklemez. async_tcp bunu yanıt poll'unda çağırır.
+    UploadResult poll(const void* key);
+
+    // Dosyanın kapanmasını timeoutMs kadar bekler; sonuç alınınca oturum
+    // serbest kalır. Süre dolarsa oturum writer'a bırakılır. timeoutMs 0
+    // ise beklemeden sonucu alır ya da oturumu bırakır.
+    UploadResult wait(const void* key, uint32_t timeoutMs);
+
+    // key için yazmaya açık (bırakılmamış) oturum var mı
+    bool has(const void* key);
+
+    // Bağlantı koptuğunda: yazılmamış tamponlar atılır, dosya silinir
+    void abort(const void* key);
+
+    // Kuyruktaki bir işi yürütür; iş yoksa false
+    bool process();
+
+    const UploadStats& getStats() const { return stats; }
+    void resetStats();
+
+    // Havuzda boşta duran tampon sayısı
+    uint8_t getFreeBuffers() const { return freeCount; }
+
+    // Toplam SD yazma hızı (MB/s)
+    float getWriteMBps() const;
+};
+
+extern UploadWriter uploadWriter;
+
+#endif // UPLOAD_WRITER_H
@@ -0,0 +1,221 @@
+#include "WavDecoder.h"
+#include "Trace.h"
+
+#define WAV_FORMAT_PCM          1
+#define WAV_FORMAT_EXTENSIBLE   0xFFFE
+#define WAV_MAX_CHUNKS          64      // data'dan önce atlanan chunk sınırı
+
+static uint16_t le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+WavDecoder::WavDecoder(AudioFileSource& _source) :
+    source(_source),
+    out(nullptr),
+    opened(false),
+    position(0),
+    pcmFrames(0),
+    pcmPos(0) {
+    memset(&format, 0, sizeof(format));
+}
+
+bool WavDecoder::parseFormat(const uint8_t* body, size_t length, WavFormat& out) {
+    if (length < 16) return false;
+    uint16_t tag = le16(body);
+    if (tag == WAV_FORMAT_EXTENSIBLE) {
+        // cbSize(2) + validBits(2) + channelMask(4) + SubFormat GUID'in ilk 2 byte'ı
+        if (length < 26 || le16(body + 24) != WAV_FORMAT_PCM) return false;
+    } else if (tag != WAV_FORMAT_PCM) {
+        return false;
+    }
+
+    out.channels = le16(body + 2);
+    out.sampleRate = le32(body + 4);
+    out.blockAlign = le16(body + 12);
+    out.bitsPerSample = le16(body + 14);
+
+    if (out.channels != 1 && out.channels != 2) return false;
+    if (out.bitsPerSample != 8 && out.bitsPerSample != 16 && out.bitsPerSample != 24) return false;
+    if (out.sampleRate < 8000 || out.sampleRate > 96000) return false;
+    return out.blockAlign == out.channels * out.bitsPerSample / 8;
+}
+
+template <int Bits, int Channels>
+static void convertBlock(const uint8_t* raw, int16_t* pcm, size_t frames) {
+    for (size_t i = 0; i < frames; i++) {
+        int16_t s[2];
+        for (int c = 0; c < Channels; c++) {
+            const uint8_t* p = raw + (i * Channels + c) * (Bits / 8);
+            if (Bits == 8) {
+                s[c] = (int16_t)(((int16_t)p[0] - 128) << 8);
+            } else if (Bits == 16) {
+                s[c] = (int16_t)le16(p);
+            } else {
+                s[c] = (int16_t)le16(p + 1);
+            }
+        }
+        pcm[2 * i] = s[0];
+        pcm[2 * i + 1] = Channels == 2 ? s[1] : s[0];
+    }
+}
+
+void WavDecoder::convert(const WavFormat& format, const uint8_t* raw, int16_t* pcm, size_t frames) {
+    switch (format.bitsPerSample * 10 + format.channels) {
+        case 81:  convertBlock<8, 1>(raw, pcm, frames); break;
+        case 82:  convertBlock<8, 2>(raw, pcm, frames); break;
+        case 161: convertBlock<16, 1>(raw, pcm, frames); break;
+        case 162:
+            if ((const void*)raw != (const void*)pcm) memcpy(pcm, raw, frames * 4);
+            break;
+        case 241: convertBlock<24, 1>(raw, pcm, frames); break;
+        case 242: convertBlock<24, 2>(raw, pcm, frames); break;
+        default: break;
+    }
+}
+
+bool WavDecoder::readHeader() {
+    uint8_t header[12];
+    if (source.read(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    uint32_t size = source.getSize();
+    uint32_t pos = 12;
+    bool haveFormat = false;
+    for (int i = 0; i < WAV_MAX_CHUNKS && pos + 8 <= size; i++) {
+        uint8_t chunk[8];
+        if (source.read(chunk, sizeof(chunk)) != sizeof(chunk)) return false;
+        uint32_t length = le32(chunk + 4);
+        uint32_t body = pos + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[40];
+            size_t want = min((size_t)length, sizeof(fmt));
+            if (source.read(fmt, want) != want || !parseFormat(fmt, want, format)) return false;
+            haveFormat = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) return false;
+            // Akış olarak yazılmış dosyalarda boyut 0 veya 0xFFFFFFFF olabilir
+            uint32_t available = size - body;
+            uint32_t dataSize = (length == 0 || length > available) ? available : length;
+            format.dataStart = body;
+            format.dataSize = dataSize - dataSize % format.blockAlign;
+            return true;
+        }
+
+        if (length > size - body) return false;
+        pos = body + length + (length & 1);
+        if (!source.seek(pos, SEEK_SET)) return false;
+    }
+    return false;
+}
+
+bool WavDecoder::begin(const String& path, AudioOutput* output) {
+    stop();
+    out = output;
+    if (!source.open(path.c_str())) {
+        return false;
+    }
+    if (!readHeader()) {
+        Serial.printf("❌ WAV başlığı okunamadı: %s\n", path.c_str());
+        source.close();
+        return false;
+    }
+
+    opened = true;
+    position = 0;
+    pcmFrames = 0;
+    pcmPos = 0;
+    // Çıkışa her zaman 16-bit stereo verilir
+    out->SetRate(format.sampleRate);
+    out->SetBitsPerSample(16);
+    out->SetChannels(2);
+    return true;
+}
+
+// Bir blok okur ve çevirir; data bittiyse veya okunamadıysa false
+bool WavDecoder::fillBlock() {
+    uint32_t remaining = format.dataSize - position;
+    size_t frames = min((size_t)(remaining / format.blockAlign), (size_t)WAV_BLOCK_FRAMES);
+    if (frames == 0) return false;
+
+    // 16-bit stereo doğrudan çıkış tamponuna okunur
+    bool direct = format.bitsPerSample == 16 && format.channels == 2;
+    uint8_t* target = direct ? (uint8_t*)pcm : raw;
+    size_t want = frames * format.blockAlign;
+    size_t got = 0;
+    {
+        TRACE_SCOPE("wav.read");
+        while (got < want) {
+            uint32_t n = source.read(target + got, want - got);
+            if (n == 0) break;
+            got += n;
+        }
+    }
+    position += got;
+    frames = got / format.blockAlign;
+    if (got < want) {
+        // Dosya beklenenden kısa: eksik frame atılır, parça biter
+        position = format.dataSize;
+    }
+    if (frames == 0) return false;
+
+    convert(format, target, pcm, frames);
+    pcmFrames = frames;
+    pcmPos = 0;
+    return true;
+}
+
+bool WavDecoder::loop() {
+    if (!opened) return false;
+    TRACE_SCOPE("decode.wav");
+    while (true) {
+        if (pcmPos < pcmFrames) {
+            pcmPos += out->ConsumeSamples(pcm + 2 * pcmPos, (uint16_t)(pcmFrames - pcmPos));
+            if (pcmPos < pcmFrames) return true;     // çıkış dolu
+        }
+        if (!fillBlock()) {
+            return false;
+        }
+    }
+}
+
+void WavDecoder::stop() {
+    if (opened) {
+        source.close();
+        opened = false;
+    }
+    pcmFrames = 0;
+    pcmPos = 0;
+}
+
+bool WavDecoder::seek(uint32_t dataOffset) {
+    if (!opened) return false;
+    if (dataOffset > format.dataSize) dataOffset = format.dataSize;
+    dataOffset -= dataOffset % format.blockAlign;
+    if (!source.seek(format.dataStart + dataOffset, SEEK_SET)) return false;
+    position = dataOffset;
+    pcmFrames = 0;
+    pcmPos = 0;
+    return true;
+}
+
+bool WavDecoder::seekMs(uint32_t ms) {
+    return seek((uint32_t)min((uint64_t)ms * format.sampleRate / 1000 * format.blockAlign, (uint64_t)UINT32_MAX));
+}
+
+uint32_t WavDecoder::getPositionMs() const {
+    if (!format.sampleRate) return 0;
+    uint32_t frames = position / format.blockAlign - (uint32_t)(pcmFrames - pcmPos);
+    return (uint32_t)((uint64_t)frames * 1000 / format.sampleRate);
+}
+
+uint32_t WavDecoder::getDurationMs() const {
+    if (!format.sampleRate || !format.blockAlign) return 0;
+    return (uint32_t)((uint64_t)(format.dataSize / format.blockAlign) * 1000 / format.sampleRate);
+}
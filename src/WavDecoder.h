@@ -0,0 +1,73 @@
+#ifndef WAV_DECODER_H
+#define WAV_DECODER_H
+
+#include <Arduino.h>
+#include <AudioFileSource.h>
+#include "GaplessChain.h"
+
+// WAV için decode'suz PCM yolu.
+//
+// RIFF/fmt/data chunk'ları begin()'de bir kez okunur; sonra data chunk'ı
+// blok blok (WAV_BLOCK_FRAMES) kaynaktan (AudioFileSourcePrefetch'in
+// hizalı SD okumaları) alınır, 16-bit stereo'ya çevrilir ve çıkışa toplu
+// ConsumeSamples() ile verilir. Örnek başına sanal çağrı, bit okuyucu veya
+// ara tampon yoktur; 16-bit stereo dosyada çevirme de yoktur, okunan blok
+// olduğu gibi geçer.
+//
+// Desteklenen: PCM (format 1) ve WAVE_FORMAT_EXTENSIBLE/PCM, 8/16/24 bit,
+// mono/stereo, 8-96 kHz. 24 bit üst 16 bitine kesilir (DAC 12 bit).
+// ESP32 ve host little-endian'dır; örnekler doğrudan okunur.
+
+#define WAV_BLOCK_FRAMES        1024    // tek okuma (16-bit stereo'da 4 KB)
+#define WAV_MAX_BLOCK_ALIGN     6       // 24-bit stereo
+
+struct WavFormat {
+    uint32_t sampleRate;
+    uint16_t channels;
+    uint16_t bitsPerSample;
+    uint16_t blockAlign;
+    uint32_t dataStart;         // dosyada data chunk'ının ilk byte'ı
+    uint32_t dataSize;          // blockAlign'ın katına indirilmiş
+};
+
+class WavDecoder : public GaplessDecoder {
+private:
+    AudioFileSource& source;
+    AudioOutput* out;
+    WavFormat format;
+    bool opened;
+
+    uint32_t position;          // data içinde okunan byte
+    uint8_t raw[WAV_BLOCK_FRAMES * WAV_MAX_BLOCK_ALIGN];
+    int16_t pcm[WAV_BLOCK_FRAMES * 2];
+    size_t pcmFrames;
+    size_t pcmPos;              // çıkışın henüz almadığı ilk frame
+
+    bool readHeader();
+    bool fillBlock();
+
+public:
+    explicit WavDecoder(AudioFileSource& source);
+
+    // fmt chunk gövdesi; desteklenmeyen biçimde false
+    static bool parseFormat(const uint8_t* body, size_t length, WavFormat& out);
+
+    // Blok dönüşümü: raw'daki frames frame -> interleaved 16-bit stereo
+    static void convert(const WavFormat& format, const uint8_t* raw, int16_t* pcm, size_t frames);
+
+    virtual bool begin(const String& path, AudioOutput* out) override;
+    virtual bool loop() override;
+    virtual void stop() override;
+
+    // data chunk'ı içinde byte konumuna atlar (frame sınırına yuvarlanır)
+    bool seek(uint32_t dataOffset);
+    bool seekMs(uint32_t ms);
+
+    bool isOpen() const { return opened; }
+    const WavFormat& getFormat() const { return format; }
+    uint32_t getPosition() const { return position; }
+    uint32_t getPositionMs() const;
+    uint32_t getDurationMs() const;
+};
+
+#endif // WAV_DECODER_H
@@ -1,4 +1,235 @@
 #include "WebServer.h"
+#include "LibraryIndex.h"
+#include "PlaylistStream.h"
+#include "TrackStream.h"
+#include "StatusChannel.h"
+#include "StaticAssets.h"
+#include "UploadWriter.h"
+#include "ResumableUpload.h"
+#include "OtaUpdater.h"
+#include "AudioFileSourcePrefetch.h"
+#include "AudioTask.h"
+#include "TimerScheduler.h"
+#include "Ds3231TimerAlarm.h"
+#include "I2cArbiter.h"
+#include "RtcClock.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "RequestArena.h"
+#include <memory>
+#include <StreamString.h>
+
+// Upload'un TCP akış kontrolü: havuz dolarken gelen segmentin ack'i
+// geciktirilir, writer tampon boşaltınca bekleyen ack'ler gönderilir.
+// lwIP'yi bloklamadan istemcinin penceresini kapatır.
+class AsyncClientFlowControl : public UploadFlowControl {
+private:
+    AsyncClient* client;
+
+public:
+    explicit AsyncClientFlowControl(AsyncClient* client) : client(client) {}
+
+    void hold() override {
+        client->ackLater();
+    }
+
+    void release() override {
+        // ack() bekleyen byte sayısıyla sınırlanır
+        client->ack(SIZE_MAX);
+    }
+};
+
+// Sonucu arka plan işine bağlı yanıt. Başlık, resolver bir durum kodu
+// döndürene kadar gönderilmez; AsyncWebServer bitmemiş yanıtı her ack'te
+// ve async_tcp poll'unda (~500 ms) yeniden dener, task hiç beklemez.
+// timeoutMs dolunca resolver expired=true ile çağrılır ve kod vermelidir.
+class DeferredResponse : public AsyncWebServerResponse {
+public:
+    // 0: sonuç henüz yok
+    typedef std::function<int(bool expired, String& contentType, String& body)> Resolver;
+
+private:
+    Resolver resolver;
+    uint32_t startMs;
+    uint32_t timeoutMs;
+
+    void tryRespond(AsyncWebServerRequest *request) {
+        String body;
+        _contentType = "text/plain";
+        _code = resolver(millis() - startMs >= timeoutMs, _contentType, body);
+        if (!_code) {
+            return;
+        }
+        _contentLength = body.length();
+        String out = _assembleHead(request->version());
+        out += body;
+        _writtenLength += request->client()->write(out.c_str(), out.length());
+        _state = RESPONSE_WAIT_ACK;
+    }
+
+public:
+    DeferredResponse(Resolver resolver, uint32_t timeoutMs) :
+        resolver(resolver),
+        startMs(millis()),
+        timeoutMs(timeoutMs) {
+        _code = 0;
+    }
+
+    bool _sourceValid() const override {
+        return true;
+    }
+
+    void _respond(AsyncWebServerRequest *request) override {
+        tryRespond(request);
+    }
+
+    size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t) override {
+        if (_state == RESPONSE_SETUP) {
+            tryRespond(request);
+            return 0;
+        }
+        _ackedLength += len;
+        if (_state == RESPONSE_WAIT_ACK && _ackedLength >= _writtenLength) {
+            _state = RESPONSE_END;
+        }
+        return 0;
+    }
+};
+
+// Düz upload isteğinin _tempObject'i (istek silinince free() edilir)
+struct UploadRequestState {
+    int code;                       // 0: yazılıyor/kapanış bekleniyor
+    const char* message;
+    char path[LIBRARY_MAX_PATH + 1];
+};
+
+// Dosya adını temizler (boşluk -> '_'), uzantıyı kontrol eder ve "/ad"
+// yolunu kurar. Düz ve devam ettirilebilir upload aynı listeyi kullanır.
+static bool uploadPath(const String& filename, LibraryPath& path) {
+    path.clear();
+    path.append('/').append(filename);
+    path.replace(' ', '_');
+    if (path.length() < 2 || path.truncated() || path.lastIndexOf('/') != 0 || path.contains("..")) {
+        return false;
+    }
+    
+    if (path.lastIndexOf('.') > 1) {
+        return path.endsWithIgnoreCase(".mp3") || path.endsWithIgnoreCase(".m4a") ||
+               path.endsWithIgnoreCase(".aac") || path.endsWithIgnoreCase(".wav");
+    }
+    return true;
+}
+
+// RTClib DateTime::timestamp() biçimi ("YYYY-MM-DDThh:mm:ss"), String'siz
+static void formatTimestamp(uint32_t unixtime, char* out, size_t size) {
+    DateTime t(unixtime);
+    snprintf(out, size, "%04u-%02u-%02uT%02u:%02u:%02u", (unsigned)t.year(), (unsigned)t.month(),
+        (unsigned)t.day(), (unsigned)t.hour(), (unsigned)t.minute(), (unsigned)t.second());
+}
+
+// Kontrol komutları ses task'ının kuyruğuna gider; yanıt sadece kabulü bildirir
+static void sendQueued(AsyncWebServerRequest *request, bool queued) {
+    if (queued) {
+        request->send(200);
+    } else {
+        request->send(503, "text/plain", "Komut kuyruğu dolu");
+    }
+}
+
+// Zamanlayıcı olayları loop task'ında gelir; ses komutları kuyruğa gider
+static Ds3231TimerAlarm rtcAlarm;
+static RTC_DS3231 clockRtc;
+static std::atomic<int> sleepBaseVolume(-1);   // uyku kısması başlamadan önceki ses
+
+static void restoreSleepVolume() {
+    int volume = sleepBaseVolume.exchange(-1);
+    if (volume >= 0) {
+        audioTask.setVolume(volume);
+    }
+}
+
+static void onTimerEvent(const TimerEvent& event, void* context) {
+    switch (event.action) {
+        case TIMER_ACTION_PLAY:
+            audioTask.resume();
+            break;
+        case TIMER_ACTION_STOP:
+            audioTask.stop();
+            restoreSleepVolume();
+            break;
+        case TIMER_ACTION_FADE: {
+            int base = sleepBaseVolume.load();
+            if (base < 0) {
+                base = statusSnapshot.getState().volume;
+                sleepBaseVolume.store(base);
+            }
+            audioTask.setVolume(base * event.level / 100);
+            break;
+        }
+    }
+}
+
+// "YYYY-MM-DDTHH:MM" veya "HH:MM"
+static bool parseTimerTime(const String& text, uint32_t* at, uint8_t& hour, uint8_t& minute) {
+    int y, mo, d, h, mi;
+    if (sscanf(text.c_str(), "%d-%d-%dT%d:%d", &y, &mo, &d, &h, &mi) == 5) {
+        if (at) *at = DateTime(y, mo, d, h, mi, 0).unixtime();
+    } else if (!at && sscanf(text.c_str(), "%d:%d", &h, &mi) == 2) {
+        // Tekrar eden kurallarda tarih gerekmez
+    } else {
+        return false;
+    }
+    if (h < 0 || h > 23 || mi < 0 || mi > 59) return false;
+    hour = (uint8_t)h;
+    minute = (uint8_t)mi;
+    return true;
+}
+
+static uint8_t timerActionFromString(const String& action) {
+    return action == "stop" ? TIMER_ACTION_STOP : TIMER_ACTION_PLAY;
+}
+
+static const char* methodName(WebRequestMethodComposite method) {
+    switch (method) {
+        case HTTP_GET:      return "GET";
+        case HTTP_POST:     return "POST";
+        case HTTP_PUT:      return "PUT";
+        case HTTP_DELETE:   return "DELETE";
+        case HTTP_PATCH:    return "PATCH";
+        default:            return "ANY";
+    }
+}
+
+// Handler'ın süresini route'un histogramına yazar (yanıtın gönderimi
+// async_tcp'de sonradan olur, dahil değildir). Handler'ın arenadan
+// ayırdıkları (ArenaJsonDocument) dönüşte geri alınır.
+static void onTimed(AsyncWebServer& server, const char* uri, WebRequestMethodComposite method,
+                    ArRequestHandlerFunction handler, ArUploadHandlerFunction upload = nullptr,
+                    ArBodyHandlerFunction body = nullptr) {
+    HttpRouteMetrics* route = metrics.route(uri, methodName(method));
+    server.on(uri, method, [uri, route, handler](AsyncWebServerRequest *request) {
+        TRACE_SCOPE(uri);
+        RequestArena::Scope arena(requestArena);
+        uint32_t start = micros();
+        handler(request);
+        if (route) route->latency.record(micros() - start);
+    }, upload, body);
+}
+
+static int resumableHttpCode(ResumableStatus status) {
+    switch (status) {
+        case RESUMABLE_OK:
+        case RESUMABLE_DUPLICATE:     return 200;
+        case RESUMABLE_NOT_FOUND:     return 404;
+        case RESUMABLE_BAD_REQUEST:   return 400;
+        case RESUMABLE_BUSY:          return 409;
+        case RESUMABLE_INCOMPLETE:    return 409;
+        case RESUMABLE_HASH_MISMATCH: return 422;
+        case RESUMABLE_IO_ERROR:      return 500;
+        case RESUMABLE_PENDING:       return 202;
+    }
+    return 500;
+}
 
 bool WebServer::begin() {
     Serial.println("\n=== Initializing Web Server ===");
@@ -8,42 +239,40 @@ bool WebServer::begin() {
         Serial.println("❌ SPIFFS Mount Failed");
         return false;
     }
-<<<<<<< HEAD
-    Serial.println("✅ SPIFFS mounted");
-=======
     
-    // SPIFFS içeriğini kontrol et
-    Serial.println("\nChecking SPIFFS files:");
-    File root = SPIFFS.open("/");
-    File file = root.openNextFile();
-    while(file) {
-        Serial.printf("Found file: %s, size: %d bytes\n", file.name(), file.size());
-        file = root.openNextFile();
-    }
+    // Müzik kütüphanesi indeksi (SD bu noktada mount edilmiş olmalı)
+    libraryIndex.begin();
     
-    // Ana sayfa route'u
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (SPIFFS.exists("/index.html")) {
-            request->send(SPIFFS, "/index.html", "text/html");
-            Serial.println("Serving index.html");
-        } else {
-            Serial.println("❌ index.html not found!");
-            request->send(404, "text/plain", "index.html not found!");
-        }
-    });
+    // Upload'ların SD yazıcısı (tampon havuzu ilk upload'da ayrılır)
+    uploadWriter.begin();
+    resumableUploads.begin();
+    otaUpdater.begin();
     
-    // Statik dosyalar için route'lar
-    server.serveStatic("/css/", SPIFFS, "/css/");
-    server.serveStatic("/js/", SPIFFS, "/js/");
+    // Decoder'ın SD kaynağı için önden okuma task'ı
+    audioPrefetch.begin();
     
-    // API route'larını ayarla
-    setupRoutes();
->>>>>>> stable-power-audio
+    // Decoder ve kontrol komutları ses çekirdeğinde (AudioTask)
+    audioTask.begin(audioManager);
+    
+    // Duvar saati millis()'ten; DS3231 dakikada bir, DAC burst'leri arasında okunur
+    if (clockRtc.begin(&Wire)) {
+        rtcClock.begin(&clockRtc, &i2cArbiter);
+    } else {
+        Serial.println("❌ RTC saati başlatılamadı");
+    }
+    
+    // Zamanlayıcılar DS3231 alarmıyla uyanır, loop() RTC'yi yoklamaz
+    rtcAlarm.begin();
+    timerScheduler.begin(&rtcAlarm, onTimerEvent);
+    Serial.printf("✅ SPIFFS mounted, %u static assets%s\n", (unsigned)StaticAssetHandler::count(),
+        StaticAssetHandler::isEmbedded() ? " (embedded)" : "");
     
     // WebSocket handler'ı ekle
     ws.onEvent([this](AsyncWebSocket *server, AsyncWebSocketClient *client, 
         AwsEventType type, void *arg, uint8_t *data, size_t len) {
-        if(type == WS_EVT_DATA) {
+        if(type == WS_EVT_CONNECT) {
+            statusChannel.requestSnapshot(client->id());
+        } else if(type == WS_EVT_DATA) {
             AwsFrameInfo *info = (AwsFrameInfo*)arg;
             if(info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
                 handleWebSocketMessage(server, client, info, data, len);
@@ -51,26 +280,11 @@ bool WebServer::begin() {
         }
     });
     server.addHandler(&ws);
-    
-<<<<<<< HEAD
-    // Ana sayfa route'u
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (SPIFFS.exists("/index.html")) {
-            request->send(SPIFFS, "/index.html", "text/html");
-        } else {
-            request->send(404, "text/plain", "index.html not found!");
-        }
-    });
-    
-    // Statik dosyalar için route'lar
-    server.serveStatic("/css/", SPIFFS, "/css/");
-    server.serveStatic("/js/", SPIFFS, "/js/");
+    statusChannel.attach(ws);
     
     // API route'larını ayarla
     setupRoutes();
     
-=======
->>>>>>> stable-power-audio
     // Sunucuyu başlat
     server.begin();
     
@@ -86,36 +300,8 @@ bool WebServer::begin() {
 }
 
 void WebServer::setupRoutes() {
-    // Ana sayfa
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (SPIFFS.exists("/index.html")) {
-            request->send(SPIFFS, "/index.html", "text/html");
-        } else {
-            request->send(404, "text/plain", "index.html not found!");
-        }
-    });
-    
-    // CSS dosyası için route
-    server.on("/css/style.css", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (SPIFFS.exists("/css/style.css")) {
-            Serial.println("Serving style.css");
-            request->send(SPIFFS, "/css/style.css", "text/css");
-        } else {
-            Serial.println("❌ style.css not found!");
-            request->send(404, "text/plain", "File not found!");
-        }
-    });
-    
-    // JavaScript dosyası için route
-    server.on("/js/app.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (SPIFFS.exists("/js/app.js")) {
-            Serial.println("Serving app.js");
-            request->send(SPIFFS, "/js/app.js", "application/javascript");
-        } else {
-            Serial.println("❌ app.js not found!");
-            request->send(404, "text/plain", "File not found!");
-        }
-    });
+    // Ana sayfa ve statik dosyalar: tek handler, gzip + ETag + Cache-Control
+    server.addHandler(&staticAssets);
     
     // Catch-all handler for any other requests
     server.onNotFound([](AsyncWebServerRequest *request) {
@@ -124,9 +310,9 @@ void WebServer::setupRoutes() {
     });
     
     // API endpoints
-    server.on("/api/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
         AsyncResponseStream *response = request->beginResponseStream("application/json");
-        DynamicJsonDocument doc(512);
+        ArenaJsonDocument doc(768);
         
 <<<<<<< HEAD
         // RTC zamanı
@@ -134,16 +320,20 @@ void WebServer::setupRoutes() {
         // Temel durum bilgileri
         doc["wifi"] = WiFi.isConnected() ? "Connected" : "Disconnected";
         doc["mqtt"] = mqttManager.isConnectedToMqtt() ? "Connected" : "Disconnected";
-        doc["volume"] = audioManager.getVolume();
-        doc["track"] = audioManager.getCurrentTrack();
-        doc["playing"] = audioManager.isCurrentlyPlaying();
+        StatusState audio = statusSnapshot.getState();
+        doc["volume"] = audio.volume;
+        doc["track"] = audio.track.c_str();
+        doc["title"] = audio.title.c_str();
+        doc["artist"] = audio.artist.c_str();
+        doc["album"] = audio.album.c_str();
+        doc["playing"] = audio.playing;
         
         // Sıcaklık ve zaman bilgileri
-        doc["temperature"] = timeManager.getTemperature();  // Sıcaklığı ekle
+        doc["temperature"] = rtcClock.getTemperature();  // Sıcaklığı ekle
         
         // Zaman bilgileri
 >>>>>>> stable-power-audio
-        DateTime now = timeManager.getDateTime();
+        DateTime now = rtcClock.now();
         doc["time"]["hour"] = now.hour();
         doc["time"]["minute"] = now.minute();
         doc["time"]["second"] = now.second();
@@ -162,7 +352,7 @@ void WebServer::setupRoutes() {
         }
         
         doc["timezone"] = timeManager.getUtcOffset();
-        doc["temperature"] = timeManager.getTemperature();
+        doc["temperature"] = rtcClock.getTemperature();
         
         serializeJson(doc, *response);
 =======
@@ -171,16 +361,165 @@ void WebServer::setupRoutes() {
         doc["time"]["date"]["year"] = now.year();
         
         // Şarkı ilerleme bilgisi
-        doc["track_position"] = audioManager.getCurrentPosition();
-        doc["track_duration"] = audioManager.getTrackDuration();
+        doc["track_position"] = audio.position;
+        doc["track_duration"] = audio.duration;
         
-        String output;
-        serializeJson(doc, output);
-        response->print(output);
+        serializeJson(doc, *response);
 >>>>>>> stable-power-audio
         request->send(response);
     });
     
+    // Devam ettirilebilir upload (data/js/upload.js):
+    //   POST   /api/upload/session?name=&size=   oturum aç (yarım kalan varsa onu döndürür)
+    //   GET    /api/upload/session?id=            alınmış bayt aralıkları
+    //   PUT    /api/upload/chunk?id=&index=       parça gövdesi (application/octet-stream)
+    //   POST   /api/upload/finalize?id=&sha256=   özet doğrula, kütüphaneye taşı (202: tekrar sor)
+    //   DELETE /api/upload/session?id=
+    // "/api/upload" önek olarak bu yolları da yakaladığından önce kaydedilir.
+    onTimed(server, "/api/upload/session", HTTP_POST, [](AsyncWebServerRequest *request) {
+        // Boyut ?size= veya /upload'daki gibi X-File-Size başlığıyla gelir
+        if (!request->hasParam("name") || (!request->hasParam("size") && !request->hasHeader("X-File-Size"))) {
+            request->send(400, "text/plain", "Missing name or size parameter");
+            return;
+        }
+        size_t size = request->hasParam("size") ? request->getParam("size")->value().toInt() :
+            request->header("X-File-Size").toInt();
+        LibraryPath path;
+        if (!uploadPath(request->getParam("name")->value(), path)) {
+            request->send(400, "text/plain", "Desteklenmeyen dosya formatı");
+            return;
+        }
+        String id;
+        ResumableStatus status = resumableUploads.create(path.c_str() + 1, size, id);
+        if (status != RESUMABLE_OK) {
+            request->send(resumableHttpCode(status), "text/plain", ResumableUploads::statusText(status));
+            return;
+        }
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        resumableUploads.writeStatus(id, *response);
+        request->send(response);
+    });
+    
+    onTimed(server, "/api/upload/session", HTTP_GET, [](AsyncWebServerRequest *request) {
+        String id = request->hasParam("id") ? request->getParam("id")->value() : String();
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        ResumableStatus status = resumableUploads.writeStatus(id, *response);
+        if (status != RESUMABLE_OK) {
+            delete response;
+            request->send(resumableHttpCode(status), "text/plain", ResumableUploads::statusText(status));
+            return;
+        }
+        request->send(response);
+    });
+    
+    onTimed(server, "/api/upload/session", HTTP_DELETE, [](AsyncWebServerRequest *request) {
+        String id = request->hasParam("id") ? request->getParam("id")->value() : String();
+        request->send(resumableUploads.remove(id) ? 200 : 404);
+    });
+    
+    // Parçanın sonucu gövde callback'inde _tempObject'e yazılır, yanıt
+    // gövde bittikten sonra çağrılan istek callback'inde gönderilir;
+    // kapanış sürüyorsa writer bitirene kadar ertelenir
+    server.on("/api/upload/chunk", HTTP_PUT,
+        [](AsyncWebServerRequest *request) {
+            ResumableStatus* status = (ResumableStatus*)request->_tempObject;
+            if (!status) {
+                request->send(400, "text/plain", "Empty chunk");
+                return;
+            }
+            if (*status == RESUMABLE_PENDING) {
+                // Writer parçayı kapatınca yanıtlanır; async_tcp SD'yi beklemez
+                request->send(new DeferredResponse([request](bool expired, String& contentType, String& body) {
+                    ResumableStatus status = resumableUploads.pollChunk(request, expired);
+                    if (status == RESUMABLE_PENDING) {
+                        return 0;
+                    }
+                    if (status == RESUMABLE_OK) {
+                        contentType = "application/json";
+                        body = "{}";
+                    } else {
+                        body = ResumableUploads::statusText(status);
+                    }
+                    return resumableHttpCode(status);
+                }, UPLOAD_FINISH_TIMEOUT_MS));
+            } else if (*status == RESUMABLE_OK || *status == RESUMABLE_DUPLICATE) {
+                request->send(200, "application/json", "{}");
+            } else {
+                request->send(resumableHttpCode(*status), "text/plain", ResumableUploads::statusText(*status));
+            }
+        },
+        nullptr,
+        [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            if (!index) {
+                ResumableStatus* status = (ResumableStatus*)malloc(sizeof(ResumableStatus));
+                request->_tempObject = status;
+                if (!status) {
+                    return;
+                }
+                String id = request->hasParam("id") ? request->getParam("id")->value() : String();
+                uint32_t chunk = request->hasParam("index") ? request->getParam("index")->value().toInt() : UINT32_MAX;
+                *status = resumableUploads.beginChunk(id, chunk, total, request,
+                    new AsyncClientFlowControl(request->client()));
+                if (*status == RESUMABLE_OK) {
+                    request->onDisconnect([request]() {
+                        resumableUploads.abortChunk(request);
+                    });
+                }
+            }
+            
+            ResumableStatus* status = (ResumableStatus*)request->_tempObject;
+            if (!status || *status != RESUMABLE_OK) {
+                return;
+            }
+            if (resumableUploads.writeChunk(request, data, len) != RESUMABLE_OK) {
+                resumableUploads.abortChunk(request);
+                *status = RESUMABLE_IO_ERROR;
+                return;
+            }
+            if (index + len == total) {
+                *status = resumableUploads.endChunk(request);
+            }
+        }
+    );
+    
+    // Özetin kalanı writer'da okunur; süre dolarsa 202 döner ve istemci
+    // aynı isteği tekrarlar (okuma sürer, sonuç oturumda bekler)
+    onTimed(server, "/api/upload/finalize", HTTP_POST, [](AsyncWebServerRequest *request) {
+        String id = request->hasParam("id") ? request->getParam("id")->value() : String();
+        String sha256 = request->hasParam("sha256") ? request->getParam("sha256")->value() : String();
+        request->send(new DeferredResponse([request, id, sha256](bool expired, String& contentType, String& body) {
+            String path;
+            ResumableStatus status = resumableUploads.finalize(id, sha256, path);
+            if (status == RESUMABLE_PENDING) {
+                if (!expired) {
+                    return 0;
+                }
+                contentType = "application/json";
+                body = "{\"pending\":true}";
+                return 202;
+            }
+            if (status == RESUMABLE_INCOMPLETE) {
+                // Eksik aralıklar gövdede, istemci sadece onları gönderir
+                StreamString out;
+                resumableUploads.writeStatus(id, out);
+                contentType = "application/json";
+                body = out;
+                return 409;
+            }
+            if (status != RESUMABLE_OK) {
+                body = ResumableUploads::statusText(status);
+                return resumableHttpCode(status);
+            }
+            char json[LIBRARY_MAX_PATH * 6 + 16];
+            size_t n = snprintf(json, sizeof(json), "{\"path\":\"");
+            n += PlaylistStream::escapeJson(path.c_str(), json + n, sizeof(json) - n - 3);
+            memcpy(json + n, "\"}", 3);
+            contentType = "application/json";
+            body = json;
+            return 200;
+        }, UPLOAD_FINISH_TIMEOUT_MS));
+    });
+    
     // Müzik dosyası yükleme
 <<<<<<< HEAD
     server.on("/api/upload", HTTP_POST, 
@@ -188,75 +527,362 @@ void WebServer::setupRoutes() {
     server.on("/upload", HTTP_POST, 
 >>>>>>> stable-power-audio
         [](AsyncWebServerRequest *request) {
-            request->send(200);
+            UploadRequestState* state = (UploadRequestState*)request->_tempObject;
+            if (!state) {
+                request->send(400, "text/plain", "Boş dosya");
+                return;
+            }
+            if (state->code) {
+                request->send(state->code, "text/plain", state->message);
+                return;
+            }
+            // Writer dosyayı kapatınca yanıtlanır; async_tcp SD'yi beklemez
+            request->send(new DeferredResponse([request, state](bool expired, String&, String& body) {
+                UploadResult result = expired ? uploadWriter.wait(request, 0) : uploadWriter.poll(request);
+                if (result == UPLOAD_PENDING) {
+                    return 0;
+                }
+                if (result == UPLOAD_OK) {
+                    Serial.printf("✅ Upload Complete: %s\n", state->path);
+                    libraryIndex.queueAdd(state->path);
+                    body = "Dosya başarıyla yüklendi";
+                    return 200;
+                }
+                Serial.printf("❌ Upload Failed: %s (%d)\n", state->path, (int)result);
+                body = result == UPLOAD_ERROR_OPEN ? "Dosya oluşturulamadı" : "Yazma hatası";
+                return 500;
+            }, UPLOAD_FINISH_TIMEOUT_MS));
         },
         [this](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
             handleFileUpload(request, filename, index, data, len, final);
         }
     );
     
-    // Playlist yönetimi
-    server.on("/api/playlist", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    // Upload yazıcısı istatistikleri (SD hızı, stall ve backpressure sayıları)
+    onTimed(server, "/api/upload/stats", HTTP_GET, [](AsyncWebServerRequest *request) {
+        const UploadStats& stats = uploadWriter.getStats();
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        ArenaJsonDocument doc(384);
+        doc["bytesWritten"] = stats.bytesWritten;
+        doc["writes"] = stats.writes;
+        doc["writeMBps"] = uploadWriter.getWriteMBps();
+        doc["lastUploadMBps"] = stats.lastUploadMBps;
+        doc["maxWriteUs"] = stats.maxWriteUs;
+        doc["slowWrites"] = stats.slowWrites;
+        doc["backpressureHolds"] = stats.backpressureHolds;
+        doc["poolOverflows"] = stats.poolOverflows;
+        doc["completed"] = stats.completed;
+        doc["failed"] = stats.failed;
+        doc["freeBuffers"] = uploadWriter.getFreeBuffers();
+        serializeJson(doc, *response);
+        request->send(response);
+    });
+    
+    // SD önden okuma tamponu: doluluk, bit hızı tahmini ve takılma sayaçları
+    onTimed(server, "/api/audio/prefetch", HTTP_GET, [](AsyncWebServerRequest *request) {
+        const PrefetchStats& stats = audioPrefetch.getStats();
         AsyncResponseStream *response = request->beginResponseStream("application/json");
-        DynamicJsonDocument doc(4096);
-        JsonArray array = doc.to<JsonArray>();
-        
-        auto files = fileManager.getMusicFiles();
-        for (const auto& file : files) {
-            String filename = file;
-            if (filename.startsWith("/")) {
-                filename = filename.substring(1);
+        ArenaJsonDocument doc(384);
+        doc["fill"] = audioPrefetch.getFill();
+        doc["capacity"] = audioPrefetch.getCapacity();
+        doc["preloaded"] = audioPrefetch.getPreloaded();
+        doc["bitrateKbps"] = audioPrefetch.getBitrateKbps();
+        doc["bytesRead"] = stats.bytesRead;
+        doc["reads"] = stats.reads;
+        doc["maxReadUs"] = stats.maxReadUs;
+        doc["underruns"] = stats.underruns;
+        doc["stallMs"] = (uint32_t)(stats.stallTimeUs / 1000);
+        doc["maxStallUs"] = stats.maxStallUs;
+        doc["resizes"] = stats.resizes;
+        doc["opens"] = stats.opens;
+        doc["preloadHits"] = stats.preloadHits;
+        doc["readErrors"] = stats.readErrors;
+        serializeJson(doc, *response);
+        request->send(response);
+    });
+    
+    // I2C bus paylaşımı: cihaz başına transaction süresi ve bekleme,
+    // RTC saatinin son düzeltmeleri
+    onTimed(server, "/api/i2c", HTTP_GET, [](AsyncWebServerRequest *request) {
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        ArenaJsonDocument doc(768);
+        doc["clockHz"] = i2cArbiter.getClock();
+        for (uint8_t device = 0; device < I2C_DEVICE_COUNT; device++) {
+            const I2cDeviceStats& stats = i2cArbiter.getStats(device);
+            JsonObject entry = doc.createNestedObject(I2cArbiter::deviceName(device));
+            entry["transactions"] = stats.transactions;
+            entry["avgBusyUs"] = stats.transactions ? (uint32_t)(stats.totalBusyUs / stats.transactions) : 0;
+            entry["maxBusyUs"] = stats.maxBusyUs;
+            entry["avgWaitUs"] = stats.transactions ? (uint32_t)(stats.totalWaitUs / stats.transactions) : 0;
+            entry["maxWaitUs"] = stats.maxWaitUs;
+            entry["deferred"] = stats.deferred;
+            entry["forced"] = stats.forced;
+        }
+        const RtcClockStats& clock = rtcClock.getStats();
+        doc["clock"]["syncs"] = clock.syncs;
+        doc["clock"]["corrections"] = clock.corrections;
+        doc["clock"]["lastErrorMs"] = clock.lastErrorMs;
+        doc["clock"]["maxErrorMs"] = clock.maxErrorMs;
+        serializeJson(doc, *response);
+        request->send(response);
+    });
+
+    // Prometheus metni: task CPU payı, heap, tamponlar, gecikme histogramları.
+    // Satır satır chunked yazılır, tüm gövde bellekte kurulmaz.
+    onTimed(server, "/api/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+        std::shared_ptr<MetricsStream> stream = std::make_shared<MetricsStream>(metrics);
+        AsyncWebServerResponse *response = request->beginChunkedResponse("text/plain; version=0.0.4",
+            [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return stream->fill(buffer, maxLen);
+            });
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+    });
+
+    // Son olayların Chrome trace_event JSON'u (chrome://tracing veya
+    // ui.perfetto.dev'de açılır). Akış sürerken kayıt durur. DELETE halkaları
+    // boşaltır; yakalanacak olaydan hemen önce çağrılır. İzleme
+    // TRACE_ENABLED=1 ile derlenmediyse 404.
+    onTimed(server, "/api/trace", HTTP_GET, [](AsyncWebServerRequest *request) {
+#if TRACE_ENABLED
+        std::shared_ptr<TraceStream> stream = std::make_shared<TraceStream>(tracer);
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+            [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return stream->fill(buffer, maxLen);
+            });
+        response->addHeader("Cache-Control", "no-cache");
+        response->addHeader("Content-Disposition", "attachment; filename=\"musicbox-trace.json\"");
+        request->send(response);
+#else
+        request->send(404, "text/plain", "Tracing disabled (TRACE_ENABLED=0)");
+#endif
+    });
+
+    onTimed(server, "/api/trace", HTTP_DELETE, [](AsyncWebServerRequest *request) {
+#if TRACE_ENABLED
+        tracer.clear();
+        request->send(200, "application/json", "{}");
+#else
+        request->send(404, "text/plain", "Tracing disabled (TRACE_ENABLED=0)");
+#endif
+    });
+    
+    // Playlist yönetimi
+    // ?offset=&limit= ile sayfalı; ETag kütüphane neslinden türetilir,
+    // If-None-Match eşleşirse gövdesiz 304 döner. Gövde chunked olarak
+    // doğrudan indeksten yazılır, JSON dokümanı kurulmaz. ?meta=1 ile
+    // kayıtlar süre ve etiketli nesnelerdir.
+    onTimed(server, "/api/playlist", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        size_t offset = 0;
+        size_t limit = PLAYLIST_DEFAULT_LIMIT;
+        if (request->hasParam("offset")) {
+            offset = max(0L, request->getParam("offset")->value().toInt());
+        }
+        if (request->hasParam("limit")) {
+            limit = constrain(request->getParam("limit")->value().toInt(), 0L, (long)PLAYLIST_MAX_LIMIT);
+        }
+        bool withMeta = request->hasParam("meta") && request->getParam("meta")->value() == "1";
+        
+        String etag = PlaylistStream::makeEtag(libraryIndex.getCardId(), libraryIndex.getGeneration(), offset, limit, withMeta);
+        
+        if (request->hasHeader("If-None-Match") &&
+            request->getHeader("If-None-Match")->value().indexOf(etag) >= 0) {
+            AsyncWebServerResponse *response = request->beginResponse(304);
+            response->addHeader("ETag", etag);
+            response->addHeader("Cache-Control", "no-cache");
+            request->send(response);
+            return;
+        }
+        
+        std::shared_ptr<PlaylistStream> stream = std::make_shared<PlaylistStream>(libraryIndex, offset, limit, withMeta);
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+            [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return stream->fill(buffer, maxLen);
+            });
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+        response->addHeader("X-Total-Count", String((unsigned)stream->getTotal()));
+        request->send(response);
+    });
+    
+    // Kütüphaneyi yeniden tara (kart başka bir cihazda değiştirildiyse);
+    // tarama loop task'ında yapılır, yanıt sadece kabulü bildirir
+    onTimed(server, "/api/library/rescan", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (libraryIndex.queueRescan()) {
+            request->send(202, "text/plain", "Tarama sıraya alındı");
+        } else {
+            request->send(503, "text/plain", "Kütüphane kuyruğu dolu");
+        }
+    });
+    
+    // Parça önizleme/indirme: /api/stream/<dosya>. Range tek aralık olarak
+    // desteklenir (206, dosya dışıysa 416). Gövde fill callback'iyle parça
+    // parça SD'den okunur; çalma sürerken akış kısılır ve ertelenir.
+    onTimed(server, "/api/stream", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        static const size_t prefixLength = strlen("/api/stream/");
+        LibraryPath path;
+        if (request->url().length() <= prefixLength ||
+            !LibraryIndex::makePath(request->url().c_str() + prefixLength, path) ||
+            !libraryIndex.contains(path.c_str())) {
+            request->send(404, "text/plain", "Track not found");
+            return;
+        }
+        
+        std::shared_ptr<TrackStream> stream = std::make_shared<TrackStream>();
+        StreamOpenResult opened = stream->open(path.c_str());
+        if (opened != STREAM_OPEN_OK) {
+            if (opened == STREAM_OPEN_BUSY) {
+                AsyncWebServerResponse *response = request->beginResponse(503, "text/plain", "Too many streams");
+                response->addHeader("Retry-After", "5");
+                request->send(response);
+            } else {
+                request->send(404, "text/plain", "Track not found");
             }
-            array.add(filename);
+            return;
+        }
+        
+        uint32_t size = stream->getSize();
+        uint32_t start = 0;
+        uint32_t end = size ? size - 1 : 0;
+        StreamRangeResult range = TrackStream::parseRange(
+            request->hasHeader("Range") ? request->getHeader("Range")->value().c_str() : nullptr, size, start, end);
+        char contentRange[48];
+        if (range == STREAM_RANGE_UNSATISFIABLE) {
+            snprintf(contentRange, sizeof(contentRange), "bytes */%lu", (unsigned long)size);
+            AsyncWebServerResponse *response = request->beginResponse(416);
+            response->addHeader("Content-Range", contentRange);
+            request->send(response);
+            return;
+        }
+        if (range == STREAM_RANGE_OK) {
+            stream->setRange(start, end);
         }
         
-        String output;
-        serializeJson(doc, output);
-        response->print(output);
+        // getContentType uzantıya küçük harfle bakar
+        String name(path.c_str());
+        name.toLowerCase();
+        AsyncWebServerResponse *response = request->beginResponse(getContentType(name), size ? end - start + 1 : 0,
+            [stream, request](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                size_t n = stream->fill(buffer, maxLen);
+                if (n == 0 && !stream->finished()) {
+                    // SD hatası: eksik gövdeyi beklemek yerine bağlantı kapanır
+                    request->client()->close();
+                }
+                return n;
+            });
+        if (range == STREAM_RANGE_OK) {
+            snprintf(contentRange, sizeof(contentRange), "bytes %lu-%lu/%lu",
+                     (unsigned long)start, (unsigned long)end, (unsigned long)size);
+            response->setCode(206);
+            response->addHeader("Content-Range", contentRange);
+        }
+        response->addHeader("Accept-Ranges", "bytes");
+        response->addHeader("Cache-Control", "no-cache");
         request->send(response);
     });
     
-    // Timer yönetimi
-    server.on("/api/timers", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    // Açık akışlar: bağlantı başına gönderilen byte, hız ve ertelemeler
+    onTimed(server, "/api/streams", HTTP_GET, [](AsyncWebServerRequest *request) {
+        const StreamTotals& totals = TrackStream::getTotals();
         AsyncResponseStream *response = request->beginResponseStream("application/json");
-        StaticJsonDocument<1024> doc;
+        ArenaJsonDocument doc(256 + STREAM_MAX_CONNECTIONS * (LIBRARY_MAX_PATH + 192));
+        doc["opened"] = totals.opened;
+        doc["completed"] = totals.completed;
+        doc["rejected"] = totals.rejected;
+        doc["readErrors"] = totals.readErrors;
+        doc["deferred"] = totals.deferred;
+        doc["kilobytes"] = (uint32_t)(totals.bytes / 1024);
+        JsonArray list = doc.createNestedArray("connections");
+        for (size_t i = 0; i < STREAM_MAX_CONNECTIONS; i++) {
+            const StreamConnection& connection = TrackStream::connection(i);
+            if (!connection.active) continue;
+            JsonObject entry = list.createNestedObject();
+            entry["id"] = connection.id;
+            entry["path"] = connection.path.c_str();
+            entry["start"] = connection.rangeStart;
+            entry["length"] = connection.length;
+            entry["sent"] = connection.sent;
+            entry["kbps"] = TrackStream::kbpsOf(connection);
+            entry["reads"] = connection.reads;
+            entry["deferred"] = connection.deferred;
+            entry["maxReadUs"] = connection.maxReadUs;
+        }
+        serializeJson(doc, *response);
+        request->send(response);
+    });
+    
+    // Timer yönetimi: kurallar scheduler'dan kilit altında okunur
+    onTimed(server, "/api/timers", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        ArenaJsonDocument doc(256 + TIMER_MAX_TIMERS * 160);
         JsonArray array = doc.createNestedArray("timers");
+        static const char* const repeats[] = { "once", "daily", "weekly", "sleep" };
         
-        auto timers = timeManager.getTimers();
-        for (const auto& timer : timers) {
+        timerScheduler.forEach([&](const TimerRule& rule, uint32_t nextFire) {
             JsonObject timerObj = array.createNestedObject();
-<<<<<<< HEAD
-            timerObj["id"] = timer.id;
-            timerObj["datetime"] = String(timer.dateTime.year()) + "-" +
-                                 String(timer.dateTime.month()) + "-" +
-                                 String(timer.dateTime.day()) + "T" +
-                                 String(timer.dateTime.hour()) + ":" +
-                                 String(timer.dateTime.minute());
-            timerObj["action"] = timer.action;
-            timerObj["enabled"] = timer.enabled;
-        }
-        
-        String output;
-        serializeJson(doc, output);
-        response->print(output);
-=======
-            timerObj["hour"] = timer.hour;
-            timerObj["minute"] = timer.minute;
-            timerObj["enabled"] = timer.enabled;
-            timerObj["isPlayTimer"] = timer.isPlayTimer;
-        }
+            timerObj["id"] = rule.id;
+            timerObj["repeat"] = repeats[rule.repeat & 3];
+            timerObj["action"] = rule.action == TIMER_ACTION_STOP ? "stop" : "play";
+            timerObj["enabled"] = rule.enabled;
+            timerObj["isPlayTimer"] = rule.action == TIMER_ACTION_PLAY;
+            // char* olarak verilir: doküman (arenada) kopyalar
+            char stamp[20];
+            if (rule.repeat == TIMER_ONCE || rule.repeat == TIMER_SLEEP) {
+                formatTimestamp(rule.at, stamp, sizeof(stamp));
+                timerObj["datetime"] = (char*)stamp;
+            } else {
+                timerObj["hour"] = rule.hour;
+                timerObj["minute"] = rule.minute;
+                timerObj["weekdays"] = rule.repeat == TIMER_DAILY ? 0x7F : rule.weekdays;
+            }
+            if (rule.repeat == TIMER_SLEEP) timerObj["fade"] = rule.fadeSeconds;
+            if (nextFire) {
+                formatTimestamp(nextFire, stamp, sizeof(stamp));
+                timerObj["next"] = (char*)stamp;
+            }
+        });
         
         serializeJson(doc, *response);
->>>>>>> stable-power-audio
         request->send(response);
     });
     
     // OTA güncelleme
+    // Kabul/ret upload callback'inde _tempObject'e yazılır; doğrulama ve
+    // Update.end OTA task'ında sürer, yanıt durumu sorgulayarak verilir.
+    // Cihaz sadece imaj boot edilebilir işaretlenince yeniden başlar (otaUpdater.loop)
     server.on("/update", HTTP_POST, 
         [](AsyncWebServerRequest *request) {
-            request->send(200);
-            delay(1000);
-            ESP.restart();
+            int* code = (int*)request->_tempObject;
+            if (!code) {
+                request->send(400, "text/plain", "Boş imaj");
+                return;
+            }
+            if (*code == 202) {
+                // Veri kuyrukta; async_tcp Update.end'i beklemez
+                request->send(new DeferredResponse([](bool expired, String&, String& body) {
+                    switch (otaUpdater.getState()) {
+                        case OTA_SUCCESS:
+                            body = "Güncelleme doğrulandı, yeniden başlatılıyor";
+                            return 200;
+                        case OTA_FAILED: {
+                            const char* error = otaUpdater.getError();
+                            body = error ? error : "Güncelleme başarısız";
+                            return error && strstr(error, "SHA-256") ? 422 : 500;
+                        }
+                        default:
+                            if (!expired) {
+                                return 0;
+                            }
+                            body = "Doğrulanıyor";
+                            return 202;
+                    }
+                }, OTA_FINISH_TIMEOUT_MS));
+            } else if (*code == 409) {
+                request->send(409, "text/plain", "Güncelleme sürüyor");
+            } else {
+                const char* error = otaUpdater.getError();
+                request->send(*code, "text/plain", error ? error : "Güncelleme başarısız");
+            }
         },
         [this](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
             handleOTAUpdate(request, filename, index, data, len, final);
@@ -264,27 +890,24 @@ void WebServer::setupRoutes() {
     );
     
     // API endpoints
-    server.on("/api/play", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/play", HTTP_POST, [this](AsyncWebServerRequest *request) {
         Serial.println("\n=== Play Request ===");
         
         // POST verilerini al
 <<<<<<< HEAD
         if (request->hasHeader("Content-Type") && request->getHeader("Content-Type")->value() == "application/json") {
             if (request->hasParam("postData", true)) {
-                String json = request->getParam("postData", true)->value();
+                const String& json = request->getParam("postData", true)->value();
                 Serial.printf("Received JSON: %s\n", json.c_str());
                 
-                DynamicJsonDocument doc(1024);
-                DeserializationError error = deserializeJson(doc, json);
+                ArenaJsonDocument doc(1024);
+                DeserializationError error = deserializeJson(doc, json.c_str(), json.length());
                 
-                if (!error && doc.containsKey("file")) {
-                    String file = doc["file"].as<String>();
-                    Serial.printf("Extracted file name: %s\n", file.c_str());
-                    Serial.printf("Full path: /%s\n", file.c_str());
+                LibraryPath path;
+                if (!error && doc.containsKey("file") && LibraryIndex::makePath(doc["file"] | "", path)) {
+                    Serial.printf("Full path: %s\n", path.c_str());
                     
-                    audioManager.play("/" + file);
-                    audioManager.printDebugInfo();
-                    request->send(200);
+                    sendQueued(request, audioTask.play(path.c_str()));
                     return;
                 }
             }
@@ -292,59 +915,53 @@ void WebServer::setupRoutes() {
         
         // Raw body'den okuma dene
         if (request->_tempObject) {
-            String json = (char*)request->_tempObject;
+            char* json = (char*)request->_tempObject;
 =======
         if (request->hasParam("file", true)) {  // form-data için
-            String file = request->getParam("file", true)->value();
+            const String& file = request->getParam("file", true)->value();
             Serial.printf("Playing file (form-data): %s\n", file.c_str());
             
             // M4A/AAC kontrolü
             if (file.endsWith(".m4a") || file.endsWith(".aac")) {
-                String message = "⚠️ M4A/AAC dosya desteği geliştirme aşamasındadır.\n";
-                message += "Lütfen MP3 formatında müzik dosyaları kullanın.\n";
-                message += "Bu özellik bir sonraki güncellemede eklenecektir.";
-                request->send(400, "text/plain", message);
+                request->send(400, "text/plain",
+                    "⚠️ M4A/AAC dosya desteği geliştirme aşamasındadır.\n"
+                    "Lütfen MP3 formatında müzik dosyaları kullanın.\n"
+                    "Bu özellik bir sonraki güncellemede eklenecektir.");
                 return;
             }
             
-            if (file.startsWith("/")) {
-                file = file.substring(1);
+            LibraryPath path;
+            if (!LibraryIndex::makePath(file.c_str(), path)) {
+                request->send(400, "text/plain", "Invalid file");
+                return;
             }
-            
-            audioManager.play("/" + file);
-            request->send(200);
+            sendQueued(request, audioTask.play(path.c_str()));
             return;
         }
-        else if (request->_tempObject) {  // JSON için
-            String json = String((char*)request->_tempObject);
-            free(request->_tempObject);
-            request->_tempObject = NULL;
+        else if (request->_tempObject) {  // JSON için; tampon istekle birlikte serbest bırakılır
+            char* json = (char*)request->_tempObject;
             
 >>>>>>> stable-power-audio
-            Serial.printf("Raw body: %s\n", json.c_str());
+            Serial.printf("Raw body: %s\n", json);
             
-            DynamicJsonDocument doc(1024);
+            // char* girdi: metinler tampondan okunur, dokümana kopyalanmaz
+            ArenaJsonDocument doc(1024);
             DeserializationError error = deserializeJson(doc, json);
             
             if (!error && doc.containsKey("file")) {
-                String file = doc["file"].as<String>();
+                const char* file = doc["file"] | "";
 <<<<<<< HEAD
-                Serial.printf("Extracted file name: %s\n", file.c_str());
-                Serial.printf("Full path: /%s\n", file.c_str());
+                Serial.printf("Extracted file name: %s\n", file);
                 
-                audioManager.play("/" + file);
-                audioManager.printDebugInfo();
 =======
-                Serial.printf("Playing file (JSON): %s\n", file.c_str());
+                Serial.printf("Playing file (JSON): %s\n", file);
                 
-                if (file.startsWith("/")) {
-                    file = file.substring(1);
-                }
-                
-                audioManager.play("/" + file);
 >>>>>>> stable-power-audio
-                request->send(200);
-                return;
+                LibraryPath path;
+                if (LibraryIndex::makePath(file, path)) {
+                    sendQueued(request, audioTask.play(path.c_str()));
+                    return;
+                }
             }
         }
         
@@ -370,53 +987,35 @@ void WebServer::setupRoutes() {
         }
     });
     
-    server.on("/api/pause", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        audioManager.pause();
-        request->send(200);
+    onTimed(server, "/api/pause", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        sendQueued(request, audioTask.pause());
     });
     
-    server.on("/api/stop", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        audioManager.stop();
-        request->send(200);
+    onTimed(server, "/api/stop", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        sendQueued(request, audioTask.stop());
     });
     
-    server.on("/api/prev", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        audioManager.previous();
-        request->send(200);
+    onTimed(server, "/api/prev", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        sendQueued(request, audioTask.previous());
     });
     
-    server.on("/api/next", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        audioManager.next();
-        request->send(200);
+    onTimed(server, "/api/next", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        sendQueued(request, audioTask.next());
     });
     
-    server.on("/api/volume", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/volume", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (request->hasParam("value", true)) {
 <<<<<<< HEAD
             int volume = request->getParam("value", true)->value().toInt();
-            Serial.printf("Setting volume to: %d\n", volume);
-            audioManager.setVolume(volume);
+            audioTask.setVolume(volume);
             request->send(200);
         } else {
             Serial.println("Missing volume parameter");
 =======
-            static uint32_t lastVolumeUpdate = 0;
-            const uint32_t VOLUME_UPDATE_INTERVAL = 50;  // 50ms'ye düşürdük
-            
-            // Çok sık volume güncellemesini engelle
-            uint32_t currentTime = millis();
-            if (currentTime - lastVolumeUpdate < VOLUME_UPDATE_INTERVAL) {
-                request->send(200);
-                return;
-            }
-            
+            // Slider sürüklenirken gelen değerler ses task'ında birleşir;
+            // son değer bir sonraki çerçevede rampayla uygulanır
             int volume = request->getParam("value", true)->value().toInt();
-            
-            // Volume değerini sınırla
-            volume = constrain(volume, 0, 100);
-            
-            audioManager.setVolume(volume);
-            lastVolumeUpdate = currentTime;
+            audioTask.setVolume(volume);
             
             // Hızlı yanıt ver
             AsyncWebServerResponse *response = request->beginResponse(200);
@@ -428,9 +1027,24 @@ void WebServer::setupRoutes() {
         }
     });
     
+    // Pozisyon (saniye); volume gibi son yazan kazanır
+    onTimed(server, "/api/seek", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!request->hasParam("value", true)) {
+            request->send(400, "text/plain", "Missing seek position");
+            return;
+        }
+        long position = request->getParam("value", true)->value().toInt();
+        if (position < 0) {
+            request->send(400, "text/plain", "Invalid seek position");
+            return;
+        }
+        audioTask.seek((uint32_t)position);
+        request->send(200);
+    });
+    
 <<<<<<< HEAD
     // WiFi ayarlarını sıfırla
-    server.on("/api/reset-wifi", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/reset-wifi", HTTP_POST, [this](AsyncWebServerRequest *request) {
         Serial.println("Resetting WiFi settings...");
         request->send(200, "text/plain", "Resetting WiFi settings");
         delay(500);
@@ -439,7 +1053,7 @@ void WebServer::setupRoutes() {
     });
     
     // Tüm NVS verilerini sil
-    server.on("/api/clear-nvs", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/clear-nvs", HTTP_POST, [this](AsyncWebServerRequest *request) {
         Serial.println("Clearing all NVS data...");
         nvs_flash_erase();  // Tüm NVS'yi sil
         nvs_flash_init();   // NVS'yi yeniden başlat
@@ -449,42 +1063,104 @@ void WebServer::setupRoutes() {
     });
     
     // NTP senkronizasyonu
-    server.on("/api/sync-time", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/sync-time", HTTP_POST, [this](AsyncWebServerRequest *request) {
         bool success = timeManager.syncFromNTP();
+        if (success) {
+            timerScheduler.notifyClockChanged();
+            rtcClock.requestSync();
+        }
         AsyncResponseStream *response = request->beginResponseStream("application/json");
-        DynamicJsonDocument doc(128);
+        ArenaJsonDocument doc(128);
         doc["success"] = success;
         serializeJson(doc, *response);
         request->send(response);
     });
     
     // Manuel saat ayarı
-    server.on("/api/set-time", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/set-time", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (request->hasParam("datetime", true)) {
-            String dateTime = request->getParam("datetime", true)->value();
+            const String& dateTime = request->getParam("datetime", true)->value();
             timeManager.setDateTime(dateTime);
+            timerScheduler.notifyClockChanged();
+            rtcClock.requestSync();
             request->send(200);
         } else {
             request->send(400);
         }
     });
     
-    // Timer ekleme
-    server.on("/api/add-timer", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        if (request->hasParam("datetime", true) && request->hasParam("action", true)) {
-            String dateTime = request->getParam("datetime", true)->value();
-            String action = request->getParam("action", true)->value();
-            timeManager.addTimer(dateTime, action);
-            request->send(200);
-        } else {
+    // Timer ekleme: repeat=daily|weekdays|weekends veya weekdays=<maske>
+    // verilirse datetime'ın sadece saati kullanılır ("HH:MM" de olur)
+    onTimed(server, "/api/add-timer", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!request->hasParam("datetime", true) || !request->hasParam("action", true)) {
             request->send(400);
+            return;
+        }
+        const String& dateTime = request->getParam("datetime", true)->value();
+        uint8_t action = timerActionFromString(request->getParam("action", true)->value());
+        const char* repeat = request->hasParam("repeat", true) ? request->getParam("repeat", true)->value().c_str() : "";
+        
+        uint8_t weekdays = 0;
+        if (request->hasParam("weekdays", true)) {
+            weekdays = (uint8_t)request->getParam("weekdays", true)->value().toInt() & 0x7F;
+        } else if (strcmp(repeat, "daily") == 0) {
+            weekdays = 0x7F;
+        } else if (strcmp(repeat, "weekdays") == 0) {
+            weekdays = TIMER_WEEKDAYS;
+        } else if (strcmp(repeat, "weekends") == 0) {
+            weekdays = TIMER_WEEKENDS;
+        }
+        
+        uint8_t hour, minute;
+        uint32_t at = 0;
+        if (!parseTimerTime(dateTime, weekdays ? nullptr : &at, hour, minute)) {
+            request->send(400, "text/plain", "Invalid datetime");
+            return;
+        }
+        
+        int id;
+        if (weekdays == 0x7F) {
+            id = timerScheduler.addDaily(hour, minute, action);
+        } else if (weekdays) {
+            id = timerScheduler.addWeekly(weekdays, hour, minute, action);
+        } else {
+            id = timerScheduler.addOnce(at, action);
+        }
+        if (id < 0) {
+            request->send(507, "text/plain", "Timer table full");
+            return;
         }
+        char body[24];
+        snprintf(body, sizeof(body), "{\"id\":%d}", id);
+        request->send(200, "application/json", body);
     });
     
-    server.on("/api/remove-timer", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    // Uyku zamanlayıcısı: minutes sonra durur, son fade saniyede ses kısılır;
+    // minutes=0 iptal eder
+    onTimed(server, "/api/sleep-timer", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        if (!request->hasParam("minutes", true)) {
+            request->send(400, "text/plain", "Missing minutes");
+            return;
+        }
+        long minutes = request->getParam("minutes", true)->value().toInt();
+        long fade = request->hasParam("fade", true) ? request->getParam("fade", true)->value().toInt() : 30;
+        if (minutes < 0 || minutes > 24 * 60 || fade < 0) {
+            request->send(400, "text/plain", "Invalid sleep timer");
+            return;
+        }
+        int id = timerScheduler.startSleep((uint32_t)minutes * 60, (uint16_t)min(fade, 3600L));
+        if (minutes == 0) restoreSleepVolume();
+        if (id < 0) {
+            request->send(507, "text/plain", "Timer table full");
+            return;
+        }
+        request->send(200);
+    });
+    
+    onTimed(server, "/api/remove-timer", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (request->hasParam("id", true)) {
-            String timerId = request->getParam("id", true)->value();
-            if (timeManager.removeTimer(timerId)) {
+            long timerId = request->getParam("id", true)->value().toInt();
+            if (timerId > 0 && timerScheduler.remove((uint16_t)timerId)) {
                 request->send(200);
             } else {
                 request->send(404, "text/plain", "Timer not found");
@@ -495,30 +1171,33 @@ void WebServer::setupRoutes() {
     });
     
     // Timezone ayarı
-    server.on("/api/set-timezone", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/set-timezone", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (request->hasParam("offset", true)) {
             int offset = request->getParam("offset", true)->value().toInt();
             timeManager.setUtcOffset(offset);
+            timerScheduler.notifyClockChanged();
+            rtcClock.requestSync();
             request->send(200);
         } else {
             request->send(400);
 =======
     // Dosya silme endpoint'i
-    server.on("/api/delete", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/delete", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (request->hasParam("file", true)) {
-            String file = request->getParam("file", true)->value();
-            
-            // Dosya adını temizle
-            if (file.startsWith("/")) {
-                file = file.substring(1);
+            // Dosya adını temizle ("ad" veya "/ad" -> "/ad")
+            LibraryPath path;
+            if (!LibraryIndex::makePath(request->getParam("file", true)->value().c_str(), path)) {
+                request->send(400, "text/plain", "Invalid file parameter");
+                return;
             }
             
             // Dosyayı sil
-            if (SD.remove("/" + file)) {
-                Serial.printf("✅ File deleted: %s\n", file.c_str());
+            if (SD.remove(path.c_str())) {
+                Serial.printf("✅ File deleted: %s\n", path.c_str() + 1);
+                libraryIndex.queueRemove(path.c_str());
                 request->send(200);
             } else {
-                Serial.printf("❌ Failed to delete file: %s\n", file.c_str());
+                Serial.printf("❌ Failed to delete file: %s\n", path.c_str() + 1);
                 request->send(500, "text/plain", "Failed to delete file");
             }
         } else {
@@ -527,28 +1206,20 @@ void WebServer::setupRoutes() {
     });
     
     // Resume endpoint'i
-    server.on("/api/resume", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        if (audioManager.getCurrentTrack().length() > 0) {
-            audioManager.play();  // Mevcut parçayı devam ettir
-            request->send(200);
-        } else {
-            // Eğer hiç şarkı seçilmemişse, ilk şarkıyı çal
-            auto files = fileManager.getMusicFiles();
-            if (!files.empty()) {
-                audioManager.play(files[0]);
-                request->send(200);
-            } else {
-                request->send(400, "text/plain", "No track to resume");
-            }
+    onTimed(server, "/api/resume", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        // Mevcut parça yoksa ses task'ı kütüphanenin ilk şarkısını çalar
+        if (!audioTask.hasTrack() && libraryIndex.size() == 0) {
+            request->send(400, "text/plain", "No track to resume");
+            return;
         }
+        sendQueued(request, audioTask.resume());
     });
     
     // Loop endpoint'i
-    server.on("/api/loop", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    onTimed(server, "/api/loop", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (request->hasParam("enabled", true)) {
             bool enabled = request->getParam("enabled", true)->value() == "true";
-            audioManager.setLooping(enabled);
-            request->send(200);
+            sendQueued(request, audioTask.setLooping(enabled));
         } else {
             request->send(400, "text/plain", "Missing enabled parameter");
 >>>>>>> stable-power-audio
@@ -558,76 +1229,74 @@ void WebServer::setupRoutes() {
 
 void WebServer::handleFileUpload(AsyncWebServerRequest *request, String filename, 
     size_t index, uint8_t *data, size_t len, bool final) {
+    TRACE_SCOPE("upload");
     
-    static File uploadFile;
-    
+    // Veri sadece writer'ın tamponuna kopyalanır; SD yazması arka planda
+    // (UploadWriter) yapılır, async_tcp task'ı SD'yi beklemez. Oturum
+    // anahtarı istek nesnesidir, eşzamanlı upload'lar ayrı dosyalara gider.
+    // Sonuç _tempObject'e yazılır, yanıtı istek callback'i gönderir.
     if (!index) {
-<<<<<<< HEAD
-        Serial.printf("Upload Start: %s\n", filename.c_str());
-        uploadFile = SD.open("/" + filename, FILE_WRITE);
-    }
-    
-    if (uploadFile) {
-        uploadFile.write(data, len);
-        
-        if (final) {
-            uploadFile.close();
-            Serial.printf("Upload Complete: %s, %u bytes\n", filename.c_str(), index + len);
-            request->send(200, "text/plain", "File uploaded successfully");
-        }
-    } else {
-        request->send(500, "text/plain", "Could not create file");
-=======
         Serial.printf("\n Upload Start: %s\n", filename.c_str());
         
-        // Dosya adını temizle (sadece boşlukları değiştir)
-        filename.replace(" ", "_");
+        UploadRequestState* state = (UploadRequestState*)malloc(sizeof(UploadRequestState));
+        request->_tempObject = state;
+        if (!state) {
+            return;
+        }
+        state->code = 0;
+        state->message = nullptr;
         
         // Dosya uzantısını kontrol et
-        int dotIndex = filename.lastIndexOf(".");
-        if (dotIndex > 0) {
-            String ext = filename.substring(dotIndex);
-            ext.toLowerCase();
-            
-            if (ext != ".mp3" && ext != ".m4a" && 
-                ext != ".aac" && ext != ".wav") {
-                request->send(400, "text/plain", "Desteklenmeyen dosya formatı");
-                return;
-            }
+        LibraryPath path;
+        if (!uploadPath(filename, path)) {
+            state->code = 400;
+            state->message = "Desteklenmeyen dosya formatı";
+            return;
         }
+        strlcpy(state->path, path.c_str(), sizeof(state->path));
         
         // SD kart kontrolü
         if (!SD.exists("/")) {
-            request->send(500, "text/plain", "SD kart bulunamadı");
+            state->code = 500;
+            state->message = "SD kart bulunamadı";
             return;
         }
         
-        // Dosyayı aç
-        uploadFile = SD.open("/" + filename, FILE_WRITE);
-        if (!uploadFile) {
-            request->send(500, "text/plain", "Dosya oluşturulamadı");
-            return;
+        // İstemci boyutu bildirdiyse dosya önceden genişletilir (FAT zinciri tek seferde)
+        size_t expectedSize = 0;
+        if (request->hasHeader("X-File-Size")) {
+            expectedSize = request->header("X-File-Size").toInt();
         }
         
-        Serial.printf("📝 Creating file: /%s\n", filename.c_str());
-    }
-    
-    if (uploadFile) {
-        if (uploadFile.write(data, len) != len) {
-            uploadFile.close();
-            request->send(500, "text/plain", "Yazma hatası");
+        if (!uploadWriter.open(request, state->path, expectedSize, new AsyncClientFlowControl(request->client()))) {
+            state->code = 503;
+            state->message = "Yükleme kuyruğu dolu";
             return;
         }
+        request->onDisconnect([request]() {
+            uploadWriter.abort(request);
+        });
         
-        if (final) {
-            uploadFile.close();
-            Serial.printf("✅ Upload Complete: %s, %u bytes\n", filename.c_str(), index + len);
-            request->send(200, "text/plain", "Dosya başarıyla yüklendi");
-            
-            // Müzik listesini güncelle
-            fileManager.getMusicFiles();  // refreshMusicFiles yerine public metodu kullan
-        }
->>>>>>> stable-power-audio
+        Serial.printf("📝 Creating file: %s\n", state->path);
+    }
+    
+    // Upload daha önce reddedildiyse veya iptal edildiyse kalan parçalar atılır
+    UploadRequestState* state = (UploadRequestState*)request->_tempObject;
+    if (!state || state->code || !uploadWriter.has(request)) {
+        return;
+    }
+    
+    if (len && !uploadWriter.write(request, data, len)) {
+        uploadWriter.abort(request);
+        state->code = 500;
+        state->message = "Yazma hatası";
+        return;
+    }
+    
+    if (final && !uploadWriter.close(request)) {
+        uploadWriter.abort(request);
+        state->code = 500;
+        state->message = "Yazma hatası";
     }
 }
 
@@ -635,78 +1304,89 @@ void WebServer::handleOTAUpdate(AsyncWebServerRequest *request, const String& fi
     size_t index, uint8_t *data, size_t len, bool final) {
     
     if (!index) {
-        Serial.println("OTA Update Start");
-        if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
-            Update.printError(Serial);
+        int* code = (int*)malloc(sizeof(int));
+        request->_tempObject = code;
+        if (!code) {
             return;
         }
+        
+        // Özet açılmış imajın SHA-256'sı; sıkıştırma parametreyle ya da
+        // dosya uzantısıyla (.gz / .hs) belirtilir, yoksa otomatik algılanır
+        String sha256 = request->hasParam("sha256") ? request->getParam("sha256")->value() : String();
+        String compression = request->hasParam("compression") ? request->getParam("compression")->value() : String();
+        if (compression.length() == 0) {
+            if (filename.endsWith(".gz")) compression = "gzip";
+            else if (filename.endsWith(".hs")) compression = "heatshrink";
+        }
+        // uint8_t'a daraltmadan önce aralık kontrolü (263 -> 7 olmasın);
+        // aralık dışı değer 0 olur ve start() reddeder
+        long windowParam = request->hasParam("window") ?
+            request->getParam("window")->value().toInt() : OTA_HEATSHRINK_WINDOW;
+        long lookaheadParam = request->hasParam("lookahead") ?
+            request->getParam("lookahead")->value().toInt() : OTA_HEATSHRINK_LOOKAHEAD;
+        uint8_t windowBits = (windowParam > 0 && windowParam <= UINT8_MAX) ? (uint8_t)windowParam : 0;
+        uint8_t lookaheadBits = (lookaheadParam > 0 && lookaheadParam <= UINT8_MAX) ? (uint8_t)lookaheadParam : 0;
+        
+        if (otaUpdater.isBusy()) {
+            *code = 409;
+            return;
+        }
+        if (!otaUpdater.start(sha256, OtaUpdater::compressionFromName(compression), request->contentLength(),
+                new AsyncClientFlowControl(request->client()), windowBits, lookaheadBits)) {
+            *code = sha256.length() == 64 ? 500 : 400;
+            return;
+        }
+        *code = 202;
+        request->onDisconnect([]() {
+            otaUpdater.abort();
+        });
+    }
+    
+    int* code = (int*)request->_tempObject;
+    if (!code || *code != 202) {
+        // Reddedildi veya başarısız oldu, kalan parçalar atılır
+        return;
     }
     
-    if (Update.write(data, len) != len) {
-        Update.printError(Serial);
+    if (len && !otaUpdater.write(data, len)) {
+        *code = 500;
         return;
     }
     
     if (final) {
-        if (!Update.end(true)) {
-            Update.printError(Serial);
-        } else {
-            Serial.println("OTA Update Success");
-        }
+        // Sonuç /update yanıtında otaUpdater.getState() ile alınır
+        otaUpdater.finish();
     }
 }
 
 void WebServer::handleWebSocketMessage(AsyncWebSocket *server, AsyncWebSocketClient *client, 
     AwsFrameInfo *info, uint8_t *data, size_t len) {
     
+    // Çerçeve yerinde ayrıştırılır (char* girdi, metinler kopyalanmaz)
     data[len] = 0;
-    String message = (char*)data;
-    
     StaticJsonDocument<200> doc;
-    DeserializationError error = deserializeJson(doc, message);
+    DeserializationError error = deserializeJson(doc, (char*)data, len);
     
     if (!error) {
-        String command = doc["command"];
-        
-        if (command == "play") {
-            audioManager.play();
-        } else if (command == "pause") {
-            audioManager.pause();
-        } else if (command == "stop") {
-            audioManager.stop();
-        } else if (command == "volume") {
+        const char* command = doc["command"] | "";
+        
+        // Durum, ses task'ı komutu uyguladığında snapshot'a yazılır
+        if (strcmp(command, "play") == 0) {
+            audioTask.resume();
+        } else if (strcmp(command, "pause") == 0) {
+            audioTask.pause();
+        } else if (strcmp(command, "stop") == 0) {
+            audioTask.stop();
+        } else if (strcmp(command, "volume") == 0) {
             int volume = doc["value"];
-            audioManager.setVolume(volume);
+            audioTask.setVolume(volume);
+        } else if (strcmp(command, "seek") == 0) {
+            long position = doc["value"] | -1L;
+            if (position >= 0) audioTask.seek((uint32_t)position);
         }
-        
-        broadcastStatus();
     }
 }
 
-void WebServer::broadcastStatus() {
-    String status = createStatusJson();
-    ws.textAll(status);
-}
-
-String WebServer::createStatusJson() {
-    StaticJsonDocument<512> doc;
-    
-    doc["playing"] = audioManager.isCurrentlyPlaying();
-    doc["volume"] = audioManager.getVolume();
-    doc["track"] = audioManager.getCurrentTrack();
-    
-    DateTime now = timeManager.getDateTime();
-    doc["time"]["hour"] = now.hour();
-    doc["time"]["minute"] = now.minute();
-    doc["time"]["second"] = now.second();
-    
-    doc["temperature"] = timeManager.getTemperature();
-    
-    String status;
-    serializeJson(doc, status);
-    return status;
-}
-
 String WebServer::getContentType(const String& filename) {
     if (filename.endsWith(".html")) return "text/html";
     else if (filename.endsWith(".css")) return "text/css";
@@ -732,4 +1412,52 @@ String WebServer::formatBytes(size_t bytes) {
 
 void WebServer::loop() {
     ws.cleanupClients();
+    
+    // Upload/delete'in kuyruğa bıraktığı indeks güncellemeleri (etiket
+    // okuma ve indeks yazma SD'ye gider, async_tcp'de yapılmaz)
+    libraryIndex.loop();
+    
+    // Paylaşılan durumu sahiplerinden örnekle; değişmeyen alan sürüm artırmaz.
+    // Ses alanlarını AudioTask yazar.
+    static unsigned long lastNetworkSample = 0;
+    static unsigned long lastClockSample = 0;
+    static unsigned long lastTemperatureSample = 0;
+    unsigned long now = millis();
+    bool refresh = statusChannel.hasPendingSnapshots();
+    
+    if (refresh || now - lastNetworkSample >= STATUS_DELTA_INTERVAL_MS) {
+        lastNetworkSample = now;
+        statusSnapshot.setWifi(WiFi.isConnected());
+        statusSnapshot.setMqtt(mqttManager.isConnectedToMqtt());
+    }
+    
+    // Saat ve sıcaklık RtcClock'un önbelleğinden; I2C'ye sadece
+    // rtcClock.loop() dakikada bir, DAC burst'leri arasında çıkar
+    rtcClock.loop();
+    if (refresh || now - lastClockSample >= STATUS_CLOCK_INTERVAL_MS) {
+        lastClockSample = now;
+        statusSnapshot.setTime(rtcClock.now());
+    }
+    if (refresh || lastTemperatureSample == 0 ||
+        now - lastTemperatureSample >= STATUS_TEMPERATURE_INTERVAL_MS) {
+        lastTemperatureSample = now;
+        statusSnapshot.setTemperature(rtcClock.getTemperature());
+    }
+    
+    timerScheduler.loop();
+    statusChannel.loop();
+    
+    // Task CPU payı METRICS_SAMPLE_INTERVAL_MS'de bir; MQTT'ye kısa özet
+    static unsigned long lastMetricsPublish = 0;
+    metrics.setWebSocketClients(ws.count());
+    metrics.loop();
+    if (mqttManager.isConnectedToMqtt() && now - lastMetricsPublish >= METRICS_MQTT_INTERVAL_MS) {
+        lastMetricsPublish = now;
+        TRACE_SCOPE("mqtt.metrics");
+        char payload[METRICS_SUMMARY_SIZE];
+        if (metrics.writeSummary(payload, sizeof(payload))) {
+            mqttManager.publish(METRICS_MQTT_TOPIC, payload);
+        }
+    }
+    otaUpdater.loop();
 } 
\ No newline at end of file